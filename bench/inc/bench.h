@@ -0,0 +1,412 @@
+
+# pragma once
+
+# include <yamdal/all.h>
+# include <yamdal/array.h>
+
+# include <array>
+# include <chrono>
+# include <functional>
+# include <memory>
+# include <string>
+# include <vector>
+# include <utility>
+# include <algorithm>
+# include <concepts>
+# include <limits>
+
+namespace bench
+{
+/*
+ * ===============================================================
+ *
+ * minimal Google Benchmark-style harness
+ *    benchmarks are registered at static-initialisation time by each source file, and run (optionally filtered by name) from main
+ *    each benchmark allocates its own data when run, so only one benchmark's data is alive at a time
+ *
+ * ===============================================================
+ */
+
+/*
+ * result of timing a single benchmark
+ */
+   struct measurement
+  {
+      double seconds=0; // best (minimum) time for one iteration of the kernel
+      size_t elems=0;   // number of grid points processed per iteration
+      size_t bytes=0;   // number of bytes moved to/from memory per iteration (STREAM convention - no write-allocate traffic)
+      size_t iters=0;   // number of timed iterations
+
+      [[nodiscard]]
+      double bandwidth() const { return double(bytes)/seconds; }
+
+      [[nodiscard]]
+      double throughput() const { return double(elems)/seconds; }
+  };
+
+/*
+ * a registered benchmark
+ *    policy is used to select the matching STREAM baseline when reporting
+ */
+   struct benchmark
+  {
+      std::string name;
+      std::string policy;
+      std::function<measurement()> run;
+  };
+
+/*
+ * global list of registered benchmarks
+ */
+   [[nodiscard]]
+   inline std::vector<benchmark>& registry()
+  {
+      static std::vector<benchmark> benchmarks;
+      return benchmarks;
+  }
+
+/*
+ * add a benchmark to the registry
+ *    returns a dummy value so that registration can be done in a namespace-scope variable initialiser
+ */
+   inline bool add( std::string name,
+                    std::string policy,
+                    std::function<measurement()> run )
+  {
+      registry().push_back( { std::move(name),
+                              std::move(policy),
+                              std::move(run) } );
+      return true;
+  }
+
+/*
+ * a registered abstraction-penalty benchmark: a yamdal kernel and the equivalent hand-written raw-pointer loop
+ *    both are run for a given 3D shape, and should process the same elements in the same order
+ */
+   struct penalty_benchmark
+  {
+      using extents_type = stx::extents<stx::dynamic_extent,
+                                        stx::dynamic_extent,
+                                        stx::dynamic_extent>;
+
+      std::string name;
+      std::function<measurement(extents_type)> yam;
+      std::function<measurement(extents_type)> raw;
+  };
+
+/*
+ * global list of registered abstraction-penalty benchmarks
+ */
+   [[nodiscard]]
+   inline std::vector<penalty_benchmark>& penalty_registry()
+  {
+      static std::vector<penalty_benchmark> benchmarks;
+      return benchmarks;
+  }
+
+/*
+ * add an abstraction-penalty benchmark to the registry
+ */
+   inline bool add_penalty( std::string name,
+                            std::function<measurement(penalty_benchmark::extents_type)> yam,
+                            std::function<measurement(penalty_benchmark::extents_type)> raw )
+  {
+      penalty_registry().push_back( { std::move(name),
+                                      std::move(yam),
+                                      std::move(raw) } );
+      return true;
+  }
+
+/*
+ * global settings for timing kernels
+ */
+   struct settings_t
+  {
+      double min_time=0.2; // minimum total time (seconds) to spend timing each kernel
+      size_t min_iters=5;  // minimum number of timed iterations of each kernel
+  };
+
+   [[nodiscard]]
+   inline settings_t& settings()
+  {
+      static settings_t s;
+      return s;
+  }
+
+/*
+ * prevent the compiler optimising away a value which is computed but never used
+ */
+   template<typename T>
+   inline void do_not_optimise( const T& value )
+  {
+      asm volatile( "" : : "r,m"(value) : "memory" );
+  }
+
+/*
+ * force the compiler to assume that all memory may have been read/written, so repeated identical kernels are not merged
+ */
+   inline void clobber_memory()
+  {
+      asm volatile( "" : : : "memory" );
+  }
+
+/*
+ * time repeated calls to kernel()
+ *    one untimed warm-up call, then repeat until both settings().min_time and settings().min_iters are reached
+ *    the best time is reported, as for STREAM
+ */
+   template<std::invocable Kernel>
+   [[nodiscard]]
+   measurement time_kernel( Kernel&& kernel,
+                            const size_t elems,
+                            const size_t bytes )
+  {
+      using clock = std::chrono::steady_clock;
+      using seconds = std::chrono::duration<double>;
+
+      kernel();
+
+      measurement m{ .seconds=0, .elems=elems, .bytes=bytes, .iters=0 };
+
+      double best  = std::numeric_limits<double>::max();
+      double total = 0;
+
+      while( (total < settings().min_time) || (m.iters < settings().min_iters) )
+     {
+         const auto start = clock::now();
+         kernel();
+         const auto stop = clock::now();
+
+         const double t = seconds(stop-start).count();
+
+         best   = std::min(best,t);
+         total += t;
+         ++m.iters;
+     }
+
+      m.seconds = best;
+      return m;
+  }
+
+/*
+ * ===============================================================
+ *
+ * Problem sizes and data layouts
+ *    each rank has approximately the same number of elements (2^22) so that all arrays are well out of cache
+ *
+ * ===============================================================
+ */
+
+   using real = double;
+
+   inline constexpr ptrdiff_t dyn = stx::dynamic_extent;
+
+// problem size for each rank
+   inline constexpr ptrdiff_t n1 = ptrdiff_t(1)<<22;
+
+   inline constexpr ptrdiff_t n2_0 = 2048;
+   inline constexpr ptrdiff_t n2_1 = 2048;
+
+   inline constexpr ptrdiff_t n3_0 = 128;
+   inline constexpr ptrdiff_t n3_1 = 128;
+   inline constexpr ptrdiff_t n3_2 = 256;
+
+// padding added to the innermost dimension for layout_stride fields
+   inline constexpr ptrdiff_t stride_padding = 8;
+
+/*
+ * extents with all static or all dynamic values for each rank
+ */
+   template<yam::ndim_t ndim,
+            bool   is_static>
+   struct extents_for;
+
+   template<> struct extents_for<1,true> : std::type_identity<stx::extents<n1>> {};
+   template<> struct extents_for<2,true> : std::type_identity<stx::extents<n2_0,n2_1>> {};
+   template<> struct extents_for<3,true> : std::type_identity<stx::extents<n3_0,n3_1,n3_2>> {};
+
+   template<> struct extents_for<1,false> : std::type_identity<stx::extents<dyn>> {};
+   template<> struct extents_for<2,false> : std::type_identity<stx::extents<dyn,dyn>> {};
+   template<> struct extents_for<3,false> : std::type_identity<stx::extents<dyn,dyn,dyn>> {};
+
+   template<yam::ndim_t ndim,
+            bool   is_static>
+   using extents_for_t = typename extents_for<ndim,is_static>::type;
+
+   template<yam::ndim_t ndim,
+            bool   is_static>
+   [[nodiscard]]
+   constexpr auto make_extents()
+  {
+      using extents_t = extents_for_t<ndim,is_static>;
+
+      if constexpr( is_static ){ return extents_t{}; }
+      else if constexpr( ndim==1 ){ return extents_t(n1); }
+      else if constexpr( ndim==2 ){ return extents_t(n2_0,n2_1); }
+      else /*       ( ndim==3 ) */{ return extents_t(n3_0,n3_1,n3_2); }
+  }
+
+/*
+ * layout_stride with all dynamic strides for each rank
+ */
+   template<yam::ndim_t ndim>
+   struct stride_layout_for;
+
+   template<> struct stride_layout_for<1> : std::type_identity<stx::layout_stride<dyn>> {};
+   template<> struct stride_layout_for<2> : std::type_identity<stx::layout_stride<dyn,dyn>> {};
+   template<> struct stride_layout_for<3> : std::type_identity<stx::layout_stride<dyn,dyn,dyn>> {};
+
+/*
+ * tags to select memory layout of benchmark fields
+ */
+   enum struct layout_kind { right, left, stride };
+
+   template<layout_kind kind,
+            yam::ndim_t  ndim>
+   using layout_for_t =
+      std::conditional_t<kind==layout_kind::right, stx::layout_right,
+      std::conditional_t<kind==layout_kind::left,  stx::layout_left,
+                                                   typename stride_layout_for<ndim>::type>>;
+
+   [[nodiscard]]
+   constexpr const char* layout_name( const layout_kind kind )
+  {
+      switch( kind )
+     {
+         case layout_kind::right : return "layout_right";
+         case layout_kind::left  : return "layout_left";
+         default                 : return "layout_stride";
+     }
+  }
+
+/*
+ * mapping for a layout over the given extents
+ *    layout_stride mapping is row-major with the innermost dimension padded
+ */
+   template<layout_kind    kind,
+            ptrdiff_t...   Exts>
+   [[nodiscard]]
+   auto make_mapping( const stx::extents<Exts...> exts )
+  {
+      constexpr yam::ndim_t ndim = sizeof...(Exts);
+
+      using layout_t  = layout_for_t<kind,ndim>;
+      using mapping_t = typename layout_t::template mapping<stx::extents<Exts...>>;
+
+      if constexpr( kind==layout_kind::stride )
+     {
+         std::array<ptrdiff_t,ndim> strides;
+         ptrdiff_t s=1;
+         for( size_t r=ndim; r>0; --r )
+        {
+            strides[r-1] = s;
+            s *= exts.extent(r-1) + ((r==ndim) ? stride_padding : 0);
+        }
+         return mapping_t( exts, strides );
+     }
+      else
+     {
+         return mapping_t( exts );
+     }
+  }
+
+/*
+ * owning field of real values with given extents and layout, exposing a yam::basic_span as an indexable
+ */
+   template<typename Extents,
+            layout_kind kind,
+            yam::grid_t grid= yam::primal>
+   struct field
+  {
+      static constexpr yam::ndim_t ndim = Extents::rank();
+
+      using layout_type = layout_for_t<kind,ndim>;
+      using span_type   = yam::basic_span<real,Extents,layout_type,yam::default_accessor<real>,false,grid>;
+
+      using mapping_type = typename span_type::mapping_type;
+
+      std::unique_ptr<real[]> storage;
+      span_type span;
+
+      explicit field( const Extents exts )
+         : field( make_mapping<kind>( exts ) )
+     { }
+
+   private :
+
+      explicit field( const mapping_type mapping )
+         : storage( std::make_unique<real[]>( size_t(mapping.required_span_size()) ) ),
+           span( storage.get(), mapping )
+     { }
+  };
+
+/*
+ * ===============================================================
+ *
+ * Naming helpers
+ *
+ * ===============================================================
+ */
+
+   template<typename Policy>
+   [[nodiscard]]
+   constexpr const char* policy_name()
+  {
+      if constexpr( std::same_as<Policy,yam::execution::serial_policy> ){ return "seq"; }
+# ifdef _OPENMP
+      else if constexpr( std::same_as<Policy,yam::execution::openmp_policy> ){ return "openmp"; }
+# endif
+  }
+
+// eg: "assign/seq/3D/static/layout_right"
+   template<typename    Policy,
+            yam::ndim_t   ndim,
+            bool     is_static>
+   [[nodiscard]]
+   std::string make_name( const std::string& kernel,
+                          const layout_kind  kind )
+  {
+      return kernel
+           + "/" + policy_name<Policy>()
+           + "/" + std::to_string(ndim) + "D"
+           + "/" + (is_static ? "static" : "dynamic")
+           + "/" + layout_name(kind);
+  }
+
+/*
+ * call func<Policy,ndim,is_static,kind>() for every combination of policy, rank, static/dynamic extents and layout
+ */
+   template<typename Func>
+   bool for_each_configuration( Func&& func )
+  {
+      const auto for_layouts =
+         [&]<typename Policy, yam::ndim_t ndim, bool is_static>()
+        {
+            func.template operator()<Policy,ndim,is_static,layout_kind::right >();
+            func.template operator()<Policy,ndim,is_static,layout_kind::left  >();
+            func.template operator()<Policy,ndim,is_static,layout_kind::stride>();
+        };
+
+      const auto for_extents =
+         [&]<typename Policy, yam::ndim_t ndim>()
+        {
+            for_layouts.template operator()<Policy,ndim,true >();
+            for_layouts.template operator()<Policy,ndim,false>();
+        };
+
+      const auto for_ranks =
+         [&]<typename Policy>()
+        {
+            for_extents.template operator()<Policy,1>();
+            for_extents.template operator()<Policy,2>();
+            for_extents.template operator()<Policy,3>();
+        };
+
+      for_ranks.template operator()<yam::execution::serial_policy>();
+# ifdef _OPENMP
+      for_ranks.template operator()<yam::execution::openmp_policy>();
+# endif
+
+      return true;
+  }
+}
@@ -0,0 +1,94 @@
+
+# include <bench.h>
+
+# include <iostream>
+# include <iomanip>
+# include <string>
+# include <string_view>
+# include <map>
+# include <vector>
+# include <utility>
+# include <cstdlib>
+
+/*
+ * run all registered benchmarks whose name contains the filter string (if given)
+ *
+ *    usage: bench.out [filter] [--min-time=seconds] [--min-iters=n]
+ *
+ * results are reported as GB/s and Gelem/s, and as a percentage of the STREAM triad bandwidth for the same execution policy
+ */
+   int main( int argc, char** argv )
+  {
+      std::string filter;
+
+      for( int i=1; i<argc; ++i )
+     {
+         const std::string_view arg = argv[i];
+
+         if( arg.starts_with("--min-time=") )
+        {
+            bench::settings().min_time = std::atof( argv[i]+11 );
+        }
+         else if( arg.starts_with("--min-iters=") )
+        {
+            bench::settings().min_iters = size_t(std::atol( argv[i]+12 ));
+        }
+         else
+        {
+            filter = arg;
+        }
+     }
+
+      const auto print_row =
+         []( const std::string& name,
+             const bench::measurement& m,
+             const double baseline )
+        {
+            std::cout << std::left  << std::setw(56) << name
+                      << std::right << std::fixed
+                      << std::setw(12) << std::setprecision(3) << m.seconds*1e3
+                      << std::setw(10) << std::setprecision(2) << m.bandwidth()*1e-9
+                      << std::setw(10) << std::setprecision(3) << m.throughput()*1e-9
+                      << std::setw(10) << std::setprecision(1) << 100*m.bandwidth()/baseline
+                      << "\n";
+        };
+
+      std::cout << std::left  << std::setw(56) << "benchmark"
+                << std::right << std::setw(12) << "time(ms)"
+                              << std::setw(10) << "GB/s"
+                              << std::setw(10) << "Gelem/s"
+                              << std::setw(10) << "%STREAM"
+                << "\n";
+
+   // STREAM baselines are always run first, triad bandwidth is stored for each policy
+      std::vector<std::pair<const bench::benchmark*,bench::measurement>> stream_results;
+      std::map<std::string,double> baseline;
+
+      for( const auto& b : bench::registry() )
+     {
+         if( !b.name.starts_with("stream_") ){ continue; }
+
+         const auto m = b.run();
+
+         if( b.name.starts_with("stream_triad") )
+        {
+            baseline[b.policy] = m.bandwidth();
+        }
+         stream_results.emplace_back( &b, m );
+     }
+
+      for( const auto& [b,m] : stream_results )
+     {
+         print_row( b->name, m, baseline[b->policy] );
+     }
+
+      for( const auto& b : bench::registry() )
+     {
+         if( b.name.starts_with("stream_") ){ continue; }
+         if( b.name.find(filter) == std::string::npos ){ continue; }
+
+         print_row( b.name, b.run(), baseline[b.policy] );
+     }
+
+      return 0;
+  }
@@ -0,0 +1,95 @@
+
+# include <bench.h>
+
+# include <iostream>
+# include <iomanip>
+# include <string>
+# include <string_view>
+# include <array>
+# include <utility>
+# include <cstdlib>
+
+/*
+ * run all registered abstraction-penalty benchmarks at problem sizes from in-L1 to DRAM
+ *
+ *    usage: penalty.out [filter] [--threshold=ratio] [--min-time=seconds] [--min-iters=n]
+ *
+ * reports the ratio (yamdal time)/(raw-loop time) for each construct and size,
+ * and returns a non-zero exit code if any ratio exceeds the threshold
+ *    the default of 2 catches gross regressions (eg a kernel which no longer vectorises) without failing on the timer noise of the in-cache sizes,
+ *    use --threshold=1.1 on a quiet machine to check for small penalties
+ */
+   int main( int argc, char** argv )
+  {
+      using extents_t = bench::penalty_benchmark::extents_type;
+
+      std::string filter;
+      double threshold = 2.0;
+
+      for( int i=1; i<argc; ++i )
+     {
+         const std::string_view arg = argv[i];
+
+         if( arg.starts_with("--threshold=") )
+        {
+            threshold = std::atof( argv[i]+12 );
+        }
+         else if( arg.starts_with("--min-time=") )
+        {
+            bench::settings().min_time = std::atof( argv[i]+11 );
+        }
+         else if( arg.starts_with("--min-iters=") )
+        {
+            bench::settings().min_iters = size_t(std::atol( argv[i]+12 ));
+        }
+         else
+        {
+            filter = arg;
+        }
+     }
+
+   // problem sizes: 8kB, 128kB, 2MB and 64MB per array
+      const std::array<std::pair<std::string,extents_t>,4> sizes{{
+         { "L1",   extents_t(  8,  8, 16) },
+         { "L2",   extents_t( 16, 32, 32) },
+         { "L3",   extents_t( 64, 64, 64) },
+         { "DRAM", extents_t(128,256,256) } }};
+
+      std::cout << std::left  << std::setw(28) << "construct"
+                              << std::setw(8)  << "size"
+                << std::right << std::setw(12) << "yam(ms)"
+                              << std::setw(12) << "raw(ms)"
+                              << std::setw(10) << "ratio"
+                << "\n";
+
+      int failures=0;
+
+      for( const auto& b : bench::penalty_registry() )
+     {
+         if( b.name.find(filter) == std::string::npos ){ continue; }
+
+         for( const auto& [label,exts] : sizes )
+        {
+            const auto yam = b.yam(exts);
+            const auto raw = b.raw(exts);
+
+            const double ratio = yam.seconds/raw.seconds;
+            const bool failed = ratio > threshold;
+
+            failures += int(failed);
+
+            std::cout << std::left  << std::setw(28) << b.name
+                                    << std::setw(8)  << label
+                      << std::right << std::fixed
+                                    << std::setw(12) << std::setprecision(3) << yam.seconds*1e3
+                                    << std::setw(12) << std::setprecision(3) << raw.seconds*1e3
+                                    << std::setw(10) << std::setprecision(3) << ratio
+                      << (failed ? "  FAIL" : "")
+                      << "\n";
+        }
+     }
+
+      std::cout << failures << " construct/size pairs exceeded abstraction penalty threshold " << threshold << "\n";
+
+      return failures==0 ? 0 : 1;
+  }
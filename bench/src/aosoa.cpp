@@ -0,0 +1,80 @@
+
+# include <bench.h>
+
+# include <yamdal/aosoa.h>
+# include <yamdal/algorithm.h>
+
+# include <string>
+# include <utility>
+
+/*
+ * a drift update x += dt*vx of 2^22 particles of 8 fields, touching 2 of the 8 fields, through field views
+ *    aosoa_drift: yam::aosoa_array1 with blocks of 512 particles, so each field of a block is one 4 KiB page
+ *    aos_drift:   yam::basic_array of the particle struct
+ */
+
+namespace
+{
+   using bench::real;
+
+   struct particle
+  {
+      real x, y, z;
+      real vx, vy, vz;
+      real m, q;
+  };
+
+   using accessor_t = yam::aosoa_accessor<512,&particle::x,&particle::y,&particle::z,
+                                             &particle::vx,&particle::vy,&particle::vz,
+                                             &particle::m,&particle::q>;
+
+   using aosoa_t = yam::aosoa_array1<accessor_t>;
+   using aos_t   = yam::primal_array1<particle>;
+   using index_t = aos_t::index_type;
+
+   constexpr yam::idx_t n = yam::idx_t(1)<<22;
+   constexpr real dt = real(0.01);
+
+   template<typename Policy,
+            typename  Array>
+   void drift( Array& p )
+  {
+      yam::transform( Policy{}, index_t{}, yam::dextents<1>(n), yam::field_view<&particle::x>( p ),
+                      []( const real x, const real vx ){ return x+dt*vx; },
+                      yam::field_view<&particle::x>( std::as_const(p) ), yam::field_view<&particle::vx>( std::as_const(p) ) );
+  }
+
+   template<typename Policy,
+            typename  Array>
+   auto drift_kernel()
+  {
+      return []()
+     {
+         Array p(n);
+         yam::assign( Policy{}, index_t{}, yam::dextents<1>(n), p,
+                      []( const index_t idx ){ const real v = real(idx[0]%7); return particle{ v, v, v, 1, 1, 1, 1, 1 }; } );
+
+         return bench::time_kernel( [&](){ drift<Policy>( p ); },
+                                    size_t(n), 3*size_t(n)*sizeof(real) );
+     };
+  }
+
+   template<typename Policy>
+   bool register_aosoa()
+  {
+      const std::string policy = bench::policy_name<Policy>();
+      const std::string suffix = "/" + policy + "/1D/dynamic/layout_right";
+
+      bench::add( "aosoa_drift" + suffix, policy, drift_kernel<Policy,aosoa_t>() );
+      bench::add( "aos_drift"   + suffix, policy, drift_kernel<Policy,aos_t>() );
+
+      return true;
+  }
+
+   [[maybe_unused]] const bool registered =
+      register_aosoa<yam::execution::serial_policy>()
+# ifdef _OPENMP
+   && register_aosoa<yam::execution::openmp_policy>()
+# endif
+      ;
+}
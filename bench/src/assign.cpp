@@ -0,0 +1,205 @@
+
+# include <bench.h>
+
+/*
+ * yam::assign, yam::fill and yam::generate over basic_spans of each rank, extents type and layout
+ *    transpose:       assign into a field of the opposite (row/column-major) layout, through the tiled transposing assign
+ *    transpose_naive: the same through a view without strides, so assign uses the plain index loop
+ *    assign_if:       assign where a (precomputed) mask with ~40% active points is true
+ *    assign_indexed:  the same assign over the list of active indices from yam::compact
+ *    assign_set:      the same assign over a yam::index_set of contiguous row spans covering ~40% of each row
+ */
+
+namespace
+{
+   using bench::real;
+   using bench::field;
+
+   [[maybe_unused]] const bool registered =
+      bench::for_each_configuration(
+         []<typename Policy, yam::ndim_t ndim, bool is_static, bench::layout_kind kind>()
+        {
+            using extents_t = bench::extents_for_t<ndim,is_static>;
+            using index_type = yam::index<ndim>;
+
+            const auto name =
+               []( const std::string& kernel )
+              { return bench::make_name<Policy,ndim,is_static>( kernel, kind ); };
+
+            const std::string policy = bench::policy_name<Policy>();
+
+         // assign one field to another
+            bench::add( name("assign"), policy,
+               []()
+              {
+                  const auto exts = bench::make_extents<ndim,is_static>();
+                  const index_type begin{};
+
+                  field<extents_t,kind> dst(exts), src(exts);
+                  yam::fill( Policy{}, begin, exts, dst.span, real(0) );
+                  yam::fill( Policy{}, begin, exts, src.span, real(1) );
+
+                  const auto n = yam::num_elems(exts);
+                  return bench::time_kernel(
+                     [&](){ yam::assign( Policy{}, begin, exts, dst.span, src.span ); },
+                     n, 2*n*sizeof(real) );
+              } );
+
+         // assign into the opposite layout, eg solver k-innermost to I/O i-innermost
+            if constexpr( ndim>1 )
+           {
+               constexpr auto other = kind==bench::layout_kind::left ? bench::layout_kind::right
+                                                                     : bench::layout_kind::left;
+
+               bench::add( name("transpose"), policy,
+                  []()
+                 {
+                     const auto exts = bench::make_extents<ndim,is_static>();
+                     const index_type begin{};
+
+                     field<extents_t,other> dst(exts);
+                     field<extents_t,kind>  src(exts);
+                     yam::fill( Policy{}, begin, exts, dst.span, real(0) );
+                     yam::fill( Policy{}, begin, exts, src.span, real(1) );
+
+                     const auto n = yam::num_elems(exts);
+                     return bench::time_kernel(
+                        [&](){ yam::assign( Policy{}, begin, exts, dst.span, src.span ); },
+                        n, 2*n*sizeof(real) );
+                 } );
+
+               bench::add( name("transpose_naive"), policy,
+                  []()
+                 {
+                     const auto exts = bench::make_extents<ndim,is_static>();
+                     const index_type begin{};
+
+                     field<extents_t,other> dst(exts);
+                     field<extents_t,kind>  src(exts);
+                     yam::fill( Policy{}, begin, exts, dst.span, real(0) );
+                     yam::fill( Policy{}, begin, exts, src.span, real(1) );
+
+                     const auto unstrided = [&]( const index_type idx ) -> real { return src.span(idx); };
+
+                     const auto n = yam::num_elems(exts);
+                     return bench::time_kernel(
+                        [&](){ yam::assign( Policy{}, begin, exts, dst.span, unstrided ); },
+                        n, 2*n*sizeof(real) );
+                 } );
+           }
+
+         // masked assign, densely and through the compacted index list
+            {
+               const auto mask_value =
+                  []( const index_type idx )
+                 {
+                     yam::idx_t s=0;
+                     for( const auto i : idx.idxs ){ s+=i; }
+                     return real( s%5<2 ? 1 : 0 );
+                 };
+
+               bench::add( name("assign_if"), policy,
+                  [mask_value]()
+                 {
+                     const auto exts = bench::make_extents<ndim,is_static>();
+                     const index_type begin{};
+
+                     field<extents_t,kind> dst(exts), src(exts), mask(exts);
+                     yam::fill( Policy{}, begin, exts, dst.span, real(0) );
+                     yam::fill( Policy{}, begin, exts, src.span, real(1) );
+                     yam::assign( Policy{}, begin, exts, mask.span, mask_value );
+
+                     const auto active = [&]( const index_type idx ){ return mask.span(idx)!=real(0); };
+
+                     const auto n = yam::num_elems(exts);
+                     return bench::time_kernel(
+                        [&](){ yam::assign_if( Policy{}, begin, exts, dst.span, active, src.span ); },
+                        n, 4*n*sizeof(real) );
+                 } );
+
+               bench::add( name("assign_indexed"), policy,
+                  [mask_value]()
+                 {
+                     const auto exts = bench::make_extents<ndim,is_static>();
+                     const index_type begin{};
+
+                     field<extents_t,kind> dst(exts), src(exts), mask(exts);
+                     yam::fill( Policy{}, begin, exts, dst.span, real(0) );
+                     yam::fill( Policy{}, begin, exts, src.span, real(1) );
+                     yam::assign( Policy{}, begin, exts, mask.span, mask_value );
+
+                     const auto indices =
+                        yam::compact( Policy{}, begin, exts,
+                                      [&]( const index_type idx ){ return mask.span(idx)!=real(0); } );
+
+                     const auto n = indices.size();
+                     return bench::time_kernel(
+                        [&](){ yam::assign( Policy{}, indices, dst.span, src.span ); },
+                        n, n*(2*sizeof(real)+sizeof(index_type)) );
+                 } );
+
+               bench::add( name("assign_set"), policy,
+                  []()
+                 {
+                     const auto exts = bench::make_extents<ndim,is_static>();
+                     const index_type begin{};
+
+                     field<extents_t,kind> dst(exts), src(exts);
+                     yam::fill( Policy{}, begin, exts, dst.span, real(0) );
+                     yam::fill( Policy{}, begin, exts, src.span, real(1) );
+
+                  // one span starting at a varying offset in each row
+                     constexpr yam::ndim_t last = ndim-1;
+                     const yam::idx_t row = exts.extent(last);
+                     const yam::idx_t length = 2*row/5;
+
+                     yam::index_set<ndim> set;
+                     yam::for_each_index( yam::execution::seq, begin, yam::replace_nth_extent<last,1>(exts),
+                        [&]( index_type idx )
+                       {
+                           yam::idx_t s=0;
+                           for( const auto i : idx.idxs ){ s+=i; }
+                           idx[last] = (7*s)%(row-length+1);
+                           set.insert( idx, length );
+                       } );
+
+                     const auto n = set.size();
+                     return bench::time_kernel(
+                        [&](){ yam::assign( Policy{}, set, dst.span, src.span ); },
+                        n, 2*n*sizeof(real) );
+                 } );
+            }
+
+         // fill a field with a constant
+            bench::add( name("fill"), policy,
+               []()
+              {
+                  const auto exts = bench::make_extents<ndim,is_static>();
+                  const index_type begin{};
+
+                  field<extents_t,kind> dst(exts);
+                  yam::fill( Policy{}, begin, exts, dst.span, real(0) );
+
+                  const auto n = yam::num_elems(exts);
+                  return bench::time_kernel(
+                     [&](){ yam::fill( Policy{}, begin, exts, dst.span, real(1) ); },
+                     n, n*sizeof(real) );
+              } );
+
+         // fill a field from a (stateless) generator
+            bench::add( name("generate"), policy,
+               []()
+              {
+                  const auto exts = bench::make_extents<ndim,is_static>();
+                  const index_type begin{};
+
+                  field<extents_t,kind> dst(exts);
+                  yam::fill( Policy{}, begin, exts, dst.span, real(0) );
+
+                  const auto n = yam::num_elems(exts);
+                  return bench::time_kernel(
+                     [&](){ yam::generate( Policy{}, begin, exts, dst.span, [](){ return real(1); } ); },
+                     n, n*sizeof(real) );
+              } );
+        } );
+}
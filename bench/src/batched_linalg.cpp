@@ -0,0 +1,121 @@
+
+# include <bench.h>
+
+# include <yamdal/batched_linalg.h>
+
+# include <array>
+# include <string>
+# include <utility>
+
+/*
+ * an 8x8 diagonally dominant system at each node of a 3D grid of 48^3 nodes, with matrix and vector components in separate arrays
+ *    lu_factor_solve:  yam::lu_factor_solve, with the elimination vectorised over segments of nodes
+ *    lu_per_node:      the same LU solve as scalar code at each node, with for_each_index
+ */
+
+namespace
+{
+   using bench::real;
+
+   using array_t = yam::primal_array3<real>;
+   using index_t = array_t::index_type;
+
+   constexpr size_t    N = 8;
+   constexpr yam::idx_t n = 48;
+
+   template<size_t size>
+   std::array<array_t,size> make_components()
+  {
+      return [&]<size_t... m>( std::index_sequence<m...> )
+     {
+         return std::array<array_t,size>{ (void(m),array_t( n, n, n ))... };
+     }( std::make_index_sequence<size>{} );
+  }
+
+   void fill( std::array<array_t,N*N>& A,
+              std::array<array_t,N>&   B )
+  {
+      for( size_t i=0; i<N; ++i )
+     {
+         for( yam::idx_t k=0; k<n*n*n; ++k )
+        {
+            B[i].data()[k] = real(1);
+            for( size_t j=0; j<N; ++j ){ A[i*N+j].data()[k] = i==j ? real(N) : real(0.5)/real(1+i+j); }
+        }
+     }
+  }
+
+   template<typename Policy>
+   void lu_per_node( const Policy                     policy,
+                     const std::array<array_t,N*N>&        A,
+                           std::array<array_t,N>&          B )
+  {
+      yam::for_each_index( policy, index_t{}, yam::dextents<3>(n,n,n),
+         [&]( const index_t idx )
+        {
+            std::array<real,N*N> a;
+            std::array<real,N>   b;
+            for( size_t m=0; m<N*N; ++m ){ a[m] = A[m](idx); }
+            for( size_t i=0; i<N; ++i ){ b[i] = B[i](idx); }
+
+            for( size_t k=0; k<N; ++k )
+           {
+               for( size_t i=k+1; i<N; ++i )
+              {
+                  a[i*N+k] /= a[k*N+k];
+                  for( size_t j=k+1; j<N; ++j ){ a[i*N+j] -= a[i*N+k]*a[k*N+j]; }
+              }
+           }
+            for( size_t i=0; i<N; ++i ){ for( size_t j=0; j<i; ++j ){ b[i] -= a[i*N+j]*b[j]; } }
+            for( size_t i=N; i-->0; )
+           {
+               for( size_t j=i+1; j<N; ++j ){ b[i] -= a[i*N+j]*b[j]; }
+               b[i] /= a[i*N+i];
+           }
+
+            for( size_t i=0; i<N; ++i ){ B[i](idx) = b[i]; }
+        } );
+  }
+
+   template<typename Policy>
+   bool register_batched_linalg()
+  {
+      const std::string policy = bench::policy_name<Policy>();
+      const std::string suffix = "/" + policy + "/3D/dynamic/layout_right";
+
+      const auto m = size_t(n*n*n);
+
+      bench::add( "lu_factor_solve" + suffix, policy,
+         [=]()
+        {
+            auto A = make_components<N*N>();
+            auto B = make_components<N>();
+            fill( A, B );
+
+            return bench::time_kernel(
+               [&](){ yam::lu_factor_solve<N>( Policy{}, index_t{}, yam::dextents<3>(n,n,n), std::as_const(A), B ); },
+               m, (N*N+2*N)*m*sizeof(real) );
+        } );
+
+      bench::add( "lu_per_node" + suffix, policy,
+         [=]()
+        {
+            auto A = make_components<N*N>();
+            auto B = make_components<N>();
+            fill( A, B );
+
+            return bench::time_kernel(
+               [&](){ lu_per_node( Policy{}, A, B ); },
+               m, (N*N+2*N)*m*sizeof(real) );
+        } );
+
+      return true;
+  }
+
+   [[maybe_unused]] const bool registered =
+      register_batched_linalg<yam::execution::serial_policy>()
+# ifdef _OPENMP
+   && register_batched_linalg<yam::execution::openmp_policy>()
+# endif
+      ;
+}
@@ -0,0 +1,134 @@
+
+# include <bench.h>
+
+# include <yamdal/blas.h>
+
+# include <functional>
+# include <string>
+# include <tuple>
+
+/*
+ * BLAS-1 kernels over 2^24 element 1D arrays, against the same operations written with the general algorithms
+ *    axpy/axpy_transform:      y = a*x+y, and an eager transform with a lambda
+ *    dot/dot_accumulate:       x.y, and an accumulate of a lazy product
+ *    axpy3/axpy3_separate:     y += a0*x0+a1*x1+a2*x2 in one pass, and as 3 axpy calls
+ */
+
+namespace
+{
+   using bench::real;
+
+   using array_t = yam::array1<real>;
+   using index_t = array_t::index_type;
+
+   constexpr yam::idx_t n = yam::idx_t(1)<<24;
+
+   void fill_ones( array_t& a )
+  {
+      for( yam::idx_t i=0; i<n; ++i ){ a(index_t{i}) = real(1); }
+  }
+
+   template<typename Policy>
+   bool register_blas()
+  {
+      const std::string policy = bench::policy_name<Policy>();
+      const std::string suffix = "/" + policy + "/1D/dynamic/layout_right";
+
+      const auto exts = yam::dextents<1>( n );
+      const auto m = size_t(n);
+
+      bench::add( "axpy" + suffix, policy,
+         [=]()
+        {
+            array_t x(n), y(n);
+            fill_ones( x );
+
+            return bench::time_kernel(
+               [&](){ yam::axpy( Policy{}, index_t{0}, exts, real(0.5), x, y ); },
+               m, 3*m*sizeof(real) );
+        } );
+
+      bench::add( "axpy_transform" + suffix, policy,
+         [=]()
+        {
+            array_t x(n), y(n);
+            fill_ones( x );
+
+            const real a = 0.5;
+            return bench::time_kernel(
+               [&](){ yam::transform( Policy{}, index_t{0}, exts, y, [a]( const real xi, const real yi ){ return a*xi+yi; }, x, y ); },
+               m, 3*m*sizeof(real) );
+        } );
+
+      bench::add( "dot" + suffix, policy,
+         [=]()
+        {
+            array_t x(n), y(n);
+            fill_ones( x );
+            fill_ones( y );
+
+            return bench::time_kernel(
+               [&](){ bench::do_not_optimise( yam::dot( Policy{}, index_t{0}, exts, x, y ) ); },
+               m, 2*m*sizeof(real) );
+        } );
+
+      bench::add( "dot_accumulate" + suffix, policy,
+         [=]()
+        {
+            array_t x(n), y(n);
+            fill_ones( x );
+            fill_ones( y );
+
+            return bench::time_kernel(
+               [&]()
+              {
+                  bench::do_not_optimise( yam::accumulate( Policy{}, index_t{0}, exts,
+                                           []( real& acc, const real xy ){ acc += xy; },
+                                           []( real& acc, const real partial ){ acc += partial; },
+                                           real(0), real(0),
+                                           [&]( const index_t i ){ return x(i)*y(i); } ) );
+              },
+               m, 2*m*sizeof(real) );
+        } );
+
+      bench::add( "axpy3" + suffix, policy,
+         [=]()
+        {
+            array_t x0(n), x1(n), x2(n), y(n);
+            fill_ones( x0 );
+            fill_ones( x1 );
+            fill_ones( x2 );
+
+            return bench::time_kernel(
+               [&](){ yam::axpy( Policy{}, index_t{0}, exts, std::array<real,3>{0.5,0.25,-0.75}, std::tie( x0, x1, x2 ), y ); },
+               m, 5*m*sizeof(real) );
+        } );
+
+      bench::add( "axpy3_separate" + suffix, policy,
+         [=]()
+        {
+            array_t x0(n), x1(n), x2(n), y(n);
+            fill_ones( x0 );
+            fill_ones( x1 );
+            fill_ones( x2 );
+
+            return bench::time_kernel(
+               [&]()
+              {
+                  yam::axpy( Policy{}, index_t{0}, exts, real( 0.5), x0, y );
+                  yam::axpy( Policy{}, index_t{0}, exts, real( 0.25), x1, y );
+                  yam::axpy( Policy{}, index_t{0}, exts, real(-0.75), x2, y );
+              },
+               m, 5*m*sizeof(real) );
+        } );
+
+      return true;
+  }
+
+   [[maybe_unused]] const bool registered =
+      register_blas<yam::execution::serial_policy>()
+# ifdef _OPENMP
+   && register_blas<yam::execution::openmp_policy>()
+# endif
+      ;
+}
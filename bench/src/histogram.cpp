@@ -0,0 +1,55 @@
+
+# include <bench.h>
+
+# include <string>
+
+/*
+ * yam::histogram over basic_spans of each rank, extents type and layout
+ *    with a few bins (privatised per thread) and with many bins (atomic updates for openmp)
+ */
+
+namespace
+{
+   using bench::real;
+   using bench::field;
+
+   [[maybe_unused]] const bool registered =
+      bench::for_each_configuration(
+         []<typename Policy, yam::ndim_t ndim, bool is_static, bench::layout_kind kind>()
+        {
+            using extents_t = bench::extents_for_t<ndim,is_static>;
+            using index_type = yam::index<ndim>;
+
+            const auto name =
+               []( const std::string& kernel )
+              { return bench::make_name<Policy,ndim,is_static>( kernel, kind ); };
+
+            const std::string policy = bench::policy_name<Policy>();
+
+            for( const size_t nbins : { size_t(64), size_t(1)<<20 } )
+           {
+               bench::add( name( "histogram_" + std::to_string(nbins) ), policy,
+                  [=]()
+                 {
+                     const auto exts = bench::make_extents<ndim,is_static>();
+                     const index_type begin{};
+
+                  // values spread over all bins
+                     field<extents_t,kind> src(exts);
+                     yam::assign( Policy{}, begin, exts, src.span,
+                        []( const index_type idx ){ return real( (idx[0]*7919 + idx[ndim-1]*104729) % 1000003 ) * real(1e-6); } );
+
+                     const yam::uniform_bins<real> bins( 0, 1, nbins );
+
+                     const auto n = yam::num_elems(exts);
+                     return bench::time_kernel(
+                        [&]()
+                       {
+                           bench::do_not_optimise(
+                              yam::histogram( Policy{}, begin, exts, bins, src.span ).front() );
+                       },
+                        n, n*sizeof(real) );
+                 } );
+           }
+        } );
+}
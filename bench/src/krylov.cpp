@@ -0,0 +1,134 @@
+
+# include <bench.h>
+
+# include <yamdal/krylov.h>
+# include <yamdal/views.h>
+
+# include <functional>
+# include <string>
+
+/*
+ * 50 conjugate gradient iterations for the 7-point -laplacian on the interior of a 3D grid of 128^3 nodes
+ *    conjugate_gradient fuses each iteration into 2 sweeps, and conjugate_gradient_unfused is the textbook iteration
+ *    written with assign, transform and accumulate (for the dot products), which takes 6 sweeps
+ */
+
+namespace
+{
+   using bench::real;
+
+   using array_t = yam::primal_array3<real>;
+   using index_t = array_t::index_type;
+
+   constexpr yam::idx_t n = 128;
+   constexpr int iterations = 50;
+
+   const auto minus_laplacian =
+      []( const auto& x )
+     {
+         return [&x]( const index_t i ) -> real
+        {
+            return 6*x(i) - x(index_t{i[0]-1,i[1],i[2]}) - x(index_t{i[0]+1,i[1],i[2]})
+                          - x(index_t{i[0],i[1]-1,i[2]}) - x(index_t{i[0],i[1]+1,i[2]})
+                          - x(index_t{i[0],i[1],i[2]-1}) - x(index_t{i[0],i[1],i[2]+1});
+        };
+     };
+
+   void fill_rhs( array_t& b )
+  {
+      yam::for_each_index( yam::execution::seq, index_t{1,1,1}, yam::dextents<3>(n-2,n-2,n-2),
+         [&]( const index_t idx ){ b(idx) = real(idx[0]%7) - real(idx[1]%5) + real(1); } );
+  }
+
+   template<typename Policy>
+   void unfused_cg( const Policy         policy,
+                    const yam::dextents<3> exts,
+                          array_t&            x,
+                          array_t&            r,
+                          array_t&            p,
+                          array_t&            q,
+                    const array_t&            b )
+  {
+      const yam::linear_operator A( minus_laplacian );
+      const index_t begin{1,1,1};
+
+      const auto dot =
+         [&]( const array_t& u, const array_t& v )
+        {
+            return yam::accumulate( policy, begin, exts,
+                                    []( real& acc, const real uv ){ acc += uv; },
+                                    []( real& acc, const real partial ){ acc += partial; },
+                                    real(0), real(0),
+                                    [&]( const index_t i ){ return u(i)*v(i); } );
+        };
+
+      A.apply( policy, begin, exts, q, x );
+      yam::transform( policy, begin, exts, r, std::minus<real>{}, b, q );
+      yam::assign( policy, begin, exts, p, r );
+      real rr = dot( r, r );
+
+      for( int k=0; k<iterations; ++k )
+     {
+         A.apply( policy, begin, exts, q, p );
+         const real alpha = rr/dot( p, q );
+         yam::transform( policy, begin, exts, x, [alpha]( const real xi, const real pi ){ return xi+alpha*pi; }, x, p );
+         yam::transform( policy, begin, exts, r, [alpha]( const real ri, const real qi ){ return ri-alpha*qi; }, r, q );
+         const real rr_new = dot( r, r );
+         const real beta = rr_new/rr;
+         rr = rr_new;
+         yam::transform( policy, begin, exts, p, [beta]( const real ri, const real pi ){ return ri+beta*pi; }, r, p );
+     }
+  }
+
+   template<typename Policy>
+   bool register_krylov()
+  {
+      const std::string policy = bench::policy_name<Policy>();
+      const std::string suffix = "/" + policy + "/3D/dynamic/layout_right";
+
+      const auto interior = yam::dextents<3>( n-2, n-2, n-2 );
+      const auto m = yam::num_elems( interior );
+
+      bench::add( "conjugate_gradient" + suffix, policy,
+         [=]()
+        {
+            array_t x(n,n,n);
+            array_t b(n,n,n);
+            fill_rhs( b );
+
+            yam::solver_options options;
+            options.max_iterations = iterations;
+            options.tolerance = 0;
+
+            const yam::linear_operator A( minus_laplacian );
+
+            return bench::time_kernel(
+               [&](){ (void)yam::conjugate_gradient( Policy{}, index_t{1,1,1}, interior, A, x, b, options ); },
+               iterations*m, iterations*m*11*sizeof(real) );
+        } );
+
+      bench::add( "conjugate_gradient_unfused" + suffix, policy,
+         [=]()
+        {
+            array_t x(n,n,n);
+            array_t r(n,n,n);
+            array_t p(n,n,n);
+            array_t q(n,n,n);
+            array_t b(n,n,n);
+            fill_rhs( b );
+
+            return bench::time_kernel(
+               [&](){ unfused_cg( Policy{}, interior, x, r, p, q, b ); },
+               iterations*m, iterations*m*14*sizeof(real) );
+        } );
+
+      return true;
+  }
+
+   [[maybe_unused]] const bool registered =
+      register_krylov<yam::execution::serial_policy>()
+# ifdef _OPENMP
+   && register_krylov<yam::execution::openmp_policy>()
+# endif
+      ;
+}
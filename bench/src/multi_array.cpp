@@ -0,0 +1,108 @@
+
+# include <bench.h>
+
+# include <yamdal/multi_array.h>
+
+# include <array>
+# include <string>
+# include <tuple>
+
+/*
+ * a pointwise update of 5 coupled components (rho, mu, mv, mw, E) on a 3D grid of 96^3 nodes, into new arrays
+ *    multi_array_update:    yam::multi_array3 with 5 components, all written by one transform
+ *    separate_arrays_update: 5 yam::basic_arrays, and one transform per component with all 5 as sources
+ */
+
+namespace
+{
+   using bench::real;
+
+   using multi_t = yam::multi_array3<real,real,real,real,real>;
+   using array_t = yam::primal_array3<real>;
+   using index_t = array_t::index_type;
+   using state_t = std::array<array_t,5>;
+
+   constexpr yam::idx_t n = 96;
+   constexpr real dt = real(0.01);
+
+   state_t make_state()
+  {
+      return { array_t(n,n,n), array_t(n,n,n), array_t(n,n,n), array_t(n,n,n), array_t(n,n,n) };
+  }
+
+// kinetic energy per unit volume, and the update of component f
+   inline real kinetic( const real rho, const real mu, const real mv, const real mw )
+  {
+      return real(0.5)*(mu*mu+mv*mv+mw*mw)/rho;
+  }
+
+   template<size_t f>
+   inline real update( const real rho, const real mu, const real mv, const real mw, const real E )
+  {
+      const real p = real(0.4)*( E-kinetic( rho, mu, mv, mw ) );
+      const std::array<real,5> q{ rho, mu, mv, mw, E };
+      return q[f] - dt*( f==0 ? mu : f==4 ? (E+p)*mu/rho : q[f]*mu/rho + (f==1 ? p : real(0)) );
+  }
+
+   template<typename Policy>
+   bool register_multi_array()
+  {
+      const std::string policy = bench::policy_name<Policy>();
+      const std::string suffix = "/" + policy + "/3D/dynamic/layout_right";
+
+      const auto exts = yam::dextents<3>(n,n,n);
+      const auto m = size_t(n*n*n);
+
+      bench::add( "multi_array_update" + suffix, policy,
+         [=]()
+        {
+            multi_t q(n,n,n);
+            multi_t qn(n,n,n);
+            yam::assign( Policy{}, index_t{}, exts, q, [](index_t){ return std::tuple<real,real,real,real,real>{ 1, 0.1, 0.2, 0.3, 3 }; } );
+
+            return bench::time_kernel(
+               [&]()
+              {
+                  yam::transform( Policy{}, index_t{}, exts, qn,
+                     []( const auto& u )
+                    {
+                        const auto& [rho,mu,mv,mw,E] = u;
+                        return std::tuple{ update<0>( rho, mu, mv, mw, E ), update<1>( rho, mu, mv, mw, E ), update<2>( rho, mu, mv, mw, E ),
+                                           update<3>( rho, mu, mv, mw, E ), update<4>( rho, mu, mv, mw, E ) };
+                    },
+                     std::as_const(q) );
+              },
+               m, 10*m*sizeof(real) );
+        } );
+
+      bench::add( "separate_arrays_update" + suffix, policy,
+         [=]()
+        {
+            state_t q = make_state();
+            state_t qn = make_state();
+            const std::array<real,5> init{ 1, 0.1, 0.2, 0.3, 3 };
+            for( size_t f=0; f<5; ++f ){ yam::assign( Policy{}, index_t{}, exts, q[f], [v=init[f]](index_t){ return v; } ); }
+
+            return bench::time_kernel(
+               [&]()
+              {
+                  [&]<size_t... f>( std::index_sequence<f...> )
+                 {
+                     ( yam::transform( Policy{}, index_t{}, exts, qn[f],
+                          []( const real rho, const real mu, const real mv, const real mw, const real E ){ return update<f>( rho, mu, mv, mw, E ); },
+                          q[0], q[1], q[2], q[3], q[4] ), ... );
+                 }( std::make_index_sequence<5>{} );
+              },
+               m, 30*m*sizeof(real) );
+        } );
+
+      return true;
+  }
+
+   [[maybe_unused]] const bool registered =
+      register_multi_array<yam::execution::serial_policy>()
+# ifdef _OPENMP
+   && register_multi_array<yam::execution::openmp_policy>()
+# endif
+      ;
+}
@@ -0,0 +1,86 @@
+
+# include <bench.h>
+
+# include <yamdal/multigrid.h>
+
+# include <string>
+
+/*
+ * multigrid transfers between a 3D cell-centred (dual) grid of 160^3 cells and a coarse grid of 80^3 cells
+ *    prolong_linear is run eagerly and as an assign of the lazy view, which evaluates the 8-point stencil separately for each fine cell
+ */
+
+namespace
+{
+   using bench::real;
+
+   using array_t = yam::dual_array3<real>;
+   using index_t = array_t::index_type;
+
+   constexpr yam::idx_t nc = 80;
+   constexpr yam::idx_t nf = 2*nc;
+
+   template<typename Array>
+   void fill_linear( Array& a )
+  {
+      yam::for_each_index( yam::execution::seq, index_t{}, yam::make_dextents( a.extents() ),
+         [&]( const index_t idx ){ a(idx) = real(idx[0]) + real(2*idx[1]) - real(idx[2]); } );
+  }
+
+   template<typename Policy>
+   bool register_multigrid()
+  {
+      const std::string policy = bench::policy_name<Policy>();
+      const std::string suffix = "/" + policy + "/3D/dynamic/layout_right";
+
+   // interior of the fine grid, whose stencils lie within the coarse grid
+      const auto interior = yam::dextents<3>( nf-4, nf-4, nf-4 );
+      const auto n = yam::num_elems( interior );
+
+      bench::add( "prolong_linear" + suffix, policy,
+         [=]()
+        {
+            array_t coarse(nc,nc,nc);
+            array_t fine(nf,nf,nf);
+            fill_linear( coarse );
+
+            return bench::time_kernel(
+               [&](){ yam::prolong_linear( Policy{}, index_t{2,2,2}, interior, fine, coarse ); },
+               n, n*sizeof(real) + n*sizeof(real)/8 );
+        } );
+
+      bench::add( "prolong_linear_view" + suffix, policy,
+         [=]()
+        {
+            array_t coarse(nc,nc,nc);
+            array_t fine(nf,nf,nf);
+            fill_linear( coarse );
+
+            return bench::time_kernel(
+               [&](){ yam::assign( Policy{}, index_t{2,2,2}, interior, fine, yam::prolong_linear( coarse ) ); },
+               n, n*sizeof(real) + n*sizeof(real)/8 );
+        } );
+
+      bench::add( "restrict_full_weighting" + suffix, policy,
+         [=]()
+        {
+            array_t coarse(nc,nc,nc);
+            array_t fine(nf,nf,nf);
+            fill_linear( fine );
+
+            const auto m = size_t(nc*nc*nc);
+            return bench::time_kernel(
+               [&](){ yam::restrict_full_weighting( Policy{}, index_t{0,0,0}, yam::dextents<3>(nc,nc,nc), coarse, fine ); },
+               m, 9*m*sizeof(real) );
+        } );
+
+      return true;
+  }
+
+   [[maybe_unused]] const bool registered =
+      register_multigrid<yam::execution::serial_policy>()
+# ifdef _OPENMP
+   && register_multigrid<yam::execution::openmp_policy>()
+# endif
+      ;
+}
@@ -0,0 +1,83 @@
+
+# include <bench.h>
+
+# include <yamdal/patch_collection.h>
+
+# include <string>
+
+/*
+ * yam::transform_patches over a yam::patch_collection of many small 3D patches of different sizes (4^3 to 19^3)
+ *    compared with a loop calling yam::transform on one patch at a time, which starts a parallel loop per patch
+ */
+
+namespace
+{
+   using bench::real;
+
+   using patches_t = yam::patch_collection<real,3>;
+
+   [[nodiscard]]
+   patches_t make_patches()
+  {
+      patches_t patches;
+
+      size_t total=0;
+      for( yam::idx_t n=0; total<(size_t(1)<<22); ++n )
+     {
+         const yam::idx_t m = 4 + (n*7)%16;
+         (void)patches.add_patch( int(n%3), {20*n,0,0}, {m,m,4+(n*5)%16} );
+         total += patches[patches.size()-1].size();
+     }
+
+      yam::generate_patches( patches, []( int, const yam::index3<> idx ){ return real(idx[0]+idx[1]+idx[2]); } );
+      return patches;
+  }
+
+   template<typename Policy>
+   bool register_patches()
+  {
+      const std::string policy = bench::policy_name<Policy>();
+
+      bench::add( "transform_patches/" + policy + "/3D/dynamic/layout_right", policy,
+         []()
+        {
+            auto patches = make_patches();
+
+            size_t n=0;
+            for( const auto& p : patches ){ n += p.size(); }
+
+            return bench::time_kernel(
+               [&](){ yam::transform_patches( Policy{}, patches, []( const real x ){ return real(0.5)*x+real(1); } ); },
+               n, 2*n*sizeof(real) );
+        } );
+
+      bench::add( "transform_per_patch/" + policy + "/3D/dynamic/layout_right", policy,
+         []()
+        {
+            auto patches = make_patches();
+
+            size_t n=0;
+            for( const auto& p : patches ){ n += p.size(); }
+
+            return bench::time_kernel(
+               [&]()
+              {
+                  for( auto& p : patches )
+                 {
+                     yam::transform( Policy{}, yam::index3<>{}, p.data.extents(), p.data,
+                                     []( const real x ){ return real(0.5)*x+real(1); }, p.data );
+                 }
+              },
+               n, 2*n*sizeof(real) );
+        } );
+
+      return true;
+  }
+
+   [[maybe_unused]] const bool registered =
+      register_patches<yam::execution::serial_policy>()
+# ifdef _OPENMP
+   && register_patches<yam::execution::openmp_policy>()
+# endif
+      ;
+}
@@ -0,0 +1,305 @@
+
+# include <bench.h>
+
+# include <functional>
+
+/*
+ * Abstraction-penalty benchmarks
+ *    each yamdal construct is paired with a hand-written raw-pointer loop doing the same work in the same traversal order
+ *    all kernels are serial so that the ratio measures only the cost of the abstraction
+ *    the raw loops do not use __restrict__, since the yamdal kernels cannot assume their arguments do not alias
+ */
+
+namespace
+{
+   using bench::real;
+   using bench::field;
+   using bench::layout_kind;
+
+   using extents_t = bench::penalty_benchmark::extents_type;
+   using index_type = yam::index3<>;
+
+// number of times each kernel is repeated per timed iteration, so that in-cache sizes are not dominated by timer resolution
+   [[nodiscard]]
+   size_t repetitions( const extents_t exts )
+  {
+      return std::max<size_t>( 1, (size_t(1)<<22)/yam::num_elems(exts) );
+  }
+
+// time `reps` calls of kernel, with a memory clobber between calls
+   template<typename Kernel>
+   [[nodiscard]]
+   bench::measurement time_repeated( Kernel&&      kernel,
+                                     const extents_t exts,
+                                     const size_t   words )
+  {
+      const size_t reps = repetitions(exts);
+      const size_t n = yam::num_elems(exts);
+
+      return bench::time_kernel(
+         [&]()
+        {
+            for( size_t r=0; r<reps; ++r )
+           {
+               kernel();
+               bench::clobber_memory();
+           }
+        },
+         reps*n, reps*words*n*sizeof(real) );
+  }
+
+// raw triple loop in (i,j,k) order with k innermost - the traversal order of the serial yamdal algorithms
+   template<typename Body>
+   void raw_loop( const extents_t exts, Body&& body )
+  {
+      const ptrdiff_t n0 = exts.extent(0);
+      const ptrdiff_t n1 = exts.extent(1);
+      const ptrdiff_t n2 = exts.extent(2);
+
+      for( ptrdiff_t i=0; i<n0; ++i )
+     {
+         for( ptrdiff_t j=0; j<n1; ++j )
+        {
+            for( ptrdiff_t k=0; k<n2; ++k )
+           {
+               body(i,j,k);
+           }
+        }
+     }
+  }
+
+// raw copy over memory with the given strides
+   void raw_copy( const extents_t exts,
+                  real* dst,
+                  const real* src,
+                  const ptrdiff_t s0,
+                  const ptrdiff_t s1,
+                  const ptrdiff_t s2 )
+  {
+      raw_loop( exts,
+         [=]( ptrdiff_t i, ptrdiff_t j, ptrdiff_t k )
+        {
+            const ptrdiff_t o = i*s0 + j*s1 + k*s2;
+            dst[o] = src[o];
+        } );
+  }
+
+// raw copy over contiguous row-major memory
+   void raw_copy( const extents_t exts,
+                  real* dst,
+                  const real* src )
+  {
+      const ptrdiff_t n1 = exts.extent(1);
+      const ptrdiff_t n2 = exts.extent(2);
+
+      raw_loop( exts,
+         [=]( ptrdiff_t i, ptrdiff_t j, ptrdiff_t k )
+        {
+            const ptrdiff_t o = (i*n1 + j)*n2 + k;
+            dst[o] = src[o];
+        } );
+  }
+
+/*
+ * yamdal assign of `source(dst,src)` into a layout_right field, against a contiguous raw copy
+ */
+   template<typename MakeSource>
+   bool add_copy_penalty( const std::string& name,
+                          MakeSource make_source )
+  {
+      return bench::add_penalty( name,
+         [=]( const extents_t exts )
+        {
+            field<extents_t,layout_kind::right> dst(exts), src(exts);
+            yam::fill( index_type{}, exts, dst.span, real(0) );
+            yam::fill( index_type{}, exts, src.span, real(1) );
+
+            const auto source = make_source( src.span );
+
+            return time_repeated(
+               [&](){ yam::assign( index_type{}, exts, dst.span, source ); },
+               exts, 2 );
+        },
+         []( const extents_t exts )
+        {
+            field<extents_t,layout_kind::right> dst(exts), src(exts);
+            yam::fill( index_type{}, exts, dst.span, real(0) );
+            yam::fill( index_type{}, exts, src.span, real(1) );
+
+            return time_repeated(
+               [&](){ raw_copy( exts, dst.span.data(), src.span.data() ); },
+               exts, 2 );
+        } );
+  }
+
+/*
+ * span-to-span assign with the given layout, against a raw copy using the same strides
+ */
+   template<layout_kind kind>
+   bool add_layout_penalty()
+  {
+      return bench::add_penalty( std::string("basic_span/")+bench::layout_name(kind),
+         []( const extents_t exts )
+        {
+            field<extents_t,kind> dst(exts), src(exts);
+            yam::fill( index_type{}, exts, dst.span, real(0) );
+            yam::fill( index_type{}, exts, src.span, real(1) );
+
+            return time_repeated(
+               [&](){ yam::assign( index_type{}, exts, dst.span, src.span ); },
+               exts, 2 );
+        },
+         []( const extents_t exts )
+        {
+            field<extents_t,kind> dst(exts), src(exts);
+            yam::fill( index_type{}, exts, dst.span, real(0) );
+            yam::fill( index_type{}, exts, src.span, real(1) );
+
+            const auto& m = src.span.mapping();
+
+            if constexpr( kind==layout_kind::right )
+           {
+               return time_repeated(
+                  [&](){ raw_copy( exts, dst.span.data(), src.span.data() ); },
+                  exts, 2 );
+           }
+            else
+           {
+               return time_repeated(
+                  [&](){ raw_copy( exts, dst.span.data(), src.span.data(),
+                                   m.stride(0), m.stride(1), m.stride(2) ); },
+                  exts, 2 );
+           }
+        } );
+  }
+
+   [[maybe_unused]] const bool registered_window =
+      add_copy_penalty( "window",
+         []( const auto& src ){ return yam::window( src ); } );
+
+   [[maybe_unused]] const bool registered_cwindow =
+      add_copy_penalty( "cwindow",
+         []( const auto& src ){ return yam::cwindow( src ); } );
+
+   [[maybe_unused]] const bool registered_layouts =
+      add_layout_penalty<layout_kind::right >()
+   && add_layout_penalty<layout_kind::left  >()
+   && add_layout_penalty<layout_kind::stride>();
+
+/*
+ * lazy transform (sum of two fields) assigned to a field, against a raw loop
+ */
+   [[maybe_unused]] const bool registered_transform =
+      bench::add_penalty( "transform",
+         []( const extents_t exts )
+        {
+            field<extents_t,layout_kind::right> dst(exts), src0(exts), src1(exts);
+            yam::fill( index_type{}, exts, dst.span,  real(0) );
+            yam::fill( index_type{}, exts, src0.span, real(1) );
+            yam::fill( index_type{}, exts, src1.span, real(2) );
+
+         // the lazy view is built inside the timed kernel, as the eager transform does
+            return time_repeated(
+               [&]()
+              {
+                  yam::assign( index_type{}, exts, dst.span,
+                               yam::transform( std::plus<real>{},
+                                               yam::cwindow( src0.span ),
+                                               yam::cwindow( src1.span ) ) );
+              },
+               exts, 3 );
+        },
+         []( const extents_t exts )
+        {
+            field<extents_t,layout_kind::right> dst(exts), src0(exts), src1(exts);
+            yam::fill( index_type{}, exts, dst.span,  real(0) );
+            yam::fill( index_type{}, exts, src0.span, real(1) );
+            yam::fill( index_type{}, exts, src1.span, real(2) );
+
+            const ptrdiff_t n1 = exts.extent(1);
+            const ptrdiff_t n2 = exts.extent(2);
+
+            real* d = dst.span.data();
+            const real* a = src0.span.data();
+            const real* b = src1.span.data();
+
+            return time_repeated(
+               [&]()
+              {
+                  raw_loop( exts,
+                     [=]( ptrdiff_t i, ptrdiff_t j, ptrdiff_t k )
+                    {
+                        const ptrdiff_t o = (i*n1 + j)*n2 + k;
+                        d[o] = a[o] + b[o];
+                    } );
+              },
+               exts, 3 );
+        } );
+
+/*
+ * basic_array to basic_array assign, against a raw copy of the underlying storage
+ */
+   [[maybe_unused]] const bool registered_array =
+      bench::add_penalty( "basic_array",
+         []( const extents_t exts )
+        {
+            yam::array3<real> dst( exts.extent(0), exts.extent(1), exts.extent(2) );
+            yam::array3<real> src( exts.extent(0), exts.extent(1), exts.extent(2) );
+            yam::fill( index_type{}, exts, dst, real(0) );
+            yam::fill( index_type{}, exts, src, real(1) );
+
+            return time_repeated(
+               [&](){ yam::assign( index_type{}, exts, dst, src ); },
+               exts, 2 );
+        },
+         []( const extents_t exts )
+        {
+            yam::array3<real> dst( exts.extent(0), exts.extent(1), exts.extent(2) );
+            yam::array3<real> src( exts.extent(0), exts.extent(1), exts.extent(2) );
+            yam::fill( index_type{}, exts, dst, real(0) );
+            yam::fill( index_type{}, exts, src, real(1) );
+
+            return time_repeated(
+               [&](){ raw_copy( exts, dst.data(), src.data() ); },
+               exts, 2 );
+        } );
+
+/*
+ * generator lambda (function of the index) assigned to a field, against a raw loop computing the same values
+ */
+   [[maybe_unused]] const bool registered_generator =
+      bench::add_penalty( "generator",
+         []( const extents_t exts )
+        {
+            field<extents_t,layout_kind::right> dst(exts);
+            yam::fill( index_type{}, exts, dst.span, real(0) );
+
+            const auto gen =
+               []( const index_type idx ){ return real(idx[0]+idx[1]+idx[2]); };
+
+            return time_repeated(
+               [&](){ yam::assign( index_type{}, exts, dst.span, gen ); },
+               exts, 1 );
+        },
+         []( const extents_t exts )
+        {
+            field<extents_t,layout_kind::right> dst(exts);
+            yam::fill( index_type{}, exts, dst.span, real(0) );
+
+            const ptrdiff_t n1 = exts.extent(1);
+            const ptrdiff_t n2 = exts.extent(2);
+
+            real* d = dst.span.data();
+
+            return time_repeated(
+               [&]()
+              {
+                  raw_loop( exts,
+                     [=]( ptrdiff_t i, ptrdiff_t j, ptrdiff_t k )
+                    {
+                        d[(i*n1 + j)*n2 + k] = real(i+j+k);
+                    } );
+              },
+               exts, 1 );
+        } );
+}
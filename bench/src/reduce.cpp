@@ -0,0 +1,191 @@
+
+# include <bench.h>
+
+# include <functional>
+# include <array>
+
+/*
+ * yam::reduce (sum) and yam::transform_reduce (dot product) over basic_spans of each rank, extents type and layout
+ *    reduce_flat: the same sum over the yam::flatten-ed span (contiguous layouts of rank > 1), as one 1D loop
+ * yam::reduce_axis (sum along the last axis) into a basic_span of one rank less
+ * yam::argmin (index of the smallest element)
+ * yam::accumulate (mean and variance, accumulated in place)
+ */
+
+namespace
+{
+   using bench::real;
+   using bench::field;
+
+   [[maybe_unused]] const bool registered =
+      bench::for_each_configuration(
+         []<typename Policy, yam::ndim_t ndim, bool is_static, bench::layout_kind kind>()
+        {
+            using extents_t = bench::extents_for_t<ndim,is_static>;
+            using index_type = yam::index<ndim>;
+
+            const auto name =
+               []( const std::string& kernel )
+              { return bench::make_name<Policy,ndim,is_static>( kernel, kind ); };
+
+            const std::string policy = bench::policy_name<Policy>();
+
+         // sum of one field
+            bench::add( name("reduce"), policy,
+               []()
+              {
+                  const auto exts = bench::make_extents<ndim,is_static>();
+                  const index_type begin{};
+
+                  field<extents_t,kind> src(exts);
+                  yam::fill( Policy{}, begin, exts, src.span, real(1) );
+
+                  const auto n = yam::num_elems(exts);
+                  return bench::time_kernel(
+                     [&]()
+                    {
+                        bench::do_not_optimise(
+                           yam::reduce( Policy{}, begin, exts,
+                                        std::plus<real>{},
+                                        real(0), real(0),
+                                        src.span ) );
+                    },
+                     n, n*sizeof(real) );
+              } );
+
+         // sum of one field through its 1D flattened span
+            if constexpr( ndim>1 && kind!=bench::layout_kind::stride )
+           {
+               bench::add( name("reduce_flat"), policy,
+                  []()
+                 {
+                     const auto exts = bench::make_extents<ndim,is_static>();
+
+                     field<extents_t,kind> src(exts);
+                     yam::fill( Policy{}, index_type{}, exts, src.span, real(1) );
+
+                     const auto flat = yam::flatten( src.span );
+
+                     const auto n = yam::num_elems(exts);
+                     return bench::time_kernel(
+                        [&]()
+                       {
+                           bench::do_not_optimise(
+                              yam::reduce( Policy{}, yam::index1<>{}, flat.extents(),
+                                           std::plus<real>{},
+                                           real(0), real(0),
+                                           flat ) );
+                       },
+                        n, n*sizeof(real) );
+                 } );
+           }
+
+         // dot product of two fields
+         // openmp reductions without an identity value are only available for 1D ranges
+            constexpr bool has_transform_reduce =
+               std::same_as<Policy,yam::execution::serial_policy> || (ndim==1);
+
+            if constexpr( has_transform_reduce )
+           {
+               bench::add( name("transform_reduce"), policy,
+                  []()
+                 {
+                     const auto exts = bench::make_extents<ndim,is_static>();
+                     const index_type begin{};
+
+                     field<extents_t,kind> src0(exts), src1(exts);
+                     yam::fill( Policy{}, begin, exts, src0.span, real(1) );
+                     yam::fill( Policy{}, begin, exts, src1.span, real(2) );
+
+                     const auto n = yam::num_elems(exts);
+                     return bench::time_kernel(
+                        [&]()
+                       {
+                           bench::do_not_optimise(
+                              yam::transform_reduce( Policy{}, begin, exts,
+                                                     std::multiplies<real>{},
+                                                     std::plus<real>{},
+                                                     real(0),
+                                                     src0.span, src1.span ) );
+                       },
+                        n, 2*n*sizeof(real) );
+                 } );
+           }
+
+         // location of the smallest element (eg CFL-limiting cell)
+            bench::add( name("argmin"), policy,
+               []()
+              {
+                  const auto exts = bench::make_extents<ndim,is_static>();
+                  const index_type begin{};
+
+                  field<extents_t,kind> src(exts);
+                  yam::fill( Policy{}, begin, exts, src.span, real(1) );
+
+                  const auto n = yam::num_elems(exts);
+                  return bench::time_kernel(
+                     [&]()
+                    {
+                        bench::do_not_optimise(
+                           yam::argmin( Policy{}, begin, exts, src.span ).value );
+                    },
+                     n, n*sizeof(real) );
+              } );
+
+         // mean and variance of one field, without copying the accumulator per element
+            bench::add( name("accumulate"), policy,
+               []()
+              {
+                  const auto exts = bench::make_extents<ndim,is_static>();
+                  const index_type begin{};
+
+                  field<extents_t,kind> src(exts);
+                  yam::fill( Policy{}, begin, exts, src.span, real(1) );
+
+                  using stats_t = yam::bin_statistics<real>;
+
+                  const auto n = yam::num_elems(exts);
+                  return bench::time_kernel(
+                     [&]()
+                    {
+                        bench::do_not_optimise(
+                           yam::accumulate( Policy{}, begin, exts,
+                                            []( stats_t& acc, const real x ){ acc.add(x); },
+                                            []( stats_t& acc, const stats_t& partial ){ acc.merge(partial); },
+                                            stats_t{}, stats_t{},
+                                            src.span ).mean );
+                    },
+                     n, n*sizeof(real) );
+              } );
+
+         // sum along the last axis (eg vertical integral) into a field of one rank less
+            if constexpr( ndim>1 )
+           {
+               bench::add( name("reduce_axis"), policy,
+                  []()
+                 {
+                     const auto exts = bench::make_extents<ndim,is_static>();
+                     const index_type begin{};
+
+                     std::array<yam::idx_t,ndim-1> dst_exts{};
+                     for( yam::ndim_t d=0; d<ndim-1; ++d ){ dst_exts[d] = exts.extent(d); }
+
+                     field<yam::dextents<ndim-1>,kind> dst{ yam::dextents<ndim-1>(dst_exts) };
+                     field<extents_t,kind> src(exts);
+                     yam::fill( Policy{}, begin, exts, src.span, real(1) );
+
+                     const auto n = yam::num_elems(exts);
+                     return bench::time_kernel(
+                        [&]()
+                       {
+                           yam::reduce_axis<ndim-1>( Policy{}, begin, exts,
+                                                     dst.span,
+                                                     std::plus<real>{},
+                                                     real(0),
+                                                     src.span );
+                       },
+                        n, n*sizeof(real) );
+                 } );
+           }
+        } );
+}
@@ -0,0 +1,119 @@
+
+# include <bench.h>
+
+# include <yamdal/runge_kutta.h>
+
+# include <array>
+# include <string>
+# include <vector>
+
+/*
+ * one RK4 step of 5 fields on a 3D grid of 96^3 nodes, with a pointwise rhs (k = -u)
+ *    rk4_integrator: yam::rk_integrator, with pooled stage arrays, one transform per stage state and one axpy for the update
+ *    rk4_chained:    stage arrays allocated in each step, and the update as one transform per stage
+ */
+
+namespace
+{
+   using bench::real;
+
+   using array_t = yam::primal_array3<real>;
+   using index_t = array_t::index_type;
+   using state_t = std::array<array_t,5>;
+
+   constexpr yam::idx_t n = 96;
+   constexpr real dt = real(0.01);
+
+   state_t make_state()
+  {
+      return { array_t(n,n,n), array_t(n,n,n), array_t(n,n,n), array_t(n,n,n), array_t(n,n,n) };
+  }
+
+   template<typename Policy>
+   void decay( const Policy     policy,
+               const state_t&        U,
+                     state_t&        k )
+  {
+      for( size_t f=0; f<5; ++f )
+     {
+         yam::transform( policy, index_t{}, yam::dextents<3>(n,n,n), k[f], []( const real x ){ return -x; }, U[f] );
+     }
+  }
+
+   template<typename Policy>
+   void rk4_chained( const Policy policy,
+                     state_t&          u )
+  {
+      const auto exts = yam::dextents<3>(n,n,n);
+
+      std::vector<state_t> k;
+      for( int s=0; s<4; ++s ){ k.push_back( make_state() ); }
+      state_t U = make_state();
+
+      const std::array<real,4> c{ 0, dt/2, dt/2, dt };
+      const std::array<real,4> b{ dt/6, dt/3, dt/3, dt/6 };
+
+      decay( policy, u, k[0] );
+      for( size_t s=1; s<4; ++s )
+     {
+         for( size_t f=0; f<5; ++f )
+        {
+            yam::transform( policy, index_t{}, exts, U[f], [a=c[s]]( const real uf, const real kf ){ return uf+a*kf; }, u[f], k[s-1][f] );
+        }
+         decay( policy, U, k[s] );
+     }
+
+      for( size_t s=0; s<4; ++s )
+     {
+         for( size_t f=0; f<5; ++f )
+        {
+            yam::transform( policy, index_t{}, exts, u[f], [a=b[s]]( const real uf, const real kf ){ return uf+a*kf; }, u[f], k[s][f] );
+        }
+     }
+  }
+
+   template<typename Policy>
+   bool register_runge_kutta()
+  {
+      const std::string policy = bench::policy_name<Policy>();
+      const std::string suffix = "/" + policy + "/3D/dynamic/layout_right";
+
+      const auto m = size_t(5*n*n*n);
+
+      bench::add( "rk4_integrator" + suffix, policy,
+         [=]()
+        {
+            state_t u = make_state();
+
+            yam::array_pool<array_t> pool;
+            yam::rk_integrator<yam::tableau::rk4,array_t,5> rk( pool, array_t::extents_type(n,n,n) );
+
+            const auto rhs = []( const real, const state_t& U, state_t& k ){ decay( Policy{}, U, k ); };
+
+         // rhs 4*2, stage states 3*3, update 6
+            return bench::time_kernel(
+               [&](){ rk.step( Policy{}, index_t{}, yam::dextents<3>(n,n,n), u, real(0), dt, rhs ); },
+               m, 23*m*sizeof(real) );
+        } );
+
+      bench::add( "rk4_chained" + suffix, policy,
+         [=]()
+        {
+            state_t u = make_state();
+
+         // rhs 4*2, stage states 3*3, update 4*3
+            return bench::time_kernel(
+               [&](){ rk4_chained( Policy{}, u ); },
+               m, 29*m*sizeof(real) );
+        } );
+
+      return true;
+  }
+
+   [[maybe_unused]] const bool registered =
+      register_runge_kutta<yam::execution::serial_policy>()
+# ifdef _OPENMP
+   && register_runge_kutta<yam::execution::openmp_policy>()
+# endif
+      ;
+}
@@ -0,0 +1,65 @@
+
+# include <bench.h>
+
+# include <functional>
+
+/*
+ * yam::inclusive_scan over the whole (row-major) range, and along the last axis, over basic_spans of each rank, extents type and layout
+ */
+
+namespace
+{
+   using bench::real;
+   using bench::field;
+
+   [[maybe_unused]] const bool registered =
+      bench::for_each_configuration(
+         []<typename Policy, yam::ndim_t ndim, bool is_static, bench::layout_kind kind>()
+        {
+            using extents_t = bench::extents_for_t<ndim,is_static>;
+            using index_type = yam::index<ndim>;
+
+            const auto name =
+               []( const std::string& kernel )
+              { return bench::make_name<Policy,ndim,is_static>( kernel, kind ); };
+
+            const std::string policy = bench::policy_name<Policy>();
+
+         // cumulative sum over the whole range
+            bench::add( name("inclusive_scan"), policy,
+               []()
+              {
+                  const auto exts = bench::make_extents<ndim,is_static>();
+                  const index_type begin{};
+
+                  field<extents_t,kind> dst(exts), src(exts);
+                  yam::fill( Policy{}, begin, exts, dst.span, real(0) );
+                  yam::fill( Policy{}, begin, exts, src.span, real(1) );
+
+                  const auto n = yam::num_elems(exts);
+                  return bench::time_kernel(
+                     [&](){ yam::inclusive_scan( Policy{}, begin, exts, dst.span, std::plus<real>{}, src.span ); },
+                     n, 2*n*sizeof(real) );
+              } );
+
+         // cumulative sum along the last axis (eg vertical integral)
+            if constexpr( ndim>1 )
+           {
+               bench::add( name("inclusive_scan_axis"), policy,
+                  []()
+                 {
+                     const auto exts = bench::make_extents<ndim,is_static>();
+                     const index_type begin{};
+
+                     field<extents_t,kind> dst(exts), src(exts);
+                     yam::fill( Policy{}, begin, exts, dst.span, real(0) );
+                     yam::fill( Policy{}, begin, exts, src.span, real(1) );
+
+                     const auto n = yam::num_elems(exts);
+                     return bench::time_kernel(
+                        [&](){ yam::inclusive_scan<ndim-1>( Policy{}, begin, exts, dst.span, std::plus<real>{}, src.span ); },
+                        n, 2*n*sizeof(real) );
+                 } );
+           }
+        } );
+}
@@ -0,0 +1,103 @@
+
+# include <bench.h>
+
+# include <array>
+# include <string>
+# include <vector>
+# include <utility>
+
+/*
+ * yam::scatter_add (deposit) and yam::gather (interpolation) between particles and basic_spans of each rank, extents type and layout
+ *    one particle per grid point, with targets spread over the grid by a hash of the particle number
+ *    scatter_add is run in each scatter_mode
+ */
+
+namespace
+{
+   using bench::real;
+   using bench::field;
+
+   const std::array<std::pair<yam::scatter_mode,std::string>,3> modes{{
+      { yam::scatter_mode::privatised,  "privatised"  },
+      { yam::scatter_mode::partitioned, "partitioned" },
+      { yam::scatter_mode::atomic,      "atomic"      } }};
+
+// target cell of each of n particles
+   template<yam::ndim_t ndim,
+            typename Extents>
+   auto particle_cells( const Extents exts )
+  {
+      const size_t n = yam::num_elems(exts);
+
+      std::vector<yam::index<ndim>> cells(n);
+      for( size_t p=0; p<n; ++p )
+     {
+         size_t h = p*2654435761u;
+         for( yam::ndim_t r=ndim; r-->0; )
+        {
+            cells[p][r] = yam::idx_t( h%size_t(exts.extent(r)) );
+            h /= size_t(exts.extent(r));
+        }
+     }
+      return cells;
+  }
+
+   [[maybe_unused]] const bool registered =
+      bench::for_each_configuration(
+         []<typename Policy, yam::ndim_t ndim, bool is_static, bench::layout_kind kind>()
+        {
+            using extents_t = bench::extents_for_t<ndim,is_static>;
+            using index_type = yam::index<ndim>;
+
+            const auto name =
+               []( const std::string& kernel )
+              { return bench::make_name<Policy,ndim,is_static>( kernel, kind ); };
+
+            const std::string policy = bench::policy_name<Policy>();
+
+            for( const auto& [mode,mode_name] : modes )
+           {
+               bench::add( name( "scatter_add_" + mode_name ), policy,
+                  [mode=mode]()
+                 {
+                     const auto exts = bench::make_extents<ndim,is_static>();
+
+                     field<extents_t,kind> dst(exts);
+                     yam::fill( Policy{}, index_type{}, exts, dst.span, real(0) );
+
+                     const auto cells = particle_cells<ndim>( exts );
+                     const std::vector<real> charge( cells.size(), real(1) );
+
+                     const auto cell_of   = [&]( const yam::index1<> p ){ return cells[size_t(p[0])]; };
+                     const auto charge_of = [&]( const yam::index1<> p ){ return charge[size_t(p[0])]; };
+
+                     const yam::dextents<1> particles( static_cast<ptrdiff_t>(cells.size()) );
+
+                     const auto n = cells.size();
+                     return bench::time_kernel(
+                        [&](){ yam::scatter_add( Policy{}, yam::index1<>{}, particles, dst.span, cell_of, charge_of, mode ); },
+                        n, n*(3*sizeof(real)+sizeof(index_type)) );
+                 } );
+           }
+
+            bench::add( name("gather"), policy,
+               []()
+              {
+                  const auto exts = bench::make_extents<ndim,is_static>();
+
+                  field<extents_t,kind> src(exts);
+                  yam::fill( Policy{}, index_type{}, exts, src.span, real(1) );
+
+                  const auto cells = particle_cells<ndim>( exts );
+                  std::vector<real> sampled( cells.size() );
+                  yam::span<real,stx::dynamic_extent> sampled_span( sampled.data(), static_cast<ptrdiff_t>(sampled.size()) );
+
+                  const auto cell_of = [&]( const yam::index1<> p ){ return cells[size_t(p[0])]; };
+
+                  const auto n = cells.size();
+                  return bench::time_kernel(
+                     [&](){ yam::gather( Policy{}, yam::index1<>{}, sampled_span.extents(), sampled_span, src.span, cell_of ); },
+                     n, n*(2*sizeof(real)+sizeof(index_type)) );
+              } );
+        } );
+}
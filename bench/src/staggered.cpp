@@ -0,0 +1,91 @@
+
+# include <bench.h>
+
+# include <array>
+# include <string>
+# include <utility>
+
+/*
+ * staggered grid views over basic_spans of each rank, extents type and layout
+ *    to_dual_interp: primal nodes averaged onto the dual cells between them
+ *    laplacian:      divergence of the gradient as one 3^ndim point stencil over the primal interior
+ */
+
+namespace
+{
+   using bench::real;
+   using bench::field;
+
+// extents of exts with each extent reduced by shrink
+   template<ptrdiff_t... Exts>
+   auto shrink_extents( const stx::extents<Exts...> exts,
+                        const ptrdiff_t           shrink )
+  {
+      return [&]<size_t... Idxs>( std::index_sequence<Idxs...> )
+     {
+         return yam::dextents<sizeof...(Exts)>( (exts.extent(Idxs)-shrink)... );
+     }( std::make_index_sequence<sizeof...(Exts)>() );
+  }
+
+   [[maybe_unused]] const bool registered =
+      bench::for_each_configuration(
+         []<typename Policy, yam::ndim_t ndim, bool is_static, bench::layout_kind kind>()
+        {
+            using extents_t = bench::extents_for_t<ndim,is_static>;
+
+            const auto name =
+               []( const std::string& kernel )
+              { return bench::make_name<Policy,ndim,is_static>( kernel, kind ); };
+
+            const std::string policy = bench::policy_name<Policy>();
+
+            bench::add( name("to_dual_interp"), policy,
+               []()
+              {
+                  const auto exts = bench::make_extents<ndim,is_static>();
+
+                  field<extents_t,kind> src(exts);
+                  field<extents_t,kind,yam::dual> dst(exts);
+                  yam::fill( Policy{}, yam::primal_index<ndim>{}, exts, src.span, real(1) );
+
+                  const auto cells = shrink_extents( exts, 1 );
+                  const auto interp = yam::to_dual_interp( src.span );
+
+                  const auto n = yam::num_elems(cells);
+                  return bench::time_kernel(
+                     [&]()
+                    {
+                        yam::assign( Policy{}, yam::dual_index<ndim>{}, cells, dst.span, interp );
+                    },
+                     n, 2*n*sizeof(real) );
+              } );
+
+            bench::add( name("laplacian"), policy,
+               []()
+              {
+                  const auto exts = bench::make_extents<ndim,is_static>();
+
+                  field<extents_t,kind> src(exts);
+                  field<extents_t,kind> dst(exts);
+                  yam::fill( Policy{}, yam::primal_index<ndim>{}, exts, src.span, real(1) );
+
+                  std::array<real,ndim> inv_dx;
+                  inv_dx.fill( real(1) );
+
+                  const auto laplacian = yam::laplacian( src.span, inv_dx );
+
+               // interior nodes
+                  yam::primal_index<ndim> begin;
+                  begin.idxs.fill(1);
+                  const auto interior = shrink_extents( exts, 2 );
+
+                  const auto n = yam::num_elems(interior);
+                  return bench::time_kernel(
+                     [&]()
+                    {
+                        yam::assign( Policy{}, begin, interior, dst.span, laplacian );
+                    },
+                     n, 2*n*sizeof(real) );
+              } );
+        } );
+}
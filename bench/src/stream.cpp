@@ -0,0 +1,84 @@
+
+# include <bench.h>
+
+# include <memory>
+
+/*
+ * STREAM-style baseline kernels (copy, scale, add, triad) written as raw-pointer loops.
+ *    All other benchmarks report their bandwidth relative to the triad result for the same execution policy.
+ */
+
+namespace
+{
+   using bench::real;
+
+   constexpr size_t n = size_t(bench::n1);
+
+   struct stream_arrays
+  {
+      std::unique_ptr<real[]> a = std::make_unique<real[]>(n);
+      std::unique_ptr<real[]> b = std::make_unique<real[]>(n);
+      std::unique_ptr<real[]> c = std::make_unique<real[]>(n);
+  };
+
+// raw loop over [0,n), with or without openmp worksharing
+   template<typename Policy,
+            typename Body>
+   void raw_loop( Body&& body )
+  {
+      if constexpr( std::same_as<Policy,yam::execution::serial_policy> )
+     {
+         for( size_t i=0; i<n; ++i ){ body(i); }
+     }
+# ifdef _OPENMP
+      else
+     {
+      # pragma omp parallel for
+         for( size_t i=0; i<n; ++i ){ body(i); }
+     }
+# endif
+  }
+
+   template<typename Policy>
+   bool add_stream_benchmarks()
+  {
+      const std::string policy = bench::policy_name<Policy>();
+
+      const auto stream_bench =
+         [policy]( const std::string& kernel, const size_t words, auto body )
+        {
+            bench::add( "stream_"+kernel+"/"+policy, policy,
+               [=]()
+              {
+                  stream_arrays arrs;
+                  real* a = arrs.a.get();
+                  real* b = arrs.b.get();
+                  real* c = arrs.c.get();
+
+               // first touch with the same policy as the kernel
+                  raw_loop<Policy>( [=]( size_t i ){ a[i]=1; b[i]=2; c[i]=0; } );
+
+                  return bench::time_kernel(
+                     [=](){ raw_loop<Policy>( [=]( size_t i ){ body(a,b,c,i); } ); },
+                     n, words*n*sizeof(real) );
+              } );
+        };
+
+      constexpr real scalar = 3;
+
+      stream_bench( "copy",  2, []( real* a, real*,   real* c, size_t i ){ c[i] = a[i]; } );
+      stream_bench( "scale", 2, []( real*,   real* b, real* c, size_t i ){ b[i] = scalar*c[i]; } );
+      stream_bench( "add",   3, []( real* a, real* b, real* c, size_t i ){ c[i] = a[i]+b[i]; } );
+      stream_bench( "triad", 3, []( real* a, real* b, real* c, size_t i ){ a[i] = b[i]+scalar*c[i]; } );
+
+      return true;
+  }
+
+   [[maybe_unused]] const bool registered_seq =
+      add_stream_benchmarks<yam::execution::serial_policy>();
+
+# ifdef _OPENMP
+   [[maybe_unused]] const bool registered_openmp =
+      add_stream_benchmarks<yam::execution::openmp_policy>();
+# endif
+}
@@ -0,0 +1,70 @@
+
+# include <bench.h>
+
+# include <array>
+
+/*
+ * eager yam::transform with 1 to 6 source fields, over basic_spans of each rank, extents type and layout
+ */
+
+namespace
+{
+   using bench::real;
+   using bench::field;
+
+   template<size_t nsrc>
+   bool add_transform_benchmarks()
+  {
+      return bench::for_each_configuration(
+         []<typename Policy, yam::ndim_t ndim, bool is_static, bench::layout_kind kind>()
+        {
+            using extents_t = bench::extents_for_t<ndim,is_static>;
+            using index_type = yam::index<ndim>;
+
+            const auto name =
+               bench::make_name<Policy,ndim,is_static>( "transform"+std::to_string(nsrc), kind );
+
+            bench::add( name, bench::policy_name<Policy>(),
+               []()
+              {
+                  const auto exts = bench::make_extents<ndim,is_static>();
+                  const index_type begin{};
+
+                  field<extents_t,kind> dst(exts);
+                  yam::fill( Policy{}, begin, exts, dst.span, real(0) );
+
+               // nsrc source fields, each filled with 1
+                  auto srcs =
+                     [&]<size_t... Idxs>( std::index_sequence<Idxs...> )
+                    {
+                        return std::array<field<extents_t,kind>,nsrc>{ (void(Idxs),field<extents_t,kind>(exts))... };
+                    }( std::make_index_sequence<nsrc>{} );
+
+                  for( auto& src : srcs ){ yam::fill( Policy{}, begin, exts, src.span, real(1) ); }
+
+               // sum of all sources
+                  const auto kernel =
+                     [&]<size_t... Idxs>( std::index_sequence<Idxs...> )
+                    {
+                        yam::transform( Policy{}, begin, exts,
+                                        dst.span,
+                                        []( auto... xs ){ return (xs+...); },
+                                        srcs[Idxs].span... );
+                    };
+
+                  const auto n = yam::num_elems(exts);
+                  return bench::time_kernel(
+                     [&](){ kernel( std::make_index_sequence<nsrc>{} ); },
+                     n, (nsrc+1)*n*sizeof(real) );
+              } );
+        } );
+  }
+
+   [[maybe_unused]] const bool registered =
+      add_transform_benchmarks<1>()
+   && add_transform_benchmarks<2>()
+   && add_transform_benchmarks<3>()
+   && add_transform_benchmarks<4>()
+   && add_transform_benchmarks<5>()
+   && add_transform_benchmarks<6>();
+}
@@ -7,10 +7,16 @@
 # include "openmp/algorithm.h"
 # endif
 
+# include "tiled/algorithm.h"
+
 # include "views.h"
 # include "concepts.h"
 # include "index.h"
 # include "execution.h"
+# include "instrument.h"
+# include "histogram.h"
+# include "index_set.h"
+# include "scatter.h"
 
 # include "external/mdspan.h"
 
@@ -18,6 +24,7 @@
 # include <functional>
 # include <concepts>
 # include <type_traits>
+# include <vector>
 
 # include <cassert>
 
@@ -44,13 +51,13 @@ namespace yam
             ptrdiff_t... Exts>
       requires same_grid_as<Destination,
                             Source>
-            && std::assignable_from<element_type_of_t<Destination>,
-                                    element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
             && (sizeof...(Exts)==ndim_of_v<Source>)
-   constexpr void assign( const index_type_of_t<Source> begin_index,
-                          const stx::extents<Exts...>          exts,
-                                Destination&&           destination,
-                          const Source&                      source )
+   constexpr void assign( const located_index<index_type_of_t<Source>> begin_index,
+                          const stx::extents<Exts...>                         exts,
+                                Destination&&                          destination,
+                          const Source&                                     source )
   {
       assign( execution::seq,
               begin_index, exts,
@@ -67,15 +74,15 @@ namespace yam
    template<indexable Destination,
             indexable Source,
             ptrdiff_t... Exts>
-   constexpr void assign( const execution_policy auto        policy,
-                          const index_type_of_t<Source> begin_index,
-                          const stx::extents<Exts...>          exts,
-                                Destination&&           destination,
-                          const Source&                      source )
+   constexpr void assign( const execution_policy auto                       policy,
+                          const located_index<index_type_of_t<Source>> begin_index,
+                          const stx::extents<Exts...>                         exts,
+                                Destination&&                          destination,
+                          const Source&                                     source )
       requires same_grid_as<Destination,
                             Source>
-            && std::assignable_from<element_type_of_t<Destination>,
-                                    element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
             && (std::is_rvalue_reference_v<decltype(std::forward<Destination>(destination))>)
             && (sizeof...(Exts)==ndim_of_v<Source>)
   {
@@ -105,19 +112,24 @@ namespace yam
             ptrdiff_t...     Exts,
             typename    ValueType>
       requires (sizeof...(Exts)==ndim_of_v<Destination>)
-            && std::assignable_from<element_type_of_t<Destination>,
-                                    ValueType>
-   constexpr void fill( const execution_policy auto             policy,
-                        const index_type_of_t<Destination> begin_index,
-                        const stx::extents<Exts...>            extents,
-                              Destination&&                destination,
-                        const ValueType&                         value )
+            && assignable_element<element_type_of_t<Destination>,
+                                  ValueType>
+   constexpr void fill( const execution_policy auto                            policy,
+                        const located_index<index_type_of_t<Destination>> begin_index,
+                        const stx::extents<Exts...>                           extents,
+                              Destination&&                               destination,
+                        const ValueType&                                        value )
   {
       if( std::is_constant_evaluated() )
      {
          assert( is_constexpr_policy_v<decltype(policy)> );
      }
 
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "fill", policy,
+                                            begin_index, extents,
+                                            instrument::bytes_per_elem<Destination>() );
+
       using index_type = index_type_of_t<Destination>;
 
       assign( policy,
@@ -132,12 +144,12 @@ namespace yam
             ptrdiff_t...     Exts,
             typename    ValueType>
       requires (sizeof...(Exts)==ndim_of_v<Destination>)
-            && std::assignable_from<element_type_of_t<Destination>,
-                                    ValueType>
-   constexpr void fill( const index_type_of_t<Destination> begin_index,
-                        const stx::extents<Exts...>            extents,
-                              Destination&&                destination,
-                              ValueType&&                        value )
+            && assignable_element<element_type_of_t<Destination>,
+                                  ValueType>
+   constexpr void fill( const located_index<index_type_of_t<Destination>> begin_index,
+                        const stx::extents<Exts...>                           extents,
+                              Destination&&                               destination,
+                              ValueType&&                                       value )
   {
       fill( execution::seq,
             begin_index, extents,
@@ -160,19 +172,24 @@ namespace yam
             typename    Generator>
       requires (sizeof...(Exts)==ndim_of_v<Destination>)
             && std::invocable<Generator>
-            && std::assignable_from<element_type_of_t<Destination>,
-                                    std::invoke_result_t<Generator>>
-   constexpr void generate( const execution_policy auto             policy,
-                            const index_type_of_t<Destination> begin_index,
-                            const stx::extents<Exts...>            extents,
-                                  Destination&&                destination,
-                                  Generator                      generator )
+            && assignable_element<element_type_of_t<Destination>,
+                                  std::invoke_result_t<Generator>>
+   constexpr void generate( const execution_policy auto                            policy,
+                            const located_index<index_type_of_t<Destination>> begin_index,
+                            const stx::extents<Exts...>                           extents,
+                                  Destination&&                               destination,
+                                  Generator                                     generator )
   {
       if( std::is_constant_evaluated() )
      {
          assert( is_constexpr_policy_v<decltype(policy)> );
      }
 
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "generate", policy,
+                                            begin_index, extents,
+                                            instrument::bytes_per_elem<Destination>() );
+
       using index_type = index_type_of_t<Destination>;
 
       assign( policy,
@@ -188,12 +205,12 @@ namespace yam
             typename    Generator>
       requires (sizeof...(Exts)==ndim_of_v<Destination>)
             && std::invocable<Generator>
-            && std::assignable_from<element_type_of_t<Destination>,
-                                    std::invoke_result_t<Generator>>
-   constexpr void generate( const index_type_of_t<Destination> begin_index,
-                            const stx::extents<Exts...>            extents,
-                                  Destination&&                destination,
-                                  Generator&&                    generator )
+            && assignable_element<element_type_of_t<Destination>,
+                                  std::invoke_result_t<Generator>>
+   constexpr void generate( const located_index<index_type_of_t<Destination>> begin_index,
+                            const stx::extents<Exts...>                           extents,
+                                  Destination&&                               destination,
+                                  Generator&&                                   generator )
   {
       generate( execution::seq,
                 begin_index, extents,
@@ -263,18 +280,23 @@ namespace yam
                                 element_type_of_t<Destination>,
                                 element_type_of_t<Sources>...>
             && (sizeof...(Exts)==ndim_of_v<Destination>)
-   constexpr void transform( const execution_policy auto             policy,
-                             const index_type_of_t<Destination> begin_index,
-                             const stx::extents<Exts...>               exts,
-                                   Destination&&                destination,
-                                   TransformFunc&&           transform_func,
-                             const Sources&...                      sources )
+   constexpr void transform( const execution_policy auto                            policy,
+                             const located_index<index_type_of_t<Destination>> begin_index,
+                             const stx::extents<Exts...>                              exts,
+                                   Destination&&                               destination,
+                                   TransformFunc&&                          transform_func,
+                             const Sources&...                                     sources )
   {
       if( std::is_constant_evaluated() )
      {
          assert( is_constexpr_policy_v<decltype(policy)> );
      }
 
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "transform", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Destination,Sources...>() );
+
    // need to create a view (window) of each source to avoid copying entire array into lazy transform adaptor
       assign( policy,
               begin_index, exts,
@@ -298,11 +320,11 @@ namespace yam
                                 element_type_of_t<Destination>,
                                 element_type_of_t<Sources>...>
             && (sizeof...(Exts)==ndim_of_v<Destination>)
-   constexpr void transform( const index_type_of_t<Destination> begin_index,
-                             const stx::extents<Exts...>               exts,
-                                   Destination&&                destination,
-                                   TransformFunc&&           transform_func,
-                                   Sources&&...                     sources )
+   constexpr void transform( const located_index<index_type_of_t<Destination>> begin_index,
+                             const stx::extents<Exts...>                              exts,
+                                   Destination&&                               destination,
+                                   TransformFunc&&                          transform_func,
+                                   Sources&&...                                    sources )
   {
       transform( execution::seq,
                  begin_index, exts,
@@ -313,6 +335,400 @@ namespace yam
       return;
   }
 
+/*
+ * ===============================================================
+ *
+ * yam::assign_if / yam::transform_where
+ *    assign (or transform) only at the indices in range [begin_index,begin_index+extents) at which mask is true
+ *    the source is evaluated at every index and selected against the current destination value, so the loop has no branch and can be vectorised:
+ *       the source must be valid over the whole range, and the destination elements must be readable lvalues
+ *
+ * yam::compact
+ *    list of the indices in range [begin_index,begin_index+extents) at which mask is true, in row-major order
+ *    evaluating a sparse mask once and passing the list to assign/transform for each later kernel evaluates the source only at the active indices
+ *
+ * ===============================================================
+ */
+
+   template<typename Mask,
+            typename    A>
+   concept mask_for = indexable<Mask>
+                   && same_grid_as<Mask,A>
+                   && (ndim_of_v<Mask> == ndim_of_v<A>)
+                   && std::convertible_to<element_type_of_t<Mask>,bool>;
+
+   template<indexable Destination,
+            typename         Mask,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && mask_for<Mask,Destination>
+            && std::is_lvalue_reference_v<element_type_of_t<Destination>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Destination>)
+   constexpr void assign_if( const execution_policy auto                            policy,
+                             const located_index<index_type_of_t<Destination>> begin_index,
+                             const stx::extents<Exts...>                              exts,
+                                   Destination&&                               destination,
+                             const Mask&                                              mask,
+                             const Source&                                          source )
+  {
+      if( std::is_constant_evaluated() )
+     {
+         assert( is_constexpr_policy_v<decltype(policy)> );
+     }
+
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "assign_if", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Destination,Destination,Mask,Source>() );
+
+      using index_type = index_type_of_t<Destination>;
+      using value_type = std::remove_cvref_t<element_type_of_t<Destination>>;
+
+      assign( policy,
+              begin_index, exts,
+              std::forward<Destination>(destination),
+              [ &destination, &mask, &source ]( const index_type idx ) -> value_type
+             {
+                 const value_type current = destination(idx);
+                 const value_type selected = source(idx);
+                 return mask(idx) ? selected : current;
+             } );
+      return;
+  }
+
+// if no policy is given, use serial
+   template<indexable Destination,
+            typename         Mask,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && mask_for<Mask,Destination>
+            && std::is_lvalue_reference_v<element_type_of_t<Destination>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Destination>)
+   constexpr void assign_if( const located_index<index_type_of_t<Destination>> begin_index,
+                             const stx::extents<Exts...>                              exts,
+                                   Destination&&                               destination,
+                             const Mask&                                              mask,
+                             const Source&                                          source )
+  {
+      assign_if( execution::seq,
+                 begin_index, exts,
+                 std::forward<Destination>(destination),
+                 mask, source );
+      return;
+  }
+
+   template<typename    TransformFunc,
+            indexable     Destination,
+            typename             Mask,
+            indexable...      Sources,
+            ptrdiff_t...         Exts>
+      requires same_grid_as<Destination,
+                            Sources...>
+            && mask_for<Mask,Destination>
+            && std::is_lvalue_reference_v<element_type_of_t<Destination>>
+            && transformation_r<TransformFunc,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Sources>...>
+            && (sizeof...(Exts)==ndim_of_v<Destination>)
+   constexpr void transform_where( const execution_policy auto                            policy,
+                                   const located_index<index_type_of_t<Destination>> begin_index,
+                                   const stx::extents<Exts...>                              exts,
+                                         Destination&&                               destination,
+                                   const Mask&                                              mask,
+                                         TransformFunc&&                          transform_func,
+                                   const Sources&...                                     sources )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "transform_where", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Destination,Destination,Mask,Sources...>() );
+
+      assign_if( policy,
+                 begin_index, exts,
+                 std::forward<Destination>(destination),
+                 mask,
+                 transform( std::forward<TransformFunc>(transform_func),
+                            window(sources)... ) );
+      return;
+  }
+
+// if no policy is given, use serial
+   template<typename    TransformFunc,
+            indexable     Destination,
+            typename             Mask,
+            indexable...      Sources,
+            ptrdiff_t...         Exts>
+      requires same_grid_as<Destination,
+                            Sources...>
+            && mask_for<Mask,Destination>
+            && std::is_lvalue_reference_v<element_type_of_t<Destination>>
+            && transformation_r<TransformFunc,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Sources>...>
+            && (sizeof...(Exts)==ndim_of_v<Destination>)
+   constexpr void transform_where( const located_index<index_type_of_t<Destination>> begin_index,
+                                   const stx::extents<Exts...>                              exts,
+                                         Destination&&                               destination,
+                                   const Mask&                                              mask,
+                                         TransformFunc&&                          transform_func,
+                                   const Sources&...                                     sources )
+  {
+      transform_where( execution::seq,
+                       begin_index, exts,
+                       std::forward<Destination>(destination),
+                       mask,
+                       std::forward<TransformFunc>(transform_func),
+                       sources... );
+      return;
+  }
+
+   template<indexable     Mask,
+            ptrdiff_t...  Exts>
+      requires std::convertible_to<element_type_of_t<Mask>,bool>
+            && (sizeof...(Exts)==ndim_of_v<Mask>)
+   [[nodiscard]]
+   std::vector<index_type_of_t<Mask>> compact( const execution_policy auto                     policy,
+                                               const located_index<index_type_of_t<Mask>> begin_index,
+                                               const stx::extents<Exts...>                       exts,
+                                               const Mask&                                       mask )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "compact", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Mask>() );
+
+      std::vector<index_type_of_t<Mask>> indices;
+      detail::compact_mask( policy, index_type_of_t<Mask>{begin_index}, exts, mask, indices );
+      return indices;
+  }
+
+// if no policy is given, use serial
+   template<indexable     Mask,
+            ptrdiff_t...  Exts>
+      requires std::convertible_to<element_type_of_t<Mask>,bool>
+            && (sizeof...(Exts)==ndim_of_v<Mask>)
+   [[nodiscard]]
+   std::vector<index_type_of_t<Mask>> compact( const located_index<index_type_of_t<Mask>> begin_index,
+                                               const stx::extents<Exts...>                       exts,
+                                               const Mask&                                       mask )
+  {
+      return compact( execution::seq, begin_index, exts, mask );
+  }
+
+/*
+ * reference to the index list or index_set of an algorithm, together with the call site for instrumentation
+ *    implicitly constructed from the list, recording the call site as located_index does
+ *    algorithms ending in a pack of sources cannot take a trailing defaulted located_index, so they take their indices through this instead
+ */
+   template<typename Indices,
+            grid_t      grid>
+   struct located_indices
+  {
+      const Indices&                    indices;
+      located_index<index<1,grid>> location;
+
+      constexpr located_indices( const Indices&                     list,
+                                 const located_index<index<1,grid>>  loc = {} )
+         : indices(list), location(loc)
+     { }
+  };
+
+/*
+ * assign / transform at each index of a list, eg from yam::compact
+ *    the list has no begin index to record the call site for instrumentation,
+ *    so assign takes a defaulted located_index as its last argument instead, and transform takes the list as located_indices
+ */
+   template<indexable Destination,
+            indexable      Source>
+      requires same_grid_as<Destination,
+                            Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+   constexpr void assign( const std::vector<index_type_of_t<Source>>&           indices,
+                                Destination&&                                destination,
+                          const Source&                                          source,
+                          const located_index<index<1,grid_of_v<Source>>>     location = {} )
+  {
+      assign( execution::seq,
+              indices,
+              std::forward<Destination>(destination),
+              source,
+              location );
+      return;
+  }
+
+// rvalue destination, as for the index range overload
+   template<indexable Destination,
+            indexable      Source>
+   constexpr void assign( const execution_policy auto                          policy,
+                          const std::vector<index_type_of_t<Source>>&           indices,
+                                Destination&&                                destination,
+                          const Source&                                          source,
+                          const located_index<index<1,grid_of_v<Source>>>     location = {} )
+      requires same_grid_as<Destination,
+                            Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+            && (std::is_rvalue_reference_v<decltype(std::forward<Destination>(destination))>)
+  {
+      assign( policy, indices, destination, source, location );
+      return;
+  }
+
+   template<typename    TransformFunc,
+            indexable     Destination,
+            indexable...      Sources>
+      requires same_grid_as<Destination,
+                            Sources...>
+            && transformation_r<TransformFunc,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Sources>...>
+   constexpr void transform( const execution_policy auto                                                                      policy,
+                             const located_indices<std::vector<index_type_of_t<Destination>>,grid_of_v<Destination>>         indices,
+                                   Destination&&                                                                         destination,
+                                   TransformFunc&&                                                                    transform_func,
+                             const Sources&...                                                                               sources )
+  {
+      assign( policy,
+              indices.indices,
+              std::forward<Destination>(destination),
+              transform( std::forward<TransformFunc>(transform_func),
+                         window(sources)... ),
+              indices.location );
+      return;
+  }
+
+   template<typename    TransformFunc,
+            indexable     Destination,
+            indexable...      Sources>
+      requires same_grid_as<Destination,
+                            Sources...>
+            && transformation_r<TransformFunc,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Sources>...>
+   constexpr void transform( const located_indices<std::vector<index_type_of_t<Destination>>,grid_of_v<Destination>>         indices,
+                                   Destination&&                                                                         destination,
+                                   TransformFunc&&                                                                    transform_func,
+                             const Sources&...                                                                               sources )
+  {
+      transform( execution::seq,
+                 indices,
+                 std::forward<Destination>(destination),
+                 std::forward<TransformFunc>(transform_func),
+                 sources... );
+      return;
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::assign / yam::transform / yam::reduce over an index_set
+ *    see index_set.h
+ *
+ * ===============================================================
+ */
+
+   template<indexable Destination,
+            indexable      Source>
+      requires same_grid_as<Destination,
+                            Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+   void assign( const index_set<ndim_of_v<Source>,grid_of_v<Source>>&      set,
+                      Destination&&                                destination,
+                const Source&                                           source,
+                const located_index<index<1,grid_of_v<Source>>>      location = {} )
+  {
+      assign( execution::seq,
+              set,
+              std::forward<Destination>(destination),
+              source,
+              location );
+  }
+
+// rvalue destination, as for the index range overload
+   template<indexable Destination,
+            indexable      Source>
+   void assign( const execution_policy auto                                 policy,
+                const index_set<ndim_of_v<Source>,grid_of_v<Source>>&      set,
+                      Destination&&                                destination,
+                const Source&                                           source,
+                const located_index<index<1,grid_of_v<Source>>>      location = {} )
+      requires same_grid_as<Destination,
+                            Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+            && (std::is_rvalue_reference_v<decltype(std::forward<Destination>(destination))>)
+  {
+      assign( policy, set, destination, source, location );
+  }
+
+   template<typename    TransformFunc,
+            indexable     Destination,
+            indexable...      Sources>
+      requires same_grid_as<Destination,
+                            Sources...>
+            && transformation_r<TransformFunc,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Sources>...>
+   void transform( const execution_policy auto                                                                                     policy,
+                   const located_indices<index_set<ndim_of_v<Destination>,grid_of_v<Destination>>,grid_of_v<Destination>>           set,
+                         Destination&&                                                                                       destination,
+                         TransformFunc&&                                                                                  transform_func,
+                   const Sources&...                                                                                             sources )
+  {
+      assign( policy,
+              set.indices,
+              std::forward<Destination>(destination),
+              transform( std::forward<TransformFunc>(transform_func),
+                         window(sources)... ),
+              set.location );
+  }
+
+   template<typename    TransformFunc,
+            indexable     Destination,
+            indexable...      Sources>
+      requires same_grid_as<Destination,
+                            Sources...>
+            && transformation_r<TransformFunc,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Sources>...>
+   void transform( const located_indices<index_set<ndim_of_v<Destination>,grid_of_v<Destination>>,grid_of_v<Destination>>           set,
+                         Destination&&                                                                                       destination,
+                         TransformFunc&&                                                                                  transform_func,
+                   const Sources&...                                                                                             sources )
+  {
+      transform( execution::seq,
+                 set,
+                 std::forward<Destination>(destination),
+                 std::forward<TransformFunc>(transform_func),
+                 sources... );
+  }
+
+   template<typename ReduceFunc,
+            typename ReduceType,
+            indexable    Source>
+      requires reduction<ReduceFunc,
+                         ReduceType,
+                         element_type_of_t<Source>>
+   [[nodiscard]]
+   ReduceType reduce( const index_set<ndim_of_v<Source>,grid_of_v<Source>>&      set,
+                            ReduceFunc                                   reduce_func,
+                            ReduceType                                          init,
+                      const Source&                                           source,
+                      const located_index<index<1,grid_of_v<Source>>>      location = {} )
+  {
+      return reduce( execution::seq, set, std::move(reduce_func), std::move(init), source, location );
+  }
+
 /*
  * ===============================================================
  *
@@ -336,11 +752,11 @@ namespace yam
                          element_type_of_t<Source>>
             && (sizeof...(Exts)==ndim_of_v<Source>)
    [[nodiscard]]
-   constexpr ReduceType reduce( const index_type_of_t<Source> begin_index,
-                                const stx::extents<Exts...>          exts,
-                                      ReduceFunc&&            reduce_func,
-                                      ReduceType&&                   init,
-                                      Source&&                     source )
+   constexpr ReduceType reduce( const located_index<index_type_of_t<Source>> begin_index,
+                                const stx::extents<Exts...>                         exts,
+                                      ReduceFunc&&                           reduce_func,
+                                      ReduceType&&                                  init,
+                                      Source&&                                    source )
   {
       return reduce( execution::seq,
                      begin_index, exts,
@@ -350,6 +766,113 @@ namespace yam
                      std::forward<Source>(source) );
   }
 
+/*
+ * ===============================================================
+ *
+ * yam::accumulate
+ *    see serial/algorithm.h
+ *    the in-place counterpart of reduce: accumulate_func(acc,element) updates acc, and combine_func(acc,partial) merges
+ *       the partial results of parallel execution, so neither the accumulator nor the functions are copied per element
+ *
+ * ===============================================================
+ */
+
+   template<typename AccumulateFunc,
+            typename    CombineFunc,
+            typename AccumulateType,
+            indexable        Source,
+            ptrdiff_t...       Exts>
+      requires accumulation<AccumulateFunc,
+                            AccumulateType,
+                            element_type_of_t<Source>>
+            && combination<CombineFunc,
+                           AccumulateType>
+            && std::copy_constructible<AccumulateType>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   constexpr AccumulateType accumulate( const execution_policy auto                       policy,
+                                        const located_index<index_type_of_t<Source>> begin_index,
+                                        const stx::extents<Exts...>                         exts,
+                                              AccumulateFunc                     accumulate_func,
+                                              CombineFunc                           combine_func,
+                                        const AccumulateType&                         identity_v,
+                                              AccumulateType                                init,
+                                        const Source&                                     source )
+  {
+      if( std::is_constant_evaluated() )
+     {
+         assert( is_constexpr_policy_v<decltype(policy)> );
+     }
+
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "accumulate", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source>() );
+
+      detail::accumulate_in_place( policy, begin_index, exts,
+                                   accumulate_func, combine_func,
+                                   identity_v, init,
+                                   source );
+
+      return init;
+  }
+
+/*
+ * serial accumulation does not need an identity value or combine function
+ */
+   template<typename AccumulateFunc,
+            typename AccumulateType,
+            indexable        Source,
+            ptrdiff_t...       Exts>
+      requires accumulation<AccumulateFunc,
+                            AccumulateType,
+                            element_type_of_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   constexpr AccumulateType accumulate(       execution::serial_policy               policy,
+                                        const located_index<index_type_of_t<Source>> begin_index,
+                                        const stx::extents<Exts...>                         exts,
+                                              AccumulateFunc                     accumulate_func,
+                                              AccumulateType                                init,
+                                        const Source&                                     source )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "accumulate", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source>() );
+
+      detail::accumulate_in_place( policy, begin_index, exts,
+                                   accumulate_func, init,
+                                   source );
+
+      return init;
+  }
+
+/*
+ * Convenience overload assumes serial evaluation
+ */
+   template<typename AccumulateFunc,
+            typename AccumulateType,
+            indexable        Source,
+            ptrdiff_t...       Exts>
+      requires accumulation<AccumulateFunc,
+                            AccumulateType,
+                            element_type_of_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   constexpr AccumulateType accumulate( const located_index<index_type_of_t<Source>> begin_index,
+                                        const stx::extents<Exts...>                         exts,
+                                              AccumulateFunc                     accumulate_func,
+                                              AccumulateType                                init,
+                                        const Source&                                     source )
+  {
+      return accumulate( execution::seq,
+                         begin_index, exts,
+                         std::move(accumulate_func),
+                         std::move(init),
+                         source );
+  }
+
 /*
  * ===============================================================
  *
@@ -374,20 +897,25 @@ namespace yam
                                         element_type_of_t<Sources>...>
             && (sizeof...(Exts)==ndim_of_v<Source0>)
    [[nodiscard]]
-   constexpr ReduceType transform_reduce( const execution_policy auto         policy,
-                                          const index_type_of_t<Source0> begin_index,
-                                          const stx::extents<Exts...>           exts,
-                                                TransformFunc&&       transform_func,
-                                                ReduceFunc&&             reduce_func,
-                                                ReduceType&&                    init,
-                                          const Source0&                     source0,
-                                          const Sources&...                  sources )
+   constexpr ReduceType transform_reduce( const execution_policy auto                        policy,
+                                          const located_index<index_type_of_t<Source0>> begin_index,
+                                          const stx::extents<Exts...>                          exts,
+                                                TransformFunc&&                      transform_func,
+                                                ReduceFunc&&                            reduce_func,
+                                                ReduceType&&                                   init,
+                                          const Source0&                                    source0,
+                                          const Sources&...                                 sources )
   {
       if( std::is_constant_evaluated() )
      {
          assert( is_constexpr_policy_v<decltype(policy)> );
      }
 
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "transform_reduce", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source0,Sources...>() );
+
       return reduce( policy,
                      begin_index, exts,
                      std::forward<ReduceFunc>(reduce_func),
@@ -415,13 +943,13 @@ namespace yam
                                         element_type_of_t<Sources>...>
             && (sizeof...(Exts)==ndim_of_v<Source0>)
    [[nodiscard]]
-   constexpr ReduceType transform_reduce( const index_type_of_t<Source0> begin_index,
-                                          const stx::extents<Exts...>           exts,
-                                                TransformFunc&&       transform_func,
-                                                ReduceFunc&&             reduce_func,
-                                                ReduceType&&                    init,
-                                                Source0&&                    source0,
-                                                Sources&&...                 sources )
+   constexpr ReduceType transform_reduce( const located_index<index_type_of_t<Source0>> begin_index,
+                                          const stx::extents<Exts...>                          exts,
+                                                TransformFunc&&                      transform_func,
+                                                ReduceFunc&&                            reduce_func,
+                                                ReduceType&&                                   init,
+                                                Source0&&                                   source0,
+                                                Sources&&...                                sources )
   {
       return transform_reduce( execution::seq,
                                begin_index, exts,
@@ -431,4 +959,814 @@ namespace yam
                                std::forward<Source0>(source0),
                                std::forward<Sources>(sources)... );
   }
+
+/*
+ * ===============================================================
+ *
+ * yam::inclusive_scan / yam::exclusive_scan
+ *    see serial/algorithm.h for the definition of each scan
+ *    serial scans sweep the range once
+ *    OpenMP whole-range scans use a two-pass blocked algorithm: each thread reduces a contiguous block of the (row-major) range,
+ *       the block results are scanned serially, then each thread scans its block again starting from the result of the preceding blocks
+ *    OpenMP per-axis scans distribute independent lines over the threads
+ *
+ * ===============================================================
+ */
+
+/*
+ * whole-range scans
+ */
+   template<indexable Destination,
+            typename     ScanFunc,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && reduction<ScanFunc,
+                         detail::scan_type_of_t<Source>,
+                         element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  const detail::scan_type_of_t<Source>&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   constexpr void inclusive_scan( const execution_policy auto                       policy,
+                                  const located_index<index_type_of_t<Source>> begin_index,
+                                  const stx::extents<Exts...>                         exts,
+                                        Destination&                           destination,
+                                        ScanFunc                                 scan_func,
+                                  const Source&                                     source )
+  {
+      detail::scan<true>( policy, begin_index, exts,
+                          destination, scan_func,
+                          std::optional<detail::scan_type_of_t<Source>>{},
+                          source );
+  }
+
+   template<indexable Destination,
+            typename     ScanFunc,
+            typename     ScanType,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && reduction<ScanFunc,
+                         ScanType,
+                         element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  const ScanType&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   constexpr void inclusive_scan( const execution_policy auto                       policy,
+                                  const located_index<index_type_of_t<Source>> begin_index,
+                                  const stx::extents<Exts...>                         exts,
+                                        Destination&                           destination,
+                                        ScanFunc                                 scan_func,
+                                        ScanType                                      init,
+                                  const Source&                                     source )
+  {
+      detail::scan<true>( policy, begin_index, exts,
+                          destination, scan_func,
+                          std::optional<ScanType>{std::move(init)},
+                          source );
+  }
+
+   template<indexable Destination,
+            typename     ScanFunc,
+            typename     ScanType,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && reduction<ScanFunc,
+                         ScanType,
+                         element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  ScanType&&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   constexpr void exclusive_scan( const execution_policy auto                       policy,
+                                  const located_index<index_type_of_t<Source>> begin_index,
+                                  const stx::extents<Exts...>                         exts,
+                                        Destination&                           destination,
+                                        ScanFunc                                 scan_func,
+                                        ScanType                                      init,
+                                  const Source&                                     source )
+  {
+      detail::scan<false>( policy, begin_index, exts,
+                           destination, scan_func,
+                           std::optional<ScanType>{std::move(init)},
+                           source );
+  }
+
+/*
+ * per-axis scans
+ */
+   template<ndim_t           Axis,
+            indexable Destination,
+            typename     ScanFunc,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && reduction<ScanFunc,
+                         detail::scan_type_of_t<Source>,
+                         element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  const detail::scan_type_of_t<Source>&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+            && (Axis<sizeof...(Exts))
+   constexpr void inclusive_scan( const execution_policy auto                       policy,
+                                  const located_index<index_type_of_t<Source>> begin_index,
+                                  const stx::extents<Exts...>                         exts,
+                                        Destination&                           destination,
+                                        ScanFunc                                 scan_func,
+                                  const Source&                                     source )
+  {
+      detail::scan_axis<Axis,true>( policy, begin_index, exts,
+                                    destination, scan_func,
+                                    std::optional<detail::scan_type_of_t<Source>>{},
+                                    source );
+  }
+
+   template<ndim_t           Axis,
+            indexable Destination,
+            typename     ScanFunc,
+            typename     ScanType,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && reduction<ScanFunc,
+                         ScanType,
+                         element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  const ScanType&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+            && (Axis<sizeof...(Exts))
+   constexpr void inclusive_scan( const execution_policy auto                       policy,
+                                  const located_index<index_type_of_t<Source>> begin_index,
+                                  const stx::extents<Exts...>                         exts,
+                                        Destination&                           destination,
+                                        ScanFunc                                 scan_func,
+                                        ScanType                                      init,
+                                  const Source&                                     source )
+  {
+      detail::scan_axis<Axis,true>( policy, begin_index, exts,
+                                    destination, scan_func,
+                                    std::optional<ScanType>{std::move(init)},
+                                    source );
+  }
+
+   template<ndim_t           Axis,
+            indexable Destination,
+            typename     ScanFunc,
+            typename     ScanType,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && reduction<ScanFunc,
+                         ScanType,
+                         element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  ScanType&&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+            && (Axis<sizeof...(Exts))
+   constexpr void exclusive_scan( const execution_policy auto                       policy,
+                                  const located_index<index_type_of_t<Source>> begin_index,
+                                  const stx::extents<Exts...>                         exts,
+                                        Destination&                           destination,
+                                        ScanFunc                                 scan_func,
+                                        ScanType                                      init,
+                                  const Source&                                     source )
+  {
+      detail::scan_axis<Axis,false>( policy, begin_index, exts,
+                                     destination, scan_func,
+                                     std::optional<ScanType>{std::move(init)},
+                                     source );
+  }
+
+/*
+ * Convenience overloads -----------------------------------------
+ */
+
+/*
+ * if no execution policy is specified, use serial
+ */
+   template<indexable Destination,
+            typename     ScanFunc,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && reduction<ScanFunc,
+                         detail::scan_type_of_t<Source>,
+                         element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  const detail::scan_type_of_t<Source>&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   constexpr void inclusive_scan( const located_index<index_type_of_t<Source>> begin_index,
+                                  const stx::extents<Exts...>                         exts,
+                                        Destination&                           destination,
+                                        ScanFunc                                 scan_func,
+                                  const Source&                                     source )
+  {
+      inclusive_scan( execution::seq,
+                      begin_index, exts,
+                      destination,
+                      std::move(scan_func),
+                      source );
+  }
+
+   template<indexable Destination,
+            typename     ScanFunc,
+            typename     ScanType,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && reduction<ScanFunc,
+                         ScanType,
+                         element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  const ScanType&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   constexpr void inclusive_scan( const located_index<index_type_of_t<Source>> begin_index,
+                                  const stx::extents<Exts...>                         exts,
+                                        Destination&                           destination,
+                                        ScanFunc                                 scan_func,
+                                        ScanType                                      init,
+                                  const Source&                                     source )
+  {
+      inclusive_scan( execution::seq,
+                      begin_index, exts,
+                      destination,
+                      std::move(scan_func),
+                      std::move(init),
+                      source );
+  }
+
+   template<indexable Destination,
+            typename     ScanFunc,
+            typename     ScanType,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && reduction<ScanFunc,
+                         ScanType,
+                         element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  ScanType&&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   constexpr void exclusive_scan( const located_index<index_type_of_t<Source>> begin_index,
+                                  const stx::extents<Exts...>                         exts,
+                                        Destination&                           destination,
+                                        ScanFunc                                 scan_func,
+                                        ScanType                                      init,
+                                  const Source&                                     source )
+  {
+      exclusive_scan( execution::seq,
+                      begin_index, exts,
+                      destination,
+                      std::move(scan_func),
+                      std::move(init),
+                      source );
+  }
+
+   template<ndim_t           Axis,
+            indexable Destination,
+            typename     ScanFunc,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && reduction<ScanFunc,
+                         detail::scan_type_of_t<Source>,
+                         element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  const detail::scan_type_of_t<Source>&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+            && (Axis<sizeof...(Exts))
+   constexpr void inclusive_scan( const located_index<index_type_of_t<Source>> begin_index,
+                                  const stx::extents<Exts...>                         exts,
+                                        Destination&                           destination,
+                                        ScanFunc                                 scan_func,
+                                  const Source&                                     source )
+  {
+      inclusive_scan<Axis>( execution::seq,
+                            begin_index, exts,
+                            destination,
+                            std::move(scan_func),
+                            source );
+  }
+
+   template<ndim_t           Axis,
+            indexable Destination,
+            typename     ScanFunc,
+            typename     ScanType,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && reduction<ScanFunc,
+                         ScanType,
+                         element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  const ScanType&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+            && (Axis<sizeof...(Exts))
+   constexpr void inclusive_scan( const located_index<index_type_of_t<Source>> begin_index,
+                                  const stx::extents<Exts...>                         exts,
+                                        Destination&                           destination,
+                                        ScanFunc                                 scan_func,
+                                        ScanType                                      init,
+                                  const Source&                                     source )
+  {
+      inclusive_scan<Axis>( execution::seq,
+                            begin_index, exts,
+                            destination,
+                            std::move(scan_func),
+                            std::move(init),
+                            source );
+  }
+
+   template<ndim_t           Axis,
+            indexable Destination,
+            typename     ScanFunc,
+            typename     ScanType,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && reduction<ScanFunc,
+                         ScanType,
+                         element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  ScanType&&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+            && (Axis<sizeof...(Exts))
+   constexpr void exclusive_scan( const located_index<index_type_of_t<Source>> begin_index,
+                                  const stx::extents<Exts...>                         exts,
+                                        Destination&                           destination,
+                                        ScanFunc                                 scan_func,
+                                        ScanType                                      init,
+                                  const Source&                                     source )
+  {
+      exclusive_scan<Axis>( execution::seq,
+                            begin_index, exts,
+                            destination,
+                            std::move(scan_func),
+                            std::move(init),
+                            source );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::reduce_axis
+ *    see serial/algorithm.h
+ *
+ * ===============================================================
+ */
+
+/*
+ * if no execution policy is specified, use serial
+ */
+   template<ndim_t...           Axes,
+            indexable    Destination,
+            typename      ReduceFunc,
+            typename      ReduceType,
+            indexable         Source,
+            ptrdiff_t...        Exts>
+      requires (grid_of_v<Destination> == grid_of_v<Source>)
+            && reduction<ReduceFunc,
+                         ReduceType,
+                         element_type_of_t<Source>>
+            && transformation_r<ReduceFunc,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  ReduceType&&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+            && (sizeof...(Axes)>0)
+            && (ndim_of_v<Destination>+sizeof...(Axes)==ndim_of_v<Source>)
+            && (detail::valid_axes<ndim_of_v<Source>,Axes...>())
+   constexpr void reduce_axis( const located_index<index_type_of_t<Source>> begin_index,
+                               const stx::extents<Exts...>                         exts,
+                                     Destination&                           destination,
+                                     ReduceFunc                             reduce_func,
+                                     ReduceType                                    init,
+                               const Source&                                     source )
+  {
+      reduce_axis<Axes...>( execution::seq,
+                            begin_index, exts,
+                            destination,
+                            std::move(reduce_func),
+                            std::move(init),
+                            source );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::argmin / yam::argmax / yam::top_k
+ *    see serial/algorithm.h
+ *    argmin/argmax return the index and value of the first (in row-major order) smallest/largest element of a non-empty range
+ *    top_k returns the (at most) k best elements according to compare, from best to worst, eg std::greater<>{} for the k largest
+ *    OpenMP versions select candidates per thread and merge them after the parallel region
+ *
+ * ===============================================================
+ */
+
+   template<indexable      Source,
+            ptrdiff_t...     Exts>
+      requires std::totally_ordered<detail::selected_value_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   constexpr auto argmin( const execution_policy auto                       policy,
+                          const located_index<index_type_of_t<Source>> begin_index,
+                          const stx::extents<Exts...>                         exts,
+                          const Source&                                     source )
+      -> detail::selected_type_t<Source>
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "argmin", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source>() );
+
+      assert( !is_empty_range(exts) );
+
+      return *detail::arg_extremum( policy, begin_index, exts, std::less<>{}, source );
+  }
+
+   template<indexable      Source,
+            ptrdiff_t...     Exts>
+      requires std::totally_ordered<detail::selected_value_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   constexpr auto argmax( const execution_policy auto                       policy,
+                          const located_index<index_type_of_t<Source>> begin_index,
+                          const stx::extents<Exts...>                         exts,
+                          const Source&                                     source )
+      -> detail::selected_type_t<Source>
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "argmax", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source>() );
+
+      assert( !is_empty_range(exts) );
+
+      return *detail::arg_extremum( policy, begin_index, exts, std::greater<>{}, source );
+  }
+
+   template<typename      Compare,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires std::strict_weak_order<Compare&,
+                                      const detail::selected_value_t<Source>&,
+                                      const detail::selected_value_t<Source>&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   constexpr auto top_k( const execution_policy auto                       policy,
+                         const located_index<index_type_of_t<Source>> begin_index,
+                         const stx::extents<Exts...>                         exts,
+                         const size_t                                           k,
+                               Compare                                    compare,
+                         const Source&                                     source )
+      -> std::vector<detail::selected_type_t<Source>>
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "top_k", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source>() );
+
+      detail::top_k_heap<index_type_of_t<Source>,
+                         detail::selected_value_t<Source>,
+                         Compare> heap( k, std::move(compare) );
+
+      detail::top_k( policy, begin_index, exts, heap, source );
+
+      return std::move(heap).sorted();
+  }
+
+/*
+ * if no execution policy is specified, use serial
+ */
+   template<indexable      Source,
+            ptrdiff_t...     Exts>
+      requires std::totally_ordered<detail::selected_value_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   constexpr auto argmin( const located_index<index_type_of_t<Source>> begin_index,
+                          const stx::extents<Exts...>                         exts,
+                          const Source&                                     source )
+      -> detail::selected_type_t<Source>
+  {
+      return argmin( execution::seq, begin_index, exts, source );
+  }
+
+   template<indexable      Source,
+            ptrdiff_t...     Exts>
+      requires std::totally_ordered<detail::selected_value_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   constexpr auto argmax( const located_index<index_type_of_t<Source>> begin_index,
+                          const stx::extents<Exts...>                         exts,
+                          const Source&                                     source )
+      -> detail::selected_type_t<Source>
+  {
+      return argmax( execution::seq, begin_index, exts, source );
+  }
+
+   template<typename      Compare,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires std::strict_weak_order<Compare&,
+                                      const detail::selected_value_t<Source>&,
+                                      const detail::selected_value_t<Source>&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   constexpr auto top_k( const located_index<index_type_of_t<Source>> begin_index,
+                         const stx::extents<Exts...>                         exts,
+                         const size_t                                           k,
+                               Compare                                    compare,
+                         const Source&                                     source )
+      -> std::vector<detail::selected_type_t<Source>>
+  {
+      return top_k( execution::seq, begin_index, exts, k, std::move(compare), source );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::histogram / yam::binned_statistic
+ *    see serial/algorithm.h, and histogram.h for the bins
+ *    histogram returns the number of elements of source in each bin
+ *    binned_statistic returns the count, mean and variance of values in each bin of keys
+ *    OpenMP versions accumulate into per-thread bins merged at the end, or into shared bins with atomic updates (see yam::histogram_mode)
+ *
+ * ===============================================================
+ */
+
+   template<binning        Bins,
+            indexable    Source,
+            ptrdiff_t...   Exts>
+      requires std::convertible_to<element_type_of_t<Source>,
+                                   typename Bins::value_type>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   auto histogram( const execution_policy auto                       policy,
+                   const located_index<index_type_of_t<Source>> begin_index,
+                   const stx::extents<Exts...>                         exts,
+                   const Bins&                                         bins,
+                   const histogram_mode                                mode,
+                   const Source&                                     source )
+      -> std::vector<size_t>
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "histogram", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source>() );
+
+      std::vector<size_t> counts( bins.size(), 0 );
+
+      detail::histogram( policy, begin_index, exts, bins, mode, counts, source );
+
+      return counts;
+  }
+
+   template<binning        Bins,
+            indexable    Source,
+            ptrdiff_t...   Exts>
+      requires std::convertible_to<element_type_of_t<Source>,
+                                   typename Bins::value_type>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   auto histogram( const execution_policy auto                       policy,
+                   const located_index<index_type_of_t<Source>> begin_index,
+                   const stx::extents<Exts...>                         exts,
+                   const Bins&                                         bins,
+                   const Source&                                     source )
+      -> std::vector<size_t>
+  {
+      return histogram( policy, begin_index, exts, bins, histogram_mode::automatic, source );
+  }
+
+   template<binning        Bins,
+            indexable      Keys,
+            indexable    Values,
+            ptrdiff_t...   Exts>
+      requires same_grid_as<Keys,
+                            Values>
+            && std::convertible_to<element_type_of_t<Keys>,
+                                   typename Bins::value_type>
+            && std::convertible_to<element_type_of_t<Values>,
+                                   detail::statistic_value_t<Values>>
+            && (sizeof...(Exts)==ndim_of_v<Keys>)
+   [[nodiscard]]
+   auto binned_statistic( const execution_policy auto                     policy,
+                          const located_index<index_type_of_t<Keys>> begin_index,
+                          const stx::extents<Exts...>                       exts,
+                          const Bins&                                       bins,
+                          const histogram_mode                              mode,
+                          const Keys&                                       keys,
+                          const Values&                                   values )
+      -> std::vector<bin_statistics<detail::statistic_value_t<Values>>>
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "binned_statistic", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Keys,Values>() );
+
+      std::vector<bin_statistics<detail::statistic_value_t<Values>>> stats( bins.size() );
+
+      detail::binned_statistic( policy, begin_index, exts, bins, mode, stats, keys, values );
+
+      return stats;
+  }
+
+   template<binning        Bins,
+            indexable      Keys,
+            indexable    Values,
+            ptrdiff_t...   Exts>
+      requires same_grid_as<Keys,
+                            Values>
+            && std::convertible_to<element_type_of_t<Keys>,
+                                   typename Bins::value_type>
+            && std::convertible_to<element_type_of_t<Values>,
+                                   detail::statistic_value_t<Values>>
+            && (sizeof...(Exts)==ndim_of_v<Keys>)
+   [[nodiscard]]
+   auto binned_statistic( const execution_policy auto                     policy,
+                          const located_index<index_type_of_t<Keys>> begin_index,
+                          const stx::extents<Exts...>                       exts,
+                          const Bins&                                       bins,
+                          const Keys&                                       keys,
+                          const Values&                                   values )
+      -> std::vector<bin_statistics<detail::statistic_value_t<Values>>>
+  {
+      return binned_statistic( policy, begin_index, exts, bins, histogram_mode::automatic, keys, values );
+  }
+
+/*
+ * if no execution policy is specified, use serial
+ */
+   template<binning        Bins,
+            indexable    Source,
+            ptrdiff_t...   Exts>
+      requires std::convertible_to<element_type_of_t<Source>,
+                                   typename Bins::value_type>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   auto histogram( const located_index<index_type_of_t<Source>> begin_index,
+                   const stx::extents<Exts...>                         exts,
+                   const Bins&                                         bins,
+                   const Source&                                     source )
+      -> std::vector<size_t>
+  {
+      return histogram( execution::seq, begin_index, exts, bins, source );
+  }
+
+   template<binning        Bins,
+            indexable      Keys,
+            indexable    Values,
+            ptrdiff_t...   Exts>
+      requires same_grid_as<Keys,
+                            Values>
+            && std::convertible_to<element_type_of_t<Keys>,
+                                   typename Bins::value_type>
+            && std::convertible_to<element_type_of_t<Values>,
+                                   detail::statistic_value_t<Values>>
+            && (sizeof...(Exts)==ndim_of_v<Keys>)
+   [[nodiscard]]
+   auto binned_statistic( const located_index<index_type_of_t<Keys>> begin_index,
+                          const stx::extents<Exts...>                       exts,
+                          const Bins&                                       bins,
+                          const Keys&                                       keys,
+                          const Values&                                   values )
+      -> std::vector<bin_statistics<detail::statistic_value_t<Values>>>
+  {
+      return binned_statistic( execution::seq, begin_index, exts, bins, keys, values );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::gather / yam::scatter_add
+ *    indirect access through an indexable of indices, eg grid cells of particles
+ *    gather:      destination(idx) = source(indices(idx)) for each idx in range [begin_index,begin_index+extents)
+ *    scatter_add: destination(indices(idx)) += values(idx) for each idx in range [begin_index,begin_index+extents)
+ *       several points may have the same target, see scatter.h for how parallel versions avoid conflicting updates
+ *
+ * ===============================================================
+ */
+
+   template<typename Indices,
+            typename  Target>
+   concept index_map_to =
+      indexable<Indices>
+   && std::convertible_to<element_type_of_t<Indices>,
+                          index_type_of_t<Target>>;
+
+   template<indexable Destination,
+            indexable      Source,
+            typename      Indices,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Indices>
+            && index_map_to<Indices,Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Destination>)
+   constexpr void gather( const execution_policy auto                            policy,
+                          const located_index<index_type_of_t<Destination>> begin_index,
+                          const stx::extents<Exts...>                              exts,
+                                Destination&&                               destination,
+                          const Source&                                          source,
+                          const Indices&                                        indices )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "gather", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Destination,Source,Indices>() );
+
+      using index_type = index_type_of_t<Destination>;
+
+      assign( policy,
+              begin_index, exts,
+              std::forward<Destination>(destination),
+              [ &source, &indices ]( const index_type idx )
+             {
+                 return source( index_type_of_t<Source>( indices(idx) ) );
+             } );
+  }
+
+// if no policy is given, use serial
+   template<indexable Destination,
+            indexable      Source,
+            typename      Indices,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Indices>
+            && index_map_to<Indices,Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Destination>)
+   constexpr void gather( const located_index<index_type_of_t<Destination>> begin_index,
+                          const stx::extents<Exts...>                              exts,
+                                Destination&&                               destination,
+                          const Source&                                          source,
+                          const Indices&                                        indices )
+  {
+      gather( execution::seq, begin_index, exts, std::forward<Destination>(destination), source, indices );
+  }
+
+   template<indexable Destination,
+            typename      Indices,
+            indexable      Values,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Indices,
+                            Values>
+            && index_map_to<Indices,Destination>
+            && std::is_lvalue_reference_v<element_type_of_t<Destination>>
+            && requires( element_type_of_t<Destination> d,
+                         element_type_of_t<Values>      v ){ d += v; }
+            && (sizeof...(Exts)==ndim_of_v<Values>)
+   void scatter_add( const execution_policy auto                       policy,
+                     const located_index<index_type_of_t<Values>> begin_index,
+                     const stx::extents<Exts...>                         exts,
+                           Destination&&                          destination,
+                     const Indices&                                   indices,
+                     const Values&                                     values,
+                     const scatter_mode                    mode= scatter_mode::automatic )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "scatter_add", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Destination,Destination,Indices,Values>() );
+
+      detail::scatter_add_into( policy, index_type_of_t<Values>{begin_index}, exts, mode,
+                                destination, indices, values );
+  }
+
+// if no policy is given, use serial
+   template<indexable Destination,
+            typename      Indices,
+            indexable      Values,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Indices,
+                            Values>
+            && index_map_to<Indices,Destination>
+            && std::is_lvalue_reference_v<element_type_of_t<Destination>>
+            && requires( element_type_of_t<Destination> d,
+                         element_type_of_t<Values>      v ){ d += v; }
+            && (sizeof...(Exts)==ndim_of_v<Values>)
+   void scatter_add( const located_index<index_type_of_t<Values>> begin_index,
+                     const stx::extents<Exts...>                         exts,
+                           Destination&&                          destination,
+                     const Indices&                                   indices,
+                     const Values&                                     values )
+  {
+      scatter_add( execution::seq, begin_index, exts, std::forward<Destination>(destination), indices, values );
+  }
 }
@@ -2,9 +2,21 @@
 # pragma once
 
 # include "algorithm.h"
+# include "aosoa.h"
+# include "batched_linalg.h"
+# include "blas.h"
 # include "concepts.h"
 # include "execution.h"
+# include "histogram.h"
 # include "index.h"
+# include "index_set.h"
+# include "krylov.h"
+# include "multi_array.h"
+# include "multigrid.h"
+# include "patch_collection.h"
+# include "runge_kutta.h"
+# include "scatter.h"
+# include "slice.h"
 # include "span.h"
 # include "type_traits.h"
 # include "utility.h"
@@ -0,0 +1,419 @@
+
+# pragma once
+
+# include "concepts.h"
+# include "type_traits.h"
+# include "index.h"
+# include "span.h"
+# include "array.h"
+
+# include "external/mdspan.h"
+
+# include <array>
+# include <cstddef>
+# include <utility>
+# include <concepts>
+# include <type_traits>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * yam::aosoa_accessor
+ *    accessor policy for basic_span / basic_array of a struct type, storing the elements in blocks of B elements with
+ *    each field of the block contiguous (array-of-structures-of-arrays)
+ *       struct particle{ double x, y, z, vx, vy, vz; };
+ *       using accessor_t = yam::aosoa_accessor<512,&particle::x,&particle::y,&particle::z,
+ *                                                  &particle::vx,&particle::vy,&particle::vz>;
+ *       yam::basic_array<particle,yam::dextents<3>,yam::default_layout,accessor_t> p(n0,n1,n2);
+ *
+ *    the layout policy maps an index to an element number as usual; element i is lane i%B of block i/B, and field f of
+ *    that element is at block + offset(f) + (i%B)*sizeof(f)
+ *    elements are returned as proxies (yam::aosoa_reference) which convert to and assign from the struct, and give
+ *    access to single fields with yam::field<&particle::x>( p(idx) ). yam::field_view<&particle::x>( p ) is an
+ *    indexable of the x field only, so a kernel reading one or two fields of a large struct reads only those bytes.
+ *
+ *    B sets the bytes of one field stored together, B*sizeof(field). For kernels streaming from memory this should be at
+ *    least a page (eg B=512 for doubles): with small blocks (8 or 16) the hardware prefetchers still fetch the
+ *    neighbouring fields, and the traffic is the same as for an array of structs.
+ *
+ *    fields not listed are not stored. The struct must be trivially copyable, as the storage of a basic_array is an
+ *    array of structs reused as raw bytes: a block of B elements occupies the same B*sizeof(Struct) bytes.
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename MemberPointer>
+      struct member_pointer_traits;
+
+      template<typename Struct,
+               typename  Field>
+      struct member_pointer_traits<Field Struct::*>
+     {
+         using struct_type = Struct;
+         using field_type  = Field;
+     };
+
+      template<auto field>
+      using field_struct_t = typename member_pointer_traits<decltype(field)>::struct_type;
+
+      template<auto field>
+      using field_type_t = typename member_pointer_traits<decltype(field)>::field_type;
+
+   // struct type of the first of a list of fields
+      template<auto first_field,
+               auto...   fields>
+      struct fields_struct
+     {
+         using type = field_struct_t<first_field>;
+     };
+
+      template<auto... fields>
+      using fields_struct_t = typename fields_struct<fields...>::type;
+
+      template<auto lhs,
+               auto rhs>
+      constexpr bool same_field()
+     {
+         if constexpr( std::same_as<decltype(lhs),decltype(rhs)> ){ return lhs==rhs; }
+         else { return false; }
+     }
+
+   // byte offsets of each field within a block of B elements: fields packed in order, each aligned to its own type
+      template<size_t     B,
+               auto... fields>
+      struct aosoa_layout
+     {
+         using struct_type = fields_struct_t<fields...>;
+
+         static constexpr size_t block_bytes = B*sizeof(struct_type);
+
+         template<auto field>
+         static constexpr bool has_field = ( same_field<field,fields>() || ... );
+
+      // offset of field, or one past the last field if field is not listed
+         template<auto field>
+         static constexpr size_t offset_of()
+        {
+            size_t offset = 0;
+            size_t result = 0;
+            bool   found  = false;
+
+            ( [&]()
+           {
+               using T = field_type_t<fields>;
+               offset = (offset+alignof(T)-1)/alignof(T)*alignof(T);
+               if( !found && same_field<field,fields>() ){ result = offset; found = true; }
+               offset += B*sizeof(T);
+           }(), ... );
+
+            return found ? result : offset;
+        }
+
+         template<auto field>
+            requires has_field<field>
+         static constexpr size_t offset = offset_of<field>();
+
+         static constexpr size_t packed_bytes = offset_of<nullptr>();
+     };
+  }
+
+/*
+ * concept for a list of fields which can be stored in an aosoa_accessor: data members of one trivially copyable struct
+ */
+   template<auto... fields>
+   concept aosoa_fields =
+      (sizeof...(fields)>0)
+   && (std::is_member_object_pointer_v<decltype(fields)>&&...)
+   && (std::same_as<detail::field_struct_t<fields>,
+                    detail::fields_struct_t<fields...>>&&...)
+   && std::is_trivially_copyable_v<detail::fields_struct_t<fields...>>
+   && std::default_initializable<detail::fields_struct_t<fields...>>;
+
+/*
+ * ===============================================================
+ *
+ * yam::aosoa_pointer
+ *    pointer type of an aosoa_accessor: the start of the storage, and the number of the first element, so that offset()
+ *    can move by any number of elements, not just whole blocks
+ *
+ * ===============================================================
+ */
+
+   template<typename Struct>
+   struct aosoa_pointer
+  {
+      Struct*   base  = nullptr;
+      ptrdiff_t first = 0;
+
+      constexpr aosoa_pointer() = default;
+
+   // implicit, as basic_array and basic_span are constructed from the storage pointer
+      constexpr aosoa_pointer( Struct* p,
+                               ptrdiff_t i = 0 ) noexcept
+         : base(p), first(i)
+     { }
+
+      constexpr explicit operator bool() const noexcept { return base!=nullptr; }
+
+      friend constexpr bool operator==( const aosoa_pointer&, const aosoa_pointer& ) = default;
+  };
+
+/*
+ * ===============================================================
+ *
+ * yam::aosoa_reference
+ *    element of an aosoa_accessor: the block and lane of one element, returned by value
+ *    assigns through a const operator= (see assignable_element), so it is the destination element of the algorithms
+ *
+ * ===============================================================
+ */
+
+   template<bool is_const,
+            size_t     B,
+            auto... fields>
+      requires aosoa_fields<fields...>
+   class aosoa_reference
+  {
+   private :
+
+      using layout_t = detail::aosoa_layout<B,fields...>;
+
+      using byte_pointer =
+         std::conditional_t<is_const,
+                            const std::byte*,
+                                  std::byte*>;
+
+   public :
+
+      using value_type = typename layout_t::struct_type;
+
+      constexpr aosoa_reference( byte_pointer block,
+                                 size_t       lane ) noexcept
+         : block_member(block), lane_member(lane)
+     { }
+
+      constexpr aosoa_reference( const aosoa_reference& ) = default;
+
+   // a reference converts to a const reference
+      constexpr aosoa_reference( const aosoa_reference<false,B,fields...>& other ) noexcept
+         requires (is_const)
+         : block_member(other.block()), lane_member(other.lane())
+     { }
+
+   // single field of the element
+      template<auto field>
+         requires (layout_t::template has_field<field>)
+      [[nodiscard]]
+      constexpr auto& get() const noexcept
+     {
+         using field_t = std::conditional_t<is_const,
+                                            const detail::field_type_t<field>,
+                                                  detail::field_type_t<field>>;
+
+         return *reinterpret_cast<field_t*>( block_member + layout_t::template offset<field>
+                                                          + lane_member*sizeof(field_t) );
+     }
+
+   // gather the fields into a struct
+      [[nodiscard]]
+      constexpr operator value_type() const
+     {
+         value_type value{};
+         ( (value.*fields = get<fields>()), ... );
+         return value;
+     }
+
+   // assign the fields of the element, not rebind the reference
+      constexpr const aosoa_reference& operator=( const value_type& value ) const
+         requires (!is_const)
+     {
+         ( (get<fields>() = value.*fields), ... );
+         return *this;
+     }
+
+      constexpr const aosoa_reference& operator=( const aosoa_reference& other ) const
+         requires (!is_const)
+     {
+         return *this = value_type( other );
+     }
+
+      template<bool other_is_const>
+      constexpr const aosoa_reference& operator=( const aosoa_reference<other_is_const,B,fields...>& other ) const
+         requires (!is_const)
+     {
+         return *this = value_type( other );
+     }
+
+      [[nodiscard]]
+      constexpr byte_pointer block() const noexcept { return block_member; }
+
+      [[nodiscard]]
+      constexpr size_t lane() const noexcept { return lane_member; }
+
+   private :
+
+      byte_pointer block_member;
+      size_t       lane_member;
+  };
+
+   template<typename T>
+   struct is_aosoa_reference : std::false_type {};
+
+   template<bool is_const,
+            size_t     B,
+            auto... fields>
+   struct is_aosoa_reference<aosoa_reference<is_const,B,fields...>> : std::true_type {};
+
+   template<typename T>
+   inline constexpr bool is_aosoa_reference_v = is_aosoa_reference<T>::value;
+
+/*
+ * the accessor policy
+ */
+   template<size_t     B,
+            auto... fields>
+      requires (B>0)
+            && aosoa_fields<fields...>
+   struct aosoa_accessor
+  {
+   private :
+
+      using layout_t = detail::aosoa_layout<B,fields...>;
+
+      static_assert( layout_t::packed_bytes<=layout_t::block_bytes,
+                     "fields of an aosoa_accessor must fit in the struct" );
+
+   public :
+
+      using offset_policy   = aosoa_accessor;
+      using element_type    = typename layout_t::struct_type;
+      using pointer         = aosoa_pointer<element_type>;
+      using reference       = aosoa_reference<false,B,fields...>;
+      using const_reference = aosoa_reference<true,B,fields...>;
+
+      static constexpr size_t block_size = B;
+
+      [[nodiscard]]
+      constexpr pointer offset( pointer p, ptrdiff_t i ) const noexcept
+     {
+         return pointer( p.base, p.first+i );
+     }
+
+      [[nodiscard]]
+      constexpr reference access( pointer p, ptrdiff_t i ) const noexcept
+     {
+         const auto n = size_t( p.first+i );
+         return reference( reinterpret_cast<std::byte*>( p.base ) + (n/B)*layout_t::block_bytes, n%B );
+     }
+
+      [[nodiscard]]
+      constexpr pointer decay( pointer p ) const noexcept
+     {
+         return p;
+     }
+
+   // number of structs allocated for span_size elements: whole blocks (see accessor_storage_size)
+      [[nodiscard]]
+      static constexpr size_t storage_size( const size_t span_size ) noexcept
+     {
+         return (span_size+B-1)/B*B;
+     }
+  };
+
+/*
+ * a single field of an element, as an lvalue if the element is an aosoa_reference or an lvalue struct
+ *    yam::field<&particle::x>( p(idx) ) += dt*yam::field<&particle::vx>( p(idx) )
+ */
+   template<auto  member,
+            typename  E>
+      requires std::is_member_object_pointer_v<decltype(member)>
+            && ( is_aosoa_reference_v<std::remove_cvref_t<E>>
+              || std::same_as<std::remove_cvref_t<E>,detail::field_struct_t<member>> )
+   [[nodiscard]]
+   constexpr decltype(auto) field( E&& element )
+  {
+      if constexpr( is_aosoa_reference_v<std::remove_cvref_t<E>> )
+     {
+         return element.template get<member>();
+     }
+      else if constexpr( std::is_lvalue_reference_v<E> )
+     {
+         return (element.*member);
+     }
+      else
+     {
+         return detail::field_type_t<member>( element.*member );
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::field_view
+ *    view of a single field of an indexable of structs (an aosoa basic_span or basic_array, or any indexable of the
+ *    struct type), like window: returns an lvalue of the field if the source returns an lvalue or an aosoa_reference
+ *       yam::transform( policy, begin, exts, yam::field_view<&particle::x>( p ),
+ *                       [=]( double x, double vx ){ return x+dt*vx; },
+ *                       yam::field_view<&particle::x>( p ), yam::field_view<&particle::vx>( p ) );
+ *
+ * ===============================================================
+ */
+
+   template<auto  member,
+            typename  I>
+      requires indexable<const I>
+   [[nodiscard]]
+   constexpr view auto field_view( const I& source )
+  {
+      using index_type  = index_type_of_t<I>;
+      using return_type = decltype( yam::field<member>( std::declval<element_type_of_t<decltype(source)>>() ) );
+
+      return [ &source ]
+            ( index_type i ) -> return_type
+           { return yam::field<member>( source(i) ); };
+  }
+
+   template<auto  member,
+            indexable I>
+      requires (!std::is_const_v<I>)
+   [[nodiscard]]
+   constexpr view auto field_view( I& source )
+  {
+      using index_type  = index_type_of_t<I>;
+      using return_type = decltype( yam::field<member>( std::declval<element_type_of_t<decltype(source)>>() ) );
+
+      return [ &source ]
+            ( index_type i ) -> return_type
+           { return yam::field<member>( source(i) ); };
+  }
+
+// convenience typedefs
+
+   template<typename Accessor,
+            grid_t       grid = primal>
+   using aosoa_array1 = basic_array<typename Accessor::element_type,
+                                    dextents<1>,
+                                    default_layout,
+                                    Accessor,
+                                    grid>;
+
+   template<typename Accessor,
+            grid_t       grid = primal>
+   using aosoa_array2 = basic_array<typename Accessor::element_type,
+                                    dextents<2>,
+                                    default_layout,
+                                    Accessor,
+                                    grid>;
+
+   template<typename Accessor,
+            grid_t       grid = primal>
+   using aosoa_array3 = basic_array<typename Accessor::element_type,
+                                    dextents<3>,
+                                    default_layout,
+                                    Accessor,
+                                    grid>;
+}
@@ -7,6 +7,7 @@
 # include "external/mdspan.h"
 
 # include <memory>
+# include <vector>
 
 namespace yam
 {
@@ -52,7 +53,7 @@ namespace yam
 
    public :
 
-      void check()
+      void check() const
      {
          assert( storage.get() );
          assert( mdspan_member.data() );
@@ -73,7 +74,7 @@ namespace yam
       using pointer         = typename mdspan_t::pointer;
       using reference       = typename mdspan_t::reference;
       using const_reference =
-         const std::remove_reference_t<reference>&;
+         accessor_const_reference_t<accessor_type>;
 
    // default operations
 
@@ -88,12 +89,12 @@ namespace yam
    // deep copy ctor from another basic_array
       constexpr basic_array( const basic_array& other  ) :
          storage( new_storage(
-            (size_t)other.mapping().required_span_size() ) ),
+            other.extents() ) ),
          mdspan_member( storage.get(),
                         dynamic_extents(other.extents()) )
      {
          check();
-         const auto size = mapping().required_span_size();
+         const auto size = storage_size( extents() );
          std::copy( other.storage.get(),
                     other.storage.get()+size, 
                     storage.get() );
@@ -131,12 +132,12 @@ namespace yam
       constexpr basic_array& operator=( const basic_array& other )
      {
       // new allocation size
-         const auto size = other.mapping().required_span_size();
+         const auto size = storage_size( other.extents() );
 
       // resize and reallocate if necessary
          if( !(extents() == other.extents()) )
         {
-            storage = std::make_unique<element_type[]>( size );
+            storage = new_storage( size );
             mdspan_member =
                mdspan_t( storage.get(),
                          dynamic_extents(other.extents()) );
@@ -147,6 +148,8 @@ namespace yam
          std::copy( other.storage.get(),
                     other.storage.get()+size, 
                     storage.get() );
+
+         return *this;
      }
 
    // element accessors ---------------------------------------------
@@ -223,12 +226,18 @@ namespace yam
    private :
 
       [[nodiscard]]
-      constexpr auto new_storage( const extents_type& extents )
+      static constexpr size_t storage_size( const extents_type& extents )
      {
-         return new_storage(size_t(
+         return accessor_storage_size<accessor_type>(size_t(
             yam::required_span_size<layout_type>(extents)));
      }
 
+      [[nodiscard]]
+      constexpr auto new_storage( const extents_type& extents )
+     {
+         return new_storage( storage_size(extents) );
+     }
+
       [[nodiscard]]
       constexpr auto new_storage( size_t size )
      {
@@ -350,4 +359,67 @@ namespace yam
                                    default_layout,
                                    default_accessor<ElementType>,
                                    dual>;
+
+/*
+ * ===============================================================
+ *
+ * yam::array_pool
+ *    arrays released to the pool are kept, and handed out again by acquire for the same extents instead of allocating
+ *    so objects needing temporary arrays for their lifetime (eg yam::rk_integrator) can share and reuse storage
+ *    the elements of an acquired array are not specified: zero for a new allocation, otherwise as they were released
+ *
+ * ===============================================================
+ */
+
+   template<typename Array>
+   class array_pool
+  {
+   public :
+
+      using array_type   = Array;
+      using extents_type = typename Array::extents_type;
+
+      array_pool() = default;
+
+   // arrays in the pool are not copied
+      array_pool( const array_pool& ) = delete;
+      array_pool& operator=( const array_pool& ) = delete;
+
+      [[nodiscard]]
+      array_type acquire( const extents_type& exts )
+     {
+         for( size_t n=0; n<free_arrays.size(); ++n )
+        {
+            if( free_arrays[n].extents()==exts )
+           {
+               array_type a = std::move( free_arrays[n] );
+               free_arrays.erase( free_arrays.begin()+ptrdiff_t(n) );
+               return a;
+           }
+        }
+
+         std::array<idx_t,extents_type::rank_dynamic()> dynamic_exts{};
+         for( size_t r=0, d=0; r<extents_type::rank(); ++r )
+        {
+            if( extents_type::static_extent(r)==stx::dynamic_extent ){ dynamic_exts[d++] = idx_t( exts.extent(r) ); }
+        }
+         return array_type( dynamic_exts );
+     }
+
+      void release( array_type&& a )
+     {
+         free_arrays.push_back( std::move(a) );
+     }
+
+   // number of arrays available
+      [[nodiscard]]
+      size_t size() const { return free_arrays.size(); }
+
+   // free the storage of all the available arrays
+      void clear(){ free_arrays.clear(); }
+
+   private :
+
+      std::vector<array_type> free_arrays;
+  };
 }
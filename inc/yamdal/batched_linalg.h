@@ -0,0 +1,550 @@
+
+# pragma once
+
+# include "algorithm.h"
+# include "blas.h"
+# include "views.h"
+# include "concepts.h"
+# include "type_traits.h"
+# include "index.h"
+# include "execution.h"
+# include "instrument.h"
+
+# include "external/mdspan.h"
+
+# include <array>
+# include <cmath>
+# include <utility>
+# include <concepts>
+# include <type_traits>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * Batched small dense linear algebra: an N x N system A*x = b at each index of a range [begin_index,begin_index+extents)
+ *    A and b are given by components, each an indexable over the grid (structure of arrays):
+ *       A[i*N+j] is the indexable of matrix element (i,j), B[i] the indexable of vector element i
+ *       eg std::array<array_t,N*N> and std::array<array_t,N>, or arrays of basic_spans of a larger array
+ *
+ *    lu_factor / cholesky_factor:             A is overwritten by its factors (LU: unit lower L below the diagonal and U
+ *                                             on and above it; Cholesky: lower L on and below the diagonal, above is not used)
+ *    lu_solve / cholesky_solve:               b is overwritten by the solution, from factors of A
+ *    lu_factor_solve / cholesky_factor_solve: b is overwritten by the solution, in one pass without storing the factors,
+ *                                             so A is only read and may be any indexables (eg lazy views)
+ *
+ *    LU is without pivoting, so it is for matrices that do not need it, eg diagonally dominant (like I-dt*J for a stiff
+ *    chemistry Jacobian J) or symmetric positive definite; Cholesky needs symmetric positive definite A, and reads its lower triangle
+ *
+ *    the range is split into segments of batched_segment_length indices along the last axis, and the components of each
+ *    segment are copied to a local array with the index innermost, so each elimination step is a loop over the indices of
+ *    the segment, which vectorises, instead of a loop within one small matrix. Segments are shared between threads,
+ *    and the local copy is on the stack (N*(N+1)*batched_segment_length values)
+ *    components with strides (basic_span, basic_array) are copied through element pointers, others element by element
+ *
+ * ===============================================================
+ */
+
+   inline constexpr idx_t batched_segment_length = 16;
+
+   namespace detail
+  {
+      template<typename Components>
+      using component_t = std::remove_cvref_t<decltype( std::declval<Components&>()[0] )>;
+
+      template<typename Components>
+      using component_value_t = std::remove_cvref_t<element_type_of_t<const component_t<Components>&>>;
+
+      template<typename Components,
+               size_t          size>
+      concept batched_components =
+         indexable<component_t<Components>>
+      && std::floating_point<component_value_t<Components>>
+      && requires( Components& c ){ { c[size-1] }; };
+
+   // one row of components for a segment, with the segment index innermost
+      template<typename T>
+      using segment_rows = std::array<T,size_t(batched_segment_length)>;
+
+      template<typename      Component,
+               typename          Index,
+               typename              T>
+      void load_segment( const Component&           c,
+                         const Index            start,
+                         const idx_t            count,
+                               segment_rows<T>&   row )
+     {
+         constexpr ndim_t last = Index::ndim-1;
+
+         if constexpr( strided_indexable<Component> )
+        {
+            const auto* p = std::addressof( c(start) );
+            const ptrdiff_t s = ptrdiff_t( c.stride(last) );
+            for( idx_t k=0; k<count; ++k ){ row[size_t(k)] = T( p[k*s] ); }
+        }
+         else
+        {
+            Index idx = start;
+            for( idx_t k=0; k<count; ++k, ++idx[last] ){ row[size_t(k)] = T( c(idx) ); }
+        }
+     }
+
+      template<typename      Component,
+               typename          Index,
+               typename              T>
+      void store_segment(       Component&            c,
+                          const Index             start,
+                          const idx_t             count,
+                          const segment_rows<T>&    row )
+     {
+         constexpr ndim_t last = Index::ndim-1;
+
+         if constexpr( strided_indexable<Component> )
+        {
+            auto* p = std::addressof( c(start) );
+            const ptrdiff_t s = ptrdiff_t( c.stride(last) );
+            for( idx_t k=0; k<count; ++k ){ p[k*s] = row[size_t(k)]; }
+        }
+         else
+        {
+            Index idx = start;
+            for( idx_t k=0; k<count; ++k, ++idx[last] ){ c(idx) = row[size_t(k)]; }
+        }
+     }
+
+   /*
+    * local copy of a segment of N x N matrices and N vectors
+    *    the lanes past the end of a partial segment are set to the identity matrix and a zero vector,
+    *    so every loop runs over the whole segment
+    */
+      template<typename T,
+               size_t   N>
+      struct matrix_segment
+     {
+         static constexpr size_t L = size_t(batched_segment_length);
+
+         std::array<segment_rows<T>,N*N> a;
+         std::array<segment_rows<T>,N>   b;
+
+         template<typename Matrix,
+                  typename  Index>
+         void load_matrix( const Matrix& A,
+                           const Index start,
+                           const idx_t count )
+        {
+            for( size_t m=0; m<N*N; ++m )
+           {
+               load_segment( A[m], start, count, a[m] );
+               for( size_t l=size_t(count); l<L; ++l ){ a[m][l] = m%(N+1)==0 ? T(1) : T(0); }
+           }
+        }
+
+         template<typename Vector,
+                  typename  Index>
+         void load_vector( const Vector&    B,
+                           const Index  start,
+                           const idx_t  count )
+        {
+            for( size_t i=0; i<N; ++i )
+           {
+               load_segment( B[i], start, count, b[i] );
+               for( size_t l=size_t(count); l<L; ++l ){ b[i][l] = T(0); }
+           }
+        }
+
+      // in place LU factorisation, without pivoting
+         void lu_factor()
+        {
+            for( size_t k=0; k<N; ++k )
+           {
+               segment_rows<T> inv;
+               for( size_t l=0; l<L; ++l ){ inv[l] = T(1)/a[k*N+k][l]; }
+
+               for( size_t i=k+1; i<N; ++i )
+              {
+                  for( size_t l=0; l<L; ++l ){ a[i*N+k][l] *= inv[l]; }
+                  for( size_t j=k+1; j<N; ++j )
+                 {
+                     for( size_t l=0; l<L; ++l ){ a[i*N+j][l] -= a[i*N+k][l]*a[k*N+j][l]; }
+                 }
+              }
+           }
+        }
+
+      // b = (LU)^-1 b
+         void lu_solve()
+        {
+            for( size_t i=0; i<N; ++i )
+           {
+               for( size_t j=0; j<i; ++j )
+              {
+                  for( size_t l=0; l<L; ++l ){ b[i][l] -= a[i*N+j][l]*b[j][l]; }
+              }
+           }
+            for( size_t i=N; i-->0; )
+           {
+               for( size_t j=i+1; j<N; ++j )
+              {
+                  for( size_t l=0; l<L; ++l ){ b[i][l] -= a[i*N+j][l]*b[j][l]; }
+              }
+               for( size_t l=0; l<L; ++l ){ b[i][l] /= a[i*N+i][l]; }
+           }
+        }
+
+      // in place Cholesky factorisation of the lower triangle
+         void cholesky_factor()
+        {
+            for( size_t j=0; j<N; ++j )
+           {
+               for( size_t k=0; k<j; ++k )
+              {
+                  for( size_t l=0; l<L; ++l ){ a[j*N+j][l] -= a[j*N+k][l]*a[j*N+k][l]; }
+              }
+               segment_rows<T> inv;
+               for( size_t l=0; l<L; ++l )
+              {
+                  a[j*N+j][l] = std::sqrt( a[j*N+j][l] );
+                  inv[l] = T(1)/a[j*N+j][l];
+              }
+
+               for( size_t i=j+1; i<N; ++i )
+              {
+                  for( size_t k=0; k<j; ++k )
+                 {
+                     for( size_t l=0; l<L; ++l ){ a[i*N+j][l] -= a[i*N+k][l]*a[j*N+k][l]; }
+                 }
+                  for( size_t l=0; l<L; ++l ){ a[i*N+j][l] *= inv[l]; }
+              }
+           }
+        }
+
+      // b = (L L^T)^-1 b
+         void cholesky_solve()
+        {
+            for( size_t i=0; i<N; ++i )
+           {
+               for( size_t j=0; j<i; ++j )
+              {
+                  for( size_t l=0; l<L; ++l ){ b[i][l] -= a[i*N+j][l]*b[j][l]; }
+              }
+               for( size_t l=0; l<L; ++l ){ b[i][l] /= a[i*N+i][l]; }
+           }
+            for( size_t i=N; i-->0; )
+           {
+               for( size_t j=i+1; j<N; ++j )
+              {
+                  for( size_t l=0; l<L; ++l ){ b[i][l] -= a[j*N+i][l]*b[j][l]; }
+              }
+               for( size_t l=0; l<L; ++l ){ b[i][l] /= a[i*N+i][l]; }
+           }
+        }
+     };
+
+   // the matrix elements stored by a factorisation: all for LU, the lower triangle for Cholesky
+      template<size_t N>
+      [[nodiscard]]
+      constexpr bool is_lower( const size_t m ){ return m%N <= m/N; }
+
+   /*
+    * for each segment of the range: load the matrices (and vectors), apply op to the local segment, and store the
+    * matrices (if store_matrix) and vectors (if store_vector)
+    */
+      template<size_t           N,
+               bool  store_matrix,
+               bool  store_vector,
+               bool   load_vector,
+               typename    Matrix,
+               typename    Vector,
+               typename        Op,
+               typename     Index,
+               ptrdiff_t...  Exts>
+      void for_each_matrix_segment( const execution_policy auto        policy,
+                                    const Index                   begin_index,
+                                    const stx::extents<Exts...>          exts,
+                                          Matrix&                           A,
+                                          Vector&                           B,
+                                          Op&&                             op,
+                                    const bool        lower_only = false )
+     {
+         using value_type = component_value_t<Matrix>;
+
+         for_each_segment<batched_segment_length>( policy, begin_index, exts,
+            [&]( const Index start, const idx_t count )
+           {
+               matrix_segment<value_type,N> seg;
+
+               seg.load_matrix( A, start, count );
+               if constexpr( load_vector ){ seg.load_vector( B, start, count ); }
+
+               op( seg );
+
+               if constexpr( store_matrix )
+              {
+                  for( size_t m=0; m<N*N; ++m )
+                 {
+                     if( !lower_only || is_lower<N>( m ) ){ store_segment( A[m], start, count, seg.a[m] ); }
+                 }
+              }
+               if constexpr( store_vector )
+              {
+                  for( size_t i=0; i<N; ++i ){ store_segment( B[i], start, count, seg.b[i] ); }
+              }
+           } );
+     }
+
+      struct no_vector
+     {
+         constexpr int operator[]( size_t ) const { return 0; }
+     };
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::lu_factor / yam::lu_solve / yam::lu_factor_solve
+ *
+ * ===============================================================
+ */
+
+   template<size_t          N,
+            typename   Matrix,
+            ptrdiff_t... Exts>
+      requires detail::batched_components<Matrix,N*N>
+            && (sizeof...(Exts)==ndim_of_v<detail::component_t<Matrix>>)
+   void lu_factor( const execution_policy auto                                          policy,
+                   const located_index<index_type_of_t<detail::component_t<Matrix>>> begin_index,
+                   const stx::extents<Exts...>                                            exts,
+                         Matrix&                                                             A )
+  {
+      using index_type = index_type_of_t<detail::component_t<Matrix>>;
+
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "lu_factor", policy,
+                                            begin_index, exts,
+                                            2*N*N*instrument::bytes_per_elem<detail::component_t<Matrix>>() );
+
+      detail::no_vector B;
+      detail::for_each_matrix_segment<N,true,false,false>( policy, index_type{begin_index}, exts, A, B,
+         []( auto& seg ){ seg.lu_factor(); } );
+  }
+
+   template<size_t          N,
+            typename   Matrix,
+            typename   Vector,
+            ptrdiff_t... Exts>
+      requires detail::batched_components<Matrix,N*N>
+            && detail::batched_components<Vector,N>
+            && (sizeof...(Exts)==ndim_of_v<detail::component_t<Matrix>>)
+   void lu_solve( const execution_policy auto                                          policy,
+                  const located_index<index_type_of_t<detail::component_t<Matrix>>> begin_index,
+                  const stx::extents<Exts...>                                            exts,
+                  const Matrix&                                                             A,
+                        Vector&                                                             B )
+  {
+      using index_type = index_type_of_t<detail::component_t<Matrix>>;
+
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "lu_solve", policy,
+                                            begin_index, exts,
+                                            (N*N+2*N)*instrument::bytes_per_elem<detail::component_t<Matrix>>() );
+
+      detail::for_each_matrix_segment<N,false,true,true>( policy, index_type{begin_index}, exts, A, B,
+         []( auto& seg ){ seg.lu_solve(); } );
+  }
+
+   template<size_t          N,
+            typename   Matrix,
+            typename   Vector,
+            ptrdiff_t... Exts>
+      requires detail::batched_components<Matrix,N*N>
+            && detail::batched_components<Vector,N>
+            && (sizeof...(Exts)==ndim_of_v<detail::component_t<Matrix>>)
+   void lu_factor_solve( const execution_policy auto                                          policy,
+                         const located_index<index_type_of_t<detail::component_t<Matrix>>> begin_index,
+                         const stx::extents<Exts...>                                            exts,
+                         const Matrix&                                                             A,
+                               Vector&                                                             B )
+  {
+      using index_type = index_type_of_t<detail::component_t<Matrix>>;
+
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "lu_factor_solve", policy,
+                                            begin_index, exts,
+                                            (N*N+2*N)*instrument::bytes_per_elem<detail::component_t<Matrix>>() );
+
+      detail::for_each_matrix_segment<N,false,true,true>( policy, index_type{begin_index}, exts, A, B,
+         []( auto& seg ){ seg.lu_factor(); seg.lu_solve(); } );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::cholesky_factor / yam::cholesky_solve / yam::cholesky_factor_solve
+ *
+ * ===============================================================
+ */
+
+   template<size_t          N,
+            typename   Matrix,
+            ptrdiff_t... Exts>
+      requires detail::batched_components<Matrix,N*N>
+            && (sizeof...(Exts)==ndim_of_v<detail::component_t<Matrix>>)
+   void cholesky_factor( const execution_policy auto                                          policy,
+                         const located_index<index_type_of_t<detail::component_t<Matrix>>> begin_index,
+                         const stx::extents<Exts...>                                            exts,
+                               Matrix&                                                             A )
+  {
+      using index_type = index_type_of_t<detail::component_t<Matrix>>;
+
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "cholesky_factor", policy,
+                                            begin_index, exts,
+                                            N*(N+1)*instrument::bytes_per_elem<detail::component_t<Matrix>>() );
+
+      detail::no_vector B;
+      detail::for_each_matrix_segment<N,true,false,false>( policy, index_type{begin_index}, exts, A, B,
+         []( auto& seg ){ seg.cholesky_factor(); },
+         true );
+  }
+
+   template<size_t          N,
+            typename   Matrix,
+            typename   Vector,
+            ptrdiff_t... Exts>
+      requires detail::batched_components<Matrix,N*N>
+            && detail::batched_components<Vector,N>
+            && (sizeof...(Exts)==ndim_of_v<detail::component_t<Matrix>>)
+   void cholesky_solve( const execution_policy auto                                          policy,
+                        const located_index<index_type_of_t<detail::component_t<Matrix>>> begin_index,
+                        const stx::extents<Exts...>                                            exts,
+                        const Matrix&                                                             A,
+                              Vector&                                                             B )
+  {
+      using index_type = index_type_of_t<detail::component_t<Matrix>>;
+
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "cholesky_solve", policy,
+                                            begin_index, exts,
+                                            (N*N+2*N)*instrument::bytes_per_elem<detail::component_t<Matrix>>() );
+
+      detail::for_each_matrix_segment<N,false,true,true>( policy, index_type{begin_index}, exts, A, B,
+         []( auto& seg ){ seg.cholesky_solve(); } );
+  }
+
+   template<size_t          N,
+            typename   Matrix,
+            typename   Vector,
+            ptrdiff_t... Exts>
+      requires detail::batched_components<Matrix,N*N>
+            && detail::batched_components<Vector,N>
+            && (sizeof...(Exts)==ndim_of_v<detail::component_t<Matrix>>)
+   void cholesky_factor_solve( const execution_policy auto                                          policy,
+                               const located_index<index_type_of_t<detail::component_t<Matrix>>> begin_index,
+                               const stx::extents<Exts...>                                            exts,
+                               const Matrix&                                                             A,
+                                     Vector&                                                             B )
+  {
+      using index_type = index_type_of_t<detail::component_t<Matrix>>;
+
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "cholesky_factor_solve", policy,
+                                            begin_index, exts,
+                                            (N*N+2*N)*instrument::bytes_per_elem<detail::component_t<Matrix>>() );
+
+      detail::for_each_matrix_segment<N,false,true,true>( policy, index_type{begin_index}, exts, A, B,
+         []( auto& seg ){ seg.cholesky_factor(); seg.cholesky_solve(); } );
+  }
+
+/*
+ * ===============================================================
+ *
+ * if no execution policy is specified, use serial
+ *
+ * ===============================================================
+ */
+
+   template<size_t          N,
+            typename   Matrix,
+            ptrdiff_t... Exts>
+      requires detail::batched_components<Matrix,N*N>
+            && (sizeof...(Exts)==ndim_of_v<detail::component_t<Matrix>>)
+   void lu_factor( const located_index<index_type_of_t<detail::component_t<Matrix>>> begin_index,
+                   const stx::extents<Exts...>                                            exts,
+                         Matrix&                                                             A )
+  {
+      lu_factor<N>( execution::seq, begin_index, exts, A );
+  }
+
+   template<size_t          N,
+            typename   Matrix,
+            typename   Vector,
+            ptrdiff_t... Exts>
+      requires detail::batched_components<Matrix,N*N>
+            && detail::batched_components<Vector,N>
+            && (sizeof...(Exts)==ndim_of_v<detail::component_t<Matrix>>)
+   void lu_solve( const located_index<index_type_of_t<detail::component_t<Matrix>>> begin_index,
+                  const stx::extents<Exts...>                                            exts,
+                  const Matrix&                                                             A,
+                        Vector&                                                             B )
+  {
+      lu_solve<N>( execution::seq, begin_index, exts, A, B );
+  }
+
+   template<size_t          N,
+            typename   Matrix,
+            typename   Vector,
+            ptrdiff_t... Exts>
+      requires detail::batched_components<Matrix,N*N>
+            && detail::batched_components<Vector,N>
+            && (sizeof...(Exts)==ndim_of_v<detail::component_t<Matrix>>)
+   void lu_factor_solve( const located_index<index_type_of_t<detail::component_t<Matrix>>> begin_index,
+                         const stx::extents<Exts...>                                            exts,
+                         const Matrix&                                                             A,
+                               Vector&                                                             B )
+  {
+      lu_factor_solve<N>( execution::seq, begin_index, exts, A, B );
+  }
+
+   template<size_t          N,
+            typename   Matrix,
+            ptrdiff_t... Exts>
+      requires detail::batched_components<Matrix,N*N>
+            && (sizeof...(Exts)==ndim_of_v<detail::component_t<Matrix>>)
+   void cholesky_factor( const located_index<index_type_of_t<detail::component_t<Matrix>>> begin_index,
+                         const stx::extents<Exts...>                                            exts,
+                               Matrix&                                                             A )
+  {
+      cholesky_factor<N>( execution::seq, begin_index, exts, A );
+  }
+
+   template<size_t          N,
+            typename   Matrix,
+            typename   Vector,
+            ptrdiff_t... Exts>
+      requires detail::batched_components<Matrix,N*N>
+            && detail::batched_components<Vector,N>
+            && (sizeof...(Exts)==ndim_of_v<detail::component_t<Matrix>>)
+   void cholesky_solve( const located_index<index_type_of_t<detail::component_t<Matrix>>> begin_index,
+                        const stx::extents<Exts...>                                            exts,
+                        const Matrix&                                                             A,
+                              Vector&                                                             B )
+  {
+      cholesky_solve<N>( execution::seq, begin_index, exts, A, B );
+  }
+
+   template<size_t          N,
+            typename   Matrix,
+            typename   Vector,
+            ptrdiff_t... Exts>
+      requires detail::batched_components<Matrix,N*N>
+            && detail::batched_components<Vector,N>
+            && (sizeof...(Exts)==ndim_of_v<detail::component_t<Matrix>>)
+   void cholesky_factor_solve( const located_index<index_type_of_t<detail::component_t<Matrix>>> begin_index,
+                               const stx::extents<Exts...>                                            exts,
+                               const Matrix&                                                             A,
+                                     Vector&                                                             B )
+  {
+      cholesky_factor_solve<N>( execution::seq, begin_index, exts, A, B );
+  }
+}
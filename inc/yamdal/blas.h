@@ -0,0 +1,516 @@
+
+# pragma once
+
+# include "algorithm.h"
+# include "views.h"
+# include "concepts.h"
+# include "type_traits.h"
+# include "index.h"
+# include "execution.h"
+# include "instrument.h"
+
+# include "external/mdspan.h"
+
+# include <array>
+# include <tuple>
+# include <cmath>
+# include <memory>
+# include <utility>
+# include <algorithm>
+# include <concepts>
+# include <type_traits>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * BLAS-1 kernels over the range [begin_index,begin_index+extents)
+ *    axpy:   y = a*x+y
+ *    axpby:  y = a*x+b*y
+ *    scal:   x = a*x
+ *    dot:    sum of x*y
+ *    nrm2:   square root of the sum of x*x (not scaled against overflow, unlike the reference BLAS)
+ *    axpy( {a0,..,ak}, std::tie(x0,..,xk), y ): y = a0*x0+..+ak*xk+y in one pass, instead of k+1 passes over y
+ *
+ *    x and y may be any indexables of arithmetic elements, y (or x for scal) writable, eg lazy views for x
+ *    the range is split into segments of up to blas_segment_length elements along the last axis, which are shared
+ *    between threads, so 1D ranges are parallel as well. When all the operands have strides (basic_span, basic_array),
+ *    each segment is a loop over element pointers, with unit stride along the last axis of layout_right
+ *    otherwise each element is accessed through its index
+ *
+ *    dot and nrm2 keep 4 partial sums in each unit stride segment, so the loop vectorises; the result is rounded
+ *    differently from a sequential sum, but is the same for a fixed number of threads
+ *    tiled policies use their inner policy, as there is no reuse between neighbouring elements to tile for
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      inline constexpr idx_t blas_segment_length = 1024;
+
+      template<typename I>
+      using blas_value_t = std::remove_cvref_t<element_type_of_t<const I&>>;
+
+      template<typename X,
+               typename Y>
+      using blas_product_t = std::remove_cvref_t<decltype( std::declval<blas_value_t<X>>()*std::declval<blas_value_t<Y>>() )>;
+
+      template<typename I>
+      concept blas_operand =
+         indexable<std::remove_cvref_t<I>>
+      && std::is_arithmetic_v<blas_value_t<std::remove_cvref_t<I>>>;
+
+   /*
+    * extents of the segments of a range: the extents of the range, with the last one divided into segments of up to length elements
+    */
+      template<idx_t        length = blas_segment_length,
+               ptrdiff_t...   Exts>
+      [[nodiscard]]
+      constexpr auto segment_extents( const stx::extents<Exts...> exts )
+     {
+         constexpr size_t ndim = sizeof...(Exts);
+
+         std::array<idx_t,ndim> segs;
+         for( size_t r=0; r<ndim; ++r ){ segs[r] = idx_t( exts.extent(r) ); }
+         segs[ndim-1] = (segs[ndim-1]+length-1)/length;
+
+         return dextents<ndim>( segs );
+     }
+
+   // first index and number of elements of segment s
+      template<idx_t        length = blas_segment_length,
+               typename      Index,
+               ptrdiff_t...   Exts>
+      [[nodiscard]]
+      constexpr std::pair<Index,idx_t> segment( const Index                 begin_index,
+                                                const stx::extents<Exts...>        exts,
+                                                const Index                           s )
+     {
+         constexpr ndim_t last = Index::ndim-1;
+
+         Index start;
+         for( ndim_t r=0; r<last; ++r ){ start[r] = begin_index[r]+s[r]; }
+         start[last] = begin_index[last]+s[last]*length;
+
+         return { start, std::min( length, idx_t( exts.extent(last) )-s[last]*length ) };
+     }
+
+   /*
+    * call func(start,count) for each segment of the range
+    */
+      template<idx_t        length = blas_segment_length,
+               typename      Index,
+               typename       Func,
+               ptrdiff_t...   Exts>
+      void for_each_segment( const execution_policy auto       policy,
+                             const Index                  begin_index,
+                             const stx::extents<Exts...>         exts,
+                                   Func&&                        func )
+     {
+         for_each_index( policy, Index{}, segment_extents<length>( exts ),
+            [&]( const Index s )
+           {
+               const auto [start,count] = segment<length>( begin_index, exts, s );
+               func( start, count );
+           } );
+     }
+
+      template<idx_t         length = blas_segment_length,
+               typename InnerPolicy,
+               typename       Index,
+               typename        Func,
+               ptrdiff_t...    Exts>
+      void for_each_segment( const execution::tiled_policy<InnerPolicy> policy,
+                             const Index                           begin_index,
+                             const stx::extents<Exts...>                  exts,
+                                   Func&&                                 func )
+     {
+         for_each_segment<length>( policy.inner, begin_index, exts, std::forward<Func>(func) );
+     }
+
+   /*
+    * sum of func(start,count) over the segments of the range, in the order of accumulate
+    */
+      template<typename          T,
+               typename      Index,
+               typename       Func,
+               ptrdiff_t...   Exts>
+      [[nodiscard]]
+      T sum_segments( const execution_policy auto       policy,
+                      const Index                  begin_index,
+                      const stx::extents<Exts...>         exts,
+                            Func&&                        func )
+     {
+         auto accumulate_func = [&]( T& acc, const Index s )
+                               {
+                                   const auto [start,count] = segment( begin_index, exts, s );
+                                   acc += func( start, count );
+                               };
+         auto combine_func = []( T& acc, const T partial ){ acc += partial; };
+
+         T sum(0);
+         accumulate_in_place( policy, Index{}, segment_extents( exts ),
+                              accumulate_func, combine_func,
+                              T(0), sum,
+                              []( const Index s ){ return s; } );
+         return sum;
+     }
+
+   /*
+    * call func(elements...) for each element of a segment of the operands
+    */
+      template<typename       Index,
+               typename        Func,
+               typename...  Operands>
+      constexpr void segment_for_each( const Index       start,
+                                       const idx_t      length,
+                                             Func&&       func,
+                                             Operands&... operands )
+     {
+         constexpr ndim_t last = Index::ndim-1;
+
+         if constexpr( (strided_indexable<std::remove_cvref_t<Operands>>&&...) )
+        {
+            [&]<size_t... N>( std::index_sequence<N...> )
+           {
+               const std::tuple p{ std::addressof( operands(start) )... };
+               const std::array<ptrdiff_t,sizeof...(N)> s{ ptrdiff_t( operands.stride(last) )... };
+
+               if( ((s[N]==1)&&...) )
+              {
+                  for( idx_t k=0; k<length; ++k ){ func( std::get<N>(p)[k]... ); }
+              }
+               else
+              {
+                  for( idx_t k=0; k<length; ++k ){ func( std::get<N>(p)[k*s[N]]... ); }
+              }
+           }( std::index_sequence_for<Operands...>{} );
+        }
+         else
+        {
+            Index idx = start;
+            for( idx_t k=0; k<length; ++k, ++idx[last] ){ func( operands(idx)... ); }
+        }
+     }
+
+   /*
+    * sum of func(elements...) over a segment of the operands
+    */
+      template<typename           T,
+               typename       Index,
+               typename        Func,
+               typename...  Operands>
+      [[nodiscard]]
+      constexpr T segment_sum( const Index             start,
+                               const idx_t            length,
+                                     Func&&             func,
+                               const Operands&... operands )
+     {
+         constexpr ndim_t last = Index::ndim-1;
+
+         if constexpr( (strided_indexable<Operands>&&...) )
+        {
+            return [&]<size_t... N>( std::index_sequence<N...> ) -> T
+           {
+               const std::tuple p{ std::addressof( operands(start) )... };
+               const std::array<ptrdiff_t,sizeof...(N)> s{ ptrdiff_t( operands.stride(last) )... };
+
+               if( ((s[N]==1)&&...) )
+              {
+                  T sum0(0), sum1(0), sum2(0), sum3(0);
+                  idx_t k=0;
+                  for( ; k+4<=length; k+=4 )
+                 {
+                     sum0 += func( std::get<N>(p)[k  ]... );
+                     sum1 += func( std::get<N>(p)[k+1]... );
+                     sum2 += func( std::get<N>(p)[k+2]... );
+                     sum3 += func( std::get<N>(p)[k+3]... );
+                 }
+                  for( ; k<length; ++k ){ sum0 += func( std::get<N>(p)[k]... ); }
+                  return (sum0+sum1)+(sum2+sum3);
+              }
+               else
+              {
+                  T sum(0);
+                  for( idx_t k=0; k<length; ++k ){ sum += func( std::get<N>(p)[k*s[N]]... ); }
+                  return sum;
+              }
+           }( std::index_sequence_for<Operands...>{} );
+        }
+         else
+        {
+            T sum(0);
+            Index idx = start;
+            for( idx_t k=0; k<length; ++k, ++idx[last] ){ sum += func( operands(idx)... ); }
+            return sum;
+        }
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::axpy / yam::axpby / yam::scal
+ *
+ * ===============================================================
+ */
+
+   template<detail::blas_operand X,
+            detail::blas_operand Y,
+            ptrdiff_t...      Exts>
+      requires same_grid_as<X,
+                            std::remove_cvref_t<Y>>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   void axpy( const execution_policy auto                  policy,
+              const located_index<index_type_of_t<X>> begin_index,
+              const stx::extents<Exts...>                    exts,
+              const detail::blas_value_t<Y>                     a,
+              const X&                                          x,
+                    Y&&                                         y )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "axpy", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<X,Y,Y>() );
+
+      detail::for_each_segment( policy, index_type_of_t<X>{begin_index}, exts,
+         [&]( const auto start, const idx_t length )
+        {
+            detail::segment_for_each( start, length, [a]( auto& yi, const auto xi ){ yi += a*xi; }, y, x );
+        } );
+  }
+
+   template<detail::blas_operand X,
+            detail::blas_operand Y,
+            ptrdiff_t...      Exts>
+      requires same_grid_as<X,
+                            std::remove_cvref_t<Y>>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   void axpby( const execution_policy auto                  policy,
+               const located_index<index_type_of_t<X>> begin_index,
+               const stx::extents<Exts...>                    exts,
+               const detail::blas_value_t<Y>                     a,
+               const X&                                          x,
+               const detail::blas_value_t<Y>                     b,
+                     Y&&                                         y )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "axpby", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<X,Y,Y>() );
+
+      detail::for_each_segment( policy, index_type_of_t<X>{begin_index}, exts,
+         [&]( const auto start, const idx_t length )
+        {
+            detail::segment_for_each( start, length, [a,b]( auto& yi, const auto xi ){ yi = a*xi+b*yi; }, y, x );
+        } );
+  }
+
+   template<detail::blas_operand X,
+            ptrdiff_t...      Exts>
+      requires (sizeof...(Exts)==ndim_of_v<std::remove_cvref_t<X>>)
+   void scal( const execution_policy auto                                        policy,
+              const located_index<index_type_of_t<std::remove_cvref_t<X>>> begin_index,
+              const stx::extents<Exts...>                                          exts,
+              const detail::blas_value_t<X>                                           a,
+                    X&&                                                               x )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "scal", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<X,X>() );
+
+      detail::for_each_segment( policy, index_type_of_t<std::remove_cvref_t<X>>{begin_index}, exts,
+         [&]( const auto start, const idx_t length )
+        {
+            detail::segment_for_each( start, length, [a]( auto& xi ){ xi *= a; }, x );
+        } );
+  }
+
+/*
+ * multi-vector axpy: y = a[0]*x0+..+a[k]*xk+y, with the sources passed as std::tie(x0,..,xk)
+ *    (or std::forward_as_tuple, for temporary views)
+ */
+   template<detail::blas_operand...  Xs,
+            detail::blas_operand      Y,
+            ptrdiff_t...           Exts>
+      requires (sizeof...(Xs)>0)
+            && same_grid_as<std::remove_cvref_t<Y>,
+                            std::remove_cvref_t<Xs>...>
+            && (sizeof...(Exts)==ndim_of_v<std::remove_cvref_t<Y>>)
+   void axpy( const execution_policy auto                                        policy,
+              const located_index<index_type_of_t<std::remove_cvref_t<Y>>> begin_index,
+              const stx::extents<Exts...>                                          exts,
+              const std::array<detail::blas_value_t<Y>,sizeof...(Xs)>&                a,
+              const std::tuple<Xs&...>&                                              xs,
+                    Y&&                                                               y )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "axpy", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Xs...,Y,Y>() );
+
+      detail::for_each_segment( policy, index_type_of_t<std::remove_cvref_t<Y>>{begin_index}, exts,
+         [&]( const auto start, const idx_t length )
+        {
+            [&]<size_t... N>( std::index_sequence<N...> )
+           {
+               detail::segment_for_each( start, length,
+                  [&a]( auto& yi, const auto... xi ){ yi += ((a[N]*xi)+...); },
+                  y, std::get<N>(xs)... );
+           }( std::index_sequence_for<Xs...>{} );
+        } );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::dot / yam::nrm2
+ *
+ * ===============================================================
+ */
+
+   template<detail::blas_operand X,
+            detail::blas_operand Y,
+            ptrdiff_t...      Exts>
+      requires same_grid_as<X,Y>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   [[nodiscard]]
+   detail::blas_product_t<X,Y> dot( const execution_policy auto                  policy,
+                                    const located_index<index_type_of_t<X>> begin_index,
+                                    const stx::extents<Exts...>                    exts,
+                                    const X&                                          x,
+                                    const Y&                                          y )
+  {
+      using value_type = detail::blas_product_t<X,Y>;
+
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "dot", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<X,Y>() );
+
+      return detail::sum_segments<value_type>( policy, index_type_of_t<X>{begin_index}, exts,
+         [&]( const auto start, const idx_t length )
+        {
+            return detail::segment_sum<value_type>( start, length, []( const auto xi, const auto yi ){ return xi*yi; }, x, y );
+        } );
+  }
+
+   template<detail::blas_operand X,
+            ptrdiff_t...      Exts>
+      requires std::floating_point<detail::blas_value_t<X>>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   [[nodiscard]]
+   detail::blas_value_t<X> nrm2( const execution_policy auto                  policy,
+                                 const located_index<index_type_of_t<X>> begin_index,
+                                 const stx::extents<Exts...>                    exts,
+                                 const X&                                          x )
+  {
+      using value_type = detail::blas_value_t<X>;
+
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "nrm2", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<X>() );
+
+      return std::sqrt( detail::sum_segments<value_type>( policy, index_type_of_t<X>{begin_index}, exts,
+         [&]( const auto start, const idx_t length )
+        {
+            return detail::segment_sum<value_type>( start, length, []( const auto xi ){ return xi*xi; }, x );
+        } ) );
+  }
+
+/*
+ * ===============================================================
+ *
+ * if no execution policy is specified, use serial
+ *
+ * ===============================================================
+ */
+
+   template<detail::blas_operand X,
+            detail::blas_operand Y,
+            ptrdiff_t...      Exts>
+      requires same_grid_as<X,
+                            std::remove_cvref_t<Y>>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   void axpy( const located_index<index_type_of_t<X>> begin_index,
+              const stx::extents<Exts...>                    exts,
+              const detail::blas_value_t<Y>                     a,
+              const X&                                          x,
+                    Y&&                                         y )
+  {
+      axpy( execution::seq, begin_index, exts, a, x, std::forward<Y>(y) );
+  }
+
+   template<detail::blas_operand X,
+            detail::blas_operand Y,
+            ptrdiff_t...      Exts>
+      requires same_grid_as<X,
+                            std::remove_cvref_t<Y>>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   void axpby( const located_index<index_type_of_t<X>> begin_index,
+               const stx::extents<Exts...>                    exts,
+               const detail::blas_value_t<Y>                     a,
+               const X&                                          x,
+               const detail::blas_value_t<Y>                     b,
+                     Y&&                                         y )
+  {
+      axpby( execution::seq, begin_index, exts, a, x, b, std::forward<Y>(y) );
+  }
+
+   template<detail::blas_operand X,
+            ptrdiff_t...      Exts>
+      requires (sizeof...(Exts)==ndim_of_v<std::remove_cvref_t<X>>)
+   void scal( const located_index<index_type_of_t<std::remove_cvref_t<X>>> begin_index,
+              const stx::extents<Exts...>                                          exts,
+              const detail::blas_value_t<X>                                           a,
+                    X&&                                                               x )
+  {
+      scal( execution::seq, begin_index, exts, a, std::forward<X>(x) );
+  }
+
+   template<detail::blas_operand...  Xs,
+            detail::blas_operand      Y,
+            ptrdiff_t...           Exts>
+      requires (sizeof...(Xs)>0)
+            && same_grid_as<std::remove_cvref_t<Y>,
+                            std::remove_cvref_t<Xs>...>
+            && (sizeof...(Exts)==ndim_of_v<std::remove_cvref_t<Y>>)
+   void axpy( const located_index<index_type_of_t<std::remove_cvref_t<Y>>> begin_index,
+              const stx::extents<Exts...>                                          exts,
+              const std::array<detail::blas_value_t<Y>,sizeof...(Xs)>&                a,
+              const std::tuple<Xs&...>&                                              xs,
+                    Y&&                                                               y )
+  {
+      axpy( execution::seq, begin_index, exts, a, xs, std::forward<Y>(y) );
+  }
+
+   template<detail::blas_operand X,
+            detail::blas_operand Y,
+            ptrdiff_t...      Exts>
+      requires same_grid_as<X,Y>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   [[nodiscard]]
+   detail::blas_product_t<X,Y> dot( const located_index<index_type_of_t<X>> begin_index,
+                                    const stx::extents<Exts...>                    exts,
+                                    const X&                                          x,
+                                    const Y&                                          y )
+  {
+      return dot( execution::seq, begin_index, exts, x, y );
+  }
+
+   template<detail::blas_operand X,
+            ptrdiff_t...      Exts>
+      requires std::floating_point<detail::blas_value_t<X>>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   [[nodiscard]]
+   detail::blas_value_t<X> nrm2( const located_index<index_type_of_t<X>> begin_index,
+                                 const stx::extents<Exts...>                    exts,
+                                 const X&                                          x )
+  {
+      return nrm2( execution::seq, begin_index, exts, x );
+  }
+}
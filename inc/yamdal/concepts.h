@@ -580,6 +580,18 @@ namespace yam
    && !std::is_void_v<std::invoke_result_t<TransformFunc,
                                            Arguments...>>;
 
+/*
+ * The assignable_element concept specifies that a value of type Source can be assigned to an element of type Destination of an indexable
+ *    Destination is either an lvalue reference, or a proxy returned by value which assigns through a const operator= (eg the elements of a yam::multi_array)
+ */
+   template<typename Destination,
+            typename      Source>
+   concept assignable_element =
+      std::assignable_from<Destination,
+                           Source>
+   || ( !std::is_reference_v<Destination>
+     && requires( const Destination destination, Source&& source ){ destination = std::forward<Source>(source); } );
+
 /*
  * Set of arguments for a transform algorithm
  *    The function TransformFunc can be called with arguments Arguments and the return type is assignable to type Destination
@@ -590,9 +602,9 @@ namespace yam
    concept transformation_r =
       std::invocable<TransformFunc,
                      Arguments...>
-   && std::assignable_from<Destination,
-                           std::invoke_result_t<TransformFunc,
-                                                Arguments...>>;
+   && assignable_element<Destination,
+                         std::invoke_result_t<TransformFunc,
+                                              Arguments...>>;
 
 /*
  * Set of arguments for a reduce algorithm
@@ -629,6 +641,43 @@ namespace yam
                        ReduceType&,
                        ReduceType&>;
 
+/*
+ * Set of arguments for an accumulate algorithm, which updates the accumulator in place instead of returning a new value
+ *
+ * The following must be valid:
+ *
+ *    AccumulateFunc   accumulate_op;
+ *    AccumulateType   acc;
+ *    const SourceType srct;
+ *
+ *    accumulate_op( acc, srct );
+ */
+   template<typename AccumulateFunc,
+            typename AccumulateType,
+            typename     SourceType>
+   concept accumulation =
+      std::invocable<AccumulateFunc&,
+                     AccumulateType&,
+                     const SourceType&>;
+
+/*
+ * Combination of two accumulators, eg per-thread partial results of an accumulate algorithm
+ *
+ * The following must be valid:
+ *
+ *    CombineFunc          combine_op;
+ *    AccumulateType       acc;
+ *    const AccumulateType other;
+ *
+ *    combine_op( acc, other );
+ */
+   template<typename    CombineFunc,
+            typename AccumulateType>
+   concept combination =
+      std::invocable<CombineFunc&,
+                     AccumulateType&,
+                     const AccumulateType&>;
+
 /*
  * Set of arguments for transform_reduce algorithm
  */
@@ -1,6 +1,11 @@
 
 # pragma once
 
+# include "index.h"
+
+# include <array>
+# include <type_traits>
+
 // # ifdef _OPENMP
 //    # include <omp.h>
 // # endif
@@ -32,6 +37,35 @@ namespace yam
 //       struct openacc_policy {}
 //       inline constexpr openacc_policy openacc;
 // # endif
+
+   /*
+    * tiled execution: the index range is split into tiles, which are swept in a given loop order
+    *    tile[d]     - extent of each tile in dimension d, 0 means the whole extent of the range
+    *    order       - dimensions from the outermost to the innermost loop over tiles
+    *    num_threads - number of threads for a parallel inner policy, 0 for the default
+    *
+    *    each tile is swept in row-major order by the serial algorithms, so tiles of width 1 in some dimensions
+    *    together with the tile order also select the order of the loops over indices (eg tile {0,1} with order {1,0} is column-major)
+    *    with a parallel inner policy the tiles are distributed over the threads
+    */
+      template<typename InnerPolicy>
+      struct tiled_policy
+     {
+         InnerPolicy inner{};
+         std::array<idx_t,3> tile{};
+         std::array<ndim_t,3> order{0,1,2};
+         int num_threads=0;
+     };
+
+      template<typename InnerPolicy>
+      [[nodiscard]]
+      constexpr tiled_policy<InnerPolicy> tiled( const InnerPolicy                inner,
+                                                 const std::array<idx_t,3>         tile,
+                                                 const std::array<ndim_t,3>       order = {0,1,2},
+                                                 const int                  num_threads = 0 )
+     {
+         return {inner,tile,order,num_threads};
+     }
   }
 
 /*
@@ -58,6 +92,10 @@ namespace yam
 //       : std::true_type {};
 // # endif
 
+   template<typename InnerPolicy>
+   struct is_execution_policy<execution::tiled_policy<InnerPolicy>>
+      : is_execution_policy<InnerPolicy> {};
+
 // helper variable template
    template<typename T>
    inline constexpr bool is_execution_policy_v =
@@ -84,6 +84,36 @@ namespace yam
       return dynamic_extent_indices( std::integer_sequence<ptrdiff_t,Exts...>{} );
   }
 
+/*
+ * extents of rank ndim with all extents dynamic
+ */
+   namespace detail
+  {
+      template<typename Indices>
+      struct all_dynamic_extents;
+
+      template<size_t... Idxs>
+      struct all_dynamic_extents<std::index_sequence<Idxs...>>
+     {
+         using type = stx::extents<((void)Idxs,stx::dynamic_extent)...>;
+     };
+  }
+
+   template<size_t ndim>
+   using dextents = typename detail::all_dynamic_extents<std::make_index_sequence<ndim>>::type;
+
+// copy of extents with all extents dynamic
+   template<ptrdiff_t... Exts>
+   [[nodiscard]]
+   constexpr auto make_dextents( const stx::extents<Exts...> exts )
+      -> dextents<sizeof...(Exts)>
+  {
+      return [&]<size_t... Idxs>( std::index_sequence<Idxs...> )
+     {
+         return dextents<sizeof...(Exts)>( exts.extent(Idxs)... );
+     }(std::make_index_sequence<sizeof...(Exts)>());
+  }
+
 /*
  * replace the NewIdx-th extent of exts with the (dynamic) new_val
  */
@@ -147,6 +177,41 @@ namespace yam
          stx::extents<Exts...>(dynamic_exts...) );
   }
 
+/*
+ * const reference type of an accessor policy: const element_type& if its reference is an lvalue reference,
+ *    otherwise (a proxy reference, eg yam::aosoa_accessor) its own const_reference
+ */
+   template<typename AccessorPolicy>
+   struct accessor_const_reference
+      : std::type_identity<const std::remove_reference_t<typename AccessorPolicy::reference>&> {};
+
+   template<typename AccessorPolicy>
+      requires requires(){ typename AccessorPolicy::const_reference; }
+   struct accessor_const_reference<AccessorPolicy>
+      : std::type_identity<typename AccessorPolicy::const_reference> {};
+
+   template<typename AccessorPolicy>
+   using accessor_const_reference_t =
+      typename accessor_const_reference<AccessorPolicy>::type;
+
+/*
+ * number of elements to allocate for a span of span_size elements: span_size, or rounded up to whole blocks for accessor
+ *    policies storing elements in blocks (eg yam::aosoa_accessor)
+ */
+   template<typename AccessorPolicy>
+   [[nodiscard]]
+   constexpr size_t accessor_storage_size( const size_t span_size )
+  {
+      if constexpr( requires(){ AccessorPolicy::storage_size( span_size ); } )
+     {
+         return AccessorPolicy::storage_size( span_size );
+     }
+      else
+     {
+         return span_size;
+     }
+  }
+
 /*
  * access elements of an stx::mdspan using a yam::index
  */
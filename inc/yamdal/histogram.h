@@ -0,0 +1,197 @@
+
+# pragma once
+
+# include <vector>
+# include <concepts>
+# include <algorithm>
+# include <utility>
+
+# include <cstddef>
+# include <cassert>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * Bin definitions for yam::histogram and yam::binned_statistic
+ *    bins are half-open [edge(i),edge(i+1)), except the last bin which also contains its upper edge
+ *    bin(x) returns the bin containing x, or size() if x is outside all bins (or NaN)
+ *
+ * ===============================================================
+ */
+
+   template<typename B>
+   concept binning =
+      requires( const B                     bins,
+                const typename B::value_type   x )
+     {
+         { bins.size() } -> std::convertible_to<size_t>;
+         { bins.bin(x) } -> std::convertible_to<size_t>;
+     };
+
+/*
+ * n bins of equal width over [lo,hi]
+ */
+   template<std::floating_point T= double>
+   struct uniform_bins
+  {
+      using value_type = T;
+
+      constexpr uniform_bins( const T      lo_,
+                              const T      hi_,
+                              const size_t  n_ )
+         : lo( lo_ ), hi( hi_ ), n( n_ ), inv_width( T(n_)/(hi_-lo_) )
+     {
+         assert( n>0 );
+         assert( lo<hi );
+     }
+
+      [[nodiscard]]
+      constexpr size_t size() const { return n; }
+
+      [[nodiscard]]
+      constexpr size_t bin( const T x ) const
+     {
+      // also rejects NaN
+         if( !( x>=lo && x<=hi ) ){ return n; }
+
+      // x==hi (and rounding just below hi) belongs to the last bin
+         return std::min( size_t( (x-lo)*inv_width ), n-1 );
+     }
+
+      [[nodiscard]]
+      constexpr T edge( const size_t i ) const
+     {
+         return lo + (hi-lo)*T(i)/T(n);
+     }
+
+      T lo;
+      T hi;
+      size_t n;
+      T inv_width;
+  };
+
+/*
+ * bins between consecutive entries of a sorted list of edges
+ */
+   template<std::floating_point T= double>
+   struct variable_bins
+  {
+      using value_type = T;
+
+      explicit variable_bins( std::vector<T> edges_ )
+         : edges( std::move(edges_) )
+     {
+         assert( edges.size()>=2 );
+         assert( std::is_sorted( edges.begin(), edges.end() ) );
+     }
+
+      [[nodiscard]]
+      size_t size() const { return edges.size()-1; }
+
+      [[nodiscard]]
+      size_t bin( const T x ) const
+     {
+      // also rejects NaN
+         if( !( x>=edges.front() && x<=edges.back() ) ){ return size(); }
+
+         const auto upper = std::upper_bound( edges.begin(), edges.end(), x );
+
+      // x==edges.back() belongs to the last bin
+         return std::min( size_t( upper-edges.begin() )-1, size()-1 );
+     }
+
+      [[nodiscard]]
+      T edge( const size_t i ) const { return edges[i]; }
+
+      std::vector<T> edges;
+  };
+
+/*
+ * ===============================================================
+ *
+ * Statistics of the values in one bin
+ *    accumulated with Welford's update, and combined with the pairwise update of Chan et al.,
+ *    so per-thread statistics are merged without forming sums of squares
+ *
+ * ===============================================================
+ */
+
+   template<std::floating_point T= double>
+   struct bin_statistics
+  {
+      using value_type = T;
+
+      size_t count=0;
+      T mean=0;
+      T m2=0;     // sum of squared differences from the mean
+
+      constexpr void add( const T x )
+     {
+         ++count;
+         const T delta = x-mean;
+         mean += delta/T(count);
+         m2 += delta*(x-mean);
+     }
+
+      constexpr void merge( const bin_statistics& other )
+     {
+         if( other.count==0 ){ return; }
+         if( count==0 ){ *this=other; return; }
+
+         const T n0 = T(count);
+         const T n1 = T(other.count);
+         const T n  = n0+n1;
+
+         const T delta = other.mean-mean;
+
+         mean += delta*n1/n;
+         m2   += other.m2 + delta*delta*n0*n1/n;
+         count += other.count;
+     }
+
+   // population variance, zero for empty bins
+      [[nodiscard]]
+      constexpr T variance() const
+     {
+         return count==0 ? T(0) : m2/T(count);
+     }
+
+   // statistics from the count, sum and sum of squares of the values
+   //    sum_sq - sum*mean cancels catastrophically when the mean is large compared with the spread, so prefer accumulating with add
+      [[nodiscard]]
+      static constexpr bin_statistics from_sums( const size_t      n,
+                                                 const T         sum,
+                                                 const T      sum_sq )
+     {
+         if( n==0 ){ return {}; }
+
+         const T avg = sum/T(n);
+         return { n, avg, std::max( T(0), sum_sq - sum*avg ) };
+     }
+  };
+
+/*
+ * how the OpenMP histogram algorithms accumulate into the bins
+ *    privatised: each thread accumulates into its own copy of the bins, which are summed at the end
+ *    atomic:     all threads accumulate into one set of bins with atomic updates (binned_statistic: under a lock per bin), for bin counts too large to copy per thread
+ *    automatic:  atomic if there are more than histogram_atomic_threshold bins, privatised otherwise
+ */
+   enum struct histogram_mode
+  {
+      automatic,
+      privatised,
+      atomic
+  };
+
+   inline constexpr size_t histogram_atomic_threshold = size_t(1)<<16;
+
+   [[nodiscard]]
+   constexpr bool use_atomic_bins( const histogram_mode mode,
+                                   const size_t        nbins )
+  {
+      return mode==histogram_mode::atomic
+         || ( mode==histogram_mode::automatic && nbins>histogram_atomic_threshold );
+  }
+}
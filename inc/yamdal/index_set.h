@@ -0,0 +1,181 @@
+
+# pragma once
+
+# include "index.h"
+
+# include <vector>
+# include <algorithm>
+# include <utility>
+
+# include <cstddef>
+# include <cassert>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * yam::index_set
+ *    sparse set of indices, stored as run-length encoded row spans: runs of consecutive indices along the last (innermost) axis
+ *       single indices are spans of length 1, and an index (or span) starting just after the end of the last span extends it,
+ *       so a set built in row-major order (eg from yam::compact) has one span per contiguous run
+ *       the set keeps the order of insertion, and does not check for duplicates
+ *
+ *    algorithms (assign, transform, reduce) accept an index_set in place of [begin_index,begin_index+extents),
+ *    with a plain loop along each span. Parallel policies split the set into parts with (nearly) equal numbers of indices,
+ *    splitting spans where needed, so the load does not depend on how the indices are distributed over the rows
+ *
+ * ===============================================================
+ */
+
+   template<ndim_t ndim,
+            grid_t grid= primal>
+   class index_set
+  {
+   public :
+
+      using index_type = index<ndim,grid>;
+
+   // length indices from begin along the last axis
+      struct row_span
+     {
+         index_type begin;
+         idx_t     length;
+     };
+
+      index_set() = default;
+
+   // set of the given indices, merged into spans where consecutive
+      explicit index_set( const std::vector<index_type>& indices )
+     {
+         for( const index_type& idx : indices ){ insert( idx ); }
+     }
+
+      void insert( const index_type idx )
+     {
+         insert( idx, 1 );
+     }
+
+   // the span [begin,begin+length) along the last axis
+      void insert( const index_type begin,
+                   const idx_t     length )
+     {
+         assert( length>=0 );
+         if( length==0 ){ return; }
+
+         if( !spans.empty() && extends( spans.back(), begin ) )
+        {
+            spans.back().length += length;
+        }
+         else
+        {
+            spans.push_back( { begin, length } );
+            starts.push_back( count );
+        }
+         count += size_t(length);
+     }
+
+      void clear()
+     {
+         spans.clear();
+         starts.clear();
+         count=0;
+     }
+
+   // number of indices
+      [[nodiscard]]
+      size_t size() const { return count; }
+
+      [[nodiscard]]
+      bool empty() const { return count==0; }
+
+      [[nodiscard]]
+      const std::vector<row_span>& row_spans() const { return spans; }
+
+   /*
+    * indices [first,last) of part p when the set is split into nparts parts with (nearly) equal numbers of indices
+    */
+      [[nodiscard]]
+      std::pair<size_t,size_t> part( const size_t      p,
+                                     const size_t nparts ) const
+     {
+         assert( p<nparts );
+         return { (count*p)/nparts, (count*(p+1))/nparts };
+     }
+
+   /*
+    * call func(begin,length) for each span, clipped to the indices [first,last) of the set, in order
+    */
+      template<typename Func>
+      void for_each_span( const size_t first,
+                          const size_t  last,
+                                Func&&  func ) const
+     {
+         if( first>=last ){ return; }
+
+      // last span starting at or before first
+         size_t s = size_t( std::upper_bound( starts.begin(), starts.end(), first ) - starts.begin() ) - 1;
+
+         for( ; s<spans.size() && starts[s]<last; ++s )
+        {
+            const size_t b = std::max( first, starts[s] );
+            const size_t e = std::min( last,  starts[s]+size_t(spans[s].length) );
+
+            index_type begin{spans[s].begin};
+            begin[ndim-1] += idx_t(b-starts[s]);
+
+            func( begin, idx_t(e-b) );
+        }
+     }
+
+      template<typename Func>
+      void for_each_span( Func&& func ) const
+     {
+         for_each_span( 0, count, std::forward<Func>(func) );
+     }
+
+   /*
+    * call func(index) for each index of the set (or of the indices [first,last) of the set), in order
+    */
+      template<typename Func>
+      void for_each_index( const size_t first,
+                           const size_t  last,
+                                 Func&&  func ) const
+     {
+         for_each_span( first, last,
+            [&func]( const index_type begin, const idx_t length )
+           {
+               index_type idx{begin};
+               for( idx_t k=begin[ndim-1]; k<begin[ndim-1]+length; ++k )
+              {
+                  idx[ndim-1] = k;
+                  func( idx );
+              }
+           } );
+     }
+
+      template<typename Func>
+      void for_each_index( Func&& func ) const
+     {
+         for_each_index( 0, count, std::forward<Func>(func) );
+     }
+
+   private :
+
+   // whether idx is the index just after the end of span
+      [[nodiscard]]
+      static bool extends( const row_span&   span,
+                           const index_type   idx )
+     {
+         for( ndim_t r=0; r+1<ndim; ++r )
+        {
+            if( idx[r]!=span.begin[r] ){ return false; }
+        }
+         return idx[ndim-1] == span.begin[ndim-1]+span.length;
+     }
+
+      std::vector<row_span> spans;
+      std::vector<size_t>   starts;   // number of indices before each span
+      size_t                count=0;
+  };
+}
@@ -0,0 +1,797 @@
+
+# pragma once
+
+# include "index.h"
+# include "type_traits.h"
+# include "execution.h"
+
+# include "external/mdspan.h"
+
+// hardware counters imply instrumentation
+# if defined(YAMDAL_INSTRUMENT_PERF) && !defined(YAMDAL_INSTRUMENT)
+   # define YAMDAL_INSTRUMENT
+# endif
+
+# ifdef YAMDAL_INSTRUMENT
+   # include "perf_counters.h"
+
+   # include <source_location>
+   # include <chrono>
+   # include <mutex>
+   # include <map>
+   # include <vector>
+   # include <string>
+   # include <algorithm>
+   # include <ostream>
+   # include <iomanip>
+   # include <thread>
+   # include <atomic>
+   # include <limits>
+   # include <sstream>
+   # include <cmath>
+# endif
+
+# include <array>
+# include <concepts>
+# include <type_traits>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * Optional instrumentation of yamdal algorithms
+ *    enabled at compile time by defining YAMDAL_INSTRUMENT before including any yamdal header
+ *    the macro changes the definitions of located_index and the algorithms, so it must be defined (or not) consistently in every translation unit of a program
+ *
+ *    each outermost call to an algorithm (assign, fill, generate, transform, reduce, transform_reduce) records:
+ *       - the execution policy
+ *       - the extents and number of elements of the index range
+ *       - an estimate of the bytes moved (from the element types of the destination and sources)
+ *       - the wall time
+ *    records are aggregated by the call site of the algorithm (std::source_location) and can be reported, or dumped as JSON or as a Chrome trace (chrome://tracing, ui.perfetto.dev)
+ *
+ *    defining YAMDAL_INSTRUMENT_PERF as well (or instead) also records hardware counters for each call (see perf_counters.h):
+ *       cycles, instructions, last-level cache misses, and packed and scalar floating-point arithmetic instructions retired
+ *    which are reported per call site alongside the bandwidth, and can be summarised against a roofline model (print_roofline)
+ *
+ *    the call site is captured by the begin_index parameter of each algorithm, which has type located_index<index_type>:
+ *       when instrumentation is disabled this is just index_type, so there is no overhead
+ *       when instrumentation is enabled it is derived from index_type, and implicitly constructed (recording the call site) from an index_type or from a braced list of idx_t
+ *
+ * ===============================================================
+ */
+
+   namespace instrument
+  {
+   /*
+    * name of an execution policy
+    */
+      [[nodiscard]]
+      constexpr const char* policy_name( execution::serial_policy ){ return "seq"; }
+
+# ifdef _OPENMP
+      [[nodiscard]]
+      constexpr const char* policy_name( execution::openmp_policy ){ return "openmp"; }
+# endif
+
+      template<typename InnerPolicy>
+      [[nodiscard]]
+      constexpr const char* policy_name( execution::tiled_policy<InnerPolicy> )
+     {
+         if constexpr( std::same_as<InnerPolicy,execution::serial_policy> ){ return "tiled/seq"; }
+         else                                                               { return "tiled/openmp"; }
+     }
+
+   /*
+    * estimate of the number of bytes moved per grid point for a set of indexables, from the sizes of their element types
+    */
+      template<typename... As>
+      [[nodiscard]]
+      constexpr size_t bytes_per_elem()
+     {
+         return (sizeof(std::remove_cvref_t<element_type_of_t<As>>)+...+0);
+     }
+  }
+
+# ifdef YAMDAL_INSTRUMENT
+
+/*
+ * index which also records the source location at which it was constructed
+ */
+   template<typename Index>
+      requires is_index_type_v<Index>
+   struct located_index
+      : Index
+  {
+      std::source_location location;
+
+      constexpr located_index( const Index idx,
+                               const std::source_location loc = std::source_location::current() )
+         : Index(idx), location(loc)
+     { }
+
+   // equivalent to Index{}
+      constexpr located_index( const std::source_location loc = std::source_location::current() )
+         : Index{}, location(loc)
+     { }
+
+   // equivalent to Index{i0,...}
+      constexpr located_index( const idx_t i0,
+                               const std::source_location loc = std::source_location::current() )
+         requires (Index::ndim==1)
+         : Index{i0}, location(loc)
+     { }
+
+      constexpr located_index( const idx_t i0,
+                               const idx_t i1,
+                               const std::source_location loc = std::source_location::current() )
+         requires (Index::ndim==2)
+         : Index{i0,i1}, location(loc)
+     { }
+
+      constexpr located_index( const idx_t i0,
+                               const idx_t i1,
+                               const idx_t i2,
+                               const std::source_location loc = std::source_location::current() )
+         requires (Index::ndim==3)
+         : Index{i0,i1,i2}, location(loc)
+     { }
+  };
+
+   namespace instrument
+  {
+   // whether hardware counters are read around each call
+# ifdef YAMDAL_INSTRUMENT_PERF
+      inline constexpr bool with_counters=true;
+# else
+      inline constexpr bool with_counters=false;
+# endif
+
+   /*
+    * aggregated statistics for all calls to an algorithm from one call site
+    */
+      struct call_site_stats
+     {
+         std::string kernel;
+         std::string policy;
+
+         std::string file;
+         std::string function;
+         unsigned line=0;
+         unsigned column=0;
+
+         size_t calls=0;
+         size_t elems=0;   // total over all calls
+         size_t bytes=0;   // total over all calls (estimated)
+
+         double total_time=0;
+         double min_time=std::numeric_limits<double>::max();
+         double max_time=0;
+
+         std::vector<ptrdiff_t> extents; // of most recent call
+
+         counter_values counters{}; // total over all calls (NaN if unavailable, zero if counters are not enabled)
+
+         [[nodiscard]]
+         double bandwidth() const { return double(bytes)/total_time; }
+
+         [[nodiscard]]
+         double mean_time() const { return total_time/double(calls); }
+
+      // instructions per cycle
+         [[nodiscard]]
+         double ipc() const { return counters[counter::instructions]/counters[counter::cycles]; }
+
+      // counter value per grid point
+         [[nodiscard]]
+         double per_elem( const counter c ) const { return counters[c]/double(elems); }
+
+      // floating-point arithmetic instructions, packed and scalar
+         [[nodiscard]]
+         double fp_instructions() const { return counters[counter::fp_packed]+counters[counter::fp_scalar]; }
+
+      // fraction of floating-point arithmetic instructions which are packed (NaN without floating-point arithmetic)
+         [[nodiscard]]
+         double fp_vector_fraction() const { return counters[counter::fp_packed]/fp_instructions(); }
+
+      // packed floating-point arithmetic instructions per byte moved
+         [[nodiscard]]
+         double fp_vector_intensity() const { return counters[counter::fp_packed]/double(bytes); }
+     };
+
+   /*
+    * single invocation of an algorithm, kept for the Chrome trace if tracing is enabled
+    */
+      struct trace_event
+     {
+         const call_site_stats* site;
+         double start;  // seconds since instrumentation epoch
+         double duration;
+         size_t thread;
+         size_t elems;
+         size_t bytes;
+     };
+
+   /*
+    * global store of instrumentation records
+    */
+      class recorder
+     {
+      public :
+
+         [[nodiscard]]
+         static recorder& instance()
+        {
+            static recorder r;
+            return r;
+        }
+
+         using clock = std::chrono::steady_clock;
+
+      // seconds since instrumentation epoch
+         [[nodiscard]]
+         double now() const
+        {
+            return std::chrono::duration<double>(clock::now()-epoch).count();
+        }
+
+         void record( const char*                 kernel,
+                      const char*                 policy,
+                      const std::source_location& location,
+                      const ptrdiff_t*            extents,
+                      const ndim_t                   ndim,
+                      const size_t                  elems,
+                      const size_t                  bytes,
+                      const double                  start,
+                      const double               duration,
+                      const counter_values&      counters )
+        {
+            const std::lock_guard lock(mutex);
+
+            std::string key = std::string(location.file_name())
+                            + ":" + std::to_string(location.line())
+                            + ":" + std::to_string(location.column())
+                            + ":" + kernel + ":" + policy;
+
+            auto [it,is_new] = sites.try_emplace( std::move(key) );
+            call_site_stats& site = it->second;
+
+            if( is_new )
+           {
+               site.kernel   = kernel;
+               site.policy   = policy;
+               site.file     = location.file_name();
+               site.function = location.function_name();
+               site.line     = location.line();
+               site.column   = location.column();
+           }
+
+            site.calls += 1;
+            site.elems += elems;
+            site.bytes += bytes;
+
+            site.total_time += duration;
+            site.min_time = std::min(site.min_time,duration);
+            site.max_time = std::max(site.max_time,duration);
+
+            site.extents.assign( extents, extents+ndim );
+
+            site.counters += counters;
+
+            if( tracing )
+           {
+               events.push_back( { &site, start, duration, thread_number(), elems, bytes } );
+           }
+        }
+
+      // all call sites, sorted by decreasing total time
+         [[nodiscard]]
+         std::vector<call_site_stats> report() const
+        {
+            const std::lock_guard lock(mutex);
+
+            std::vector<call_site_stats> r;
+            r.reserve(sites.size());
+            for( const auto& [key,site] : sites ){ r.push_back(site); }
+
+            std::sort( r.begin(), r.end(),
+                       []( const auto& a, const auto& b ){ return a.total_time > b.total_time; } );
+            return r;
+        }
+
+      // all recorded events (empty unless tracing is enabled)
+         [[nodiscard]]
+         std::vector<trace_event> trace() const
+        {
+            const std::lock_guard lock(mutex);
+            return events;
+        }
+
+         void enable_trace( const bool enable )
+        {
+            const std::lock_guard lock(mutex);
+            tracing = enable;
+        }
+
+         void reset()
+        {
+            const std::lock_guard lock(mutex);
+            events.clear();
+            sites.clear();
+        }
+
+      // small sequential number for the calling thread, for trace output
+         [[nodiscard]]
+         static size_t thread_number()
+        {
+            static std::atomic<size_t> count=0;
+            thread_local const size_t n = count++;
+            return n;
+        }
+
+      private :
+
+         recorder() = default;
+
+         const clock::time_point epoch = clock::now();
+
+         mutable std::mutex mutex;
+
+      // std::map so that pointers to call_site_stats held by trace events remain valid
+         std::map<std::string,call_site_stats> sites;
+         std::vector<trace_event> events;
+         bool tracing=false;
+     };
+
+   /*
+    * depth of nested instrumented calls on this thread
+    *    only the outermost call (depth 0) is recorded, so that eg the assign inside a transform is not also recorded
+    */
+      [[nodiscard]]
+      inline int& nesting_depth()
+     {
+         thread_local int depth=0;
+         return depth;
+     }
+
+   /*
+    * RAII marker for code that is nested inside an instrumented call, but runs on a different thread (eg the body of an OpenMP parallel loop)
+    */
+      struct nested_scope
+     {
+         constexpr nested_scope()
+        {
+            if( !std::is_constant_evaluated() ){ ++nesting_depth(); }
+        }
+
+         constexpr ~nested_scope()
+        {
+            if( !std::is_constant_evaluated() ){ --nesting_depth(); }
+        }
+
+         nested_scope( const nested_scope& ) = delete;
+         nested_scope& operator=( const nested_scope& ) = delete;
+     };
+
+   /*
+    * RAII timer for a single algorithm invocation, recording on destruction if it is the outermost instrumented call on this thread
+    *    literal type so that it can be used in constexpr algorithms, but does nothing during constant evaluation
+    */
+      class kernel_scope
+     {
+      public :
+
+         template<execution_policy  Policy,
+                  typename           Index,
+                  ptrdiff_t...        Exts>
+         constexpr kernel_scope( const char*                         kernel_name,
+                                 const Policy                             policy,
+                                 const located_index<Index>&         begin_index,
+                                 const stx::extents<Exts...>                exts,
+                                 const size_t                     bytes_per_elem )
+            : kernel(kernel_name),
+              policy_str(policy_name(policy)),
+              location(begin_index.location),
+              ndim(sizeof...(Exts)),
+              elems(num_elems(exts))
+       {
+            if( std::is_constant_evaluated() ){ return; }
+
+            is_outermost = (nesting_depth()==0);
+            ++nesting_depth();
+
+            if( !is_outermost ){ return; }
+
+            for( size_t r=0; r<ndim; ++r ){ extents[r] = exts.extent(r); }
+            bytes = elems*bytes_per_elem;
+
+            start = recorder::instance().now();
+
+            if constexpr( with_counters ){ counters_start = perf_counters::instance().read(); }
+        }
+
+         constexpr ~kernel_scope()
+        {
+            if( std::is_constant_evaluated() ){ return; }
+
+            --nesting_depth();
+
+            if( !is_outermost ){ return; }
+
+            counter_values counters{};
+            if constexpr( with_counters ){ counters = perf_counters::instance().read()-counters_start; }
+
+            auto& rec = recorder::instance();
+            const double stop = rec.now();
+
+            rec.record( kernel, policy_str, location,
+                        extents.data(), ndim,
+                        elems, bytes,
+                        start, stop-start,
+                        counters );
+        }
+
+         kernel_scope( const kernel_scope& ) = delete;
+         kernel_scope& operator=( const kernel_scope& ) = delete;
+
+      private :
+
+         const char* kernel;
+         const char* policy_str;
+         std::source_location location;
+
+         std::array<ptrdiff_t,3> extents{};
+         ndim_t ndim;
+
+         size_t elems;
+         size_t bytes=0;
+
+         double start=0;
+         counter_values counters_start{};
+         bool is_outermost=false;
+     };
+
+   /*
+    * ===============================================================
+    *
+    * report API
+    *
+    * ===============================================================
+    */
+
+   /*
+    * aggregated statistics for each call site, sorted by decreasing total time
+    */
+      [[nodiscard]]
+      inline std::vector<call_site_stats> report()
+     {
+         return recorder::instance().report();
+     }
+
+   /*
+    * record every invocation (not only aggregates) for write_chrome_trace
+    */
+      inline void enable_trace( const bool enable=true )
+     {
+         recorder::instance().enable_trace(enable);
+     }
+
+   /*
+    * discard all records
+    */
+      inline void reset()
+     {
+         recorder::instance().reset();
+     }
+
+      namespace detail
+     {
+      // escape string for JSON output (quotes, backslashes and control characters)
+         [[nodiscard]]
+         inline std::string json_string( const std::string& s )
+        {
+            std::string out="\"";
+            for( const char c : s )
+           {
+               if( c=='"' || c=='\\' ){ out += '\\'; out += c; }
+               else if( static_cast<unsigned char>(c) < 0x20 )
+              {
+                  constexpr char hex[] = "0123456789abcdef";
+                  out += "\\u00";
+                  out += hex[(c>>4)&0xf];
+                  out += hex[c&0xf];
+              }
+               else { out += c; }
+           }
+            out += '"';
+            return out;
+        }
+
+      // "file:line:column"
+         [[nodiscard]]
+         inline std::string site_name( const call_site_stats& site )
+        {
+            return site.file + ":" + std::to_string(site.line) + ":" + std::to_string(site.column);
+        }
+
+      // restores the format flags and precision of a stream on destruction
+         struct stream_state
+        {
+            explicit stream_state( std::ostream& stream )
+               : os(stream), flags(stream.flags()), precision(stream.precision())
+           { }
+
+            ~stream_state()
+           {
+               os.flags(flags);
+               os.precision(precision);
+           }
+
+            std::ostream& os;
+            std::ios_base::fmtflags flags;
+            std::streamsize precision;
+        };
+
+      // JSON number, or null if not finite (unavailable counter)
+         [[nodiscard]]
+         inline std::string json_number( const double x )
+        {
+            if( !std::isfinite(x) ){ return "null"; }
+
+            std::ostringstream os;
+            os << std::setprecision(9) << x;
+            return os.str();
+        }
+
+      // fixed-width column for a value which may be NaN
+         inline void write_column( std::ostream& os, const int width, const int precision, const double x )
+        {
+            if( std::isfinite(x) ){ os << std::setw(width) << std::setprecision(precision) << x; }
+            else                  { os << std::setw(width) << "-"; }
+        }
+
+         inline void write_extents( std::ostream& os, const std::vector<ptrdiff_t>& extents )
+        {
+            os << "[";
+            for( size_t r=0; r<extents.size(); ++r ){ os << (r>0 ? "," : "") << extents[r]; }
+            os << "]";
+        }
+     }
+
+   /*
+    * human-readable table of call sites, sorted by decreasing total time
+    */
+      inline void print_report( std::ostream& os )
+     {
+         const auto sites = report();
+         const detail::stream_state state(os);
+
+         os << std::left  << std::setw(18) << "kernel"
+                          << std::setw(14) << "policy"
+            << std::right << std::setw(10) << "calls"
+                          << std::setw(14) << "total(ms)"
+                          << std::setw(12) << "mean(ms)"
+                          << std::setw(10) << "GB/s";
+         if constexpr( with_counters )
+        {
+            os            << std::setw(8)  << "IPC"
+                          << std::setw(10) << "cyc/elem"
+                          << std::setw(10) << "LLC/elem"
+                          << std::setw(8)  << "fpv%";
+        }
+         os << "  call site\n";
+
+         for( const auto& site : sites )
+        {
+            os << std::left  << std::setw(18) << site.kernel
+                             << std::setw(14) << site.policy
+               << std::right << std::fixed
+                             << std::setw(10) << site.calls
+                             << std::setw(14) << std::setprecision(3) << site.total_time*1e3
+                             << std::setw(12) << std::setprecision(3) << site.mean_time()*1e3
+                             << std::setw(10) << std::setprecision(2) << site.bandwidth()*1e-9;
+            if constexpr( with_counters )
+           {
+               detail::write_column( os, 8,  2, site.ipc() );
+               detail::write_column( os, 10, 2, site.per_elem(counter::cycles) );
+               detail::write_column( os, 10, 4, site.per_elem(counter::llc_misses) );
+               detail::write_column( os, 8,  1, site.fp_vector_fraction()*100 );
+           }
+            os << "  " << detail::site_name(site) << "\n";
+        }
+     }
+
+   /*
+    * JSON array of aggregated call site statistics
+    */
+      inline void write_json( std::ostream& os )
+     {
+         const auto sites = report();
+         const detail::stream_state state(os);
+
+         os << std::defaultfloat << std::setprecision(9) << "[\n";
+         for( size_t i=0; i<sites.size(); ++i )
+        {
+            const auto& site = sites[i];
+
+            os << "  {\"kernel\":"   << detail::json_string(site.kernel)
+               << ",\"policy\":"     << detail::json_string(site.policy)
+               << ",\"file\":"       << detail::json_string(site.file)
+               << ",\"line\":"       << site.line
+               << ",\"column\":"     << site.column
+               << ",\"function\":"   << detail::json_string(site.function)
+               << ",\"calls\":"      << site.calls
+               << ",\"elems\":"      << site.elems
+               << ",\"bytes\":"      << site.bytes
+               << ",\"total_time\":" << site.total_time
+               << ",\"min_time\":"   << site.min_time
+               << ",\"max_time\":"   << site.max_time
+               << ",\"extents\":";
+            detail::write_extents( os, site.extents );
+            if constexpr( with_counters )
+           {
+               for( size_t n=0; n<num_counters; ++n )
+              {
+                  os << ",\"" << counter_names[n] << "\":" << detail::json_number(site.counters.values[n]);
+              }
+           }
+            os << "}" << (i+1<sites.size() ? "," : "") << "\n";
+        }
+         os << "]\n";
+     }
+
+   /*
+    * Chrome trace event format (one complete event per recorded invocation), requires enable_trace() before the algorithms are called
+    */
+      inline void write_chrome_trace( std::ostream& os )
+     {
+         const auto events = recorder::instance().trace();
+         const detail::stream_state state(os);
+
+         os << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+         for( size_t i=0; i<events.size(); ++i )
+        {
+            const auto& e = events[i];
+
+            os << "  {\"name\":"  << detail::json_string(e.site->kernel)
+               << ",\"cat\":\"yamdal\",\"ph\":\"X\",\"pid\":0"
+               << ",\"tid\":"     << e.thread
+               << ",\"ts\":"      << e.start*1e6
+               << ",\"dur\":"     << e.duration*1e6
+               << ",\"args\":{\"policy\":" << detail::json_string(e.site->policy)
+               << ",\"site\":"    << detail::json_string(detail::site_name(*e.site))
+               << ",\"elems\":"   << e.elems
+               << ",\"bytes\":"   << e.bytes
+               << "}}" << (i+1<events.size() ? "," : "") << "\n";
+        }
+         os << "]}\n";
+     }
+
+   /*
+    * ===============================================================
+    *
+    * roofline summary
+    *    each call site is placed on a roofline with the packed floating-point instruction rate as the compute roof,
+    *    and classified from its achieved bandwidth and hardware counters as:
+    *       bandwidth - achieved bandwidth is close to the peak memory bandwidth
+    *       latency   - most data comes from memory (LLC misses), but neither bandwidth nor IPC are high
+    *       fp-scalar - data is mostly in cache, but few floating-point instructions are packed (floating-point work failed to vectorise)
+    *       compute   - data is mostly in cache, and floating-point work is vectorised
+    *       unknown   - required counters are unavailable, or the kernel does no floating-point arithmetic
+    *
+    *    only floating-point arithmetic is counted (see perf_counters.h), so kernels which only copy data (eg assign) or do integer arithmetic
+    *    cannot be told to be vectorised or not: unless they are bandwidth- or latency-bound they are unknown, and their fpv/B is zero
+    *
+    * ===============================================================
+    */
+
+   /*
+    * peak rates of the machine (eg from the bench/ STREAM triad and the processor specification)
+    */
+      struct machine_peaks
+     {
+         double bandwidth=0;    // bytes/s
+         double fp_vector_rate=0;  // packed floating-point instructions/s, over all cores in use
+
+      // classification thresholds
+         double bandwidth_fraction=0.6;  // fraction of peak bandwidth above which a kernel is bandwidth-bound
+         double miss_fraction=0.5;       // LLC misses per cache line moved above which data is considered to come from memory
+         double latency_ipc=1.0;         // IPC below which a kernel reading from memory is latency-bound
+         double fp_vector_fraction=0.5;  // fraction of packed floating-point instructions below which a kernel is considered fp-scalar
+         double line_size=64;            // bytes
+     };
+
+   /*
+    * classification of a call site, one of "bandwidth", "latency", "fp-scalar", "compute", "unknown"
+    */
+      [[nodiscard]]
+      inline const char* classify( const call_site_stats& site, const machine_peaks& peaks )
+     {
+         if( site.bandwidth() >= peaks.bandwidth_fraction*peaks.bandwidth ){ return "bandwidth"; }
+
+         const double lines = double(site.bytes)/peaks.line_size;
+         const double misses = site.counters[counter::llc_misses];
+
+         if( !std::isfinite(misses) ){ return "unknown"; }
+
+         if( misses >= peaks.miss_fraction*lines )
+        {
+            const double ipc = site.ipc();
+            return (std::isfinite(ipc) && ipc>=peaks.latency_ipc) ? "compute" : "latency";
+        }
+
+      // NaN if the fp counters are unavailable or there was no floating-point arithmetic
+         const double vec = site.fp_vector_fraction();
+
+         if( !std::isfinite(vec) ){ return "unknown"; }
+
+         return vec < peaks.fp_vector_fraction ? "fp-scalar" : "compute";
+     }
+
+   /*
+    * table of call sites against the roofline of the machine
+    *    %BW   - achieved bandwidth as a percentage of peak
+    *    fpv/B - packed floating-point instructions per byte moved (arithmetic intensity), zero for kernels without floating-point arithmetic
+    *    %roof - achieved packed floating-point instruction rate as a percentage of the attainable rate min(fp_vector_rate, intensity*bandwidth)
+    */
+      inline void print_roofline( std::ostream& os, const machine_peaks& peaks )
+     {
+         const auto sites = report();
+         const detail::stream_state state(os);
+
+         os << std::left  << std::setw(18) << "kernel"
+                          << std::setw(14) << "policy"
+            << std::right << std::setw(10) << "GB/s"
+                          << std::setw(8)  << "%BW"
+                          << std::setw(10) << "fpv/B"
+                          << std::setw(8)  << "%roof"
+                          << std::setw(8)  << "IPC"
+                          << std::setw(11) << "bound"
+                          << "  call site\n";
+
+         for( const auto& site : sites )
+        {
+            const double intensity = site.fp_vector_intensity();
+            const double attainable = std::min( peaks.fp_vector_rate, intensity*peaks.bandwidth );
+            const double achieved = site.counters[counter::fp_packed]/site.total_time;
+
+            os << std::left  << std::setw(18) << site.kernel
+                             << std::setw(14) << site.policy
+               << std::right << std::fixed
+                             << std::setw(10) << std::setprecision(2) << site.bandwidth()*1e-9;
+            detail::write_column( os, 8,  1, 100*site.bandwidth()/peaks.bandwidth );
+            detail::write_column( os, 10, 4, intensity );
+            detail::write_column( os, 8,  1, attainable>0 ? 100*achieved/attainable : std::nan("") );
+            detail::write_column( os, 8,  2, site.ipc() );
+            os << std::setw(11) << classify( site, peaks )
+               << "  " << detail::site_name(site) << "\n";
+        }
+     }
+  }
+
+# else /* !YAMDAL_INSTRUMENT */
+
+/*
+ * without instrumentation the begin index of an algorithm is a plain index
+ */
+   template<typename Index>
+   using located_index = Index;
+
+   namespace instrument
+  {
+   // no-op markers
+      struct nested_scope
+     {
+         constexpr nested_scope() {}
+     };
+
+      struct kernel_scope
+     {
+         template<typename... Args>
+         constexpr kernel_scope( Args&&... ) {}
+     };
+  }
+
+# endif /* YAMDAL_INSTRUMENT */
+}
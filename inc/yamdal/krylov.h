@@ -0,0 +1,610 @@
+
+# pragma once
+
+# include "array.h"
+# include "algorithm.h"
+# include "slice.h"
+# include "concepts.h"
+# include "type_traits.h"
+# include "index.h"
+# include "execution.h"
+# include "instrument.h"
+
+# include "external/mdspan.h"
+
+# include <array>
+# include <vector>
+# include <cmath>
+# include <utility>
+# include <concepts>
+# include <type_traits>
+
+# include <cassert>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * yam::linear_operator
+ *    matrix-free linear operator A, defined by a function returning a lazy view of A*x for an indexable x
+ *    (eg a stencil such as yam::laplacian). The function should accept any indexable, as the solvers
+ *    also apply it to lazy combinations of vectors
+ *
+ * ===============================================================
+ */
+
+   template<typename ViewFunc>
+   class linear_operator
+  {
+   public :
+
+      constexpr explicit linear_operator( ViewFunc view_func_ )
+         : view_func( std::move(view_func_) )
+     { }
+
+   // lazy view of A*x
+      template<indexable X>
+      [[nodiscard]]
+      constexpr view auto operator()( const X& x ) const
+     {
+         return view_func( x );
+     }
+
+   // y = A*x over the range [begin_index,begin_index+extents)
+      template<indexable      Y,
+               indexable      X,
+               ptrdiff_t... Exts>
+      void apply( const execution_policy auto                  policy,
+                  const located_index<index_type_of_t<X>> begin_index,
+                  const stx::extents<Exts...>                    exts,
+                        Y&&                                         y,
+                  const X&                                          x ) const
+     {
+         assign( policy, begin_index, exts, y, (*this)( x ) );
+     }
+
+   private :
+
+      ViewFunc view_func;
+  };
+
+/*
+ * ===============================================================
+ *
+ * Krylov solvers for A*x = b over the range [begin_index,begin_index+extents)
+ *    conjugate_gradient (A symmetric positive definite), bicgstab and gmres (restarted after options.restart iterations)
+ *
+ *    x holds the initial guess and is overwritten by the solution. Elements of x outside the range are boundary values:
+ *    they are used to form the initial residual, while the work vectors (arrays of the extents of x) are zero outside the range
+ *    each iteration sweeps the range a fixed small number of times, with the vector updates and dot products of the
+ *    iteration fused into the same sweeps as the operator applications:
+ *       conjugate_gradient: 2 sweeps, in the Chronopoulos-Gear form, which updates A*p from A*r instead of applying A to p
+ *       bicgstab:           3 sweeps, applying A to the lazy updates of p and s instead of storing them first
+ *       gmres:              2 sweeps per Arnoldi step, with classical Gram-Schmidt on an unnormalised basis,
+ *                           plus 2 sweeps per restart to update x and form the new residual
+ *    convergence is ||r|| <= options.tolerance*||b|| (or ||r|| <= options.tolerance if b is zero)
+ *    the reported gmres residual is the estimate from the least-squares problem
+ *
+ * ===============================================================
+ */
+
+   struct solver_options
+  {
+      int    max_iterations = 1000;
+      double tolerance      = 1e-8;
+      int    restart        = 30;    // gmres basis size
+  };
+
+   struct solver_result
+  {
+      int    iterations = 0;
+      double residual   = 0;   // ||r||/||b||
+      bool   converged  = false;
+  };
+
+   namespace detail
+  {
+   // element-wise sum of fixed or variable size arrays of partial sums
+      struct elementwise_plus
+     {
+         template<typename Sums>
+         constexpr void operator()(       Sums&     acc,
+                                    const Sums& partial ) const
+        {
+            for( size_t k=0; k<acc.size(); ++k ){ acc[k] += partial[k]; }
+        }
+     };
+
+   /*
+    * one sweep over the range, calling kernel(sums,idx) for each index idx, which may update any vectors at idx and add to sums
+    *    an accumulate over the indices themselves, so it has the parallel implementations of accumulate,
+    *    which visit each index exactly once
+    */
+      template<typename    Sums,
+               typename  Kernel,
+               typename   Index,
+               ptrdiff_t... Exts>
+      [[nodiscard]]
+      Sums fused_sweep( const execution_policy auto       policy,
+                        const located_index<Index>   begin_index,
+                        const stx::extents<Exts...>         exts,
+                        const Sums&                         zero,
+                              Kernel&&                    kernel )
+     {
+         return accumulate( policy, begin_index, exts,
+                            std::forward<Kernel>(kernel), elementwise_plus{},
+                            zero, zero,
+                            []( const Index idx ){ return idx; } );
+     }
+
+   // work vector with the extents of x, zero everywhere
+      template<typename X>
+      [[nodiscard]]
+      auto work_vector( const X& x )
+     {
+         using value_type = std::remove_cvref_t<element_type_of_t<const X&>>;
+         using array_type = basic_array<value_type,
+                                        dextents<ndim_of_v<X>>,
+                                        default_layout,
+                                        default_accessor<value_type>,
+                                        grid_of_v<X>>;
+
+         std::array<idx_t,ndim_of_v<X>> exts;
+         for( size_t r=0; r<exts.size(); ++r ){ exts[r] = idx_t( x.extent(r) ); }
+
+      // basic_array value-initialises its elements
+         return array_type( exts );
+     }
+
+      template<typename X>
+      using work_vector_t = decltype( work_vector( std::declval<const X&>() ) );
+
+      template<typename X,
+               typename B>
+      concept krylov_vectors =
+         mdspan_backed<X>
+      && same_grid_as<X,B>
+      && std::floating_point<std::remove_cvref_t<element_type_of_t<const X&>>>;
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::conjugate_gradient
+ *
+ * ===============================================================
+ */
+
+   template<typename ViewFunc,
+            typename        X,
+            indexable       B,
+            ptrdiff_t...   Exts>
+      requires detail::krylov_vectors<X,B>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   solver_result conjugate_gradient( const execution_policy auto                  policy,
+                                     const located_index<index_type_of_t<X>> begin_index,
+                                     const stx::extents<Exts...>                    exts,
+                                     const linear_operator<ViewFunc>&                  A,
+                                           X&                                          x,
+                                     const B&                                          b,
+                                     const solver_options&                       options = {} )
+  {
+      using T          = std::remove_cvref_t<element_type_of_t<const X&>>;
+      using index_type = index_type_of_t<X>;
+
+      auto r = detail::work_vector( x );
+      auto w = detail::work_vector( x );
+      auto p = detail::work_vector( x );
+      auto s = detail::work_vector( x );   // A*p
+
+   // r = b-A*x
+      const auto Ax = A( x );
+      const auto [rr0,bb] =
+         detail::fused_sweep( policy, begin_index, exts, std::array<T,2>{},
+            [&]( std::array<T,2>& sums, const index_type idx )
+           {
+               const T ri = b(idx)-Ax(idx);
+               r(idx) = ri;
+               sums[0] += ri*ri;
+               sums[1] += b(idx)*b(idx);
+           } );
+
+      const T bnorm = bb>0 ? std::sqrt( bb ) : T(1);
+
+      solver_result result{ 0, double( std::sqrt( rr0 )/bnorm ), false };
+      if( result.residual<=options.tolerance ){ result.converged=true; return result; }
+
+   // w = A*r, and (w,r)
+      const auto Ar = A( r );
+      const auto apply_A =
+         [&]()
+        {
+            return detail::fused_sweep( policy, begin_index, exts, std::array<T,1>{},
+               [&]( std::array<T,1>& sums, const index_type idx )
+              {
+                  const T wi = Ar(idx);
+                  w(idx) = wi;
+                  sums[0] += wi*r(idx);
+              } )[0];
+        };
+
+      T gamma = rr0;
+      T delta = apply_A();
+      T alpha = gamma/delta;
+      T beta  = 0;
+
+      while( result.iterations<options.max_iterations )
+     {
+         ++result.iterations;
+
+      // p = r+beta*p, s = w+beta*s (= A*p), x += alpha*p, r -= alpha*s, and (r,r)
+         const T gamma_new =
+            detail::fused_sweep( policy, begin_index, exts, std::array<T,1>{},
+               [&]( std::array<T,1>& sums, const index_type idx )
+              {
+                  const T pi = r(idx)+beta*p(idx);
+                  const T si = w(idx)+beta*s(idx);
+                  p(idx) = pi;
+                  s(idx) = si;
+                  x(idx) += alpha*pi;
+                  const T ri = r(idx)-alpha*si;
+                  r(idx) = ri;
+                  sums[0] += ri*ri;
+              } )[0];
+
+         result.residual = double( std::sqrt( gamma_new )/bnorm );
+         if( result.residual<=options.tolerance ){ result.converged=true; break; }
+
+         delta = apply_A();
+         beta  = gamma_new/gamma;
+         alpha = gamma_new/(delta-beta*gamma_new/alpha);
+         gamma = gamma_new;
+     }
+
+      return result;
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::bicgstab
+ *
+ * ===============================================================
+ */
+
+   template<typename ViewFunc,
+            typename        X,
+            indexable       B,
+            ptrdiff_t...   Exts>
+      requires detail::krylov_vectors<X,B>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   solver_result bicgstab( const execution_policy auto                  policy,
+                           const located_index<index_type_of_t<X>> begin_index,
+                           const stx::extents<Exts...>                    exts,
+                           const linear_operator<ViewFunc>&                  A,
+                                 X&                                          x,
+                           const B&                                          b,
+                           const solver_options&                       options = {} )
+  {
+      using T          = std::remove_cvref_t<element_type_of_t<const X&>>;
+      using index_type = index_type_of_t<X>;
+
+      auto r     = detail::work_vector( x );
+      auto r_hat = detail::work_vector( x );
+      auto p     = detail::work_vector( x );
+      auto v     = detail::work_vector( x );
+      auto t     = detail::work_vector( x );
+
+   // p and v are written while their old values are read around each index, so the new values go to separate arrays
+      auto p_new = detail::work_vector( x );
+      auto v_new = detail::work_vector( x );
+
+   // r = r_hat = b-A*x
+      const auto Ax = A( x );
+      const auto [rho0,rr0,bb] =
+         detail::fused_sweep( policy, begin_index, exts, std::array<T,3>{},
+            [&]( std::array<T,3>& sums, const index_type idx )
+           {
+               const T ri = b(idx)-Ax(idx);
+               r(idx) = ri;
+               r_hat(idx) = ri;
+               sums[0] += ri*ri;
+               sums[1] += ri*ri;
+               sums[2] += b(idx)*b(idx);
+           } );
+
+      const T bnorm = bb>0 ? std::sqrt( bb ) : T(1);
+
+      solver_result result{ 0, double( std::sqrt( rr0 )/bnorm ), false };
+      if( result.residual<=options.tolerance ){ result.converged=true; return result; }
+
+      T rho     = rho0;
+      T rho_old = 1;
+      T alpha   = 1;
+      T omega   = 1;
+
+      while( result.iterations<options.max_iterations )
+     {
+         ++result.iterations;
+
+         const T beta = (rho/rho_old)*(alpha/omega);
+
+      // p = r+beta*(p-omega*v) and v = A*p, with A applied to the lazy update of p
+         const auto p_update =
+            [&]( const index_type idx ) -> T
+           {
+               return r(idx)+beta*(p(idx)-omega*v(idx));
+           };
+         const auto Ap = A( p_update );
+
+         const T rhat_v =
+            detail::fused_sweep( policy, begin_index, exts, std::array<T,1>{},
+               [&]( std::array<T,1>& sums, const index_type idx )
+              {
+                  const T vi = Ap(idx);
+                  p_new(idx) = p_update(idx);
+                  v_new(idx) = vi;
+                  sums[0] += r_hat(idx)*vi;
+              } )[0];
+
+         std::swap( p, p_new );
+         std::swap( v, v_new );
+
+         alpha = rho/rhat_v;
+
+      // s = r-alpha*v and t = A*s, with A applied to the lazy s
+         const auto s =
+            [&]( const index_type idx ) -> T
+           {
+               return r(idx)-alpha*v(idx);
+           };
+         const auto As = A( s );
+
+         const auto [ts,tt,ss] =
+            detail::fused_sweep( policy, begin_index, exts, std::array<T,3>{},
+               [&]( std::array<T,3>& sums, const index_type idx )
+              {
+                  const T ti = As(idx);
+                  const T si = s(idx);
+                  t(idx) = ti;
+                  sums[0] += ti*si;
+                  sums[1] += ti*ti;
+                  sums[2] += si*si;
+              } );
+
+         omega = tt>0 ? ts/tt : T(0);
+
+      // x += alpha*p+omega*s, r = s-omega*t, and (r_hat,r), (r,r)
+         const auto [rho_new,rr] =
+            detail::fused_sweep( policy, begin_index, exts, std::array<T,2>{},
+               [&]( std::array<T,2>& sums, const index_type idx )
+              {
+                  const T si = s(idx);
+                  x(idx) += alpha*p(idx)+omega*si;
+                  const T ri = si-omega*t(idx);
+                  r(idx) = ri;
+                  sums[0] += r_hat(idx)*ri;
+                  sums[1] += ri*ri;
+              } );
+
+         result.residual = double( std::sqrt( rr )/bnorm );
+         if( result.residual<=options.tolerance ){ result.converged=true; break; }
+
+      // breakdown
+         if( omega==T(0) || rho_new==T(0) ){ break; }
+
+         rho_old = rho;
+         rho     = rho_new;
+     }
+
+      return result;
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::gmres
+ *    basis vectors are stored unnormalised, u_j = n_j*v_j, so that a new basis vector does not need a sweep of its own to be normalised
+ *
+ * ===============================================================
+ */
+
+   template<typename ViewFunc,
+            typename        X,
+            indexable       B,
+            ptrdiff_t...   Exts>
+      requires detail::krylov_vectors<X,B>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   solver_result gmres( const execution_policy auto                  policy,
+                        const located_index<index_type_of_t<X>> begin_index,
+                        const stx::extents<Exts...>                    exts,
+                        const linear_operator<ViewFunc>&                  A,
+                              X&                                          x,
+                        const B&                                          b,
+                        const solver_options&                       options = {} )
+  {
+      using T          = std::remove_cvref_t<element_type_of_t<const X&>>;
+      using index_type = index_type_of_t<X>;
+
+      assert( options.restart>=1 );
+      const size_t m = size_t(options.restart);
+
+      std::vector<detail::work_vector_t<X>> u;
+      u.reserve( m+1 );
+      for( size_t j=0; j<=m; ++j ){ u.push_back( detail::work_vector( x ) ); }
+
+      std::vector<T> n( m+1 );                        // norms of the basis vectors
+      std::vector<std::vector<T>> H( m+1, std::vector<T>( m ) );
+      std::vector<T> cs( m ), sn( m ), g( m+1 ), y( m );
+
+      const auto Ax = A( x );
+
+      T bnorm = 0;
+      solver_result result;
+
+      while( true )
+     {
+      // u_0 = b-A*x
+         const auto [rr,bb] =
+            detail::fused_sweep( policy, begin_index, exts, std::array<T,2>{},
+               [&]( std::array<T,2>& sums, const index_type idx )
+              {
+                  const T ri = b(idx)-Ax(idx);
+                  u[0](idx) = ri;
+                  sums[0] += ri*ri;
+                  sums[1] += b(idx)*b(idx);
+              } );
+
+         if( result.iterations==0 ){ bnorm = bb>0 ? std::sqrt( bb ) : T(1); }
+
+         n[0] = std::sqrt( rr );
+         result.residual = double( n[0]/bnorm );
+         if( result.residual<=options.tolerance ){ result.converged=true; break; }
+         if( result.iterations>=options.max_iterations ){ break; }
+
+         std::fill( g.begin(), g.end(), T(0) );
+         g[0] = n[0];
+
+         size_t k=0;   // size of the basis used in this cycle
+         while( k<m && result.iterations<options.max_iterations )
+        {
+            const size_t j=k;
+            ++k;
+            ++result.iterations;
+
+         // w = A*u_j stored in u_{j+1}, and (w,u_i) for i<=j
+            const auto Au = A( u[j] );
+            const auto dots =
+               detail::fused_sweep( policy, begin_index, exts, std::vector<T>( j+1 ),
+                  [&]( std::vector<T>& sums, const index_type idx )
+                 {
+                     const T wi = Au(idx);
+                     u[j+1](idx) = wi;
+                     for( size_t i=0; i<=j; ++i ){ sums[i] += wi*u[i](idx); }
+                 } );
+
+            std::vector<T> scale( j+1 );
+            for( size_t i=0; i<=j; ++i )
+           {
+               H[i][j]  = dots[i]/(n[i]*n[j]);
+               scale[i] = H[i][j]/n[i];
+           }
+
+         // u_{j+1} = w/n_j - sum_i H[i][j]*u_i/n_i, and its norm
+            const T inv_nj = T(1)/n[j];
+            const T unorm2 =
+               detail::fused_sweep( policy, begin_index, exts, std::array<T,1>{},
+                  [&]( std::array<T,1>& sums, const index_type idx )
+                 {
+                     T ui = inv_nj*u[j+1](idx);
+                     for( size_t i=0; i<=j; ++i ){ ui -= scale[i]*u[i](idx); }
+                     u[j+1](idx) = ui;
+                     sums[0] += ui*ui;
+                 } )[0];
+
+            n[j+1]     = std::sqrt( unorm2 );
+            H[j+1][j]  = n[j+1];
+
+         // least-squares problem: rotate the new column of H, and the residual vector g
+            for( size_t i=0; i<j; ++i )
+           {
+               const T h = cs[i]*H[i][j]+sn[i]*H[i+1][j];
+               H[i+1][j] = -sn[i]*H[i][j]+cs[i]*H[i+1][j];
+               H[i][j]   = h;
+           }
+            const T d = std::hypot( H[j][j], H[j+1][j] );
+            cs[j] = d>0 ? H[j][j]/d : T(1);
+            sn[j] = d>0 ? H[j+1][j]/d : T(0);
+            H[j][j]   = d;
+            H[j+1][j] = 0;
+            g[j+1] = -sn[j]*g[j];
+            g[j]   =  cs[j]*g[j];
+
+            result.residual = double( std::abs( g[j+1] )/bnorm );
+
+         // converged, or the Krylov space is invariant (then the least-squares solution is exact)
+            if( result.residual<=options.tolerance || n[j+1]==T(0) ){ break; }
+        }
+
+      // y = H^-1 g, then x += sum_j y_j*u_j/n_j
+         for( size_t i=k; i-->0; )
+        {
+            T sum = g[i];
+            for( size_t l=i+1; l<k; ++l ){ sum -= H[i][l]*y[l]; }
+            y[i] = sum/H[i][i];
+        }
+
+         std::vector<T> coeff( k );
+         for( size_t j=0; j<k; ++j ){ coeff[j] = y[j]/n[j]; }
+
+         (void)detail::fused_sweep( policy, begin_index, exts, std::array<T,0>{},
+            [&]( std::array<T,0>&, const index_type idx )
+           {
+               T dx = 0;
+               for( size_t j=0; j<k; ++j ){ dx += coeff[j]*u[j](idx); }
+               x(idx) += dx;
+           } );
+
+         if( result.residual<=options.tolerance ){ result.converged=true; break; }
+     }
+
+      return result;
+  }
+
+/*
+ * ===============================================================
+ *
+ * if no execution policy is specified, use serial
+ *
+ * ===============================================================
+ */
+
+   template<typename ViewFunc,
+            typename        X,
+            indexable       B,
+            ptrdiff_t...   Exts>
+      requires detail::krylov_vectors<X,B>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   solver_result conjugate_gradient( const located_index<index_type_of_t<X>> begin_index,
+                                     const stx::extents<Exts...>                    exts,
+                                     const linear_operator<ViewFunc>&                  A,
+                                           X&                                          x,
+                                     const B&                                          b,
+                                     const solver_options&                       options = {} )
+  {
+      return conjugate_gradient( execution::seq, begin_index, exts, A, x, b, options );
+  }
+
+   template<typename ViewFunc,
+            typename        X,
+            indexable       B,
+            ptrdiff_t...   Exts>
+      requires detail::krylov_vectors<X,B>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   solver_result bicgstab( const located_index<index_type_of_t<X>> begin_index,
+                           const stx::extents<Exts...>                    exts,
+                           const linear_operator<ViewFunc>&                  A,
+                                 X&                                          x,
+                           const B&                                          b,
+                           const solver_options&                       options = {} )
+  {
+      return bicgstab( execution::seq, begin_index, exts, A, x, b, options );
+  }
+
+   template<typename ViewFunc,
+            typename        X,
+            indexable       B,
+            ptrdiff_t...   Exts>
+      requires detail::krylov_vectors<X,B>
+            && (sizeof...(Exts)==ndim_of_v<X>)
+   solver_result gmres( const located_index<index_type_of_t<X>> begin_index,
+                        const stx::extents<Exts...>                    exts,
+                        const linear_operator<ViewFunc>&                  A,
+                              X&                                          x,
+                        const B&                                          b,
+                        const solver_options&                       options = {} )
+  {
+      return gmres( execution::seq, begin_index, exts, A, x, b, options );
+  }
+}
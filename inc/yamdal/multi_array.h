@@ -0,0 +1,460 @@
+
+# pragma once
+
+# include "blas.h"
+# include "concepts.h"
+# include "type_traits.h"
+# include "index.h"
+# include "span.h"
+# include "execution.h"
+# include "instrument.h"
+
+# include "external/mdspan.h"
+
+# include <new>
+# include <array>
+# include <algorithm>
+# include <tuple>
+# include <memory>
+# include <cstddef>
+# include <cstring>
+# include <utility>
+# include <concepts>
+# include <type_traits>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * yam::multi_reference
+ *    element of a yam::multi_array: a std::tuple of references to each component at one index, so std::get, structured
+ *    bindings and the comparisons of std::tuple apply
+ *    returned by value, and assigns through its references with a const operator=, so it is the destination element of the
+ *    algorithms (see assignable_element)
+ *       q(idx) = std::tuple{ rho, mu, mv, mw, E }, or from any tuple-like value (eg the element of another multi_array)
+ *
+ * ===============================================================
+ */
+
+   template<typename... Ts>
+   class multi_reference
+      : public std::tuple<Ts&...>
+  {
+   public :
+
+      constexpr explicit multi_reference( Ts&... components )
+         : std::tuple<Ts&...>( components... )
+     { }
+
+      constexpr multi_reference( const multi_reference& ) = default;
+
+   // assign the components through the references, not rebind them
+      constexpr const multi_reference& operator=( const multi_reference& other ) const
+     {
+         return assign( other );
+     }
+
+      template<typename Tuple>
+         requires (!std::same_as<std::remove_cvref_t<Tuple>,multi_reference>)
+               && (std::tuple_size<std::remove_cvref_t<Tuple>>::value==sizeof...(Ts))
+      constexpr const multi_reference& operator=( Tuple&& values ) const
+     {
+         return assign( std::forward<Tuple>(values) );
+     }
+
+   private :
+
+      template<typename Tuple>
+      constexpr const multi_reference& assign( Tuple&& values ) const
+     {
+         [&]<size_t... I>( std::index_sequence<I...> )
+        {
+            using std::get;
+            ( (get<I>( *this ) = get<I>( std::forward<Tuple>(values) )), ... );
+        }( std::index_sequence_for<Ts...>{} );
+
+         return *this;
+     }
+  };
+}
+
+// tuple protocol, for structured bindings
+   template<typename... Ts>
+   struct std::tuple_size<yam::multi_reference<Ts...>>
+      : std::integral_constant<size_t,sizeof...(Ts)> {};
+
+   template<size_t       I,
+            typename... Ts>
+   struct std::tuple_element<I,yam::multi_reference<Ts...>>
+      : std::tuple_element<I,std::tuple<Ts&...>> {};
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * yam::basic_multi_array
+ *    Memory-managing class of several components (eg rho, mu, mv, mw, E) with the same extents, in structure of arrays form
+ *    The components are stored as separate contiguous planes (layout_right) in a single allocation, each aligned to
+ *    plane_alignment bytes, so they are allocated, copied and checkpointed (data(), size_bytes()) as a unit
+ *
+ *    as an indexable, returns all the components at an index:
+ *       a multi_reference (non-const access), so algorithms write all components in one sweep, eg yam::transform with
+ *       a function returning a std::tuple of the components
+ *       a std::tuple of const references (const access), so the components of a source are read in one sweep
+ *    each component is also a basic_span, from component<I>(), for kernels needing only some components
+ *
+ *    the components must be trivial types (eg arithmetic types), and are zero initialised like basic_array
+ *
+ * ===============================================================
+ */
+
+// declaration
+   template<typename  Extents,
+            grid_t       GRID,
+            typename...    Ts>
+   class [[nodiscard("yam::basic_multi_array allocates memory so should not be immediately discarded")]]
+   /*class*/ basic_multi_array;
+
+// only allowed specialisation
+   template<ptrdiff_t... Exts,
+            grid_t       GRID,
+            typename...    Ts>
+      requires (sizeof...(Ts)>0)
+            && (std::is_trivial_v<Ts>&&...)
+            && (!std::is_const_v<Ts>&&...)
+   class basic_multi_array<stx::extents<Exts...>,
+                           GRID,
+                           Ts...>
+  {
+   public :
+
+      static constexpr ndim_t ndim = sizeof...(Exts);
+      static constexpr grid_t grid = GRID;
+
+      static constexpr size_t num_components  = sizeof...(Ts);
+      static constexpr size_t plane_alignment = 64;
+
+      using index_type      = index<ndim,grid>;
+      using extents_type    = stx::extents<Exts...>;
+      using layout_type     = default_layout;
+      using mapping_type    = typename layout_type::template mapping<extents_type>;
+      using value_type      = std::tuple<Ts...>;
+      using reference       = multi_reference<Ts...>;
+      using const_reference = std::tuple<const Ts&...>;
+
+      template<size_t I>
+      using component_type = std::tuple_element_t<I,value_type>;
+
+      template<size_t I>
+      using span_type = basic_span<component_type<I>,extents_type,layout_type,default_accessor<component_type<I>>,false,GRID>;
+
+      template<size_t I>
+      using cspan_type = basic_span<component_type<I>,extents_type,layout_type,default_accessor<component_type<I>>,true,GRID>;
+
+   // default operations
+
+      basic_multi_array( basic_multi_array&& ) = default;
+      basic_multi_array& operator=( basic_multi_array&& ) = default;
+      ~basic_multi_array() = default;
+
+   // user defined constructors -------------------------------------------
+
+   // deep copy ctor from another basic_multi_array
+      basic_multi_array( const basic_multi_array& other )
+         : mapping_member( other.mapping_member ),
+           storage( new_storage( mapping_member ) ),
+           planes( make_planes( storage.get(), mapping_member ) )
+     {
+         std::memcpy( storage.get(), other.storage.get(), size_bytes() );
+     }
+
+   // dynamic extent parameter pack
+      template<typename... IndexTypes>
+         requires (sizeof...(IndexTypes) == extents_type::rank_dynamic())
+               && (std::convertible_to<IndexTypes,ptrdiff_t>&&...)
+      explicit basic_multi_array( IndexTypes... dynamic_extents )
+         : basic_multi_array( extents_type( ptrdiff_t(dynamic_extents)... ) )
+     { }
+
+   // dynamic extent array
+      template<typename IndexType,
+               size_t N>
+         requires (N==extents_type::rank_dynamic())
+               && (std::convertible_to<IndexType,ptrdiff_t>)
+      explicit basic_multi_array( const std::array<IndexType,N>& dynamic_extents )
+         : basic_multi_array( extents_type( dynamic_extents ) )
+     { }
+
+      explicit basic_multi_array( const extents_type& exts )
+         : mapping_member( exts ),
+           storage( new_storage( mapping_member ) ),
+           planes( make_planes( storage.get(), mapping_member ) )
+     { }
+
+   // assignment -------------------------------------------
+
+   // deep copy assignment from another basic_multi_array
+      basic_multi_array& operator=( const basic_multi_array& other )
+     {
+         if( !(extents()==other.extents()) )
+        {
+            mapping_member = other.mapping_member;
+            storage = new_storage( mapping_member );
+            planes  = make_planes( storage.get(), mapping_member );
+        }
+
+         std::memcpy( storage.get(), other.storage.get(), size_bytes() );
+         return *this;
+     }
+
+   // element accessors ---------------------------------------------
+
+   // only allow element access with yam::index
+      [[nodiscard]]
+      const_reference operator()( const index_type i ) const
+     {
+         const ptrdiff_t offset = element_offset( i );
+         return std::apply( [offset]( const auto*... p ){ return const_reference( p[offset]... ); }, planes );
+     }
+
+      [[nodiscard]]
+      reference operator()( const index_type i )
+     {
+         const ptrdiff_t offset = element_offset( i );
+         return std::apply( [offset]( auto*... p ){ return reference( p[offset]... ); }, planes );
+     }
+
+   // components, as spans
+      template<size_t I>
+      [[nodiscard]]
+      span_type<I> component()
+     {
+         return span_type<I>( std::get<I>( planes ), mapping_member );
+     }
+
+      template<size_t I>
+      [[nodiscard]]
+      cspan_type<I> component() const
+     {
+         return cspan_type<I>( std::get<I>( planes ), mapping_member );
+     }
+
+   // stx::basic_mdspan-like interface
+
+      [[nodiscard]]
+      constexpr auto mapping() const { return mapping_member; }
+
+      [[nodiscard]]
+      constexpr auto extents() const { return mapping_member.extents(); }
+
+      [[nodiscard]]
+      constexpr auto extent(size_t r) const { return mapping_member.extents().extent(r); }
+
+      [[nodiscard]]
+      constexpr auto stride(size_t r) const { return mapping_member.stride(r); }
+
+      [[nodiscard]]
+      constexpr auto size() const { return num_elems( extents() ); }
+
+      [[nodiscard]]
+      static constexpr auto rank(){ return extents_type::rank(); }
+
+      [[nodiscard]]
+      static constexpr auto rank_dynamic(){ return extents_type::rank_dynamic(); }
+
+      [[nodiscard]]
+      static constexpr auto static_extent(size_t r){ return extents_type::static_extent(r); }
+
+   // the whole allocation, with all the components
+      [[nodiscard]]
+      std::byte* data(){ return storage.get(); }
+
+      [[nodiscard]]
+      const std::byte* data() const { return storage.get(); }
+
+      [[nodiscard]]
+      size_t size_bytes() const { return total_bytes( mapping_member ); }
+
+   private :
+
+      struct aligned_delete
+     {
+         void operator()( std::byte* p ) const { ::operator delete[]( p, std::align_val_t(plane_alignment) ); }
+     };
+
+      using storage_type = std::unique_ptr<std::byte[],aligned_delete>;
+      using planes_type  = std::tuple<Ts*...>;
+
+   // bytes of each plane, padded to the alignment
+      template<typename T>
+      [[nodiscard]]
+      static size_t plane_bytes( const mapping_type& m )
+     {
+         const size_t bytes = size_t( m.required_span_size() )*sizeof(T);
+         return (bytes+plane_alignment-1)/plane_alignment*plane_alignment;
+     }
+
+      [[nodiscard]]
+      static size_t total_bytes( const mapping_type& m )
+     {
+         return (plane_bytes<Ts>( m )+...);
+     }
+
+      [[nodiscard]]
+      static storage_type new_storage( const mapping_type& m )
+     {
+         const size_t bytes = std::max( total_bytes( m ), plane_alignment );
+         storage_type s( static_cast<std::byte*>( ::operator new[]( bytes, std::align_val_t(plane_alignment) ) ) );
+         std::memset( s.get(), 0, bytes );
+         return s;
+     }
+
+      [[nodiscard]]
+      static planes_type make_planes( std::byte* p, const mapping_type& m )
+     {
+         size_t offset = 0;
+         return planes_type{ [&]()
+                            {
+                                Ts* const plane = reinterpret_cast<Ts*>( p+offset );
+                                offset += plane_bytes<Ts>( m );
+                                return plane;
+                            }()... };
+     }
+
+      [[nodiscard]]
+      ptrdiff_t element_offset( const index_type i ) const
+     {
+         return [&]<size_t... r>( std::index_sequence<r...> )
+        {
+            return ptrdiff_t( mapping_member( i[r]... ) );
+        }( std::make_index_sequence<ndim>{} );
+     }
+
+      mapping_type mapping_member;
+      storage_type storage;
+      planes_type  planes;
+  };
+
+
+// convenience typedefs
+
+   template<typename... Ts>
+   using multi_array1 = basic_multi_array<dextents<1>,primal,Ts...>;
+
+   template<typename... Ts>
+   using multi_array2 = basic_multi_array<dextents<2>,primal,Ts...>;
+
+   template<typename... Ts>
+   using multi_array3 = basic_multi_array<dextents<3>,primal,Ts...>;
+
+   template<typename... Ts>
+   using dual_multi_array1 = basic_multi_array<dextents<1>,dual,Ts...>;
+
+   template<typename... Ts>
+   using dual_multi_array2 = basic_multi_array<dextents<2>,dual,Ts...>;
+
+   template<typename... Ts>
+   using dual_multi_array3 = basic_multi_array<dextents<3>,dual,Ts...>;
+
+/*
+ * ===============================================================
+ *
+ * yam::assign to a multi_array (and so yam::transform to a multi_array)
+ *    the range is assigned in segments of multi_array_segment_length indices along the last axis: the source is evaluated
+ *    into a local array of each component, and each component is then stored with its own loop
+ *    so the compiler need not check the planes of the destination for aliasing against each other and the sources, which
+ *    it does not do for more than a few planes, and both loops vectorise
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      inline constexpr idx_t multi_array_segment_length = 32;
+
+      template<typename  MultiArray,
+               typename      Source,
+               typename       Index,
+               ptrdiff_t...    Exts>
+      void assign_multi_array( const execution_policy auto       policy,
+                               const Index                  begin_index,
+                               const stx::extents<Exts...>         exts,
+                                     MultiArray&            destination,
+                               const Source&                     source )
+     {
+         constexpr ndim_t last = Index::ndim-1;
+         constexpr size_t L    = size_t(multi_array_segment_length);
+
+         for_each_segment<multi_array_segment_length>( policy, begin_index, exts,
+            [&]( const Index start, const idx_t count )
+           {
+               [&]<size_t... c>( std::index_sequence<c...> )
+              {
+                  std::tuple<std::array<typename MultiArray::template component_type<c>,L>...> values;
+
+                  Index idx = start;
+                  for( idx_t k=0; k<count; ++k, ++idx[last] )
+                 {
+                     const auto& v = source(idx);
+                     ( (std::get<c>( values )[size_t(k)] = std::get<c>( v )), ... );
+                 }
+
+                  ( [&]( auto* const p, const auto& component )
+                   {
+                       for( idx_t k=0; k<count; ++k ){ p[k] = component[size_t(k)]; }
+                   }( std::addressof( destination.template component<c>()(start) ), std::get<c>( values ) ), ... );
+              }( std::make_index_sequence<MultiArray::num_components>{} );
+           } );
+     }
+  }
+
+   template<ptrdiff_t...  DExts,
+            grid_t         GRID,
+            typename...      Ts,
+            indexable    Source,
+            ptrdiff_t...   Exts>
+      requires same_grid_as<basic_multi_array<stx::extents<DExts...>,GRID,Ts...>,
+                            Source>
+            && assignable_element<multi_reference<Ts...>,
+                                  element_type_of_t<Source>>
+            && (sizeof...(Exts)==sizeof...(DExts))
+   void assign(       execution::serial_policy                                                 policy,
+                const located_index<index_type_of_t<Source>>                              begin_index,
+                const stx::extents<Exts...>                                                      exts,
+                      basic_multi_array<stx::extents<DExts...>,GRID,Ts...>&               destination,
+                const Source&                                                                  source )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "assign", policy,
+                                            begin_index, exts,
+                                            (sizeof(Ts)+...)+instrument::bytes_per_elem<Source>() );
+
+      detail::assign_multi_array( policy, index_type_of_t<Source>{begin_index}, exts, destination, source );
+  }
+
+   template<ptrdiff_t...  DExts,
+            grid_t         GRID,
+            typename...      Ts,
+            indexable    Source,
+            ptrdiff_t...   Exts>
+      requires same_grid_as<basic_multi_array<stx::extents<DExts...>,GRID,Ts...>,
+                            Source>
+            && assignable_element<multi_reference<Ts...>,
+                                  element_type_of_t<Source>>
+            && (sizeof...(Exts)==sizeof...(DExts))
+   void assign(       execution::openmp_policy                                                 policy,
+                const located_index<index_type_of_t<Source>>                              begin_index,
+                const stx::extents<Exts...>                                                      exts,
+                      basic_multi_array<stx::extents<DExts...>,GRID,Ts...>&               destination,
+                const Source&                                                                  source )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "assign", policy,
+                                            begin_index, exts,
+                                            (sizeof(Ts)+...)+instrument::bytes_per_elem<Source>() );
+
+      detail::assign_multi_array( policy, index_type_of_t<Source>{begin_index}, exts, destination, source );
+  }
+}
@@ -0,0 +1,224 @@
+
+# pragma once
+
+# include "algorithm.h"
+# include "views.h"
+# include "concepts.h"
+# include "type_traits.h"
+# include "index.h"
+# include "execution.h"
+# include "instrument.h"
+
+# include "external/mdspan.h"
+
+# include <array>
+# include <utility>
+# include <concepts>
+# include <type_traits>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * Multigrid transfer operators between a fine grid and a coarse grid of half resolution
+ *    primal (node centred): coarse node I coincides with fine node 2*I
+ *       restrict_full_weighting: weights 1/4,1/2,1/4 along each axis around fine node 2*I (3^ndim points)
+ *       prolong_linear:          fine nodes 2*I are copied, others are averaged from the 2,4 or 8 coarse nodes around them
+ *    dual (cell centred): coarse cell I covers fine cells 2*I+c, c in {0,1} along each axis
+ *       restrict_full_weighting: average of the 2^ndim fine cells
+ *       prolong_linear:          weights 3/4 for the coarse cell and 1/4 for its neighbour on the side of the fine cell, along each axis
+ *    both reproduce linear functions (away from boundaries), and the dual restriction is conservative
+ *
+ *    restrict_full_weighting( fine ) and prolong_linear( coarse ) are lazy views on the coarse and fine grids
+ *    the eager versions fill a range of the destination
+ *       restriction assigns the view, so it has the same (tiled) parallel implementations as assign
+ *       prolongation interpolates one fine row at a time from a buffer row, so it does not branch on the position
+ *       of each fine index in its coarse cell across all the axes
+ *
+ *    the source is read around the stencil of each destination index:
+ *       fine   [2*I-1,2*I+1] (primal) or [2*I,2*I+1] (dual) for restriction
+ *       coarse [floor(i/2),floor(i/2)+1] (primal) or [floor(i/2)-1,floor(i/2)+1] (dual) for prolongation
+ *    so the ranges should leave room for any boundary (ghost) layers the source does not have
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+   // (1/4,1/2,1/4) along each axis, for the offsets of neighbourhood_offsets
+      template<typename T,
+               size_t  ndim>
+      [[nodiscard]]
+      constexpr auto full_weighting_weights()
+     {
+         constexpr auto points = neighbourhood_offsets<ndim>();
+
+         std::array<T,points.size()> weights{};
+         for( size_t k=0; k<points.size(); ++k )
+        {
+            weights[k] = T(1);
+            for( size_t r=0; r<ndim; ++r ){ weights[k] *= points[k][r]==0 ? T(0.5) : T(0.25); }
+        }
+         return weights;
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * lazy views
+ *
+ * ===============================================================
+ */
+
+/*
+ * full weighting restriction of a fine indexable, on the coarse grid
+ */
+   template<indexable I>
+   [[nodiscard]]
+   constexpr view auto restrict_full_weighting( const I& fine )
+  {
+      using value_type = detail::stencil_value_t<I>;
+
+      constexpr ndim_t ndim = ndim_of_v<I>;
+
+      if constexpr( grid_of_v<I> == primal )
+     {
+         constexpr auto offsets = [](){ return detail::neighbourhood_offsets<ndim>(); };
+
+         return detail::stencil<primal,decltype(offsets),2>( fine, detail::full_weighting_weights<value_type,ndim>() );
+     }
+      else
+     {
+         constexpr auto mask = detail::axis_mask<ndim>();
+         constexpr size_t ncorners = detail::num_corners( mask );
+         constexpr auto offsets = [](){ return detail::corner_offsets<ncorners>( mask, 1 ); };
+
+         std::array<value_type,ncorners> weights;
+         weights.fill( value_type(1)/value_type(ncorners) );
+
+         return detail::stencil<dual,decltype(offsets),2>( fine, weights );
+     }
+  }
+
+/*
+ * linear (bilinear, trilinear) prolongation of a coarse indexable, on the fine grid
+ */
+   template<indexable I>
+   [[nodiscard]]
+   constexpr view auto prolong_linear( const I& coarse )
+  {
+      using value_type = detail::stencil_value_t<I>;
+      using index_type = index_type_of_t<I>;
+
+      constexpr ndim_t ndim = ndim_of_v<I>;
+      constexpr grid_t grid = grid_of_v<I>;
+
+      static_assert( std::floating_point<value_type>, "multigrid transfer operators need floating point elements" );
+
+      return [&coarse]
+            ( const index_type i ) -> value_type
+           {
+               std::array<std::array<idx_t,2>,ndim>      points;
+               std::array<std::array<value_type,2>,ndim> weights;
+               std::array<int,ndim>                      npoints;
+               for( ndim_t r=0; r<ndim; ++r ){ npoints[r] = detail::linear_prolongation_1d<grid>( i[r], points[r], weights[r] ); }
+
+               value_type sum(0);
+               for( unsigned corner=0; corner<(1u<<ndim); ++corner )
+              {
+                  index_type point;
+                  value_type w(1);
+                  bool used=true;
+                  for( ndim_t r=0; r<ndim; ++r )
+                 {
+                     const unsigned b = (corner>>r)&1u;
+                     used = used && int(b)<npoints[r];
+                     point[r] = points[r][b];
+                     w       *= weights[r][b];
+                 }
+                  if( used ){ sum += w*coarse(point); }
+              }
+               return sum;
+           };
+  }
+
+/*
+ * ===============================================================
+ *
+ * eager versions
+ *    restrict_full_weighting: coarse(I) for each coarse index I in range [begin_index,begin_index+extents)
+ *    prolong_linear:          fine(i) for each fine index i in range [begin_index,begin_index+extents)
+ *
+ * ===============================================================
+ */
+
+   template<indexable      Coarse,
+            indexable        Fine,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Coarse,
+                            Fine>
+            && (sizeof...(Exts)==ndim_of_v<Fine>)
+   void restrict_full_weighting( const execution_policy auto                       policy,
+                                 const located_index<index_type_of_t<Fine>>   begin_index,
+                                 const stx::extents<Exts...>                         exts,
+                                       Coarse&&                                    coarse,
+                                 const Fine&                                         fine )
+  {
+      assign( policy, begin_index, exts, coarse, restrict_full_weighting( fine ) );
+  }
+
+   template<indexable        Fine,
+            indexable      Coarse,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Fine,
+                            Coarse>
+            && (sizeof...(Exts)==ndim_of_v<Fine>)
+   void prolong_linear( const execution_policy auto                       policy,
+                        const located_index<index_type_of_t<Fine>>   begin_index,
+                        const stx::extents<Exts...>                         exts,
+                              Fine&&                                        fine,
+                        const Coarse&                                     coarse )
+  {
+      static_assert( std::floating_point<detail::stencil_value_t<Coarse>>, "multigrid transfer operators need floating point elements" );
+
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "prolong_linear", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Fine,Coarse>() );
+
+      detail::prolong_linear_into( policy, index_type_of_t<Fine>{begin_index}, exts, fine, coarse );
+  }
+
+/*
+ * if no execution policy is specified, use serial
+ */
+   template<indexable      Coarse,
+            indexable        Fine,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Coarse,
+                            Fine>
+            && (sizeof...(Exts)==ndim_of_v<Fine>)
+   void restrict_full_weighting( const located_index<index_type_of_t<Fine>>   begin_index,
+                                 const stx::extents<Exts...>                         exts,
+                                       Coarse&&                                    coarse,
+                                 const Fine&                                         fine )
+  {
+      restrict_full_weighting( execution::seq, begin_index, exts, std::forward<Coarse>(coarse), fine );
+  }
+
+   template<indexable        Fine,
+            indexable      Coarse,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Fine,
+                            Coarse>
+            && (sizeof...(Exts)==ndim_of_v<Fine>)
+   void prolong_linear( const located_index<index_type_of_t<Fine>>   begin_index,
+                        const stx::extents<Exts...>                         exts,
+                              Fine&&                                        fine,
+                        const Coarse&                                     coarse )
+  {
+      prolong_linear( execution::seq, begin_index, exts, std::forward<Fine>(fine), coarse );
+  }
+}
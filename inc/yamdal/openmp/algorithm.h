@@ -6,6 +6,7 @@
 # include "../index.h"
 # include "../execution.h"
 # include "../utility.h"
+# include "../instrument.h"
 
 # include "../serial/algorithm.h"
 # include "../external/mdspan.h"
@@ -14,6 +15,10 @@
 # include <functional>
 # include <concepts>
 # include <vector>
+# include <optional>
+# include <array>
+# include <atomic>
+# include <algorithm>
 
 # include <omp.h>
 
@@ -29,20 +34,55 @@ namespace yam
             ptrdiff_t... Exts>
       requires same_grid_as<Destination,
                             Source>
-            && std::assignable_from<element_type_of_t<Destination>,
-                                    element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
             && (sizeof...(Exts)==ndim_of_v<Source>)
    void assign(       execution::openmp_policy,
-                const index_type_of_t<Source> begin_index,
-                const stx::extents<Exts...>          exts,
-                      Destination&            destination,
-                const Source&                      source )
+                const located_index<index_type_of_t<Source>> begin_index,
+                const stx::extents<Exts...>                         exts,
+                      Destination&                           destination,
+                const Source&                                     source )
   {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "assign", execution::openmp,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Destination,Source>() );
+
       using index_type = index_type_of_t<Source>;
 
+   // a transpose is split along i in blocks of whole tiles, so each thread keeps the tiled traversal
+      if( detail::is_transposing<sizeof...(Exts)>( destination, source ) )
+     {
+         const idx_t tile = detail::transpose_tile;
+
+      # pragma omp parallel for
+         for( idx_t i=0; i<exts.extent(0); i+=tile )
+        {
+            [[maybe_unused]]
+            const instrument::nested_scope nested;
+
+            index_type block_begin{begin_index};
+            block_begin[0]+=i;
+
+            std::array<idx_t,sizeof...(Exts)> block_exts{};
+            for( ndim_t d=0; d<sizeof...(Exts); ++d ){ block_exts[d] = exts.extent(d); }
+            block_exts[0] = std::min( tile, exts.extent(0)-i );
+
+            assign( execution::seq,
+                    block_begin,
+                    dextents<sizeof...(Exts)>(block_exts),
+                    destination,
+                    source );
+        }
+         return;
+     }
+
    # pragma omp parallel for
       for( idx_t i=0; i<exts.extent(0); ++i )
      {
+         [[maybe_unused]]
+         const instrument::nested_scope nested;
+
       // create block of only one i index, and all j,k,... etc indices
          index_type block_begin{begin_index};
          block_begin[0]+=i;
@@ -75,12 +115,12 @@ namespace yam
             && std::default_initializable<ReduceFunc>
    [[nodiscard]]
    ReduceType reduce(       execution::openmp_policy,
-                      const index_type_of_t<Source> begin_index,
-                      const stx::extents<Exts...>          exts,
-                            ReduceFunc              reduce_func,
-                            ReduceType               identity_v,
-                            ReduceType                     init,
-                      const Source&                      source )
+                      const located_index<index_type_of_t<Source>> begin_index,
+                      const stx::extents<Exts...>                         exts,
+                            ReduceFunc                             reduce_func,
+                            ReduceType                              identity_v,
+                            ReduceType                                    init,
+                      const Source&                                     source )
   {
 # pragma omp declare reduction( \
    my_reduce : \
@@ -88,6 +128,11 @@ namespace yam
    omp_out = ReduceFunc{}( omp_out, omp_in ) ) \
    initializer ( omp_priv = omp_orig )
 
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "reduce", execution::openmp,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source>() );
+
       using index_type = index_type_of_t<Source>;
 
    // thread local value for reduction
@@ -96,6 +141,9 @@ namespace yam
 # pragma omp parallel for reduction(my_reduce:local_val)
       for( idx_t i=0; i<exts.extent(0); ++i )
      {
+         [[maybe_unused]]
+         const instrument::nested_scope nested;
+
       // create block of only one i index, and all j,k,... etc indices
          index_type block_begin{begin_index};
          block_begin[0]+=i;
@@ -109,8 +157,7 @@ namespace yam
                     block_begin,
                     block_exts,
                     reduce_func,
-                    local_val,
-                    identity_v,
+                    std::move(local_val),
                     source );
      }
 
@@ -130,12 +177,17 @@ namespace yam
             && ( sizeof...(Exts) == 1 )
    [[nodiscard]]
    ReduceType reduce(       execution::openmp_policy,
-                      const index_type_of_t<Source> begin_index,
-                      const stx::extents<Exts...>          exts,
-                            ReduceFunc              reduce_func,
-                            ReduceType                     init,
-                      const Source&                      source )
+                      const located_index<index_type_of_t<Source>> begin_index,
+                      const stx::extents<Exts...>                         exts,
+                            ReduceFunc                             reduce_func,
+                            ReduceType                                    init,
+                      const Source&                                     source )
   {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "reduce", execution::openmp,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source>() );
+
    // reduce functor using std::invoke
       auto rfunc =
          [&]( auto&& arg0, auto&& arg1 )
@@ -201,4 +253,1012 @@ namespace yam
 
       return init;
   }
+
+/*
+ * OpenMP for_each_index
+ *    func is called concurrently for different indices
+ */
+   template<typename      Index,
+            typename       Func,
+            ptrdiff_t...   Exts>
+      requires is_index_type_v<Index>
+            && (sizeof...(Exts)==Index::ndim)
+            && std::invocable<Func&,Index>
+   void for_each_index(       execution::openmp_policy,
+                        const Index                       begin_index,
+                        const stx::extents<Exts...>              exts,
+                              Func&&                             func )
+  {
+   # pragma omp parallel for
+      for( idx_t i=0; i<exts.extent(0); ++i )
+     {
+      // create block of only one i index, and all j,k,... etc indices
+         Index block_begin{begin_index};
+         block_begin[0]+=i;
+
+      // make the 0th extent a static size of 1
+         const auto block_exts = replace_nth_extent<0,1>(exts);
+
+         for_each_index( execution::seq,
+                         block_begin,
+                         block_exts,
+                         func );
+     }
+
+      return;
+  }
+
+   namespace detail
+  {
+   /*
+    * OpenMP accumulate
+    *    each thread accumulates its share of the outermost axis into its own copy of identity_v,
+    *    and the copies are combined into acc in thread order after the parallel region
+    */
+      template<typename AccumulateFunc,
+               typename    CombineFunc,
+               typename AccumulateType,
+               typename         Source,
+               ptrdiff_t...       Exts>
+      void accumulate_in_place(       execution::openmp_policy,
+                                const index_type_of_t<Source>             begin_index,
+                                const stx::extents<Exts...>                      exts,
+                                      AccumulateFunc&                 accumulate_func,
+                                      CombineFunc&                       combine_func,
+                                const AccumulateType&                      identity_v,
+                                      AccumulateType&                             acc,
+                                const Source&                                  source )
+     {
+         using index_type = index_type_of_t<Source>;
+
+      // optional, so AccumulateType does not need to be default constructible
+         std::vector<std::optional<AccumulateType>> thread_acc;
+
+   # pragma omp parallel
+        {
+   # pragma omp single
+           {
+               thread_acc.resize( size_t(omp_get_num_threads()) );
+           }
+
+         // private accumulator, moved to the shared vector once finished
+            AccumulateType my_acc = identity_v;
+
+   # pragma omp for schedule(static) nowait
+            for( idx_t i=0; i<exts.extent(0); ++i )
+           {
+               index_type block_begin{begin_index};
+               block_begin[0]+=i;
+
+               accumulate_in_place( execution::seq,
+                                    block_begin,
+                                    replace_nth_extent<0,1>(exts),
+                                    accumulate_func,
+                                    my_acc,
+                                    source );
+           }
+
+            thread_acc[size_t(omp_get_thread_num())].emplace( std::move(my_acc) );
+        }
+
+         for( const auto& partial : thread_acc ){ std::invoke( combine_func, acc, *partial ); }
+     }
+  }
+
+   namespace detail
+  {
+   /*
+    * OpenMP whole-range scan, two-pass blocked algorithm
+    *    the row-major range is split into one contiguous block per thread
+    *    1) each thread reduces its block
+    *    2) the block results are scanned serially, giving the starting value of each block
+    *    3) each thread scans its block from its starting value
+    */
+      template<bool      is_inclusive,
+               typename   Destination,
+               typename      ScanFunc,
+               typename      ScanType,
+               typename        Source,
+               ptrdiff_t...      Exts>
+      void scan(       execution::openmp_policy,
+                 const located_index<index_type_of_t<Source>> begin_index,
+                 const stx::extents<Exts...>                         exts,
+                       Destination&                           destination,
+                       ScanFunc&                                scan_func,
+                 const std::optional<ScanType>&                      init,
+                 const Source&                                     source )
+     {
+         [[maybe_unused]]
+         const instrument::kernel_scope scope( is_inclusive ? "inclusive_scan" : "exclusive_scan",
+                                               execution::openmp,
+                                               begin_index, exts,
+                                               instrument::bytes_per_elem<Destination,Source>() );
+
+         using index_type = index_type_of_t<Source>;
+         constexpr ndim_t ndim = index_type::ndim;
+
+         const idx_t n = idx_t(num_elems(exts));
+
+         if( n==0 ){ return; }
+
+      // index of the l-th element of the range in row-major order
+         const auto unravel =
+            [&]( idx_t l ) -> index_type
+           {
+               index_type idx{begin_index};
+               for( ndim_t r=ndim; r-->0; )
+              {
+                  idx[r] += l%exts.extent(r);
+                  l /= exts.extent(r);
+              }
+               return idx;
+           };
+
+      // next index in row-major order
+         const auto advance =
+            [&]( index_type& idx )
+           {
+               for( ndim_t r=ndim; r-->0; )
+              {
+                  if( ++idx[r] < begin_index[r]+exts.extent(r) ){ return; }
+                  idx[r] = begin_index[r];
+              }
+           };
+
+      // result of each block, and starting value of each block
+         std::vector<std::optional<ScanType>> block_result;
+         std::vector<std::optional<ScanType>> block_start;
+
+# pragma omp parallel
+        {
+            const idx_t nthreads  = omp_get_num_threads();
+            const idx_t thread_id = omp_get_thread_num();
+
+   # pragma omp single
+           {
+               block_result.resize(size_t(nthreads));
+               block_start.resize(size_t(nthreads));
+           }
+
+         // this thread's block [lo,hi) of the row-major range
+            const idx_t lo = (n*thread_id)/nthreads;
+            const idx_t hi = (n*(thread_id+1))/nthreads;
+
+         // 1) reduce block
+            if( lo<hi )
+           {
+               index_type idx = unravel(lo);
+
+               ScanType acc( source(idx) );
+               for( idx_t l=lo+1; l<hi; ++l )
+              {
+                  advance(idx);
+                  acc = std::invoke( scan_func, std::move(acc), source(idx) );
+              }
+               block_result[size_t(thread_id)].emplace( std::move(acc) );
+           }
+
+   # pragma omp barrier
+
+         // 2) scan block results
+   # pragma omp single
+           {
+               std::optional<ScanType> carry = init;
+               for( idx_t b=0; b<nthreads; ++b )
+              {
+                  block_start[size_t(b)] = carry;
+
+                  auto& result = block_result[size_t(b)];
+                  if( !result ){ continue; }
+
+                  if( carry ){ carry.emplace( std::invoke( scan_func, std::move(*carry), std::move(*result) ) ); }
+                  else       { carry.emplace( std::move(*result) ); }
+              }
+           }
+
+         // 3) scan block from starting value
+            if( lo<hi )
+           {
+               index_type idx = unravel(lo);
+               idx_t l = lo;
+
+               auto& start = block_start[size_t(thread_id)];
+
+            // only the first block of an inclusive scan without init has no starting value
+               if( !start )
+              {
+                  start.emplace( source(idx) );
+                  destination(idx) = *start;
+                  advance(idx);
+                  ++l;
+              }
+
+               ScanType& acc = *start;
+               for( ; l<hi; ++l )
+              {
+                  scan_step<is_inclusive>( destination, scan_func, acc, source, idx );
+                  advance(idx);
+              }
+           }
+        }
+     }
+
+   /*
+    * OpenMP scan along each line of the range in direction Axis
+    *    lines are independent, so the range is split over a dimension other than Axis and each thread scans its lines serially
+    *    a 1D range has a single line, which uses the whole-range scan
+    */
+      template<ndim_t           Axis,
+               bool      is_inclusive,
+               typename   Destination,
+               typename      ScanFunc,
+               typename      ScanType,
+               typename        Source,
+               ptrdiff_t...      Exts>
+      void scan_axis(       execution::openmp_policy                policy,
+                      const located_index<index_type_of_t<Source>> begin_index,
+                      const stx::extents<Exts...>                         exts,
+                            Destination&                           destination,
+                            ScanFunc&                                scan_func,
+                      const std::optional<ScanType>&                      init,
+                      const Source&                                     source )
+     {
+         if constexpr( sizeof...(Exts)==1 )
+        {
+            scan<is_inclusive>( policy, begin_index, exts,
+                                destination, scan_func,
+                                init, source );
+        }
+         else
+        {
+            [[maybe_unused]]
+            const instrument::kernel_scope scope( is_inclusive ? "inclusive_scan" : "exclusive_scan",
+                                                  execution::openmp,
+                                                  begin_index, exts,
+                                                  instrument::bytes_per_elem<Destination,Source>() );
+
+            using index_type = index_type_of_t<Source>;
+
+         // dimension to split over threads
+            constexpr ndim_t split = (Axis==0) ? 1 : 0;
+
+         # pragma omp parallel for
+            for( idx_t i=0; i<exts.extent(split); ++i )
+           {
+               [[maybe_unused]]
+               const instrument::nested_scope nested;
+
+               index_type block_begin{begin_index};
+               block_begin[split]+=i;
+
+               const auto block_exts = replace_nth_extent<split,1>(exts);
+
+               scan_axis<Axis,is_inclusive>( execution::seq,
+                                             block_begin, block_exts,
+                                             destination, scan_func,
+                                             init, source );
+           }
+        }
+     }
+  }
+
+/*
+ * OpenMP reduce_axis
+ *    output points are split over the threads along the outermost (largest stride) axis that is not reduced,
+ *    so each thread writes distinct destination elements, and each thread reduces its slab serially
+ */
+   template<ndim_t...           Axes,
+            indexable    Destination,
+            typename      ReduceFunc,
+            typename      ReduceType,
+            indexable         Source,
+            ptrdiff_t...        Exts>
+      requires (grid_of_v<Destination> == grid_of_v<Source>)
+            && reduction<ReduceFunc,
+                         ReduceType,
+                         element_type_of_t<Source>>
+            && transformation_r<ReduceFunc,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  ReduceType&&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+            && (sizeof...(Axes)>0)
+            && (ndim_of_v<Destination>+sizeof...(Axes)==ndim_of_v<Source>)
+            && (detail::valid_axes<ndim_of_v<Source>,Axes...>())
+   void reduce_axis(       execution::openmp_policy,
+                     const located_index<index_type_of_t<Source>> begin_index,
+                     const stx::extents<Exts...>                         exts,
+                           Destination&                           destination,
+                           ReduceFunc                             reduce_func,
+                           ReduceType                                    init,
+                     const Source&                                     source )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "reduce_axis", execution::openmp,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source>() );
+
+      using index_type = index_type_of_t<Source>;
+      constexpr ndim_t ndim = index_type::ndim;
+
+      const auto order = detail::memory_order<ndim>(source);
+
+   // outermost axis which is not reduced
+      ndim_t split = order[0];
+      for( const ndim_t d : order )
+     {
+         if( !((d==Axes)||...) ){ split=d; break; }
+     }
+
+      std::array<idx_t,ndim> slab_exts{};
+      for( ndim_t d=0; d<ndim; ++d ){ slab_exts[d] = exts.extent(d); }
+      slab_exts[split] = 1;
+
+   # pragma omp parallel for
+      for( idx_t i=0; i<exts.extent(split); ++i )
+     {
+         [[maybe_unused]]
+         const instrument::nested_scope nested;
+
+         index_type slab_begin{begin_index};
+         slab_begin[split]+=i;
+
+         reduce_axis<Axes...>( execution::seq,
+                               slab_begin,
+                               dextents<ndim>(slab_exts),
+                               destination,
+                               reduce_func,
+                               init,
+                               source );
+     }
+
+      return;
+  }
+
+   namespace detail
+  {
+   /*
+    * OpenMP argmin/argmax and top_k
+    *    each thread selects candidates from its share of the outermost axis into a private result,
+    *    and the per-thread results are merged after the parallel region
+    */
+      template<typename   Compare,
+               typename    Source,
+               ptrdiff_t...  Exts>
+      auto arg_extremum(       execution::openmp_policy,
+                         const index_type_of_t<Source>             begin_index,
+                         const stx::extents<Exts...>                      exts,
+                               Compare                                 compare,
+                         const Source&                                  source )
+         -> std::optional<selected_type_t<Source>>
+     {
+         using index_type  = index_type_of_t<Source>;
+         using result_type = std::optional<selected_type_t<Source>>;
+
+         std::vector<result_type> thread_best;
+
+   # pragma omp parallel
+        {
+   # pragma omp single
+           {
+               thread_best.resize( size_t(omp_get_num_threads()) );
+           }
+
+            result_type my_best;
+
+   # pragma omp for schedule(static) nowait
+            for( idx_t i=0; i<exts.extent(0); ++i )
+           {
+               index_type block_begin{begin_index};
+               block_begin[0]+=i;
+
+               select_best( compare, my_best,
+                            arg_extremum( execution::seq,
+                                          block_begin,
+                                          replace_nth_extent<0,1>(exts),
+                                          compare,
+                                          source ) );
+           }
+
+            thread_best[size_t(omp_get_thread_num())] = std::move(my_best);
+        }
+
+         result_type best;
+         for( const auto& candidate : thread_best ){ select_best( compare, best, candidate ); }
+
+         return best;
+     }
+
+      template<typename   Compare,
+               typename    Source,
+               ptrdiff_t...  Exts>
+      void top_k(       execution::openmp_policy,
+                  const index_type_of_t<Source>             begin_index,
+                  const stx::extents<Exts...>                      exts,
+                        top_k_heap<index_type_of_t<Source>,
+                                   selected_value_t<Source>,
+                                   Compare>&                        heap,
+                  const Source&                                  source )
+     {
+         using index_type = index_type_of_t<Source>;
+         using heap_type  = std::remove_reference_t<decltype(heap)>;
+
+         std::vector<heap_type> thread_heaps;
+
+   # pragma omp parallel
+        {
+   # pragma omp single
+           {
+               thread_heaps.assign( size_t(omp_get_num_threads()), heap.empty_copy() );
+           }
+
+         // private heap, moved to the shared vector once finished
+            heap_type my_heap = heap.empty_copy();
+
+   # pragma omp for schedule(static) nowait
+            for( idx_t i=0; i<exts.extent(0); ++i )
+           {
+               index_type block_begin{begin_index};
+               block_begin[0]+=i;
+
+               top_k( execution::seq,
+                      block_begin,
+                      replace_nth_extent<0,1>(exts),
+                      my_heap,
+                      source );
+           }
+
+            thread_heaps[size_t(omp_get_thread_num())] = std::move(my_heap);
+        }
+
+         for( const auto& thread_heap : thread_heaps ){ heap.merge( thread_heap ); }
+     }
+  }
+
+   namespace detail
+  {
+   /*
+    * OpenMP histogram and binned_statistic
+    *    privatised: each thread accumulates its share of the outermost axis into its own bins,
+    *       which are then summed over the threads in parallel over the bins
+    *    atomic: the threads accumulate into the shared bins, histogram with relaxed atomic updates and
+    *       binned_statistic with Welford updates under a spin lock per bin, so it is as accurate as privatised
+    *       (sums of values and their squares could be updated atomically, but the variance formed from them cancels for values with a large mean)
+    */
+      template<binning      Bins,
+               typename   Source,
+               ptrdiff_t... Exts>
+      void histogram(       execution::openmp_policy,
+                      const index_type_of_t<Source>             begin_index,
+                      const stx::extents<Exts...>                      exts,
+                      const Bins&                                      bins,
+                            histogram_mode                             mode,
+                            std::vector<size_t>&                     counts,
+                      const Source&                                  source )
+     {
+         using index_type = index_type_of_t<Source>;
+         using value_type = typename Bins::value_type;
+
+         const size_t nbins = bins.size();
+
+         if( use_atomic_bins( mode, nbins ) )
+        {
+   # pragma omp parallel for
+            for( idx_t i=0; i<exts.extent(0); ++i )
+           {
+               index_type block_begin{begin_index};
+               block_begin[0]+=i;
+
+               for_each_index( execution::seq, block_begin, replace_nth_extent<0,1>(exts),
+                  [&]( const index_type idx )
+                 {
+                     const size_t b = bins.bin( value_type( source(idx) ) );
+                     if( b<nbins ){ std::atomic_ref<size_t>( counts[b] ).fetch_add( 1, std::memory_order_relaxed ); }
+                 } );
+           }
+            return;
+        }
+
+         std::vector<std::vector<size_t>> thread_counts;
+
+   # pragma omp parallel
+        {
+   # pragma omp single
+           {
+               thread_counts.resize( size_t(omp_get_num_threads()) );
+           }
+
+         // each thread allocates (and first touches) its own bins
+            auto& my_counts = thread_counts[size_t(omp_get_thread_num())];
+            my_counts.assign( nbins, 0 );
+
+   # pragma omp for schedule(static)
+            for( idx_t i=0; i<exts.extent(0); ++i )
+           {
+               index_type block_begin{begin_index};
+               block_begin[0]+=i;
+
+               histogram( execution::seq, block_begin, replace_nth_extent<0,1>(exts),
+                          bins, mode, my_counts, source );
+           }
+
+   # pragma omp for schedule(static)
+            for( size_t b=0; b<nbins; ++b )
+           {
+               for( const auto& tc : thread_counts ){ counts[b] += tc[b]; }
+           }
+        }
+     }
+
+      template<binning      Bins,
+               typename        T,
+               typename     Keys,
+               typename   Values,
+               ptrdiff_t... Exts>
+      void binned_statistic(       execution::openmp_policy,
+                             const index_type_of_t<Keys>               begin_index,
+                             const stx::extents<Exts...>                      exts,
+                             const Bins&                                      bins,
+                                   histogram_mode                             mode,
+                                   std::vector<bin_statistics<T>>&           stats,
+                             const Keys&                                      keys,
+                             const Values&                                  values )
+     {
+         using index_type = index_type_of_t<Keys>;
+         using value_type = typename Bins::value_type;
+
+         const size_t nbins = bins.size();
+
+         if( use_atomic_bins( mode, nbins ) )
+        {
+            std::vector<std::atomic_flag> locks(nbins);
+
+   # pragma omp parallel for
+            for( idx_t i=0; i<exts.extent(0); ++i )
+           {
+               index_type block_begin{begin_index};
+               block_begin[0]+=i;
+
+               for_each_index( execution::seq, block_begin, replace_nth_extent<0,1>(exts),
+                  [&]( const index_type idx )
+                 {
+                     const size_t b = bins.bin( value_type( keys(idx) ) );
+                     if( b<nbins )
+                    {
+                        const T x = T( values(idx) );
+
+                        while( locks[b].test_and_set( std::memory_order_acquire ) )
+                       {
+                           while( locks[b].test( std::memory_order_relaxed ) ){}
+                       }
+                        stats[b].add( x );
+                        locks[b].clear( std::memory_order_release );
+                    }
+                 } );
+           }
+            return;
+        }
+
+         std::vector<std::vector<bin_statistics<T>>> thread_stats;
+
+   # pragma omp parallel
+        {
+   # pragma omp single
+           {
+               thread_stats.resize( size_t(omp_get_num_threads()) );
+           }
+
+            auto& my_stats = thread_stats[size_t(omp_get_thread_num())];
+            my_stats.assign( nbins, {} );
+
+   # pragma omp for schedule(static)
+            for( idx_t i=0; i<exts.extent(0); ++i )
+           {
+               index_type block_begin{begin_index};
+               block_begin[0]+=i;
+
+               binned_statistic( execution::seq, block_begin, replace_nth_extent<0,1>(exts),
+                                 bins, mode, my_stats, keys, values );
+           }
+
+         // merged in thread order, so the result does not depend on the schedule of the merge
+   # pragma omp for schedule(static)
+            for( size_t b=0; b<nbins; ++b )
+           {
+               for( const auto& ts : thread_stats ){ stats[b].merge( ts[b] ); }
+           }
+        }
+     }
+  }
+
+/*
+ * OpenMP compact
+ *    each thread compacts a contiguous block of i (static schedule) into its own list,
+ *    and the lists are concatenated in thread order, so the indices are in row-major order
+ */
+   namespace detail
+  {
+      template<typename         Mask,
+               ptrdiff_t...     Exts>
+      void compact_mask(       execution::openmp_policy,
+                         const index_type_of_t<Mask>                      begin_index,
+                         const stx::extents<Exts...>                             exts,
+                         const Mask&                                             mask,
+                               std::vector<index_type_of_t<Mask>>&            indices )
+     {
+         using index_type = index_type_of_t<Mask>;
+
+         std::vector<std::vector<index_type>> thread_indices( static_cast<size_t>(omp_get_max_threads()) );
+         std::vector<size_t> offsets( thread_indices.size()+1, 0 );
+
+      # pragma omp parallel
+        {
+            auto& my_indices = thread_indices[size_t(omp_get_thread_num())];
+
+      # pragma omp for schedule(static)
+            for( idx_t i=0; i<exts.extent(0); ++i )
+           {
+               index_type block_begin{begin_index};
+               block_begin[0]+=i;
+
+               compact_mask( execution::seq, block_begin, replace_nth_extent<0,1>(exts), mask, my_indices );
+           }
+
+      # pragma omp single
+           {
+               for( size_t t=0; t<thread_indices.size(); ++t ){ offsets[t+1] = offsets[t]+thread_indices[t].size(); }
+               indices.resize( indices.size()+offsets.back() );
+           }
+
+            const size_t t = size_t(omp_get_thread_num());
+            const size_t first = indices.size()-offsets.back()+offsets[t];
+            std::copy( my_indices.begin(), my_indices.end(), indices.begin()+ptrdiff_t(first) );
+        }
+     }
+  }
+
+/*
+ * OpenMP assign over an index list
+ */
+   template<indexable Destination,
+            indexable      Source>
+      requires same_grid_as<Destination,
+                            Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+   void assign(       execution::openmp_policy,
+                const std::vector<index_type_of_t<Source>>&           indices,
+                      Destination&                                destination,
+                const Source&                                          source,
+                const located_index<index<1,grid_of_v<Source>>>     location = {} )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "assign", execution::openmp,
+                                            location,
+                                            dextents<1>( static_cast<ptrdiff_t>(indices.size()) ),
+                                            instrument::bytes_per_elem<Destination,Source>() );
+
+      const ptrdiff_t n = static_cast<ptrdiff_t>(indices.size());
+
+   # pragma omp parallel for schedule(static)
+      for( ptrdiff_t m=0; m<n; ++m )
+     {
+         [[maybe_unused]]
+         const instrument::nested_scope nested;
+
+         const auto& idx = indices[size_t(m)];
+         destination(idx) = source(idx);
+     }
+      return;
+  }
+
+/*
+ * OpenMP assign / reduce over an index_set
+ *    each thread takes one part of the set, with an equal number of indices
+ *    partial reductions are combined in thread order
+ */
+   template<indexable Destination,
+            indexable      Source>
+      requires same_grid_as<Destination,
+                            Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+   void assign(       execution::openmp_policy,
+                const index_set<ndim_of_v<Source>,grid_of_v<Source>>&      set,
+                      Destination&                                 destination,
+                const Source&                                           source,
+                const located_index<index<1,grid_of_v<Source>>>      location = {} )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "assign", execution::openmp,
+                                            location,
+                                            dextents<1>( static_cast<ptrdiff_t>(set.size()) ),
+                                            instrument::bytes_per_elem<Destination,Source>() );
+
+   # pragma omp parallel
+     {
+         [[maybe_unused]]
+         const instrument::nested_scope nested;
+
+         const auto [first,last] = set.part( size_t(omp_get_thread_num()), size_t(omp_get_num_threads()) );
+
+         set.for_each_index( first, last,
+            [&]( const index_type_of_t<Source> idx )
+           {
+               destination(idx) = source(idx);
+           } );
+     }
+  }
+
+   template<typename ReduceFunc,
+            typename ReduceType,
+            indexable    Source>
+      requires reduction<ReduceFunc,
+                         ReduceType,
+                         element_type_of_t<Source>>
+   [[nodiscard]]
+   ReduceType reduce(       execution::openmp_policy,
+                      const index_set<ndim_of_v<Source>,grid_of_v<Source>>&      set,
+                            ReduceFunc                                   reduce_func,
+                            ReduceType                                    identity_v,
+                            ReduceType                                          init,
+                      const Source&                                           source,
+                      const located_index<index<1,grid_of_v<Source>>>      location = {} )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "reduce", execution::openmp,
+                                            location,
+                                            dextents<1>( static_cast<ptrdiff_t>(set.size()) ),
+                                            instrument::bytes_per_elem<Source>() );
+
+   // reduction value for each thread, each on seperate cache lines
+      using partial_t = utl::aligned_t<ReduceType>;
+      std::vector<partial_t> partial( static_cast<size_t>(omp_get_max_threads()), partial_t{identity_v} );
+
+   # pragma omp parallel
+     {
+         [[maybe_unused]]
+         const instrument::nested_scope nested;
+
+         const size_t t = size_t(omp_get_thread_num());
+         const auto [first,last] = set.part( t, size_t(omp_get_num_threads()) );
+
+         ReduceType local = identity_v;
+         set.for_each_index( first, last,
+            [&]( const index_type_of_t<Source> idx )
+           {
+               local = std::invoke( reduce_func, std::move(local), source(idx) );
+           } );
+         partial[t].data = std::move(local);
+     }
+
+      for( auto& p : partial ){ init = std::invoke( reduce_func, std::move(init), std::move(p.data) ); }
+
+      return init;
+  }
+
+/*
+ * OpenMP scatter_add
+ *    see scatter.h for the modes
+ *    the atomic mode needs arithmetic destination elements, other element types use the automatic choice instead
+ */
+   namespace detail
+  {
+      template<typename Destination,
+               typename     Indices,
+               typename      Values,
+               ptrdiff_t...    Exts>
+      void scatter_add_into(       execution::openmp_policy,
+                             const index_type_of_t<Values>               begin_index,
+                             const stx::extents<Exts...>                        exts,
+                             const scatter_mode                                 mode,
+                                   Destination&                          destination,
+                             const Indices&                                  indices,
+                             const Values&                                    values )
+     {
+         using point_index  = index_type_of_t<Values>;
+         using target_index = index_type_of_t<Destination>;
+         using value_type   = std::remove_cvref_t<element_type_of_t<Destination>>;
+
+      // call func(point) for each point of the i-th slab of the range
+         const auto for_each_point =
+            [&]( const idx_t i, auto&& func )
+           {
+               point_index block_begin{begin_index};
+               block_begin[0]+=i;
+
+               for_each_index( execution::seq, block_begin, replace_nth_extent<0,1>(exts), func );
+           };
+
+         const auto target =
+            [&]( const point_index p ){ return target_index( indices(p) ); };
+
+      // no conflicts to avoid
+         if( omp_get_max_threads()==1 )
+        {
+            scatter_add_into( execution::seq, begin_index, exts, mode, destination, indices, values );
+            return;
+        }
+
+         if constexpr( std::is_arithmetic_v<value_type> )
+        {
+            if( mode==scatter_mode::atomic )
+           {
+            # pragma omp parallel for schedule(static)
+               for( idx_t i=0; i<exts.extent(0); ++i )
+              {
+                  for_each_point( i,
+                     [&]( const point_index p )
+                    {
+                        std::atomic_ref<value_type>( destination( target(p) ) )
+                           .fetch_add( value_type( values(p) ), std::memory_order_relaxed );
+                    } );
+              }
+               return;
+           }
+        }
+
+      // bounding box of the targets
+         target_box<target_index> box;
+
+      # pragma omp parallel
+        {
+            target_box<target_index> my_box;
+
+      # pragma omp for schedule(static) nowait
+            for( idx_t i=0; i<exts.extent(0); ++i )
+           {
+               for_each_point( i, [&]( const point_index p ){ my_box.extend( target(p) ); } );
+           }
+
+      # pragma omp critical
+            box.merge( my_box );
+        }
+
+         if( box.empty() ){ return; }
+
+         const size_t nthreads = static_cast<size_t>(omp_get_max_threads());
+         const size_t nbox = box.size();
+
+         const bool privatised =
+            mode==scatter_mode::privatised
+         || ( mode!=scatter_mode::partitioned && nbox<=scatter_privatise_threshold );
+
+         if( privatised )
+        {
+            std::vector<value_type> buffers( nthreads*nbox, value_type{} );
+
+         # pragma omp parallel
+           {
+               value_type* const my_buffer = buffers.data() + size_t(omp_get_thread_num())*nbox;
+
+         # pragma omp for schedule(static)
+               for( idx_t i=0; i<exts.extent(0); ++i )
+              {
+                  for_each_point( i, [&]( const point_index p ){ my_buffer[box.offset( target(p) )] += values(p); } );
+              }
+
+            // summed in thread order
+         # pragma omp for schedule(static)
+               for( size_t e=0; e<nbox; ++e )
+              {
+                  value_type sum = buffers[e];
+                  for( size_t t=1; t<nthreads; ++t ){ sum += buffers[t*nbox+e]; }
+                  destination( box.index(e) ) += sum;
+              }
+           }
+        }
+         else
+        {
+         // points bucketed by the slab of the box their target is in, per thread which found them
+            const size_t nparts = nthreads;
+            const idx_t  nslab  = box.extent(0);
+
+            const auto part_of =
+               [&]( const target_index t ){ return size_t( (t[0]-box.lo[0])*idx_t(nparts)/nslab ); };
+
+            std::vector<std::vector<std::vector<point_index>>> buckets( nthreads, std::vector<std::vector<point_index>>( nparts ) );
+
+         # pragma omp parallel
+           {
+               auto& my_buckets = buckets[size_t(omp_get_thread_num())];
+
+         # pragma omp for schedule(static)
+               for( idx_t i=0; i<exts.extent(0); ++i )
+              {
+                  for_each_point( i, [&]( const point_index p ){ my_buckets[part_of( target(p) )].push_back( p ); } );
+              }
+
+            // each part is added by one thread, in the order the points were found
+         # pragma omp for schedule(static,1)
+               for( size_t part=0; part<nparts; ++part )
+              {
+                  for( const auto& thread_buckets : buckets )
+                 {
+                     for( const point_index p : thread_buckets[part] ){ destination( target(p) ) += values(p); }
+                 }
+              }
+           }
+        }
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * OpenMP yam::detail::for_each_weighted
+ *    the items are split into one list per thread with (nearly) equal total weights, see utl::balanced_partition,
+ *    and all lists are run in a single parallel region, each list in item order
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename Func>
+         requires std::invocable<Func&,size_t>
+      void for_each_weighted(       execution::openmp_policy,
+                              const std::vector<size_t>&      weights,
+                                    Func&&                       func )
+     {
+         const auto parts = utl::balanced_partition( weights, static_cast<size_t>(omp_get_max_threads()) );
+         const auto nparts = static_cast<ptrdiff_t>(parts.size());
+
+      # pragma omp parallel for schedule(static,1)
+         for( ptrdiff_t p=0; p<nparts; ++p )
+        {
+            [[maybe_unused]]
+            const instrument::nested_scope nested;
+
+            for( const size_t n : parts[size_t(p)] ){ func( n ); }
+        }
+     }
+  }
+
+
+/*
+ * ===============================================================
+ *
+ * OpenMP yam::prolong_linear
+ *    the range is split along the first axis into one contiguous block per thread, so each thread fills its own buffer row once per fine row
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename    Fine,
+               typename  Coarse,
+               ptrdiff_t... Exts>
+      void prolong_linear_into(       execution::openmp_policy,
+                                const index_type_of_t<Fine>          begin_index,
+                                const stx::extents<Exts...>                 exts,
+                                      Fine&                                 fine,
+                                const Coarse&                             coarse )
+     {
+         constexpr size_t ndim = sizeof...(Exts);
+
+      # pragma omp parallel
+        {
+            [[maybe_unused]]
+            const instrument::nested_scope nested;
+
+            const idx_t n  = exts.extent(0);
+            const idx_t t  = omp_get_thread_num();
+            const idx_t nt = omp_get_num_threads();
+
+            index_type_of_t<Fine> block_begin{begin_index};
+            block_begin[0] += (n*t)/nt;
+
+            std::array<idx_t,ndim> block_exts{};
+            for( ndim_t d=0; d<ndim; ++d ){ block_exts[d] = exts.extent(d); }
+            block_exts[0] = (n*(t+1))/nt - (n*t)/nt;
+
+            prolong_linear_into( execution::seq, block_begin, dextents<ndim>(block_exts), fine, coarse );
+        }
+     }
+  }
+
 }
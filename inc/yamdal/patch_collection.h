@@ -0,0 +1,655 @@
+
+# pragma once
+
+# include "array.h"
+# include "algorithm.h"
+# include "concepts.h"
+# include "index.h"
+# include "execution.h"
+# include "instrument.h"
+# include "utility.h"
+
+# include "external/mdspan.h"
+
+# include <vector>
+# include <array>
+# include <numeric>
+# include <functional>
+# include <concepts>
+# include <utility>
+
+# include <cstddef>
+# include <cassert>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * yam::patch_collection
+ *    collection of basic_array patches of a block-structured (AMR) grid, at different refinement levels
+ *       each patch has a level and an origin: the index of its first element in the global index space of its level,
+ *       so patch element idx-origin holds the value at global index idx. Level l+1 is finer than level l by ratio() in each dimension
+ *
+ *    the batched algorithms (for_each_patch, generate_patches, transform_patches, reduce_patches) run a kernel over every patch
+ *    in a single parallel dispatch: whole patches are shared out between the threads with (nearly) equal numbers of elements per thread,
+ *    and each patch is swept serially by the thread it belongs to, so many small patches do not mean many small parallel loops
+ *
+ *    restrict_to_coarse and prolong_to_fine transfer values between the patches of two consecutive levels, see below
+ *
+ *    there is no begin index to record the call site for instrumentation, so each algorithm takes a defaulted located_index as its last argument instead
+ *
+ * ===============================================================
+ */
+
+   template<typename ElementType,
+            ndim_t          NDIM,
+            grid_t          GRID= primal>
+   class patch_collection
+  {
+   public :
+
+      static constexpr ndim_t ndim = NDIM;
+      static constexpr grid_t grid = GRID;
+
+      using element_type = ElementType;
+      using index_type   = index<ndim,grid>;
+      using array_type   = basic_array<element_type,
+                                       dextents<ndim>,
+                                       default_layout,
+                                       default_accessor<element_type>,
+                                       grid>;
+
+      struct patch
+     {
+         using element_type = ElementType;
+         using index_type   = index<ndim,grid>;
+
+         array_type data;
+         index_type origin;
+         int        level;
+
+      // global index one past the last element in each dimension
+         [[nodiscard]]
+         index_type end() const
+        {
+            index_type idx{origin};
+            for( ndim_t r=0; r<ndim; ++r ){ idx[r] += data.extent(r); }
+            return idx;
+        }
+
+         [[nodiscard]]
+         size_t size() const { return size_t(data.size()); }
+
+         [[nodiscard]]
+         bool contains( const index_type idx ) const
+        {
+            const index_type last = end();
+            for( ndim_t r=0; r<ndim; ++r )
+           {
+               if( idx[r]<origin[r] || idx[r]>=last[r] ){ return false; }
+           }
+            return true;
+        }
+
+      // element access with global indices, so a patch is indexable over [origin,end())
+         [[nodiscard]]
+         element_type& operator()( const index_type idx )
+        {
+            return data( local( idx ) );
+        }
+
+         [[nodiscard]]
+         const element_type& operator()( const index_type idx ) const
+        {
+            return data( local( idx ) );
+        }
+
+      private :
+
+         [[nodiscard]]
+         index_type local( index_type idx ) const
+        {
+            assert( contains( idx ) );
+            for( ndim_t r=0; r<ndim; ++r ){ idx[r] -= origin[r]; }
+            return idx;
+        }
+     };
+
+      explicit patch_collection( const idx_t ratio_ = 2 )
+         : refinement_ratio( ratio_ )
+     {
+         assert( ratio_>=1 );
+     }
+
+   // add a patch of the given extents, returns its number
+      size_t add_patch( const int                           level,
+                        const index_type                   origin,
+                        const std::array<idx_t,ndim>         exts )
+     {
+         assert( level>=0 );
+         patch_list.push_back( patch{ array_type( exts ), origin, level } );
+         return patch_list.size()-1;
+     }
+
+      [[nodiscard]]
+      idx_t ratio() const { return refinement_ratio; }
+
+      [[nodiscard]]
+      size_t size() const { return patch_list.size(); }
+
+      [[nodiscard]]
+      bool empty() const { return patch_list.empty(); }
+
+   // one more than the finest level of any patch
+      [[nodiscard]]
+      int num_levels() const
+     {
+         int n=0;
+         for( const patch& p : patch_list ){ n = std::max( n, p.level+1 ); }
+         return n;
+     }
+
+   // numbers of the patches on a level, in increasing order
+      [[nodiscard]]
+      std::vector<size_t> level_patches( const int level ) const
+     {
+         std::vector<size_t> list;
+         for( size_t n=0; n<patch_list.size(); ++n )
+        {
+            if( patch_list[n].level==level ){ list.push_back( n ); }
+        }
+         return list;
+     }
+
+      [[nodiscard]]
+      patch& operator[]( const size_t n ) { return patch_list[n]; }
+
+      [[nodiscard]]
+      const patch& operator[]( const size_t n ) const { return patch_list[n]; }
+
+      [[nodiscard]]
+      auto begin()       { return patch_list.begin(); }
+
+      [[nodiscard]]
+      auto begin() const { return patch_list.begin(); }
+
+      [[nodiscard]]
+      auto end()         { return patch_list.end(); }
+
+      [[nodiscard]]
+      auto end() const   { return patch_list.end(); }
+
+   private :
+
+      std::vector<patch> patch_list;
+      idx_t              refinement_ratio;
+  };
+
+   namespace detail
+  {
+      template<typename T>
+      struct is_patch_collection
+         : std::false_type {};
+
+      template<typename ElementType,
+               ndim_t          ndim,
+               grid_t          grid>
+      struct is_patch_collection<patch_collection<ElementType,ndim,grid>>
+         : std::true_type {};
+  }
+
+   template<typename T>
+   concept patch_collection_type =
+      detail::is_patch_collection<std::remove_cvref_t<T>>::value;
+
+/*
+ * ===============================================================
+ *
+ * yam::for_each_patch
+ *    call func(patch) for each patch of the collection (or each patch on one level), with a single parallel dispatch
+ *    func should only modify the patch it is given
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+   // func(patches[n]) for each n in list, patches weighted by their sizes
+      template<typename Patches,
+               typename    Func>
+      void for_each_listed_patch( const execution_policy auto           policy,
+                                  const char*                      kernel_name,
+                                        Patches&                       patches,
+                                  const std::vector<size_t>&              list,
+                                        Func&&                            func,
+                                  const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location )
+     {
+         using element_type = typename std::remove_cvref_t<Patches>::element_type;
+
+         std::vector<size_t> weights( list.size() );
+         size_t total=0;
+         for( size_t k=0; k<list.size(); ++k )
+        {
+            weights[k] = patches[list[k]].size();
+            total += weights[k];
+        }
+
+         [[maybe_unused]]
+         const instrument::kernel_scope scope( kernel_name, policy,
+                                               location,
+                                               dextents<1>( static_cast<ptrdiff_t>(total) ),
+                                               sizeof(element_type) );
+
+         for_each_weighted( policy, weights,
+            [&]( const size_t k )
+           {
+               func( patches[list[k]] );
+           } );
+     }
+
+      template<typename Patches>
+      [[nodiscard]]
+      std::vector<size_t> all_patches( const Patches& patches )
+     {
+         std::vector<size_t> list( patches.size() );
+         std::iota( list.begin(), list.end(), size_t(0) );
+         return list;
+     }
+
+   // call func(idx) for each global index idx of a patch, in row-major order
+      template<typename Patch,
+               typename  Func>
+      void for_each_patch_index( const Patch& p,
+                                       Func&& func )
+     {
+         for_each_index( execution::seq, p.origin, make_dextents( p.data.extents() ), std::forward<Func>(func) );
+     }
+  }
+
+   template<patch_collection_type Patches,
+            typename                 Func>
+   void for_each_patch( const execution_policy auto  policy,
+                              Patches&&             patches,
+                              Func&&                   func,
+                        const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+      detail::for_each_listed_patch( policy, "for_each_patch", patches, detail::all_patches( patches ), std::forward<Func>(func), location );
+  }
+
+   template<patch_collection_type Patches,
+            typename                 Func>
+   void for_each_patch( const execution_policy auto  policy,
+                              Patches&&             patches,
+                        const int                     level,
+                              Func&&                   func,
+                        const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+      detail::for_each_listed_patch( policy, "for_each_patch", patches, patches.level_patches( level ), std::forward<Func>(func), location );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::generate_patches / yam::transform_patches / yam::reduce_patches
+ *    generate_patches:  set each element to func(level,idx), with idx its global index
+ *    transform_patches: replace each element x by func(x)
+ *    reduce_patches:    reduce all elements of all patches; each patch is reduced from identity_v, and the
+ *                       patch results are combined into init in patch order, so the result does not depend on the policy
+ *
+ * ===============================================================
+ */
+
+   template<patch_collection_type Patches,
+            typename                 Func>
+      requires std::invocable<Func&,int,typename std::remove_cvref_t<Patches>::index_type>
+   void generate_patches( const execution_policy auto  policy,
+                                Patches&&             patches,
+                                Func&&                   func,
+                          const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+      detail::for_each_listed_patch( policy, "generate_patches", patches, detail::all_patches( patches ),
+         [&func]( auto& p )
+        {
+            detail::for_each_patch_index( p,
+               [&]( const auto idx ){ p(idx) = func( p.level, idx ); } );
+        }, location );
+  }
+
+   template<patch_collection_type Patches,
+            typename                 Func>
+      requires std::invocable<Func&,typename std::remove_cvref_t<Patches>::element_type>
+   void transform_patches( const execution_policy auto  policy,
+                                 Patches&&             patches,
+                                 Func&&                   func,
+                           const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+      detail::for_each_listed_patch( policy, "transform_patches", patches, detail::all_patches( patches ),
+         [&func]( auto& p )
+        {
+            detail::for_each_patch_index( p,
+               [&]( const auto idx ){ p(idx) = func( p(idx) ); } );
+        }, location );
+  }
+
+   template<patch_collection_type Patches,
+            typename            ReduceFunc,
+            typename            ReduceType>
+      requires reduction<ReduceFunc,
+                         ReduceType,
+                         typename std::remove_cvref_t<Patches>::element_type>
+   [[nodiscard]]
+   ReduceType reduce_patches( const execution_policy auto       policy,
+                              const Patches&                   patches,
+                                    ReduceFunc             reduce_func,
+                                    ReduceType              identity_v,
+                                    ReduceType                    init,
+                              const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+   // one padded slot per patch, written once when the patch is done, so threads neither share a cache line nor a vector<bool> word
+      using partial_t = utl::aligned_t<ReduceType>;
+      std::vector<partial_t> partial( patches.size(), partial_t{identity_v} );
+
+      detail::for_each_listed_patch( policy, "reduce_patches", patches, detail::all_patches( patches ),
+         [&]( const auto& p )
+        {
+            ReduceType local = identity_v;
+            detail::for_each_patch_index( p,
+               [&]( const auto idx ){ local = std::invoke( reduce_func, std::move(local), p(idx) ); } );
+         // patches are stored contiguously, so this is the patch number
+            partial[size_t(&p-&patches[0])].data = std::move(local);
+        }, location );
+
+      for( auto& value : partial ){ init = std::invoke( reduce_func, std::move(init), std::move(value.data) ); }
+
+      return init;
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::restrict_to_coarse / yam::prolong_to_fine
+ *    transfer values between the patches on level fine_level and those on level fine_level-1, with refinement ratio r
+ *
+ *    dual grid (cell centred): coarse cell I covers fine cells r*I+c, for c in [0,r) in each dimension
+ *       restriction sets each coarse cell covered by a fine patch to the average of its fine cells
+ *       prolongation sets each fine cell to the value of its coarse cell (piecewise constant, so conservative)
+ *    primal grid (node centred): coarse node I coincides with fine node r*I
+ *       restriction sets each coarse node coinciding with a fine node to its value (injection)
+ *       prolongation sets each fine node to the multilinear interpolation of the coarse nodes around it
+ *
+ *    only elements whose whole stencil lies within one source patch are set, others are left unchanged
+ *    each destination patch is written by one thread, reading from all overlapping source patches in patch order
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      [[nodiscard]]
+      constexpr idx_t floor_div( const idx_t a,
+                                 const idx_t b )
+     {
+         return a/b - ( (a%b!=0) && ((a<0)!=(b<0)) ? 1 : 0 );
+     }
+
+      [[nodiscard]]
+      constexpr idx_t ceil_div( const idx_t a,
+                                const idx_t b )
+     {
+         return -floor_div( -a, b );
+     }
+
+   // call func(idx) for each idx in the box [lo,hi), if it is not empty
+      template<typename Index,
+               typename  Func>
+      void for_each_in_box( const Index   lo,
+                            const Index   hi,
+                                  Func&& func )
+     {
+         constexpr ndim_t ndim = Index::ndim;
+
+         std::array<idx_t,ndim> exts;
+         for( ndim_t r=0; r<ndim; ++r )
+        {
+            if( hi[r]<=lo[r] ){ return; }
+            exts[r] = hi[r]-lo[r];
+        }
+         for_each_index( execution::seq, lo, dextents<ndim>( exts ), std::forward<Func>(func) );
+     }
+
+   // set coarse patch elements from one fine patch
+      template<typename Patch>
+      void restrict_patch(       Patch&   coarse,
+                           const Patch&     fine,
+                           const idx_t     ratio )
+     {
+         using index_type   = typename Patch::index_type;
+         using element_type = typename Patch::element_type;
+         constexpr ndim_t ndim = index_type::ndim;
+
+         const index_type fine_end   = fine.end();
+         const index_type coarse_end = coarse.end();
+
+         index_type lo, hi;
+         idx_t children=1;
+         for( ndim_t r=0; r<ndim; ++r )
+        {
+            lo[r] = ceil_div( fine.origin[r], ratio );
+            if constexpr( index_type::grid==dual )
+           {
+               hi[r] = floor_div( fine_end[r], ratio );
+               children *= ratio;
+           }
+            else
+           {
+               hi[r] = floor_div( fine_end[r]-1, ratio )+1;
+           }
+            lo[r] = std::max( lo[r], coarse.origin[r] );
+            hi[r] = std::min( hi[r], coarse_end[r] );
+        }
+
+         const element_type scale = element_type(1)/element_type(children);
+
+         for_each_in_box( lo, hi,
+            [&]( const index_type I )
+           {
+               index_type i0;
+               for( ndim_t r=0; r<ndim; ++r ){ i0[r] = ratio*I[r]; }
+
+               if constexpr( index_type::grid==dual )
+              {
+                  index_type i1{i0};
+                  for( ndim_t r=0; r<ndim; ++r ){ i1[r] += ratio; }
+
+                  element_type sum{};
+                  for_each_in_box( i0, i1, [&]( const index_type i ){ sum += fine(i); } );
+                  coarse(I) = sum*scale;
+              }
+               else
+              {
+                  coarse(I) = fine(i0);
+              }
+           } );
+     }
+
+   // set fine patch elements from one coarse patch
+      template<typename Patch>
+      void prolong_patch(       Patch&     fine,
+                          const Patch&   coarse,
+                          const idx_t     ratio )
+     {
+         using index_type   = typename Patch::index_type;
+         using element_type = typename Patch::element_type;
+         constexpr ndim_t ndim = index_type::ndim;
+
+         const index_type fine_end   = fine.end();
+         const index_type coarse_end = coarse.end();
+
+         index_type lo, hi;
+         for( ndim_t r=0; r<ndim; ++r )
+        {
+            lo[r] = ratio*coarse.origin[r];
+            if constexpr( index_type::grid==dual )
+           {
+               hi[r] = ratio*coarse_end[r];
+           }
+            else
+           {
+               hi[r] = ratio*(coarse_end[r]-1)+1;
+           }
+            lo[r] = std::max( lo[r], fine.origin[r] );
+            hi[r] = std::min( hi[r], fine_end[r] );
+        }
+
+         idx_t denominator=1;
+         for( ndim_t r=0; r<ndim; ++r ){ denominator *= ratio; }
+         const element_type scale = element_type(1)/element_type(denominator);
+
+         for_each_in_box( lo, hi,
+            [&]( const index_type i )
+           {
+               index_type I0;
+               for( ndim_t r=0; r<ndim; ++r ){ I0[r] = floor_div( i[r], ratio ); }
+
+               if constexpr( index_type::grid==dual )
+              {
+                  fine(i) = coarse(I0);
+              }
+               else
+              {
+               // corners of the coarse cell around i, skipping those with zero weight (which may be outside the patch)
+                  element_type value{};
+                  for( unsigned corner=0; corner<(1u<<ndim); ++corner )
+                 {
+                     index_type I{I0};
+                     idx_t weight=1;
+                     for( ndim_t r=0; r<ndim; ++r )
+                    {
+                        const idx_t f = i[r]-ratio*I0[r];
+                        if( corner&(1u<<r) ){ ++I[r]; weight *= f; }
+                        else                { weight *= ratio-f; }
+                    }
+                     if( weight!=0 ){ value += coarse(I)*(element_type(weight)*scale); }
+                 }
+                  fine(i) = value;
+              }
+           } );
+     }
+  }
+
+   template<patch_collection_type Patches>
+   void restrict_to_coarse( const execution_policy auto     policy,
+                                  Patches&                patches,
+                            const int                  fine_level,
+                            const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+      assert( fine_level>=1 );
+
+      const auto fine_list = patches.level_patches( fine_level );
+
+      detail::for_each_listed_patch( policy, "restrict_to_coarse", patches, patches.level_patches( fine_level-1 ),
+         [&]( auto& coarse )
+        {
+            for( const size_t n : fine_list ){ detail::restrict_patch( coarse, std::as_const(patches)[n], patches.ratio() ); }
+        }, location );
+  }
+
+   template<patch_collection_type Patches>
+   void prolong_to_fine( const execution_policy auto     policy,
+                               Patches&                patches,
+                         const int                  fine_level,
+                         const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+      assert( fine_level>=1 );
+
+      const auto coarse_list = patches.level_patches( fine_level-1 );
+
+      detail::for_each_listed_patch( policy, "prolong_to_fine", patches, patches.level_patches( fine_level ),
+         [&]( auto& fine )
+        {
+            for( const size_t n : coarse_list ){ detail::prolong_patch( fine, std::as_const(patches)[n], patches.ratio() ); }
+        }, location );
+  }
+
+/*
+ * ===============================================================
+ *
+ * if no execution policy is specified, use serial
+ *
+ * ===============================================================
+ */
+
+   template<patch_collection_type Patches,
+            typename                 Func>
+   void for_each_patch(       Patches&& patches,
+                              Func&&       func,
+                        const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+      for_each_patch( execution::seq, std::forward<Patches>(patches), std::forward<Func>(func), location );
+  }
+
+   template<patch_collection_type Patches,
+            typename                 Func>
+   void for_each_patch(       Patches&& patches,
+                        const int         level,
+                              Func&&       func,
+                        const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+      for_each_patch( execution::seq, std::forward<Patches>(patches), level, std::forward<Func>(func), location );
+  }
+
+   template<patch_collection_type Patches,
+            typename                 Func>
+   void generate_patches(       Patches&& patches,
+                                Func&&       func,
+                          const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+      generate_patches( execution::seq, std::forward<Patches>(patches), std::forward<Func>(func), location );
+  }
+
+   template<patch_collection_type Patches,
+            typename                 Func>
+   void transform_patches(       Patches&& patches,
+                                 Func&&       func,
+                           const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+      transform_patches( execution::seq, std::forward<Patches>(patches), std::forward<Func>(func), location );
+  }
+
+// serial reduction does not need an identity value
+   template<patch_collection_type Patches,
+            typename            ReduceFunc,
+            typename            ReduceType>
+      requires reduction<ReduceFunc,
+                         ReduceType,
+                         typename std::remove_cvref_t<Patches>::element_type>
+   [[nodiscard]]
+   ReduceType reduce_patches( const Patches&       patches,
+                                    ReduceFunc reduce_func,
+                                    ReduceType        init )
+  {
+      for( const auto& p : patches )
+     {
+         detail::for_each_patch_index( p,
+            [&]( const auto idx ){ init = std::invoke( reduce_func, std::move(init), p(idx) ); } );
+     }
+      return init;
+  }
+
+   template<patch_collection_type Patches>
+   void restrict_to_coarse(       Patches&   patches,
+                            const int fine_level,
+                            const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+      restrict_to_coarse( execution::seq, patches, fine_level, location );
+  }
+
+   template<patch_collection_type Patches>
+   void prolong_to_fine(       Patches&   patches,
+                         const int fine_level,
+                         const located_index<index<1,std::remove_cvref_t<Patches>::grid>> location = {} )
+  {
+      prolong_to_fine( execution::seq, patches, fine_level, location );
+  }
+}
@@ -0,0 +1,244 @@
+
+# pragma once
+
+# include <array>
+# include <limits>
+# include <cmath>
+# include <cstdint>
+# include <cstdlib>
+# include <cstring>
+
+# ifdef __linux__
+   # include <linux/perf_event.h>
+   # include <sys/syscall.h>
+   # include <unistd.h>
+# endif
+
+# if defined(__x86_64__) || defined(__i386__)
+   # include <cpuid.h>
+# endif
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * Hardware performance counters, read through the Linux perf_event_open interface
+ *    used by the instrumentation (instrument.h) when YAMDAL_INSTRUMENT_PERF is defined
+ *
+ *    counters are opened on first use, for the calling thread and all threads it creates afterwards (perf "inherit")
+ *    so to include the OpenMP thread pool, call instrument::perf_counters::instance() (or instrument::start_counters())
+ *    at the start of main, before the first parallel region
+ *
+ *    counters which cannot be opened (no PMU access in a virtual machine, perf_event_paranoid too high, non-Linux system)
+ *    read as NaN rather than failing
+ *
+ * ===============================================================
+ */
+
+   namespace instrument
+  {
+   /*
+    * counted events
+    *    llc_misses - last-level cache read misses
+    *    fp_packed  - packed (SIMD) floating-point arithmetic instructions retired
+    *    fp_scalar  - scalar floating-point arithmetic instructions retired
+    *
+    *    the fp counters count floating-point arithmetic only: vectorised copies, loads and stores, and integer arithmetic are in neither,
+    *    so they show whether floating-point work is vectorised, not whether a kernel as a whole is
+    *    there are no generic perf events for them, so the raw event codes are taken from the environment variables
+    *    YAMDAL_PERF_FP_PACKED_EVENT and YAMDAL_PERF_FP_SCALAR_EVENT (eg "0xfcc7" and "0x03c7"),
+    *    defaulting to FP_ARITH_INST_RETIRED.PACKED and FP_ARITH_INST_RETIRED.SCALAR on Intel processors
+    */
+      enum class counter : size_t
+     {
+         cycles,
+         instructions,
+         llc_misses,
+         fp_packed,
+         fp_scalar
+     };
+
+      inline constexpr size_t num_counters=5;
+
+      inline constexpr std::array<const char*,num_counters> counter_names =
+         { "cycles", "instructions", "llc_misses", "fp_packed", "fp_scalar" };
+
+   /*
+    * values of all counters, NaN for any that are unavailable
+    */
+      struct counter_values
+     {
+         std::array<double,num_counters> values{};
+
+         [[nodiscard]]
+         constexpr double  operator[]( const counter c ) const { return values[size_t(c)]; }
+
+         [[nodiscard]]
+         constexpr double& operator[]( const counter c )       { return values[size_t(c)]; }
+
+         constexpr counter_values& operator+=( const counter_values& other )
+        {
+            for( size_t n=0; n<num_counters; ++n ){ values[n] += other.values[n]; }
+            return *this;
+        }
+
+         [[nodiscard]]
+         friend constexpr counter_values operator-( counter_values a, const counter_values& b )
+        {
+            for( size_t n=0; n<num_counters; ++n ){ a.values[n] -= b.values[n]; }
+            return a;
+        }
+     };
+
+   /*
+    * group of perf counters for this process
+    */
+      class perf_counters
+     {
+      public :
+
+         [[nodiscard]]
+         static perf_counters& instance()
+        {
+            static perf_counters c;
+            return c;
+        }
+
+      // current (cumulative) values of the counters, scaled for multiplexing
+         [[nodiscard]]
+         counter_values read() const
+        {
+            counter_values r;
+            for( size_t n=0; n<num_counters; ++n ){ r.values[n] = read_one(fds[n]); }
+            return r;
+        }
+
+         [[nodiscard]]
+         bool available( const counter c ) const { return fds[size_t(c)]>=0; }
+
+         [[nodiscard]]
+         bool any_available() const
+        {
+            for( const int fd : fds ){ if( fd>=0 ){ return true; } }
+            return false;
+        }
+
+         ~perf_counters()
+        {
+# ifdef __linux__
+            for( const int fd : fds ){ if( fd>=0 ){ close(fd); } }
+# endif
+        }
+
+         perf_counters( const perf_counters& ) = delete;
+         perf_counters& operator=( const perf_counters& ) = delete;
+
+      private :
+
+         perf_counters()
+        {
+            fds.fill(-1);
+
+# ifdef __linux__
+            fds[size_t(counter::cycles)] =
+               open_event( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES );
+
+            fds[size_t(counter::instructions)] =
+               open_event( PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS );
+
+            fds[size_t(counter::llc_misses)] =
+               open_event( PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL
+                                             | (PERF_COUNT_HW_CACHE_OP_READ<<8)
+                                             | (PERF_COUNT_HW_CACHE_RESULT_MISS<<16) );
+
+            if( const std::uint64_t code = fp_event_code( "YAMDAL_PERF_FP_PACKED_EVENT", 0xfcc7 ); code!=0 )
+           {
+               fds[size_t(counter::fp_packed)] =
+                  open_event( PERF_TYPE_RAW, code );
+           }
+
+            if( const std::uint64_t code = fp_event_code( "YAMDAL_PERF_FP_SCALAR_EVENT", 0x03c7 ); code!=0 )
+           {
+               fds[size_t(counter::fp_scalar)] =
+                  open_event( PERF_TYPE_RAW, code );
+           }
+# endif
+        }
+
+      // raw event code of a floating-point event from the environment variable, or the Intel code, or 0 if unknown
+      //    FP_ARITH_INST_RETIRED is event 0xc7: umask 0xfc counts 128/256/512-bit packed single and double, umask 0x03 scalar single and double
+         [[nodiscard]]
+         static std::uint64_t fp_event_code(                      const char*           env_name,
+                                             [[maybe_unused]] const std::uint64_t intel_code )
+        {
+            if( const char* env = std::getenv(env_name) )
+           {
+               return std::strtoull( env, nullptr, 0 );
+           }
+
+# if defined(__x86_64__) || defined(__i386__)
+            unsigned eax=0, ebx=0, ecx=0, edx=0;
+            if( __get_cpuid( 0, &eax, &ebx, &ecx, &edx ) )
+           {
+               char vendor[13]{};
+               std::memcpy( vendor+0, &ebx, 4 );
+               std::memcpy( vendor+4, &edx, 4 );
+               std::memcpy( vendor+8, &ecx, 4 );
+
+               if( std::strcmp( vendor, "GenuineIntel" )==0 ){ return intel_code; }
+           }
+# endif
+            return 0;
+        }
+
+# ifdef __linux__
+         [[nodiscard]]
+         static int open_event( const std::uint32_t type, const std::uint64_t config )
+        {
+            perf_event_attr attr;
+            std::memset( &attr, 0, sizeof(attr) );
+
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.inherit = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const long fd = syscall( SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC );
+            return int(fd);
+        }
+# endif
+
+         [[nodiscard]]
+         static double read_one( const int fd )
+        {
+            constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+            if( fd<0 ){ return nan; }
+
+# ifdef __linux__
+         // value, time enabled, time running
+            std::uint64_t buf[3]{};
+            if( ::read( fd, buf, sizeof(buf) )!=ssize_t(sizeof(buf)) || buf[2]==0 ){ return nan; }
+
+            return double(buf[0])*(double(buf[1])/double(buf[2]));
+# else
+            return nan;
+# endif
+        }
+
+         std::array<int,num_counters> fds;
+     };
+
+   /*
+    * open the counters now, so that they also count threads created from here on
+    */
+      inline void start_counters()
+     {
+         [[maybe_unused]] auto& c = perf_counters::instance();
+     }
+  }
+}
@@ -0,0 +1,280 @@
+
+# pragma once
+
+# include "array.h"
+# include "algorithm.h"
+# include "blas.h"
+# include "concepts.h"
+# include "type_traits.h"
+# include "index.h"
+# include "execution.h"
+
+# include "external/mdspan.h"
+
+# include <array>
+# include <tuple>
+# include <utility>
+# include <concepts>
+# include <type_traits>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * yam::butcher_tableau
+ *    coefficients of an explicit Runge-Kutta method with S stages, for du/dt = f(t,u):
+ *       U_i = u + dt*sum_{j<i} a[i][j]*k_j,   k_i = f( t+c[i]*dt, U_i ),   u <- u + dt*sum_j b[j]*k_j
+ *    a structural type, so tableaus can be template arguments and the integrator skips zero coefficients at compile time
+ *
+ * ===============================================================
+ */
+
+   template<size_t S>
+   struct butcher_tableau
+  {
+      std::array<std::array<double,S>,S> a{};
+      std::array<double,S>               b{};
+      std::array<double,S>               c{};
+
+      [[nodiscard]]
+      static constexpr size_t stages(){ return S; }
+
+   // a is strictly lower triangular
+      [[nodiscard]]
+      constexpr bool is_explicit() const
+     {
+         for( size_t i=0; i<S; ++i )
+        {
+            for( size_t j=i; j<S; ++j ){ if( a[i][j]!=0 ){ return false; } }
+        }
+         return true;
+     }
+  };
+
+   namespace tableau
+  {
+      inline constexpr butcher_tableau<1> forward_euler{ {{ {0} }},
+                                                         { 1 },
+                                                         { 0 } };
+
+   // Heun's method (explicit trapezoidal rule)
+      inline constexpr butcher_tableau<2> heun{ {{ {0,0},
+                                                   {1,0} }},
+                                                { 0.5, 0.5 },
+                                                { 0,   1   } };
+
+   // strong stability preserving, 3rd order (Shu-Osher)
+      inline constexpr butcher_tableau<3> ssprk3{ {{ {0,   0,   0},
+                                                     {1,   0,   0},
+                                                     {0.25,0.25,0} }},
+                                                  { 1./6, 1./6, 2./3 },
+                                                  { 0,    1,    0.5  } };
+
+   // classical 4th order
+      inline constexpr butcher_tableau<4> rk4{ {{ {0,  0,  0,0},
+                                                  {0.5,0,  0,0},
+                                                  {0,  0.5,0,0},
+                                                  {0,  0,  1,0} }},
+                                               { 1./6, 1./3, 1./3, 1./6 },
+                                               { 0,    0.5,  0.5,  1    } };
+  }
+
+   namespace detail
+  {
+      template<typename T>
+      struct is_butcher_tableau : std::false_type {};
+
+      template<size_t S>
+      struct is_butcher_tableau<butcher_tableau<S>> : std::true_type {};
+
+   /*
+    * indices j of the nonzero coefficients in a row of a tableau, as an index_sequence
+    */
+      template<size_t S,
+               std::array<double,S> row>
+      [[nodiscard]]
+      constexpr auto nonzero_indices()
+     {
+         constexpr auto list =
+            []()
+           {
+               std::pair<std::array<size_t,S>,size_t> result{};
+               for( size_t j=0; j<S; ++j ){ if( row[j]!=0 ){ result.first[result.second++] = j; } }
+               return result;
+           }();
+
+         return [&]<size_t... N>( std::index_sequence<N...> )
+        {
+            return std::index_sequence<list.first[N]...>{};
+        }( std::make_index_sequence<list.second>{} );
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::rk_integrator
+ *    explicit Runge-Kutta time steps for a state of nfields arrays, with the method given by a butcher_tableau
+ *
+ *    the stage arrays (S tendencies k_j and one stage state U per field) are acquired from an array_pool at construction
+ *    and released to it on destruction, so integrators and other users of the pool share storage, and steps do not allocate
+ *
+ *    step( policy, begin_index, exts, u, t, dt, rhs ) advances u over the range [begin_index,begin_index+extents), calling
+ *       rhs( t_i, U_i, k_i ) for each stage, with U_i and k_i of type state_type& (std::array<Array,nfields>&)
+ *       rhs should set k_i over the range; it is given non-const U_i so that it can set any boundary (ghost) values it reads
+ *       outside the range, which are not set by the integrator
+ *
+ *       each stage state U_i = u + dt*sum_j a[i][j]*k_j is one transform per field, with u and the k_j of nonzero a[i][j]
+ *       as its sources, and the final update u += dt*sum_j b[j]*k_j is one multi-vector axpy per field
+ *       the first stage (or any stage with a zero row of a) passes u itself as U_i
+ *
+ * ===============================================================
+ */
+
+   template<auto      tableau,
+            typename    Array,
+            size_t    nfields=1>
+      requires detail::is_butcher_tableau<std::remove_cvref_t<decltype(tableau)>>::value
+            && (nfields>0)
+   class rk_integrator
+  {
+   public :
+
+      static_assert( tableau.is_explicit(), "rk_integrator needs an explicit Runge-Kutta method" );
+
+      static constexpr size_t num_stages = tableau.stages();
+
+      using array_type   = Array;
+      using value_type   = std::remove_cvref_t<typename Array::element_type>;
+      using extents_type = typename Array::extents_type;
+      using index_type   = typename Array::index_type;
+      using state_type   = std::array<Array,nfields>;
+      using pool_type    = array_pool<Array>;
+
+      rk_integrator( pool_type&          pool_,
+                     const extents_type& exts )
+         : pool( pool_ ),
+           k( make_stages( exts, std::make_index_sequence<num_stages>{} ) ),
+           stage_state( make_state( exts ) )
+     { }
+
+      rk_integrator( const rk_integrator& ) = delete;
+      rk_integrator& operator=( const rk_integrator& ) = delete;
+
+      ~rk_integrator()
+     {
+         for( auto& kj : k ){ release_state( kj ); }
+         release_state( stage_state );
+     }
+
+      template<typename         RHS,
+               ptrdiff_t...    Exts>
+         requires std::invocable<RHS&,value_type,state_type&,state_type&>
+               && (sizeof...(Exts)==Array::rank())
+      void step( const execution_policy auto                  policy,
+                 const located_index<index_type>         begin_index,
+                 const stx::extents<Exts...>                    exts,
+                       state_type&                                 u,
+                 const value_type                                  t,
+                 const value_type                                 dt,
+                       RHS&&                                     rhs )
+     {
+         [&]<size_t... I>( std::index_sequence<I...> )
+        {
+            ( stage<I>( policy, begin_index, exts, u, t, dt, rhs ), ... );
+        }( std::make_index_sequence<num_stages>{} );
+
+         update( policy, begin_index, exts, u, dt, detail::nonzero_indices<num_stages,tableau.b>() );
+     }
+
+   // tendency of stage j from the last step
+      [[nodiscard]]
+      const state_type& stage_tendency( const size_t j ) const { return k[j]; }
+
+   private :
+
+      template<size_t I>
+      void stage( const execution_policy auto           policy,
+                  const located_index<index_type>  begin_index,
+                  const auto                              exts,
+                        state_type&                          u,
+                  const value_type                           t,
+                  const value_type                          dt,
+                        auto&                              rhs )
+     {
+         constexpr auto J = detail::nonzero_indices<num_stages,tableau.a[I]>();
+
+         const value_type t_stage = t + value_type(tableau.c[I])*dt;
+
+         if constexpr( J.size()==0 )
+        {
+            rhs( t_stage, u, k[I] );
+        }
+         else
+        {
+            [&]<size_t... j>( std::index_sequence<j...> )
+           {
+               const std::array<value_type,sizeof...(j)> coeffs{ value_type(dt*value_type(tableau.a[I][j]))... };
+
+               for( size_t f=0; f<nfields; ++f )
+              {
+                  transform( policy, begin_index, exts, stage_state[f],
+                     [coeffs]( const value_type uf, const auto... kf )
+                    {
+                        return [&]<size_t... n>( std::index_sequence<n...> )
+                       {
+                           return uf + ((coeffs[n]*kf)+...);
+                       }( std::index_sequence_for<decltype(kf)...>{} );
+                    },
+                     u[f], k[j][f]... );
+              }
+           }( J );
+
+            rhs( t_stage, stage_state, k[I] );
+        }
+     }
+
+      template<size_t... j>
+      void update( const execution_policy auto           policy,
+                   const located_index<index_type>  begin_index,
+                   const auto                              exts,
+                         state_type&                          u,
+                   const value_type                          dt,
+                         std::index_sequence<j...> )
+     {
+         const std::array<value_type,sizeof...(j)> coeffs{ value_type(dt*value_type(tableau.b[j]))... };
+
+         for( size_t f=0; f<nfields; ++f )
+        {
+            axpy( policy, begin_index, exts, coeffs, std::tie( std::as_const(k[j][f])... ), u[f] );
+        }
+     }
+
+      [[nodiscard]]
+      state_type make_state( const extents_type& exts )
+     {
+         return [&]<size_t... f>( std::index_sequence<f...> )
+        {
+            return state_type{ (void(f),pool.acquire( exts ))... };
+        }( std::make_index_sequence<nfields>{} );
+     }
+
+      template<size_t... j>
+      [[nodiscard]]
+      std::array<state_type,num_stages> make_stages( const extents_type& exts,
+                                                     std::index_sequence<j...> )
+     {
+         return { (void(j),make_state( exts ))... };
+     }
+
+      void release_state( state_type& s )
+     {
+         for( auto& a : s ){ pool.release( std::move(a) ); }
+     }
+
+      pool_type& pool;
+      std::array<state_type,num_stages> k;
+      state_type stage_state;
+  };
+}
@@ -0,0 +1,114 @@
+
+# pragma once
+
+# include "index.h"
+
+# include <array>
+# include <algorithm>
+# include <limits>
+
+# include <cstddef>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * Options for yam::scatter_add
+ *
+ * ===============================================================
+ */
+
+/*
+ * how the OpenMP scatter_add avoids conflicting updates of the same destination element
+ *    privatised:  each thread adds into its own zeroed copy of the bounding box of the targets, and the copies are summed into the destination
+ *    partitioned: the bounding box is split into one slab (along the first axis) per thread, the points are bucketed by the slab of their target,
+ *                 and each thread adds the points of its own slab, so every destination element is only updated by one thread
+ *    atomic:      all threads add directly into the destination with atomic updates
+ *    automatic:   privatised if the bounding box has at most scatter_privatise_threshold elements, partitioned otherwise
+ *
+ *    privatised and partitioned are deterministic for a fixed number of threads; privatised also adds zero to each untouched element of the box
+ */
+   enum struct scatter_mode
+  {
+      automatic,
+      privatised,
+      partitioned,
+      atomic
+  };
+
+   inline constexpr size_t scatter_privatise_threshold = size_t(1)<<16;
+
+   namespace detail
+  {
+   /*
+    * bounding box [lo,hi] of the targets of a scatter, with the row-major offset of an index within it
+    */
+      template<typename Index>
+      struct target_box
+     {
+         static constexpr ndim_t ndim = Index::ndim;
+
+         std::array<idx_t,ndim> lo;
+         std::array<idx_t,ndim> hi;
+
+         constexpr target_box()
+        {
+            lo.fill( std::numeric_limits<idx_t>::max() );
+            hi.fill( std::numeric_limits<idx_t>::lowest() );
+        }
+
+         constexpr void extend( const Index idx )
+        {
+            for( ndim_t r=0; r<ndim; ++r )
+           {
+               lo[r] = std::min( lo[r], idx[r] );
+               hi[r] = std::max( hi[r], idx[r] );
+           }
+        }
+
+         constexpr void merge( const target_box& other )
+        {
+            for( ndim_t r=0; r<ndim; ++r )
+           {
+               lo[r] = std::min( lo[r], other.lo[r] );
+               hi[r] = std::max( hi[r], other.hi[r] );
+           }
+        }
+
+         [[nodiscard]]
+         constexpr bool empty() const { return lo[0]>hi[0]; }
+
+         [[nodiscard]]
+         constexpr idx_t extent( const ndim_t r ) const { return empty() ? 0 : hi[r]-lo[r]+1; }
+
+         [[nodiscard]]
+         constexpr size_t size() const
+        {
+            size_t n=1;
+            for( ndim_t r=0; r<ndim; ++r ){ n *= size_t(extent(r)); }
+            return n;
+        }
+
+         [[nodiscard]]
+         constexpr size_t offset( const Index idx ) const
+        {
+            size_t n=0;
+            for( ndim_t r=0; r<ndim; ++r ){ n = n*size_t(extent(r)) + size_t(idx[r]-lo[r]); }
+            return n;
+        }
+
+         [[nodiscard]]
+         constexpr Index index( size_t n ) const
+        {
+            Index idx{};
+            for( ndim_t r=ndim; r-->0; )
+           {
+               idx[r] = lo[r] + idx_t( n%size_t(extent(r)) );
+               n /= size_t(extent(r));
+           }
+            return idx;
+        }
+     };
+  }
+}
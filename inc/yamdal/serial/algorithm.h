@@ -4,6 +4,10 @@
 # include "../concepts.h"
 # include "../index.h"
 # include "../execution.h"
+# include "../instrument.h"
+# include "../histogram.h"
+# include "../index_set.h"
+# include "../scatter.h"
 
 # include "../external/mdspan.h"
 
@@ -11,6 +15,10 @@
 # include <type_traits>
 # include <functional>
 # include <utility>
+# include <optional>
+# include <array>
+# include <vector>
+# include <algorithm>
 
 namespace yam
 {
@@ -19,10 +27,128 @@ namespace yam
  *
  * yam::assign
  * Assign values in range [begin_index,begin_index+extents) from one indexable to another indexable
+ *    if both have strides and their innermost axes differ (a transpose), the range is assigned in tiles
  *
  * ===============================================================
  */
 
+   namespace detail
+  {
+   /*
+    * order of the dimensions of an indexable from largest to smallest stride, row-major if it does not have strides
+    */
+      template<ndim_t      ndim,
+               typename       A>
+      [[nodiscard]]
+      constexpr std::array<ndim_t,ndim> memory_order( const A& a )
+     {
+         std::array<ndim_t,ndim> order{};
+         for( ndim_t d=0; d<ndim; ++d ){ order[d]=d; }
+
+         if constexpr( requires { a.stride(0); } )
+        {
+         // stable insertion sort, so equal strides (eg extent 1) keep row-major order
+            for( ndim_t r=1; r<ndim; ++r )
+           {
+               for( ndim_t q=r; q>0 && a.stride(order[q-1]) < a.stride(order[q]); --q )
+              {
+                  std::swap( order[q-1], order[q] );
+              }
+           }
+        }
+         return order;
+     }
+
+   /*
+    * extent of the square tiles used when assigning between indexables with different innermost axes
+    */
+      inline constexpr idx_t transpose_tile = 32;
+
+   /*
+    * true if both indexables have strides and the smallest stride is along different axes,
+    *    so the naive loop would access one of them with a large stride
+    */
+      template<ndim_t      ndim,
+               typename       D,
+               typename       S>
+      [[nodiscard]]
+      constexpr bool is_transposing( const D& destination,
+                                     const S&      source )
+     {
+         if constexpr( requires { destination.stride(0); source.stride(0); } )
+        {
+            return memory_order<ndim>(destination)[ndim-1] != memory_order<ndim>(source)[ndim-1];
+        }
+         else
+        {
+            return false;
+        }
+     }
+
+   /*
+    * assign through square tiles in the plane of the innermost axes of the destination and the source,
+    *    so both are read/written contiguously within a tile and each tile stays in cache
+    */
+      template<typename       Index,
+               typename     Extents,
+               typename Destination,
+               typename      Source>
+      constexpr void transposing_assign( const Index      begin_index,
+                                         const Extents           exts,
+                                               Destination& destination,
+                                         const Source&           source )
+     {
+         constexpr ndim_t ndim = Index::ndim;
+
+         const ndim_t a = memory_order<ndim>(destination)[ndim-1];
+         const ndim_t b = memory_order<ndim>(source)[ndim-1];
+
+         const idx_t na = exts.extent(a);
+         const idx_t nb = exts.extent(b);
+
+         const auto tiles = [&]( Index idx )
+        {
+            for( idx_t bt=0; bt<nb; bt+=transpose_tile )
+           {
+               const idx_t bn = std::min( transpose_tile, nb-bt );
+
+               for( idx_t at=0; at<na; at+=transpose_tile )
+              {
+                  const idx_t an = std::min( transpose_tile, na-at );
+
+                  for( idx_t jb=bt; jb<bt+bn; ++jb )
+                 {
+                     idx[b] = begin_index[b]+jb;
+                     for( idx_t ja=at; ja<at+an; ++ja )
+                    {
+                        idx[a] = begin_index[a]+ja;
+                        destination(idx) = source(idx);
+                    }
+                 }
+              }
+           }
+        };
+
+         if constexpr( ndim==2 )
+        {
+            tiles( begin_index );
+        }
+         else
+        {
+            static_assert( ndim==3, "transposing_assign supports 2 or 3 dimensions" );
+
+         // the remaining axis is the outermost loop
+            const ndim_t c = static_cast<ndim_t>(3-a-b);
+
+            Index idx{begin_index};
+            for( idx[c]=begin_index[c]; idx[c]<begin_index[c]+exts.extent(c); ++idx[c] )
+           {
+               tiles( idx );
+           }
+        }
+     }
+  }
+
 /*
  * 1D grid
  */
@@ -31,15 +157,20 @@ namespace yam
             ptrdiff_t... Exts>
       requires same_grid_as<Destination,
                             Source>
-            && std::assignable_from<element_type_of_t<Destination>,
-                                    element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
             && (sizeof...(Exts)==1)
    constexpr void assign(       execution::serial_policy,
-                          const index_type_of_t<Source> begin_index,
-                          const stx::extents<Exts...>          exts,
-                                Destination&            destination,
-                          const Source&                      source )
+                          const located_index<index_type_of_t<Source>> begin_index,
+                          const stx::extents<Exts...>                         exts,
+                                Destination&                           destination,
+                          const Source&                                     source )
   {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "assign", execution::seq,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Destination,Source>() );
+
       const auto i0 = begin_index[0];
 
       for( idx_t i=i0; i<i0+exts.extent(0); ++i )
@@ -58,15 +189,27 @@ namespace yam
             ptrdiff_t... Exts>
       requires same_grid_as<Destination,
                             Source>
-            && std::assignable_from<element_type_of_t<Destination>,
-                                    element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
             && (sizeof...(Exts)==2)
    constexpr void assign(       execution::serial_policy,
-                          const index_type_of_t<Source> begin_index,
-                          const stx::extents<Exts...>          exts,
-                                Destination&            destination,
-                          const Source&                      source )
+                          const located_index<index_type_of_t<Source>> begin_index,
+                          const stx::extents<Exts...>                         exts,
+                                Destination&                           destination,
+                          const Source&                                     source )
   {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "assign", execution::seq,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Destination,Source>() );
+
+   // strided indexables with different innermost axes, eg a permute_axes view of a span
+      if( detail::is_transposing<2>( destination, source ) )
+     {
+         detail::transposing_assign( begin_index, exts, destination, source );
+         return;
+     }
+
       const auto i0 = begin_index[0];
       const auto j0 = begin_index[1];
 
@@ -90,15 +233,27 @@ namespace yam
             ptrdiff_t... Exts>
       requires same_grid_as<Destination,
                             Source>
-            && std::assignable_from<element_type_of_t<Destination>,
-                                    element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
             && (sizeof...(Exts)==3)
    constexpr void assign(       execution::serial_policy,
-                          const index_type_of_t<Source> begin_index,
-                          const stx::extents<Exts...>          exts,
-                                Destination&            destination,
-                          const Source&                      source )
+                          const located_index<index_type_of_t<Source>> begin_index,
+                          const stx::extents<Exts...>                         exts,
+                                Destination&                           destination,
+                          const Source&                                     source )
   {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "assign", execution::seq,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Destination,Source>() );
+
+   // strided indexables with different innermost axes, eg a permute_axes view of a span
+      if( detail::is_transposing<3>( destination, source ) )
+     {
+         detail::transposing_assign( begin_index, exts, destination, source );
+         return;
+     }
+
       const auto i0 = begin_index[0];
       const auto j0 = begin_index[1];
       const auto k0 = begin_index[2];
@@ -139,13 +294,17 @@ namespace yam
             && (sizeof...(Exts)==ndim_of_v<Source>)
    [[nodiscard]]
    constexpr ReduceType reduce(       execution::serial_policy,
-                                const index_type_of_t<Source> begin_index,
-                                const stx::extents<Exts...>          exts,
-                                      ReduceFunc              reduce_func,
-                                      ReduceType,         /* identity_v */
-                                      ReduceType                     init,
-                                const Source&                      source )
+                                const located_index<index_type_of_t<Source>> begin_index,
+                                const stx::extents<Exts...>                         exts,
+                                      ReduceFunc                             reduce_func,
+                                      ReduceType                                    init,
+                                const Source&                                     source )
   {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "reduce", execution::seq,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source>() );
+
       using index_type   =   index_type_of_t<Source>;
       using element_type = element_type_of_t<Source>;
 
@@ -175,4 +334,1057 @@ namespace yam
 
       return init;
   }
+
+/*
+ * the serial reduction does not need an identity value, but this overload matches the signature of the parallel reductions
+ */
+   template<typename ReduceFunc,
+            typename ReduceType,
+            indexable    Source,
+            ptrdiff_t...   Exts>
+      requires reduction<ReduceFunc,
+                         ReduceType,
+                         element_type_of_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   constexpr ReduceType reduce(       execution::serial_policy               policy,
+                                const located_index<index_type_of_t<Source>> begin_index,
+                                const stx::extents<Exts...>                         exts,
+                                      ReduceFunc                             reduce_func,
+                                      ReduceType,                        /* identity_v */
+                                      ReduceType                                    init,
+                                const Source&                                     source )
+  {
+      return reduce( policy,
+                     begin_index, exts,
+                     std::move(reduce_func),
+                     std::move(init),
+                     source );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::for_each_index
+ * call func(index) for each index in range [begin_index,begin_index+extents), in row-major order
+ *
+ * ===============================================================
+ */
+
+   template<typename      Index,
+            typename       Func,
+            ptrdiff_t...   Exts>
+      requires is_index_type_v<Index>
+            && (sizeof...(Exts)==Index::ndim)
+            && std::invocable<Func&,Index>
+   constexpr void for_each_index(       execution::serial_policy,
+                                  const Index                       begin_index,
+                                  const stx::extents<Exts...>              exts,
+                                        Func&&                             func )
+  {
+      constexpr ndim_t ndim = Index::ndim;
+
+      const auto i0 = begin_index[0];
+
+      for( idx_t i=i0; i<i0+exts.extent(0); ++i )
+     {
+         if constexpr( ndim==1 )
+        {
+            func( Index{i} );
+        }
+         else
+        {
+            const auto j0 = begin_index[1];
+
+            for( idx_t j=j0; j<j0+exts.extent(1); ++j )
+           {
+               if constexpr( ndim==2 )
+              {
+                  func( Index{i,j} );
+              }
+               else
+              {
+                  static_assert( ndim==3, "for_each_index supports up to 3 dimensions" );
+
+                  const auto k0 = begin_index[2];
+
+                  for( idx_t k=k0; k<k0+exts.extent(2); ++k )
+                 {
+                     func( Index{i,j,k} );
+                 }
+              }
+           }
+        }
+     }
+
+      return;
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::accumulate
+ *    Accumulates the range [begin_index,begin_index+extents), in unspecified order, into init in place
+ *       ie requires accumulate_func(init,source(index)), with any return value ignored
+ *    unlike reduce, the accumulator is never moved or copied per element, so large accumulators (vectors, statistics) are as cheap as scalars
+ *    parallel versions accumulate into a copy of identity_v per thread, and merge the copies into init with combine_func(init,partial)
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename AccumulateFunc,
+               typename AccumulateType,
+               typename         Source,
+               ptrdiff_t...       Exts>
+      constexpr void accumulate_in_place(       execution::serial_policy,
+                                          const index_type_of_t<Source>             begin_index,
+                                          const stx::extents<Exts...>                      exts,
+                                                AccumulateFunc&                 accumulate_func,
+                                                AccumulateType&                             acc,
+                                          const Source&                                  source )
+     {
+         using index_type = index_type_of_t<Source>;
+
+         for_each_index( execution::seq, begin_index, exts,
+            [&]( const index_type idx )
+           {
+               std::invoke( accumulate_func, acc, source(idx) );
+           } );
+     }
+
+   // serial accumulation does not need identity_v or combine_func, but this overload matches the parallel ones
+      template<typename AccumulateFunc,
+               typename    CombineFunc,
+               typename AccumulateType,
+               typename         Source,
+               ptrdiff_t...       Exts>
+      constexpr void accumulate_in_place(       execution::serial_policy             policy,
+                                          const index_type_of_t<Source>             begin_index,
+                                          const stx::extents<Exts...>                      exts,
+                                                AccumulateFunc&                 accumulate_func,
+                                                CombineFunc&,                /* combine_func */
+                                          const AccumulateType&,               /* identity_v */
+                                                AccumulateType&                             acc,
+                                          const Source&                                  source )
+     {
+         accumulate_in_place( policy, begin_index, exts, accumulate_func, acc, source );
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::inclusive_scan / yam::exclusive_scan
+ *    whole-range scan, over the range [begin_index,begin_index+extents) in row-major order:
+ *       inclusive: destination(idx) = scan_func( ...scan_func( scan_func( init, source(first) ), ... ), source(idx) )
+ *       exclusive: the same, but excluding source(idx), so destination(first) = init
+ *    inclusive_scan without init starts from source(first)
+ *
+ *    per-axis scan (inclusive_scan<Axis> / exclusive_scan<Axis>), along each line of the range in the direction Axis independently
+ *       eg cumulative integral in the vertical
+ *
+ *    destination may be the same as source (in-place scan)
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+   // value type of a scan without an initial value
+      template<typename Source>
+      using scan_type_of_t = std::remove_cvref_t<element_type_of_t<Source>>;
+
+   /*
+    * one step of a scan at idx: update the running value and write the destination
+    */
+      template<bool      is_inclusive,
+               typename   Destination,
+               typename      ScanFunc,
+               typename      ScanType,
+               typename        Source,
+               typename         Index>
+      constexpr void scan_step(       Destination& destination,
+                                      ScanFunc&      scan_func,
+                                      ScanType&            acc,
+                                const Source&           source,
+                                const Index                idx )
+     {
+         if constexpr( is_inclusive )
+        {
+            acc = std::invoke( scan_func, std::move(acc), source(idx) );
+            destination(idx) = acc;
+        }
+         else
+        {
+            ScanType next = std::invoke( scan_func, acc, source(idx) );
+            destination(idx) = std::move(acc);
+            acc = std::move(next);
+        }
+     }
+
+   /*
+    * serial whole-range scan, starting from init if it has a value, otherwise from source(begin_index) (inclusive only)
+    */
+      template<bool      is_inclusive,
+               typename   Destination,
+               typename      ScanFunc,
+               typename      ScanType,
+               typename        Source,
+               ptrdiff_t...      Exts>
+      constexpr void scan(       execution::serial_policy,
+                           const located_index<index_type_of_t<Source>> begin_index,
+                           const stx::extents<Exts...>                         exts,
+                                 Destination&                           destination,
+                                 ScanFunc&                                scan_func,
+                                 std::optional<ScanType>                       init,
+                           const Source&                                     source )
+     {
+         [[maybe_unused]]
+         const instrument::kernel_scope scope( is_inclusive ? "inclusive_scan" : "exclusive_scan",
+                                               execution::seq,
+                                               begin_index, exts,
+                                               instrument::bytes_per_elem<Destination,Source>() );
+
+         using index_type = index_type_of_t<Source>;
+
+         if( is_empty_range(exts) ){ return; }
+
+         const index_type first{begin_index};
+
+      // without an initial value the scan starts from the first element, which is then skipped
+         bool skip_first = false;
+
+         if( !init )
+        {
+            init.emplace( source(first) );
+            destination(first) = *init;
+            skip_first = true;
+        }
+
+         ScanType& acc = *init;
+
+         for_each_index( execution::seq, first, exts,
+            [&]( const index_type idx )
+           {
+               if( skip_first ){ skip_first=false; return; }
+               scan_step<is_inclusive>( destination, scan_func, acc, source, idx );
+           } );
+     }
+
+   /*
+    * serial scan along each line of the range in direction Axis
+    */
+      template<ndim_t           Axis,
+               bool      is_inclusive,
+               typename   Destination,
+               typename      ScanFunc,
+               typename      ScanType,
+               typename        Source,
+               ptrdiff_t...      Exts>
+      constexpr void scan_axis(       execution::serial_policy,
+                                const located_index<index_type_of_t<Source>> begin_index,
+                                const stx::extents<Exts...>                         exts,
+                                      Destination&                           destination,
+                                      ScanFunc&                                scan_func,
+                                const std::optional<ScanType>&                      init,
+                                const Source&                                     source )
+     {
+         [[maybe_unused]]
+         const instrument::kernel_scope scope( is_inclusive ? "inclusive_scan" : "exclusive_scan",
+                                               execution::seq,
+                                               begin_index, exts,
+                                               instrument::bytes_per_elem<Destination,Source>() );
+
+         using index_type = index_type_of_t<Source>;
+
+         const idx_t n = exts.extent(Axis);
+
+         if( is_empty_range(exts) ){ return; }
+
+      // one index per line: extent 1 in direction Axis
+         const auto line_exts = replace_nth_extent<Axis,1>(exts);
+
+         for_each_index( execution::seq, index_type{begin_index}, line_exts,
+            [&]( index_type idx )
+           {
+               idx_t k=0;
+
+               ScanType acc = init ? *init : ScanType(source(idx));
+
+               if( !init )
+              {
+                  destination(idx) = acc;
+                  ++idx[Axis];
+                  ++k;
+              }
+
+               for( ; k<n; ++k )
+              {
+                  scan_step<is_inclusive>( destination, scan_func, acc, source, idx );
+                  ++idx[Axis];
+              }
+           } );
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::reduce_axis
+ *    reduces the range [begin_index,begin_index+extents) along the axes Axes... into a destination of rank ndim-sizeof...(Axes)
+ *       destination(out) = reduce_func( ...reduce_func( init, source(idx0) )..., source(idxn) ) for all idx in the range with idx==out on the remaining axes
+ *    the destination is indexed by the source index with the reduced axes removed, eg column sums of a 2D range: reduce_axis<0>, destination(index1{j})
+ *
+ *    single pass over the source, sweeping the dimensions from largest to smallest stride (for indexables with strides, row-major otherwise):
+ *       if the reduced axes are innermost, each output point is accumulated in a local value and written once
+ *       otherwise the destination is initialised to init and used as the accumulator, so intermediate values are stored as the destination element type
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+   /*
+    * call func(index) for each index in the range, with order[0] the outermost loop and order[ndim-1] the innermost
+    */
+      template<typename      Index,
+               typename    Extents,
+               typename       Func>
+      constexpr void for_each_index_in_order( const Index                            begin_index,
+                                              const Extents                                 exts,
+                                              const std::array<ndim_t,Index::ndim>&        order,
+                                                    Func&&                                  func )
+     {
+         constexpr ndim_t ndim = Index::ndim;
+
+         Index idx{begin_index};
+
+         const ndim_t d0 = order[0];
+         for( idx[d0]=begin_index[d0]; idx[d0]<begin_index[d0]+exts.extent(d0); ++idx[d0] )
+        {
+            if constexpr( ndim==1 )
+           {
+               func( idx );
+           }
+            else
+           {
+               const ndim_t d1 = order[1];
+               for( idx[d1]=begin_index[d1]; idx[d1]<begin_index[d1]+exts.extent(d1); ++idx[d1] )
+              {
+                  if constexpr( ndim==2 )
+                 {
+                     func( idx );
+                 }
+                  else
+                 {
+                     static_assert( ndim==3, "for_each_index_in_order supports up to 3 dimensions" );
+
+                     const ndim_t d2 = order[2];
+                     for( idx[d2]=begin_index[d2]; idx[d2]<begin_index[d2]+exts.extent(d2); ++idx[d2] )
+                    {
+                        func( idx );
+                    }
+                 }
+              }
+           }
+        }
+     }
+
+   // true if axes are strictly increasing and less than ndim
+      template<ndim_t ndim,
+               ndim_t... Axes>
+      [[nodiscard]]
+      constexpr bool valid_axes()
+     {
+         constexpr std::array<ndim_t,sizeof...(Axes)> axes{Axes...};
+
+         for( size_t r=0; r<axes.size(); ++r )
+        {
+            if( axes[r]>=ndim ){ return false; }
+            if( r>0 && axes[r]<=axes[r-1] ){ return false; }
+        }
+         return true;
+     }
+
+   // index with the axes Axes... removed
+      template<ndim_t... Axes,
+               ndim_t    ndim,
+               grid_t    grid>
+      [[nodiscard]]
+      constexpr auto drop_axes( const index<ndim,grid> idx )
+         -> index<ndim-sizeof...(Axes),grid>
+     {
+         index<ndim-sizeof...(Axes),grid> out{};
+         ndim_t r=0;
+         for( ndim_t d=0; d<ndim; ++d )
+        {
+            if( !((d==Axes)||...) ){ out[r++]=idx[d]; }
+        }
+         return out;
+     }
+  }
+
+   template<ndim_t...           Axes,
+            indexable    Destination,
+            typename      ReduceFunc,
+            typename      ReduceType,
+            indexable         Source,
+            ptrdiff_t...        Exts>
+      requires (grid_of_v<Destination> == grid_of_v<Source>)
+            && reduction<ReduceFunc,
+                         ReduceType,
+                         element_type_of_t<Source>>
+            && transformation_r<ReduceFunc,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  ReduceType&&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+            && (sizeof...(Axes)>0)
+            && (ndim_of_v<Destination>+sizeof...(Axes)==ndim_of_v<Source>)
+            && (detail::valid_axes<ndim_of_v<Source>,Axes...>())
+   constexpr void reduce_axis(       execution::serial_policy,
+                               const located_index<index_type_of_t<Source>> begin_index,
+                               const stx::extents<Exts...>                         exts,
+                                     Destination&                           destination,
+                                     ReduceFunc                             reduce_func,
+                                     ReduceType                                    init,
+                               const Source&                                     source )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "reduce_axis", execution::seq,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source>() );
+
+      using index_type = index_type_of_t<Source>;
+      constexpr ndim_t ndim = index_type::ndim;
+      constexpr ndim_t nreduced = sizeof...(Axes);
+
+      constexpr auto is_reduced =
+         []( const ndim_t d ){ return ((d==Axes)||...); };
+
+      if( is_empty_range(exts) ){ return; }
+
+      const auto order = detail::memory_order<ndim>(source);
+
+   // extents of the output points (reduced axes have extent 1), and of the reduced axes for one output point
+      std::array<idx_t,ndim> outer_exts{};
+      std::array<idx_t,ndim> inner_exts{};
+      for( ndim_t d=0; d<ndim; ++d )
+     {
+         outer_exts[d] = is_reduced(d) ? 1 : exts.extent(d);
+         inner_exts[d] = is_reduced(d) ? exts.extent(d) : 1;
+     }
+
+      bool reduced_innermost=true;
+      for( ndim_t r=ndim-nreduced; r<ndim; ++r ){ reduced_innermost = reduced_innermost && is_reduced(order[r]); }
+
+      if( reduced_innermost )
+     {
+         detail::for_each_index_in_order( index_type{begin_index}, dextents<ndim>(outer_exts), order,
+            [&]( const index_type out_idx )
+           {
+               ReduceType acc = init;
+
+               detail::for_each_index_in_order( out_idx, dextents<ndim>(inner_exts), order,
+                  [&]( const index_type idx )
+                 {
+                     acc = std::invoke( reduce_func, std::move(acc), source(idx) );
+                 } );
+
+               destination( detail::drop_axes<Axes...>(out_idx) ) = std::move(acc);
+           } );
+     }
+      else
+     {
+         detail::for_each_index_in_order( index_type{begin_index}, dextents<ndim>(outer_exts), order,
+            [&]( const index_type out_idx )
+           {
+               destination( detail::drop_axes<Axes...>(out_idx) ) = init;
+           } );
+
+         detail::for_each_index_in_order( index_type{begin_index}, exts, order,
+            [&]( const index_type idx )
+           {
+               auto&& acc = destination( detail::drop_axes<Axes...>(idx) );
+               acc = std::invoke( reduce_func, std::move(acc), source(idx) );
+           } );
+     }
+
+      return;
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::argmin / yam::argmax / yam::top_k
+ *    reductions which return the index of the selected elements together with their values, as yam::indexed_value
+ *    candidates are ranked by compare(a.value,b.value) (a before b), and equal values are ranked by row-major index,
+ *       so the result does not depend on the execution policy or the number of threads
+ *    top_k keeps a bounded heap of at most k candidates, so uses O(k) memory per thread
+ *
+ * ===============================================================
+ */
+
+   template<typename Index,
+            typename     T>
+   struct indexed_value
+  {
+      Index index;
+      T     value;
+  };
+
+   namespace detail
+  {
+      template<typename Source>
+      using selected_value_t = std::remove_cvref_t<element_type_of_t<Source>>;
+
+      template<typename Source>
+      using selected_type_t = indexed_value<index_type_of_t<Source>,
+                                            selected_value_t<Source>>;
+
+   // true if candidate a is ranked before candidate b
+      template<typename Compare,
+               typename   Index,
+               typename       T>
+      [[nodiscard]]
+      constexpr bool ranks_before(       Compare&                      compare,
+                                   const indexed_value<Index,T>&             a,
+                                   const indexed_value<Index,T>&             b )
+     {
+         if( std::invoke( compare, a.value, b.value ) ){ return true;  }
+         if( std::invoke( compare, b.value, a.value ) ){ return false; }
+         return a.index.idxs < b.index.idxs;
+     }
+
+   // keep the better of best and candidate in best, either may be empty
+      template<typename Compare,
+               typename   Index,
+               typename       T>
+      constexpr void select_best(       Compare&                                     compare,
+                                        std::optional<indexed_value<Index,T>>&          best,
+                                  const std::optional<indexed_value<Index,T>>&     candidate )
+     {
+         if( candidate && ( !best || ranks_before( compare, *candidate, *best ) ) ){ best = candidate; }
+     }
+
+   /*
+    * the (at most) k best candidates, stored as a heap with the worst candidate at the front
+    */
+      template<typename   Index,
+               typename       T,
+               typename Compare>
+      class top_k_heap
+     {
+      public :
+
+         using value_type = indexed_value<Index,T>;
+
+         constexpr top_k_heap( const size_t    k_max,
+                                     Compare   comp )
+            : k( k_max ), compare( std::move(comp) )
+        {
+            heap.reserve( k );
+        }
+
+         constexpr void push( value_type candidate )
+        {
+            if( heap.size() < k )
+           {
+               heap.push_back( std::move(candidate) );
+               std::push_heap( heap.begin(), heap.end(), ranked() );
+           }
+            else if( k > 0 && ranks_before( compare, candidate, heap.front() ) )
+           {
+               std::pop_heap( heap.begin(), heap.end(), ranked() );
+               heap.back() = std::move(candidate);
+               std::push_heap( heap.begin(), heap.end(), ranked() );
+           }
+        }
+
+      // heap with the same k and compare, and no candidates
+         [[nodiscard]]
+         constexpr top_k_heap empty_copy() const
+        {
+            return top_k_heap( k, compare );
+        }
+
+         constexpr void merge( const top_k_heap& other )
+        {
+            for( const auto& candidate : other.heap ){ push( candidate ); }
+        }
+
+      // candidates from best to worst
+         [[nodiscard]]
+         constexpr std::vector<value_type> sorted() &&
+        {
+            std::sort_heap( heap.begin(), heap.end(), ranked() );
+            return std::move(heap);
+        }
+
+      private :
+
+      // heap order: the worst candidate is at the front
+         [[nodiscard]]
+         constexpr auto ranked()
+        {
+            return [this]( const value_type& a, const value_type& b ){ return ranks_before( compare, a, b ); };
+        }
+
+         size_t k;
+         Compare compare;
+         std::vector<value_type> heap;
+     };
+
+   /*
+    * serial argmin/argmax: best element in the range according to compare
+    *    the range is visited in row-major order, so only a strictly better value replaces the current best
+    */
+      template<typename   Compare,
+               typename    Source,
+               ptrdiff_t...  Exts>
+      constexpr auto arg_extremum(       execution::serial_policy,
+                                   const index_type_of_t<Source>             begin_index,
+                                   const stx::extents<Exts...>                      exts,
+                                         Compare                                 compare,
+                                   const Source&                                  source )
+         -> std::optional<selected_type_t<Source>>
+     {
+         using index_type = index_type_of_t<Source>;
+
+         if( is_empty_range(exts) ){ return std::nullopt; }
+
+      // seeded with the first element, so the loop only compares values
+         selected_type_t<Source> best{begin_index, source(begin_index)};
+
+         for_each_index( execution::seq, begin_index, exts,
+            [&]( const index_type idx )
+           {
+               decltype(auto) elem = source(idx);
+               if( std::invoke( compare, elem, best.value ) ){ best = {idx, elem}; }
+           } );
+
+         return best;
+     }
+
+   // serial top_k, the k best elements in the range according to compare
+      template<typename   Compare,
+               typename    Source,
+               ptrdiff_t...  Exts>
+      constexpr void top_k(       execution::serial_policy,
+                            const index_type_of_t<Source>             begin_index,
+                            const stx::extents<Exts...>                      exts,
+                                  top_k_heap<index_type_of_t<Source>,
+                                             selected_value_t<Source>,
+                                             Compare>&                        heap,
+                            const Source&                                  source )
+     {
+         using index_type = index_type_of_t<Source>;
+
+         for_each_index( execution::seq, begin_index, exts,
+            [&]( const index_type idx )
+           {
+               heap.push( {idx, source(idx)} );
+           } );
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::histogram / yam::binned_statistic
+ *    histogram counts the elements of the range in each bin
+ *    binned_statistic accumulates the statistics of values(idx) in the bin of keys(idx)
+ *    elements outside all bins are ignored
+ *    the bins are updated in place, so the cost per element does not depend on the number of bins
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+   // statistics of integer values are accumulated in double precision
+      template<typename Values>
+      using statistic_value_t =
+         std::conditional_t<std::floating_point<std::remove_cvref_t<element_type_of_t<Values>>>,
+                            std::remove_cvref_t<element_type_of_t<Values>>,
+                            double>;
+
+      template<binning      Bins,
+               typename   Source,
+               ptrdiff_t... Exts>
+      constexpr void histogram(       execution::serial_policy,
+                                const index_type_of_t<Source>             begin_index,
+                                const stx::extents<Exts...>                      exts,
+                                const Bins&                                      bins,
+                                      histogram_mode,
+                                      std::vector<size_t>&                     counts,
+                                const Source&                                  source )
+     {
+         using index_type = index_type_of_t<Source>;
+         using value_type = typename Bins::value_type;
+
+         const size_t nbins = bins.size();
+
+         for_each_index( execution::seq, begin_index, exts,
+            [&]( const index_type idx )
+           {
+               const size_t b = bins.bin( value_type( source(idx) ) );
+               if( b<nbins ){ ++counts[b]; }
+           } );
+     }
+
+      template<binning      Bins,
+               typename        T,
+               typename     Keys,
+               typename   Values,
+               ptrdiff_t... Exts>
+      constexpr void binned_statistic(       execution::serial_policy,
+                                       const index_type_of_t<Keys>               begin_index,
+                                       const stx::extents<Exts...>                      exts,
+                                       const Bins&                                      bins,
+                                             histogram_mode,
+                                             std::vector<bin_statistics<T>>&           stats,
+                                       const Keys&                                      keys,
+                                       const Values&                                  values )
+     {
+         using index_type = index_type_of_t<Keys>;
+         using value_type = typename Bins::value_type;
+
+         const size_t nbins = bins.size();
+
+         for_each_index( execution::seq, begin_index, exts,
+            [&]( const index_type idx )
+           {
+               const size_t b = bins.bin( value_type( keys(idx) ) );
+               if( b<nbins ){ stats[b].add( T( values(idx) ) ); }
+           } );
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::compact
+ *    indices in range [begin_index,begin_index+extents) at which mask is true, in row-major order
+ *
+ * yam::assign over an index list
+ *    assign from one indexable to another at each index of a (compacted) list
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename         Mask,
+               ptrdiff_t...     Exts>
+      constexpr void compact_mask(       execution::serial_policy,
+                                   const index_type_of_t<Mask>                      begin_index,
+                                   const stx::extents<Exts...>                             exts,
+                                   const Mask&                                             mask,
+                                         std::vector<index_type_of_t<Mask>>&            indices )
+     {
+         using index_type = index_type_of_t<Mask>;
+
+         for_each_index( execution::seq, begin_index, exts,
+            [&]( const index_type idx )
+           {
+               if( mask(idx) ){ indices.push_back( idx ); }
+           } );
+     }
+  }
+
+   template<indexable Destination,
+            indexable      Source>
+      requires same_grid_as<Destination,
+                            Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+   constexpr void assign(       execution::serial_policy,
+                          const std::vector<index_type_of_t<Source>>&           indices,
+                                Destination&                                destination,
+                          const Source&                                          source,
+                          const located_index<index<1,grid_of_v<Source>>>     location = {} )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "assign", execution::seq,
+                                            location,
+                                            dextents<1>( static_cast<ptrdiff_t>(indices.size()) ),
+                                            instrument::bytes_per_elem<Destination,Source>() );
+
+      for( const auto& idx : indices )
+     {
+         destination(idx) = source(idx);
+     }
+      return;
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::assign / yam::reduce over an index_set
+ *    iterate over the row spans of the set, instead of a dense range
+ *
+ * ===============================================================
+ */
+
+   template<indexable Destination,
+            indexable      Source>
+      requires same_grid_as<Destination,
+                            Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+   void assign(       execution::serial_policy,
+                const index_set<ndim_of_v<Source>,grid_of_v<Source>>&      set,
+                      Destination&                                 destination,
+                const Source&                                           source,
+                const located_index<index<1,grid_of_v<Source>>>      location = {} )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "assign", execution::seq,
+                                            location,
+                                            dextents<1>( static_cast<ptrdiff_t>(set.size()) ),
+                                            instrument::bytes_per_elem<Destination,Source>() );
+
+      set.for_each_index(
+         [&]( const index_type_of_t<Source> idx )
+        {
+            destination(idx) = source(idx);
+        } );
+  }
+
+   template<typename ReduceFunc,
+            typename ReduceType,
+            indexable    Source>
+      requires reduction<ReduceFunc,
+                         ReduceType,
+                         element_type_of_t<Source>>
+   [[nodiscard]]
+   ReduceType reduce(       execution::serial_policy,
+                      const index_set<ndim_of_v<Source>,grid_of_v<Source>>&      set,
+                            ReduceFunc                                   reduce_func,
+                            ReduceType                                          init,
+                      const Source&                                           source,
+                      const located_index<index<1,grid_of_v<Source>>>      location = {} )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "reduce", execution::seq,
+                                            location,
+                                            dextents<1>( static_cast<ptrdiff_t>(set.size()) ),
+                                            instrument::bytes_per_elem<Source>() );
+
+      set.for_each_index(
+         [&]( const index_type_of_t<Source> idx )
+        {
+            init = std::invoke( reduce_func, std::move(init), source(idx) );
+        } );
+
+      return init;
+  }
+
+// matches the signature of the parallel reductions
+   template<typename ReduceFunc,
+            typename ReduceType,
+            indexable    Source>
+      requires reduction<ReduceFunc,
+                         ReduceType,
+                         element_type_of_t<Source>>
+   [[nodiscard]]
+   ReduceType reduce(       execution::serial_policy                          policy,
+                      const index_set<ndim_of_v<Source>,grid_of_v<Source>>&      set,
+                            ReduceFunc                                   reduce_func,
+                            ReduceType,                                /* identity_v */
+                            ReduceType                                          init,
+                      const Source&                                           source,
+                      const located_index<index<1,grid_of_v<Source>>>      location = {} )
+  {
+      return reduce( policy, set, std::move(reduce_func), std::move(init), source, location );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::scatter_add
+ *    destination(indices(idx)) += values(idx) for each idx in range [begin_index,begin_index+extents)
+ *    the serial version ignores the scatter_mode
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename Destination,
+               typename     Indices,
+               typename      Values,
+               ptrdiff_t...    Exts>
+      constexpr void scatter_add_into(       execution::serial_policy,
+                                       const index_type_of_t<Values>               begin_index,
+                                       const stx::extents<Exts...>                        exts,
+                                             scatter_mode,
+                                             Destination&                          destination,
+                                       const Indices&                                  indices,
+                                       const Values&                                    values )
+     {
+         using point_index  = index_type_of_t<Values>;
+         using target_index = index_type_of_t<Destination>;
+
+         for_each_index( execution::seq, begin_index, exts,
+            [&]( const point_index idx )
+           {
+               destination( target_index( indices(idx) ) ) += values(idx);
+           } );
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::detail::for_each_weighted
+ *    call func(n) for each item n of a list of weighted items (eg the patches of a yam::patch_collection, weighted by their sizes)
+ *    the serial version calls func in item order
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename Func>
+         requires std::invocable<Func&,size_t>
+      void for_each_weighted(       execution::serial_policy,
+                              const std::vector<size_t>&      weights,
+                                    Func&&                       func )
+     {
+         for( size_t n=0; n<weights.size(); ++n ){ func( n ); }
+     }
+  }
+
+
+/*
+ * ===============================================================
+ *
+ * yam::prolong_linear
+ *    fine(i) for each fine index i in range [begin_index,begin_index+extents), interpolated from coarse of half resolution, see multigrid.h
+ *    the interpolation is separable: for each fine row along the last axis, the coarse rows around it are first combined
+ *    with the weights of the outer axes into one buffer row, which is then interpolated along the last axis
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+   /*
+    * coarse indices and weights for linear interpolation onto fine index i along one axis, returns the number of points used (1 or 2)
+    *    primal: even fine nodes coincide with coarse node i/2, odd ones lie midway between two coarse nodes
+    *    dual:   fine cell i is one half of coarse cell floor(i/2), and is interpolated towards the coarse neighbour on the same side
+    */
+      template<grid_t      grid,
+               typename       T>
+      [[nodiscard]]
+      constexpr int linear_prolongation_1d( const idx_t                     i,
+                                                  std::array<idx_t,2>& coarse,
+                                                  std::array<T,2>&    weights )
+     {
+         const idx_t I = i>>1;   // floor(i/2), also for negative i
+         const bool odd = (i&1)!=0;
+
+         if constexpr( grid==primal )
+        {
+            coarse  = { I, I+1 };
+            weights = { odd ? T(0.5) : T(1), T(0.5) };
+            return odd ? 2 : 1;
+        }
+         else
+        {
+            coarse  = { I, odd ? I+1 : I-1 };
+            weights = { T(0.75), T(0.25) };
+            return 2;
+        }
+     }
+
+      template<typename    Fine,
+               typename  Coarse,
+               ptrdiff_t... Exts>
+      void prolong_linear_into(       execution::serial_policy,
+                                const index_type_of_t<Fine>          begin_index,
+                                const stx::extents<Exts...>                 exts,
+                                      Fine&                                 fine,
+                                const Coarse&                             coarse )
+     {
+         using fine_index   = index_type_of_t<Fine>;
+         using coarse_index = index_type_of_t<Coarse>;
+         using value_type   = std::remove_cvref_t<element_type_of_t<const Coarse&>>;
+
+         constexpr ndim_t ndim = fine_index::ndim;
+         constexpr grid_t grid = fine_index::grid;
+         constexpr ndim_t last = ndim-1;
+
+         if( num_elems( exts )==0 ){ return; }
+
+      // coarse indices [K0,K1] needed along the last axis
+         const idx_t k0 = begin_index[last];
+         const idx_t k1 = k0+exts.extent(last)-1;
+         std::array<idx_t,2> lo_points, hi_points;
+         std::array<value_type,2> unused;
+         const int nlo = linear_prolongation_1d<grid>( k0, lo_points, unused );
+         const int nhi = linear_prolongation_1d<grid>( k1, hi_points, unused );
+         const idx_t K0 = nlo==2 ? std::min( lo_points[0], lo_points[1] ) : lo_points[0];
+         const idx_t K1 = nhi==2 ? std::max( hi_points[0], hi_points[1] ) : hi_points[0];
+
+         std::vector<value_type> row( size_t(K1-K0+1) );
+
+         for_each_index( execution::seq, begin_index, replace_nth_extent<last,1>(exts),
+            [&]( const fine_index first )
+           {
+            // coarse rows around this fine row, and their weights, along the outer axes
+               std::array<std::array<idx_t,2>,ndim>      points{};
+               std::array<std::array<value_type,2>,ndim> weights{};
+               std::array<int,ndim>                      npoints{};
+               for( ndim_t r=0; r<last; ++r ){ npoints[r] = linear_prolongation_1d<grid>( first[r], points[r], weights[r] ); }
+
+               std::fill( row.begin(), row.end(), value_type(0) );
+
+               for( unsigned corner=0; corner<(1u<<last); ++corner )
+              {
+                  coarse_index I{};
+                  value_type w(1);
+                  bool used=true;
+                  for( ndim_t r=0; r<last; ++r )
+                 {
+                     const unsigned b = (corner>>r)&1u;
+                     used = used && int(b)<npoints[r];
+                     I[r] = points[r][b];
+                     w   *= weights[r][b];
+                 }
+                  if( !used ){ continue; }
+
+                  for( idx_t K=K0; K<=K1; ++K )
+                 {
+                     I[last] = K;
+                     row[size_t(K-K0)] += w*coarse(I);
+                 }
+              }
+
+            // interpolate the buffer row along the last axis, buffer element K-K0 holding coarse index K
+               const value_type* const r = row.data();
+               fine_index i{first};
+               for( idx_t k=k0; k<=k1; ++k )
+              {
+                  i[last] = k;
+                  const idx_t K = (k>>1)-K0;
+                  if constexpr( grid==primal )
+                 {
+                     fine(i) = (k&1) ? value_type(0.5)*(r[K]+r[K+1]) : r[K];
+                 }
+                  else
+                 {
+                     fine(i) = value_type(0.75)*r[K] + value_type(0.25)*r[(k&1) ? K+1 : K-1];
+                 }
+              }
+           } );
+     }
+  }
+
 }
@@ -0,0 +1,506 @@
+
+# pragma once
+
+# include "concepts.h"
+# include "type_traits.h"
+# include "index.h"
+# include "span.h"
+# include "array.h"
+
+# include "external/mdspan.h"
+
+# include <array>
+# include <utility>
+# include <concepts>
+# include <type_traits>
+
+# include <cassert>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * yam::slice / yam::subview
+ * zero-copy views of a box (slice: every strides[r]-th point along each axis) of a source indexable
+ *    the view has its own index origin: view(i) is source(begin_index + strides*i)
+ *
+ *    basic_span and basic_array sources give a basic_span over the same memory (through stx::subspan),
+ *    so algorithms keep direct pointer access. The span is a cspan if the source elements are not modifiable.
+ *    An rvalue basic_array is rejected, since the span would outlive its storage.
+ *    Other indexables give a view which remaps the index and calls the source, holding a reference to an lvalue source
+ *    or a copy of an rvalue source.
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+   // indexables exposing the parts of an stx::basic_mdspan, eg basic_span and basic_array
+      template<typename A>
+      concept mdspan_backed =
+         indexable<A>
+      && requires( const A& a )
+        {
+            a.data();
+            a.mapping();
+            a.accessor();
+            a.extents();
+            typename A::element_type;
+            typename A::layout_type;
+            typename A::accessor_type;
+        };
+
+   // basic_array owns its storage, so a basic_span over an rvalue basic_array would dangle
+      template<typename A>
+      inline constexpr bool is_owning_v = false;
+
+      template<typename    ElementType,
+               typename        Extents,
+               typename   LayoutPolicy,
+               typename AccessorPolicy,
+               grid_t             GRID>
+      inline constexpr bool is_owning_v<basic_array<ElementType,Extents,LayoutPolicy,AccessorPolicy,GRID>> = true;
+
+   // forwarded source (S deduced from S&&) which a basic_span can point into: an lvalue, or an rvalue which does not own its storage
+      template<typename S>
+      concept borrowable =
+         std::is_lvalue_reference_v<S>
+      || !is_owning_v<std::remove_cvref_t<S>>;
+
+      template<typename Indices>
+      struct dynamic_stride_layout;
+
+      template<size_t... Idxs>
+      struct dynamic_stride_layout<std::index_sequence<Idxs...>>
+         : std::type_identity<stx::layout_stride<((void)Idxs,stx::dynamic_extent)...>> {};
+
+   // layout_stride with all strides dynamic
+      template<size_t ndim>
+      using dynamic_stride_layout_t = typename dynamic_stride_layout<std::make_index_sequence<ndim>>::type;
+
+   // stx::subspan of the box [begin_index, begin_index+lengths) of an mdspan-backed source
+      template<mdspan_backed S>
+      [[nodiscard]]
+      constexpr auto subspan_box( const S&                                              source,
+                                  const index_type_of_t<S>                         begin_index,
+                                  const std::array<ptrdiff_t,ndim_of_v<S>>            lengths )
+     {
+         using mdspan_t =
+            stx::basic_mdspan<typename S::element_type,
+                              typename S::extents_type,
+                              typename S::layout_type,
+                              typename S::accessor_type>;
+
+         const mdspan_t m( source.data(), source.mapping(), source.accessor() );
+
+         return [&]<size_t... Idxs>( std::index_sequence<Idxs...> )
+        {
+            return stx::subspan( m, std::pair<ptrdiff_t,ptrdiff_t>{ begin_index[Idxs],
+                                                                   begin_index[Idxs]+lengths[Idxs] }... );
+        }( std::make_index_sequence<ndim_of_v<S>>() );
+     }
+
+   // whether the elements of the source can be modified through I
+      template<typename I>
+      inline constexpr bool is_const_source_v =
+         std::is_const_v<std::remove_reference_t<element_type_of_t<I&>>>;
+
+   // view calling the source at source_index(idx), holding a reference to an lvalue source or a copy of an rvalue source
+      template<typename         I,
+               typename  IndexMap>
+      [[nodiscard]]
+      constexpr view auto reindexed( I&&               source,
+                                     const IndexMap source_index )
+     {
+         using source_type = std::remove_cvref_t<I>;
+         using index_type  = index_type_of_t<source_type>;
+
+         if constexpr( std::is_lvalue_reference_v<I> )
+        {
+            using return_type = element_type_of_t<I>;
+
+            return [ &source, source_index ]
+                  ( const index_type idx ) -> return_type
+                 { return source( source_index(idx) ); };
+        }
+         else
+        {
+            using return_type = element_type_of_t<const source_type&>;
+
+            return [ source=std::move(source), source_index ]
+                  ( const index_type idx ) -> return_type
+                 { return source( source_index(idx) ); };
+        }
+     }
+
+   // generic index-remapping view: view(idx) is source(begin_index + strides*idx)
+      template<typename I>
+      [[nodiscard]]
+      constexpr view auto remapped( I&&                                                                      source,
+                                    const index_type_of_t<std::remove_cvref_t<I>>                      begin_index,
+                                    const std::array<idx_t,ndim_of_v<std::remove_cvref_t<I>>>              strides )
+     {
+         using index_type = index_type_of_t<std::remove_cvref_t<I>>;
+
+         constexpr ndim_t ndim = ndim_of_v<std::remove_cvref_t<I>>;
+
+         return reindexed( std::forward<I>(source),
+                           [ begin_index, strides ]( const index_type idx ) -> index_type
+                          {
+                              index_type i{};
+                              for( ndim_t r=0; r<ndim; ++r ){ i[r] = begin_index[r] + strides[r]*idx[r]; }
+                              return i;
+                          } );
+     }
+  }
+
+/*
+ * slice of an mdspan-backed source, as a basic_span with layout_stride and the given extents type
+ */
+   template<typename         S,
+            ptrdiff_t...  Exts>
+      requires detail::mdspan_backed<std::remove_cvref_t<S>>
+            && (sizeof...(Exts) == ndim_of_v<std::remove_cvref_t<S>>)
+            && detail::borrowable<S>
+   [[nodiscard]]
+   constexpr auto slice( S&&                                                                       source,
+                         const index_type_of_t<std::remove_cvref_t<S>>                        begin_index,
+                         const stx::extents<Exts...>                                                 exts,
+                         const std::array<idx_t,sizeof...(Exts)>                                  strides )
+  {
+      using source_type = std::remove_cvref_t<S>;
+
+      constexpr size_t ndim = sizeof...(Exts);
+
+      using extents_type = stx::extents<Exts...>;
+      using layout_type  = detail::dynamic_stride_layout_t<ndim>;
+      using mapping_type = typename layout_type::template mapping<extents_type>;
+
+      using span_type =
+         basic_span<typename source_type::element_type,
+                    extents_type,
+                    layout_type,
+                    typename source_type::accessor_type::offset_policy,
+                    detail::is_const_source_v<S>,
+                    grid_of_v<source_type>>;
+
+   // box covering all selected points, so stx::subspan gives the offset pointer and the source strides
+      std::array<ptrdiff_t,ndim> lengths{};
+      for( size_t r=0; r<ndim; ++r )
+     {
+         assert( strides[r]>0 );
+         lengths[r] = exts.extent(r)>0 ? (exts.extent(r)-1)*strides[r]+1 : 0;
+     }
+
+      const auto box = detail::subspan_box( source, begin_index, lengths );
+
+      std::array<ptrdiff_t,ndim> span_strides{};
+      for( size_t r=0; r<ndim; ++r ){ span_strides[r] = box.stride(r)*strides[r]; }
+
+      return span_type( box.data(), mapping_type( exts, span_strides ), box.accessor() );
+  }
+
+/*
+ * slice of any other indexable, as an index-remapping view
+ *    exts is not stored: the view can be evaluated at any index for which the source can
+ */
+   template<typename         I,
+            ptrdiff_t...  Exts>
+      requires indexable<std::remove_cvref_t<I>>
+            && (!detail::mdspan_backed<std::remove_cvref_t<I>>)
+            && (sizeof...(Exts) == ndim_of_v<std::remove_cvref_t<I>>)
+   [[nodiscard]]
+   constexpr view auto slice( I&&                                                                       source,
+                              const index_type_of_t<std::remove_cvref_t<I>>                        begin_index,
+                              const stx::extents<Exts...>,                                          /* exts */
+                              const std::array<idx_t,sizeof...(Exts)>                                  strides )
+  {
+      return detail::remapped( std::forward<I>(source), begin_index, strides );
+  }
+
+/*
+ * contiguous box of a source, starting at begin_index
+ *    mdspan-backed sources give a basic_span with the given extents type, and the layout of stx::subspan of the box,
+ *    which keeps layout_right/layout_left where the box allows
+ */
+   template<typename         S,
+            ptrdiff_t...  Exts>
+      requires detail::mdspan_backed<std::remove_cvref_t<S>>
+            && (sizeof...(Exts) == ndim_of_v<std::remove_cvref_t<S>>)
+            && detail::borrowable<S>
+   [[nodiscard]]
+   constexpr auto subview( S&&                                                                       source,
+                           const index_type_of_t<std::remove_cvref_t<S>>                        begin_index,
+                           const stx::extents<Exts...>                                                 exts )
+  {
+      using source_type = std::remove_cvref_t<S>;
+
+      std::array<ptrdiff_t,sizeof...(Exts)> lengths{};
+      for( size_t r=0; r<sizeof...(Exts); ++r ){ lengths[r] = exts.extent(r); }
+
+      const auto box = detail::subspan_box( source, begin_index, lengths );
+
+      using box_type = decltype(box);
+      using layout_type = typename box_type::layout_type;
+
+   // stx::subspan gives dynamic extents, so remap to the static extents of the caller
+      if constexpr( std::same_as<layout_type,stx::layout_right>
+                 || std::same_as<layout_type,stx::layout_left> )
+     {
+         using extents_type = stx::extents<Exts...>;
+         using mapping_type = typename layout_type::template mapping<extents_type>;
+
+         using span_type =
+            basic_span<typename box_type::element_type,
+                       extents_type,
+                       layout_type,
+                       typename box_type::accessor_type,
+                       detail::is_const_source_v<S>,
+                       grid_of_v<source_type>>;
+
+         return span_type( box.data(), mapping_type( exts ), box.accessor() );
+     }
+      else
+     {
+         std::array<idx_t,sizeof...(Exts)> strides;
+         strides.fill(1);
+
+         return slice( std::forward<S>(source), begin_index, exts, strides );
+     }
+  }
+
+   template<typename         I,
+            ptrdiff_t...  Exts>
+      requires indexable<std::remove_cvref_t<I>>
+            && (!detail::mdspan_backed<std::remove_cvref_t<I>>)
+            && (sizeof...(Exts) == ndim_of_v<std::remove_cvref_t<I>>)
+   [[nodiscard]]
+   constexpr view auto subview( I&&                                                                       source,
+                                const index_type_of_t<std::remove_cvref_t<I>>                        begin_index,
+                                const stx::extents<Exts...>                                                 exts )
+  {
+      std::array<idx_t,sizeof...(Exts)> strides;
+      strides.fill(1);
+
+      return slice( std::forward<I>(source), begin_index, exts, strides );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::permute_axes
+ * zero-copy view with the index dimensions reordered: axis r of the view is axis P[r] of the source,
+ *    ie view(i) is source(j) with j[P[r]] = i[r]
+ *
+ *    basic_span and basic_array sources give a basic_span with layout_stride and the permuted extents and strides,
+ *    so permute_axes<2,1,0> of a k-innermost (layout_right) span is an i-innermost span over the same memory.
+ *    Other indexables give an index-permuting view, holding a reference to an lvalue source or a copy of an rvalue source.
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+   // true if Axes is a permutation of {0,...,ndim-1}
+      template<ndim_t ndim,
+               ndim_t... Axes>
+      [[nodiscard]]
+      constexpr bool is_permutation()
+     {
+         if( sizeof...(Axes)!=ndim ){ return false; }
+
+         std::array<bool,ndim> seen{};
+         for( const ndim_t a : std::array<ndim_t,sizeof...(Axes)>{Axes...} )
+        {
+            if( a>=ndim || seen[a] ){ return false; }
+            seen[a]=true;
+        }
+         return true;
+     }
+  }
+
+   template<ndim_t... P,
+            typename  S>
+      requires detail::mdspan_backed<std::remove_cvref_t<S>>
+            && (detail::is_permutation<ndim_of_v<std::remove_cvref_t<S>>,P...>())
+            && detail::borrowable<S>
+   [[nodiscard]]
+   constexpr auto permute_axes( S&& source )
+  {
+      using source_type = std::remove_cvref_t<S>;
+
+      constexpr size_t ndim = sizeof...(P);
+
+      using source_extents = typename source_type::extents_type;
+
+      using extents_type = stx::extents<source_extents::static_extent(P)...>;
+      using layout_type  = detail::dynamic_stride_layout_t<ndim>;
+      using mapping_type = typename layout_type::template mapping<extents_type>;
+
+      using span_type =
+         basic_span<typename source_type::element_type,
+                    extents_type,
+                    layout_type,
+                    typename source_type::accessor_type,
+                    detail::is_const_source_v<S>,
+                    grid_of_v<source_type>>;
+
+      const extents_type exts( dextents<ndim>( source.extent(P)... ) );
+
+      const std::array<ptrdiff_t,ndim> strides{ source.stride(P)... };
+
+      return span_type( source.data(), mapping_type( exts, strides ), source.accessor() );
+  }
+
+   template<ndim_t... P,
+            typename  I>
+      requires indexable<std::remove_cvref_t<I>>
+            && (!detail::mdspan_backed<std::remove_cvref_t<I>>)
+            && (detail::is_permutation<ndim_of_v<std::remove_cvref_t<I>>,P...>())
+   [[nodiscard]]
+   constexpr view auto permute_axes( I&& source )
+  {
+      using index_type = index_type_of_t<std::remove_cvref_t<I>>;
+
+      return detail::reindexed( std::forward<I>(source),
+                                []( const index_type idx ) -> index_type
+                               {
+                                   constexpr std::array<ndim_t,sizeof...(P)> axes{P...};
+
+                                   index_type j{};
+                                   for( ndim_t r=0; r<axes.size(); ++r ){ j[axes[r]] = idx[r]; }
+                                   return j;
+                               } );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::reshape / yam::flatten / yam::linear_view
+ * zero-copy views of a source with a different rank
+ *
+ *    reshape: contiguous (layout_right or layout_left) basic_span/basic_array as a basic_span with new extents
+ *             and the same layout over the same storage, so the number of elements must be the same
+ *    flatten: reshape to 1D, indexed in memory order, so the 1D fast paths run one contiguous loop over a whole array
+ *    linear_view: 1D view over any mdspan-backed source, index n is the n-th point of the source extents in row-major order
+ *                 (does not need contiguous storage, but pays an index division per dimension)
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+   // mdspan-backed indexables whose mapping is contiguous by construction
+      template<typename A>
+      concept contiguous_mdspan_backed =
+         mdspan_backed<A>
+      && ( std::same_as<typename A::layout_type,stx::layout_right>
+        || std::same_as<typename A::layout_type,stx::layout_left> );
+
+   // static product of the extents, or dynamic_extent if any extent is dynamic
+      template<typename Extents>
+      [[nodiscard]]
+      constexpr ptrdiff_t static_num_elems()
+     {
+         ptrdiff_t n=1;
+         for( size_t r=0; r<Extents::rank(); ++r )
+        {
+            if( Extents::static_extent(r)==stx::dynamic_extent ){ return stx::dynamic_extent; }
+            n *= Extents::static_extent(r);
+        }
+         return n;
+     }
+  }
+
+   template<typename         S,
+            ptrdiff_t...  Exts>
+      requires detail::contiguous_mdspan_backed<std::remove_cvref_t<S>>
+            && detail::borrowable<S>
+   [[nodiscard]]
+   constexpr auto reshape( S&&                        source,
+                           const stx::extents<Exts...>  exts )
+  {
+      using source_type = std::remove_cvref_t<S>;
+
+      using extents_type = stx::extents<Exts...>;
+      using layout_type  = typename source_type::layout_type;
+      using mapping_type = typename layout_type::template mapping<extents_type>;
+
+      using span_type =
+         basic_span<typename source_type::element_type,
+                    extents_type,
+                    layout_type,
+                    typename source_type::accessor_type,
+                    detail::is_const_source_v<S>,
+                    grid_of_v<source_type>>;
+
+      assert( num_elems(exts)==num_elems(source.extents()) && "reshape must keep the number of elements" );
+
+      return span_type( source.data(), mapping_type( exts ), source.accessor() );
+  }
+
+   template<typename S>
+      requires detail::contiguous_mdspan_backed<std::remove_cvref_t<S>>
+            && detail::borrowable<S>
+   [[nodiscard]]
+   constexpr auto flatten( S&& source )
+  {
+      using source_extents = typename std::remove_cvref_t<S>::extents_type;
+
+      using extents_type = stx::extents<detail::static_num_elems<source_extents>()>;
+
+      if constexpr( extents_type::rank_dynamic()==0 )
+     {
+         return reshape( std::forward<S>(source), extents_type{} );
+     }
+      else
+     {
+         return reshape( std::forward<S>(source), extents_type( static_cast<ptrdiff_t>(num_elems(source.extents())) ) );
+     }
+  }
+
+   template<typename S>
+      requires detail::mdspan_backed<std::remove_cvref_t<S>>
+   [[nodiscard]]
+   constexpr view auto linear_view( S&& source )
+  {
+      using source_type = std::remove_cvref_t<S>;
+      using index_type  = index_type_of_t<source_type>;
+
+      constexpr ndim_t ndim = ndim_of_v<source_type>;
+      constexpr grid_t grid = grid_of_v<source_type>;
+
+      const auto exts = make_dextents( source.extents() );
+
+      const auto source_index =
+         [ exts ]( const index<1,grid> n ) -> index_type
+        {
+            index_type idx{};
+            idx_t rest = n[0];
+            for( ndim_t r=ndim; r-->0; )
+           {
+               idx[r] = rest%exts.extent(r);
+               rest  /= exts.extent(r);
+           }
+            return idx;
+        };
+
+      if constexpr( std::is_lvalue_reference_v<S> )
+     {
+         using return_type = element_type_of_t<S>;
+
+         return [ &source, source_index ]
+               ( const index<1,grid> n ) -> return_type
+              { return source( source_index(n) ); };
+     }
+      else
+     {
+         using return_type = element_type_of_t<const source_type&>;
+
+         return [ source=std::move(source), source_index ]
+               ( const index<1,grid> n ) -> return_type
+              { return source( source_index(n) ); };
+     }
+  }
+}
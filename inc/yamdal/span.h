@@ -65,7 +65,7 @@ namespace yam
       using pointer         = typename mdspan_t::pointer;
       using reference       = typename mdspan_t::reference;
       using const_reference =
-         const std::remove_reference_t<reference>&;
+         accessor_const_reference_t<accessor_type>;
 
    // default operations
       constexpr basic_span() = default;
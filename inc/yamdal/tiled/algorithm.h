@@ -0,0 +1,701 @@
+
+# pragma once
+
+# include "../concepts.h"
+# include "../index.h"
+# include "../execution.h"
+# include "../instrument.h"
+# include "../utility.h"
+
+# include "../serial/algorithm.h"
+# include "../external/mdspan.h"
+
+# ifdef _OPENMP
+   # include <omp.h>
+# endif
+
+# include <array>
+# include <vector>
+# include <utility>
+# include <functional>
+# include <concepts>
+# include <algorithm>
+# include <optional>
+
+# include <cassert>
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * tiling of an index range [begin_index,begin_index+extents) for execution::tiled_policy
+ *
+ * ===============================================================
+ */
+
+   namespace tiling
+  {
+   /*
+    * extent of the tiles in each dimension (the whole extent if the policy tile is 0 or larger than the range)
+    */
+      template<typename InnerPolicy,
+               ptrdiff_t...     Exts>
+      [[nodiscard]]
+      constexpr auto tile_extents( const execution::tiled_policy<InnerPolicy>& policy,
+                                   const stx::extents<Exts...>                   exts )
+         -> std::array<idx_t,sizeof...(Exts)>
+     {
+         static_assert( sizeof...(Exts)<=3, "tiled execution supports up to 3 dimensions" );
+
+         std::array<idx_t,sizeof...(Exts)> tile{};
+         for( ndim_t d=0; d<sizeof...(Exts); ++d )
+        {
+            const idx_t n = exts.extent(d);
+            const idx_t t = policy.tile[d];
+            tile[d] = ( t<=0 || t>n ) ? n : t;
+        }
+         return tile;
+     }
+
+   /*
+    * number of tiles in each dimension
+    */
+      template<size_t ndim>
+      [[nodiscard]]
+      constexpr auto num_tiles( const std::array<idx_t,ndim>& tile,
+                                const dextents<ndim>          exts )
+         -> std::array<idx_t,ndim>
+     {
+         std::array<idx_t,ndim> n{};
+         for( ndim_t d=0; d<ndim; ++d )
+        {
+            n[d] = tile[d]>0 ? (exts.extent(d)+tile[d]-1)/tile[d] : 0;
+        }
+         return n;
+     }
+
+   /*
+    * the dimensions in order of the policy loop order, ignoring dimensions >= ndim
+    */
+      template<size_t ndim>
+      [[nodiscard]]
+      constexpr auto loop_order( const std::array<ndim_t,3>& order )
+         -> std::array<ndim_t,ndim>
+     {
+         std::array<ndim_t,ndim> dims{};
+         size_t r=0;
+         for( const ndim_t d : order )
+        {
+            if( d<ndim ){ dims[r++]=d; }
+        }
+         assert( r==ndim && "tiled_policy order must be a permutation of {0,1,2}" );
+         return dims;
+     }
+
+   /*
+    * call func( n, tile_begin, tile_extents ) for each tile n, with tiles numbered in the loop order of the policy
+    *    with a parallel inner policy tiles are distributed statically over the threads
+    */
+      template<typename InnerPolicy,
+               typename       Index,
+               ptrdiff_t...    Exts,
+               typename        Func>
+      void for_each_tile( const execution::tiled_policy<InnerPolicy>& policy,
+                          const Index                              begin_index,
+                          const stx::extents<Exts...>                     exts,
+                                Func&&                                    func )
+     {
+         constexpr size_t ndim = sizeof...(Exts);
+
+         const auto range_exts = make_dextents( exts );
+
+         const auto tile  = tile_extents( policy, exts );
+         const auto count = num_tiles( tile, range_exts );
+         const auto dims  = loop_order<ndim>( policy.order );
+
+         idx_t total=1;
+         for( const idx_t c : count ){ total*=c; }
+
+      // begin index and extents of the n-th tile, the last dimension in the loop order varying fastest
+         const auto nth_tile =
+            [&]( idx_t n ) -> std::pair<Index,dextents<ndim>>
+           {
+               Index tile_begin{begin_index};
+               std::array<idx_t,ndim> tile_exts{};
+
+               for( size_t r=ndim; r-->0; )
+              {
+                  const ndim_t d = dims[r];
+                  const idx_t t = n%count[d];
+                  n/=count[d];
+
+                  tile_begin[d] += t*tile[d];
+                  tile_exts[d] = std::min( tile[d], range_exts.extent(d)-t*tile[d] );
+              }
+               return { tile_begin, dextents<ndim>(tile_exts) };
+           };
+
+         if constexpr( std::same_as<InnerPolicy,execution::serial_policy> )
+        {
+            for( idx_t n=0; n<total; ++n )
+           {
+               const auto [tile_begin,tile_exts] = nth_tile(n);
+               func( n, tile_begin, tile_exts );
+           }
+        }
+# ifdef _OPENMP
+         else if constexpr( std::same_as<InnerPolicy,execution::openmp_policy> )
+        {
+            const int num_threads = policy.num_threads>0 ? policy.num_threads : omp_get_max_threads();
+
+         # pragma omp parallel for num_threads(num_threads) schedule(static)
+            for( idx_t n=0; n<total; ++n )
+           {
+               [[maybe_unused]]
+               const instrument::nested_scope nested;
+
+               const auto [tile_begin,tile_exts] = nth_tile(n);
+               func( n, tile_begin, tile_exts );
+           }
+        }
+# endif
+         else
+        {
+            static_assert( std::same_as<InnerPolicy,execution::serial_policy>, "unsupported inner policy for tiled execution" );
+        }
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::assign
+ *    each tile is assigned by the serial algorithm
+ *
+ * ===============================================================
+ */
+
+   template<typename InnerPolicy,
+            indexable Destination,
+            indexable      Source,
+            ptrdiff_t...     Exts>
+      requires same_grid_as<Destination,
+                            Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   void assign( const execution::tiled_policy<InnerPolicy>             policy,
+                const located_index<index_type_of_t<Source>> begin_index,
+                const stx::extents<Exts...>                         exts,
+                      Destination&                           destination,
+                const Source&                                     source )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "assign", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Destination,Source>() );
+
+      using index_type = index_type_of_t<Source>;
+
+      tiling::for_each_tile( policy, index_type{begin_index}, exts,
+         [&]( idx_t, const index_type tile_begin, const auto tile_exts )
+        {
+            assign( execution::seq,
+                    tile_begin,
+                    tile_exts,
+                    destination,
+                    source );
+        } );
+
+      return;
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::reduce
+ *    serial tiled reduction is a left-fold over the tiles in the loop order of the policy
+ *    parallel tiled reduction reduces each tile from identity_v, then folds the tile results in tile order, so the result is independent of the number of threads
+ *
+ * ===============================================================
+ */
+
+   template<typename ReduceFunc,
+            typename ReduceType,
+            indexable    Source,
+            ptrdiff_t...   Exts>
+      requires reduction<ReduceFunc,
+                         ReduceType,
+                         element_type_of_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   ReduceType reduce( const execution::tiled_policy<execution::serial_policy> policy,
+                      const located_index<index_type_of_t<Source>>       begin_index,
+                      const stx::extents<Exts...>                               exts,
+                            ReduceFunc                                   reduce_func,
+                            ReduceType                                          init,
+                      const Source&                                           source )
+  {
+      [[maybe_unused]]
+      const instrument::kernel_scope scope( "reduce", policy,
+                                            begin_index, exts,
+                                            instrument::bytes_per_elem<Source>() );
+
+      using index_type = index_type_of_t<Source>;
+
+      tiling::for_each_tile( policy, index_type{begin_index}, exts,
+         [&]( idx_t, const index_type tile_begin, const auto tile_exts )
+        {
+            init = reduce( execution::seq,
+                           tile_begin,
+                           tile_exts,
+                           reduce_func,
+                           std::move(init),
+                           source );
+        } );
+
+      return init;
+  }
+
+   template<typename InnerPolicy,
+            typename  ReduceFunc,
+            typename  ReduceType,
+            indexable     Source,
+            ptrdiff_t...    Exts>
+      requires reduction<ReduceFunc,
+                         ReduceType,
+                         element_type_of_t<Source>>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+   [[nodiscard]]
+   ReduceType reduce( const execution::tiled_policy<InnerPolicy>             policy,
+                      const located_index<index_type_of_t<Source>> begin_index,
+                      const stx::extents<Exts...>                         exts,
+                            ReduceFunc                             reduce_func,
+                            ReduceType                              identity_v,
+                            ReduceType                                    init,
+                      const Source&                                     source )
+  {
+      if constexpr( std::same_as<InnerPolicy,execution::serial_policy> )
+     {
+         return reduce( policy,
+                        begin_index, exts,
+                        std::move(reduce_func),
+                        std::move(init),
+                        source );
+     }
+      else
+     {
+         [[maybe_unused]]
+         const instrument::kernel_scope scope( "reduce", policy,
+                                               begin_index, exts,
+                                               instrument::bytes_per_elem<Source>() );
+
+         using index_type = index_type_of_t<Source>;
+
+         const auto tile = tiling::tile_extents( policy, exts );
+         const auto count = tiling::num_tiles( tile, make_dextents( exts ) );
+
+         size_t total=1;
+         for( const idx_t c : count ){ total*=size_t(c); }
+
+      // result of each tile, each on separate cache lines (and never a std::vector<bool>, which cannot be written concurrently)
+         using partial_t = utl::aligned_t<ReduceType>;
+         std::vector<partial_t> partial( total, partial_t{identity_v} );
+
+         tiling::for_each_tile( policy, index_type{begin_index}, exts,
+            [&]( const idx_t n, const index_type tile_begin, const auto tile_exts )
+           {
+               partial[size_t(n)].data =
+                  reduce( execution::seq,
+                          tile_begin,
+                          tile_exts,
+                          reduce_func,
+                          identity_v,
+                          source );
+           } );
+
+         for( auto& p : partial ){ init = std::invoke( reduce_func, std::move(init), std::move(p.data) ); }
+
+         return init;
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::inclusive_scan / yam::exclusive_scan
+ *    scans have a fixed traversal order, so tiling does not apply and the inner policy is used
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<bool      is_inclusive,
+               typename   InnerPolicy,
+               typename   Destination,
+               typename      ScanFunc,
+               typename      ScanType,
+               typename        Source,
+               ptrdiff_t...      Exts>
+      void scan( const execution::tiled_policy<InnerPolicy>             policy,
+                 const located_index<index_type_of_t<Source>> begin_index,
+                 const stx::extents<Exts...>                         exts,
+                       Destination&                           destination,
+                       ScanFunc&                                scan_func,
+                 const std::optional<ScanType>&                      init,
+                 const Source&                                     source )
+     {
+         scan<is_inclusive>( policy.inner, begin_index, exts,
+                             destination, scan_func,
+                             init, source );
+     }
+
+      template<ndim_t           Axis,
+               bool      is_inclusive,
+               typename   InnerPolicy,
+               typename   Destination,
+               typename      ScanFunc,
+               typename      ScanType,
+               typename        Source,
+               ptrdiff_t...      Exts>
+      void scan_axis( const execution::tiled_policy<InnerPolicy>             policy,
+                      const located_index<index_type_of_t<Source>> begin_index,
+                      const stx::extents<Exts...>                         exts,
+                            Destination&                           destination,
+                            ScanFunc&                                scan_func,
+                      const std::optional<ScanType>&                      init,
+                      const Source&                                     source )
+     {
+         scan_axis<Axis,is_inclusive>( policy.inner, begin_index, exts,
+                                       destination, scan_func,
+                                       init, source );
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::reduce_axis
+ *    the loop order of reduce_axis is chosen from the memory layout of the source, so the inner policy is used
+ *
+ * ===============================================================
+ */
+
+   template<ndim_t...           Axes,
+            typename     InnerPolicy,
+            indexable    Destination,
+            typename      ReduceFunc,
+            typename      ReduceType,
+            indexable         Source,
+            ptrdiff_t...        Exts>
+      requires (grid_of_v<Destination> == grid_of_v<Source>)
+            && reduction<ReduceFunc,
+                         ReduceType,
+                         element_type_of_t<Source>>
+            && transformation_r<ReduceFunc,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Destination>,
+                                element_type_of_t<Source>>
+            && assignable_element<element_type_of_t<Destination>,
+                                  ReduceType&&>
+            && (sizeof...(Exts)==ndim_of_v<Source>)
+            && (sizeof...(Axes)>0)
+            && (ndim_of_v<Destination>+sizeof...(Axes)==ndim_of_v<Source>)
+            && (detail::valid_axes<ndim_of_v<Source>,Axes...>())
+   void reduce_axis( const execution::tiled_policy<InnerPolicy>             policy,
+                     const located_index<index_type_of_t<Source>> begin_index,
+                     const stx::extents<Exts...>                         exts,
+                           Destination&                           destination,
+                           ReduceFunc                             reduce_func,
+                           ReduceType                                    init,
+                     const Source&                                     source )
+  {
+      reduce_axis<Axes...>( policy.inner,
+                            begin_index, exts,
+                            destination,
+                            std::move(reduce_func),
+                            std::move(init),
+                            source );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::argmin / yam::argmax / yam::top_k
+ *    the candidates are ranked independently of the visiting order, so the inner policy is used
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename InnerPolicy,
+               typename     Compare,
+               typename      Source,
+               ptrdiff_t...    Exts>
+      constexpr auto arg_extremum( const execution::tiled_policy<InnerPolicy>        policy,
+                                   const index_type_of_t<Source>             begin_index,
+                                   const stx::extents<Exts...>                      exts,
+                                         Compare                                 compare,
+                                   const Source&                                  source )
+     {
+         return arg_extremum( policy.inner, begin_index, exts, std::move(compare), source );
+     }
+
+      template<typename InnerPolicy,
+               typename     Compare,
+               typename      Source,
+               ptrdiff_t...    Exts>
+      constexpr void top_k( const execution::tiled_policy<InnerPolicy>        policy,
+                            const index_type_of_t<Source>             begin_index,
+                            const stx::extents<Exts...>                      exts,
+                                  top_k_heap<index_type_of_t<Source>,
+                                             selected_value_t<Source>,
+                                             Compare>&                        heap,
+                            const Source&                                  source )
+     {
+         top_k( policy.inner, begin_index, exts, heap, source );
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::histogram / yam::binned_statistic
+ *    the bins are updated independently of the visiting order, so the inner policy is used
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename InnerPolicy,
+               binning         Bins,
+               typename      Source,
+               ptrdiff_t...    Exts>
+      constexpr void histogram( const execution::tiled_policy<InnerPolicy>        policy,
+                                const index_type_of_t<Source>             begin_index,
+                                const stx::extents<Exts...>                      exts,
+                                const Bins&                                      bins,
+                                      histogram_mode                             mode,
+                                      std::vector<size_t>&                     counts,
+                                const Source&                                  source )
+     {
+         histogram( policy.inner, begin_index, exts, bins, mode, counts, source );
+     }
+
+      template<typename InnerPolicy,
+               binning         Bins,
+               typename           T,
+               typename        Keys,
+               typename      Values,
+               ptrdiff_t...    Exts>
+      constexpr void binned_statistic( const execution::tiled_policy<InnerPolicy>        policy,
+                                       const index_type_of_t<Keys>               begin_index,
+                                       const stx::extents<Exts...>                      exts,
+                                       const Bins&                                      bins,
+                                             histogram_mode                             mode,
+                                             std::vector<bin_statistics<T>>&           stats,
+                                       const Keys&                                      keys,
+                                       const Values&                                  values )
+     {
+         binned_statistic( policy.inner, begin_index, exts, bins, mode, stats, keys, values );
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::accumulate
+ *    the accumulation order is unspecified, so the inner policy is used
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename    InnerPolicy,
+               typename AccumulateFunc,
+               typename    CombineFunc,
+               typename AccumulateType,
+               typename         Source,
+               ptrdiff_t...       Exts>
+      constexpr void accumulate_in_place( const execution::tiled_policy<InnerPolicy>        policy,
+                                          const index_type_of_t<Source>             begin_index,
+                                          const stx::extents<Exts...>                      exts,
+                                                AccumulateFunc&                 accumulate_func,
+                                                CombineFunc&                       combine_func,
+                                          const AccumulateType&                      identity_v,
+                                                AccumulateType&                             acc,
+                                          const Source&                                  source )
+     {
+         accumulate_in_place( policy.inner, begin_index, exts, accumulate_func, combine_func, identity_v, acc, source );
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::compact / yam::assign over an index list
+ *    an index list is not tiled, so these use the inner policy
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename  InnerPolicy,
+               typename         Mask,
+               ptrdiff_t...     Exts>
+      void compact_mask( const execution::tiled_policy<InnerPolicy>        policy,
+                         const index_type_of_t<Mask>                  begin_index,
+                         const stx::extents<Exts...>                         exts,
+                         const Mask&                                         mask,
+                               std::vector<index_type_of_t<Mask>>&        indices )
+     {
+         compact_mask( policy.inner, begin_index, exts, mask, indices );
+     }
+  }
+
+   template<typename InnerPolicy,
+            indexable Destination,
+            indexable      Source>
+      requires same_grid_as<Destination,
+                            Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+   void assign( const execution::tiled_policy<InnerPolicy>                policy,
+                const std::vector<index_type_of_t<Source>>&              indices,
+                      Destination&                                   destination,
+                const Source&                                             source,
+                const located_index<index<1,grid_of_v<Source>>>        location = {} )
+  {
+      assign( policy.inner, indices, destination, source, location );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::assign / yam::reduce over an index_set
+ *    an index_set is not tiled, so these use the inner policy
+ *
+ * ===============================================================
+ */
+
+   template<typename InnerPolicy,
+            indexable Destination,
+            indexable      Source>
+      requires same_grid_as<Destination,
+                            Source>
+            && assignable_element<element_type_of_t<Destination>,
+                                  element_type_of_t<Source>>
+   void assign( const execution::tiled_policy<InnerPolicy>                   policy,
+                const index_set<ndim_of_v<Source>,grid_of_v<Source>>&          set,
+                      Destination&                                     destination,
+                const Source&                                               source,
+                const located_index<index<1,grid_of_v<Source>>>          location = {} )
+  {
+      assign( policy.inner, set, destination, source, location );
+  }
+
+   template<typename InnerPolicy,
+            typename  ReduceFunc,
+            typename  ReduceType,
+            indexable     Source>
+      requires reduction<ReduceFunc,
+                         ReduceType,
+                         element_type_of_t<Source>>
+   [[nodiscard]]
+   ReduceType reduce( const execution::tiled_policy<InnerPolicy>                   policy,
+                      const index_set<ndim_of_v<Source>,grid_of_v<Source>>&          set,
+                            ReduceFunc                                       reduce_func,
+                            ReduceType                                        identity_v,
+                            ReduceType                                              init,
+                      const Source&                                               source,
+                      const located_index<index<1,grid_of_v<Source>>>          location = {} )
+  {
+      return reduce( policy.inner, set, std::move(reduce_func), std::move(identity_v), std::move(init), source, location );
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::scatter_add
+ *    the targets are not related to the tiles of the range, so this uses the inner policy
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename InnerPolicy,
+               typename Destination,
+               typename     Indices,
+               typename      Values,
+               ptrdiff_t...    Exts>
+      void scatter_add_into( const execution::tiled_policy<InnerPolicy>        policy,
+                             const index_type_of_t<Values>                begin_index,
+                             const stx::extents<Exts...>                         exts,
+                             const scatter_mode                                  mode,
+                                   Destination&                           destination,
+                             const Indices&                                   indices,
+                             const Values&                                     values )
+     {
+         scatter_add_into( policy.inner, begin_index, exts, mode, destination, indices, values );
+     }
+  }
+
+/*
+ * ===============================================================
+ *
+ * yam::detail::for_each_weighted
+ *    the items are not tiled, so this uses the inner policy
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename InnerPolicy,
+               typename        Func>
+      void for_each_weighted( const execution::tiled_policy<InnerPolicy>  policy,
+                              const std::vector<size_t>&                 weights,
+                                    Func&&                                  func )
+     {
+         for_each_weighted( policy.inner, weights, std::forward<Func>(func) );
+     }
+  }
+
+
+/*
+ * ===============================================================
+ *
+ * yam::prolong_linear
+ *    each tile of the fine range is interpolated by the serial algorithm
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+      template<typename InnerPolicy,
+               typename        Fine,
+               typename      Coarse,
+               ptrdiff_t...    Exts>
+      void prolong_linear_into( const execution::tiled_policy<InnerPolicy>  policy,
+                                const index_type_of_t<Fine>            begin_index,
+                                const stx::extents<Exts...>                   exts,
+                                      Fine&                                   fine,
+                                const Coarse&                               coarse )
+     {
+         tiling::for_each_tile( policy, begin_index, exts,
+            [&]( idx_t, const index_type_of_t<Fine> tile_begin, const auto tile_exts )
+           {
+               prolong_linear_into( execution::seq, tile_begin, tile_exts, fine, coarse );
+           } );
+     }
+  }
+
+}
@@ -0,0 +1,610 @@
+
+# pragma once
+
+# include "algorithm.h"
+# include "array.h"
+# include "concepts.h"
+# include "index.h"
+# include "execution.h"
+# include "instrument.h"
+
+# include "external/mdspan.h"
+
+# ifdef _OPENMP
+   # include <omp.h>
+# endif
+
+# include <array>
+# include <vector>
+# include <map>
+# include <string>
+# include <string_view>
+# include <optional>
+# include <mutex>
+# include <chrono>
+# include <limits>
+# include <fstream>
+# include <sstream>
+# include <algorithm>
+# include <utility>
+# include <functional>
+# include <type_traits>
+# include <cstdlib>
+# include <cstdio>
+# include <cassert>
+
+# ifdef __linux__
+   # include <sys/file.h>
+   # include <fcntl.h>
+   # include <unistd.h>
+# endif
+
+namespace yam
+{
+/*
+ * ===============================================================
+ *
+ * yam::tune
+ *    autotuning of the tile shape, tile loop order and number of threads of execution::tiled_policy for a given call signature
+ *
+ *    a call signature is a kernel name given by the caller, the element type, layout and extents type of the destination and of each source, the extents and the inner policy
+ *    the types of functions and lazy views are not part of it (the compiler may print different lambdas identically), so each distinct kernel needs its own name
+ *    the best configuration found for each signature is stored in an on-disk database keyed by the CPU model, so subsequent runs on the same type of node reuse it
+ *
+ *       yam::tune::assign( execution::openmp, "copy_halo", begin, exts, dst, src );    // tunes on first call of this signature, then looks up the result
+ *       yam::tune::transform( execution::seq, "axpy", begin, exts, dst, func, src0, src1 );
+ *
+ *       auto policy = yam::tune::tuned_policy( execution::openmp, signature, exts, kernel ); // for any other kernel
+ *
+ *    tune::assign and tune::transform time the candidates on a scratch array with the element type and layout of the destination,
+ *    and then run the chosen configuration once on the destination, so the destination may also be a source; transform_func is still called many times
+ *    tuned_policy runs the given kernel many times, so that kernel must be repeatable (eg write to scratch, not read its own destination)
+ *
+ *    the database file is $YAMDAL_TUNE_DB, or yamdal_tune.db in the working directory
+ *    it may be shared by several processes: each new record is merged into the file under a lock, and the file is replaced atomically
+ *
+ * ===============================================================
+ */
+
+   namespace tune
+  {
+   /*
+    * configuration of a tiled_policy, and the time it took
+    */
+      struct config
+     {
+         std::array<idx_t,3> tile{};
+         std::array<ndim_t,3> order{0,1,2};
+         int num_threads=0;
+
+         double seconds=std::numeric_limits<double>::max();
+     };
+
+      template<typename InnerPolicy>
+      [[nodiscard]]
+      constexpr execution::tiled_policy<InnerPolicy> make_policy( const InnerPolicy  inner,
+                                                                  const config&        cfg )
+     {
+         return execution::tiled( inner, cfg.tile, cfg.order, cfg.num_threads );
+     }
+
+   /*
+    * name of a type, as given by the compiler
+    */
+      template<typename T>
+      [[nodiscard]]
+      constexpr std::string_view type_name()
+     {
+         const std::string_view name = __PRETTY_FUNCTION__;
+
+         const size_t first = name.find("T = ")+4;
+         size_t last = name.find(';',first);
+         if( last==std::string_view::npos ){ last = name.rfind(']'); }
+
+         return name.substr(first,last-first);
+     }
+
+   /*
+    * element type, layout and extents type of an indexable, without the type of the indexable itself
+    *    (which for a lazy view includes the type of a lambda)
+    */
+      template<typename T>
+      [[nodiscard]]
+      std::string argument_name()
+     {
+         using A = std::remove_cvref_t<T>;
+
+         std::string s( type_name<std::remove_cvref_t<element_type_of_t<A>>>() );
+
+         if constexpr( requires{ typename A::layout_type; typename A::extents_type; } )
+        {
+            s += " ";
+            s += type_name<typename A::layout_type>();
+            s += " ";
+            s += type_name<typename A::extents_type>();
+        }
+         else
+        {
+            s += " view";
+        }
+         return s;
+     }
+
+   /*
+    * signature of a call, used as the database key
+    *    kernel should name the kernel uniquely, and not contain tabs or newlines
+    */
+      template<indexable... Ts,
+               ptrdiff_t... Exts>
+      [[nodiscard]]
+      std::string signature( const std::string_view      kernel,
+                             const stx::extents<Exts...>   exts )
+     {
+         assert( kernel.find_first_of("\t\n")==std::string_view::npos );
+
+         std::string s(kernel);
+
+         s += "|";
+         ((s += argument_name<Ts>() + ","),...);
+
+         s += "|";
+         for( size_t r=0; r<sizeof...(Exts); ++r ){ s += (r>0 ? "x" : "") + std::to_string(exts.extent(r)); }
+
+         return s;
+     }
+
+   /*
+    * model name of this CPU, from /proc/cpuinfo
+    */
+      [[nodiscard]]
+      inline std::string cpu_model()
+     {
+         std::ifstream cpuinfo("/proc/cpuinfo");
+
+         std::string line;
+         while( std::getline(cpuinfo,line) )
+        {
+            if( line.starts_with("model name") )
+           {
+               const size_t colon = line.find(':');
+               const size_t first = line.find_first_not_of(" \t",colon+1);
+               return first==std::string::npos ? "unknown" : line.substr(first);
+           }
+        }
+         return "unknown";
+     }
+
+   /*
+    * on-disk tuning database
+    *    one record per line: cpu model, signature, tile, order, number of threads, time (tab separated)
+    *    records for other CPU models are kept, but not used
+    */
+      class database
+     {
+      public :
+
+         explicit database( std::string file_path,
+                            std::string       cpu = cpu_model() )
+            : path_(std::move(file_path)), cpu_(std::move(cpu))
+        {
+            load();
+        }
+
+      // database at $YAMDAL_TUNE_DB, or yamdal_tune.db
+         [[nodiscard]]
+         static database& instance()
+        {
+            static database db( std::getenv("YAMDAL_TUNE_DB") ? std::getenv("YAMDAL_TUNE_DB") : "yamdal_tune.db" );
+            return db;
+        }
+
+         [[nodiscard]]
+         std::optional<config> find( const std::string& key ) const
+        {
+            const std::lock_guard lock(mutex);
+
+            const auto it = records.find( {cpu_,key} );
+            if( it==records.end() ){ return std::nullopt; }
+            return it->second;
+        }
+
+      // add (or replace) the record for this CPU, merged with any records saved by other processes since this database was loaded
+         void insert( const std::string& key, const config& cfg )
+        {
+            const std::lock_guard lock(mutex);
+            const file_lock       flock(path_+".lock");
+
+            load();
+            records[{cpu_,key}] = cfg;
+            save();
+        }
+
+         [[nodiscard]]
+         const std::string& path() const { return path_; }
+
+         [[nodiscard]]
+         const std::string& cpu() const { return cpu_; }
+
+         [[nodiscard]]
+         size_t size() const
+        {
+            const std::lock_guard lock(mutex);
+            return records.size();
+        }
+
+      private :
+
+      // exclusive lock on a file shared between processes, held for the lifetime of the object (no lock if the file cannot be opened)
+         class file_lock
+        {
+         public :
+
+            explicit file_lock( [[maybe_unused]] const std::string& lock_path )
+           {
+# ifdef __linux__
+               fd = ::open( lock_path.c_str(), O_RDWR|O_CREAT|O_CLOEXEC, 0666 );
+               if( fd>=0 ){ ::flock( fd, LOCK_EX ); }
+# endif
+           }
+
+            ~file_lock()
+           {
+# ifdef __linux__
+               if( fd>=0 ){ ::flock( fd, LOCK_UN ); ::close( fd ); }
+# endif
+           }
+
+            file_lock( const file_lock& ) = delete;
+            file_lock& operator=( const file_lock& ) = delete;
+
+         private :
+
+            [[maybe_unused]] int fd=-1;
+        };
+
+      // read records from the file, replacing those with the same cpu model and signature
+         void load()
+        {
+            std::ifstream file(path_);
+
+            std::string line;
+            while( std::getline(file,line) )
+           {
+               std::istringstream fields(line);
+
+               std::string cpu, key, tile, order, threads, seconds;
+               if( !std::getline(fields,cpu,'\t')
+                || !std::getline(fields,key,'\t')
+                || !std::getline(fields,tile,'\t')
+                || !std::getline(fields,order,'\t')
+                || !std::getline(fields,threads,'\t')
+                || !std::getline(fields,seconds,'\t') ){ continue; }
+
+               config cfg;
+               std::istringstream(tile)  >> cfg.tile[0]  >> cfg.tile[1]  >> cfg.tile[2];
+               std::istringstream(order) >> cfg.order[0] >> cfg.order[1] >> cfg.order[2];
+               cfg.num_threads = std::atoi( threads.c_str() );
+               cfg.seconds     = std::atof( seconds.c_str() );
+
+               records[{cpu,key}] = cfg;
+           }
+        }
+
+      // write all records to a temporary file and rename it over the database, so readers never see a partly written file
+         void save() const
+        {
+# ifdef __linux__
+            const std::string tmp_path = path_ + ".tmp" + std::to_string( ::getpid() );
+# else
+            const std::string tmp_path = path_ + ".tmp";
+# endif
+           {
+               std::ofstream file(tmp_path,std::ios::trunc);
+               if( !file ){ return; }
+
+               for( const auto& [cpu_key,cfg] : records )
+              {
+                  file << cpu_key.first << "\t"
+                       << cpu_key.second << "\t"
+                       << cfg.tile[0]  << " " << cfg.tile[1]  << " " << cfg.tile[2]  << "\t"
+                       << cfg.order[0] << " " << cfg.order[1] << " " << cfg.order[2] << "\t"
+                       << cfg.num_threads << "\t"
+                       << cfg.seconds << "\n";
+              }
+           }
+            if( std::rename( tmp_path.c_str(), path_.c_str() )!=0 ){ std::remove( tmp_path.c_str() ); }
+        }
+
+         std::string path_;
+         std::string cpu_;
+
+         std::map<std::pair<std::string,std::string>,config> records;
+
+         mutable std::mutex mutex;
+     };
+
+   /*
+    * search parameters
+    */
+      struct settings_t
+     {
+         size_t repeats=3;                               // timed runs per candidate (best is used), after one warm-up run
+         std::vector<idx_t> tile_sizes{4,16,64,256};     // candidate tile extents in each dimension, besides the whole extent
+     };
+
+      [[nodiscard]]
+      inline settings_t& settings()
+     {
+         static settings_t s;
+         return s;
+     }
+
+   /*
+    * time kernel(policy) for candidate configurations, and return the fastest
+    *    coordinate search: tile extent of each dimension (innermost first), then the tile loop order, then the number of threads
+    */
+      template<typename InnerPolicy,
+               ptrdiff_t...    Exts,
+               typename      Kernel>
+      [[nodiscard]]
+      config search( const InnerPolicy             inner,
+                     const stx::extents<Exts...>    exts,
+                           Kernel&&               kernel )
+     {
+         constexpr size_t ndim = sizeof...(Exts);
+
+         using clock = std::chrono::steady_clock;
+
+         const auto time_config =
+            [&]( const config& cfg ) -> double
+           {
+               const auto policy = make_policy( inner, cfg );
+
+               kernel( policy );
+
+               double best = std::numeric_limits<double>::max();
+               for( size_t r=0; r<settings().repeats; ++r )
+              {
+                  const auto start = clock::now();
+                  kernel( policy );
+                  const auto stop = clock::now();
+
+                  best = std::min( best, std::chrono::duration<double>(stop-start).count() );
+              }
+               return best;
+           };
+
+         config best;
+         best.seconds = time_config(best);
+
+         const auto try_config =
+            [&]( config cfg )
+           {
+               cfg.seconds = time_config(cfg);
+               if( cfg.seconds < best.seconds ){ best = cfg; }
+           };
+
+      // tile extents
+         for( size_t d=ndim; d-->0; )
+        {
+            const config base = best;
+            for( const idx_t t : settings().tile_sizes )
+           {
+               if( t >= exts.extent(d) ){ continue; }
+
+               config cfg = base;
+               cfg.tile[d] = t;
+               try_config( cfg );
+           }
+        }
+
+      // tile loop order, only relevant if there is more than one tile
+         if( ndim>1 )
+        {
+            const config base = best;
+
+            std::array<ndim_t,ndim> perm{};
+            for( ndim_t d=0; d<ndim; ++d ){ perm[d]=d; }
+
+            while( std::next_permutation( perm.begin(), perm.end() ) )
+           {
+               config cfg = base;
+               for( ndim_t d=0; d<ndim; ++d ){ cfg.order[d]=perm[d]; }
+               try_config( cfg );
+           }
+        }
+
+      // number of threads
+# ifdef _OPENMP
+         if constexpr( std::same_as<InnerPolicy,execution::openmp_policy> )
+        {
+            const config base = best;
+            const int max_threads = omp_get_max_threads();
+
+            for( int n=1; n<max_threads; n*=2 )
+           {
+               config cfg = base;
+               cfg.num_threads = n;
+               try_config( cfg );
+           }
+        }
+# endif
+
+         return best;
+     }
+
+   /*
+    * tiled policy for the call signature, from the database if present or by searching (and then storing the result) otherwise
+    */
+      template<typename InnerPolicy,
+               ptrdiff_t...    Exts,
+               typename      Kernel>
+      [[nodiscard]]
+      execution::tiled_policy<InnerPolicy> tuned_policy(       database&                 db,
+                                                         const InnerPolicy            inner,
+                                                         const std::string&       call_sig,
+                                                         const stx::extents<Exts...>  exts,
+                                                               Kernel&&             kernel )
+     {
+         const std::string key = call_sig + "|" + instrument::policy_name(inner);
+
+         if( const auto cfg = db.find(key) )
+        {
+            return make_policy( inner, *cfg );
+        }
+
+         const config cfg = search( inner, exts, std::forward<Kernel>(kernel) );
+         db.insert( key, cfg );
+
+         return make_policy( inner, cfg );
+     }
+
+      template<typename InnerPolicy,
+               ptrdiff_t...    Exts,
+               typename      Kernel>
+      [[nodiscard]]
+      execution::tiled_policy<InnerPolicy> tuned_policy( const InnerPolicy            inner,
+                                                         const std::string&       call_sig,
+                                                         const stx::extents<Exts...>  exts,
+                                                               Kernel&&             kernel )
+     {
+         return tuned_policy( database::instance(),
+                              inner, call_sig, exts,
+                              std::forward<Kernel>(kernel) );
+     }
+
+   /*
+    * ===============================================================
+    *
+    * tuned algorithms
+    *    same arguments as the corresponding yam:: algorithm after a kernel name, with the policy used as the inner policy of the tuned tiled_policy
+    *
+    * ===============================================================
+    */
+
+      namespace detail
+     {
+      /*
+       * array standing in for a destination while tuning
+       *    same element type and grid, and the same layout if that is layout_left (layout_right otherwise)
+       *    it covers the indices [0,begin+exts) so the kernel is called with the same indices as on the destination
+       */
+         template<typename Destination>
+         struct scratch_layout
+            : std::type_identity<default_layout> {};
+
+         template<typename Destination>
+            requires std::same_as<typename Destination::layout_type,stx::layout_left>
+         struct scratch_layout<Destination>
+            : std::type_identity<stx::layout_left> {};
+
+         template<typename Destination>
+         using scratch_t =
+            basic_array<std::remove_cvref_t<element_type_of_t<Destination>>,
+                        dextents<ndim_of_v<Destination>>,
+                        typename scratch_layout<Destination>::type,
+                        default_accessor<std::remove_cvref_t<element_type_of_t<Destination>>>,
+                        grid_of_v<Destination>>;
+
+         template<typename Destination,
+                  ptrdiff_t...   Exts>
+         [[nodiscard]]
+         scratch_t<Destination> make_scratch( const index_type_of_t<Destination> begin_index,
+                                              const stx::extents<Exts...>               exts )
+        {
+            std::array<idx_t,sizeof...(Exts)> scratch_exts;
+            for( ndim_t r=0; r<sizeof...(Exts); ++r ){ scratch_exts[r] = begin_index[r]+exts.extent(r); }
+
+            return scratch_t<Destination>( scratch_exts );
+        }
+
+      /*
+       * tiled policy for a call writing to a Destination: kernel(policy,scratch) is only called while tuning, with a scratch array allocated on first use
+       */
+         template<typename   Destination,
+                  typename   InnerPolicy,
+                  ptrdiff_t...      Exts,
+                  typename        Kernel>
+         [[nodiscard]]
+         execution::tiled_policy<InnerPolicy> tuned_policy_on_scratch( const InnerPolicy                          inner,
+                                                                       const std::string&                      call_sig,
+                                                                       const index_type_of_t<Destination> begin_index,
+                                                                       const stx::extents<Exts...>                 exts,
+                                                                             Kernel&&                            kernel )
+        {
+            std::optional<scratch_t<Destination>> scratch;
+
+            return tuned_policy( inner, call_sig, exts,
+               [&]( const auto policy )
+              {
+                  if( !scratch ){ scratch.emplace( make_scratch<Destination>( begin_index, exts ) ); }
+                  kernel( policy, *scratch );
+              } );
+        }
+     }
+
+   /*
+    * tuned yam::assign
+    */
+      template<execution_policy InnerPolicy,
+               indexable        Destination,
+               indexable             Source,
+               ptrdiff_t...            Exts>
+         requires same_grid_as<Destination,
+                               Source>
+               && assignable_element<element_type_of_t<Destination>,
+                                     element_type_of_t<Source>>
+               && (sizeof...(Exts)==ndim_of_v<Source>)
+      void assign( const InnerPolicy                                  inner,
+                   const std::string_view                       kernel_name,
+                   const located_index<index_type_of_t<Source>> begin_index,
+                   const stx::extents<Exts...>                         exts,
+                         Destination&                           destination,
+                   const Source&                                     source )
+     {
+         const auto policy =
+            detail::tuned_policy_on_scratch<Destination>( inner, signature<Destination,Source>( "assign:"+std::string(kernel_name), exts ), begin_index, exts,
+               [&]( const auto p, auto& scratch ){ yam::assign( p, begin_index, exts, scratch, source ); } );
+
+         yam::assign( policy,
+                      begin_index, exts,
+                      destination,
+                      source );
+     }
+
+   /*
+    * tuned eager yam::transform
+    *    the signature includes the number and types of the sources, so eg 2- and 6-source transforms are tuned separately,
+    *    but not the type of transform_func: transforms with different functions need different kernel names
+    */
+      template<execution_policy InnerPolicy,
+               typename       TransformFunc,
+               indexable        Destination,
+               indexable...         Sources,
+               ptrdiff_t...            Exts>
+         requires same_grid_as<Destination,
+                               Sources...>
+               && transformation_r<TransformFunc,
+                                   element_type_of_t<Destination>,
+                                   element_type_of_t<Sources>...>
+               && (sizeof...(Exts)==ndim_of_v<Destination>)
+      void transform( const InnerPolicy                                       inner,
+                      const std::string_view                            kernel_name,
+                      const located_index<index_type_of_t<Destination>> begin_index,
+                      const stx::extents<Exts...>                              exts,
+                            Destination&                                destination,
+                      const TransformFunc&                           transform_func,
+                      const Sources&...                                     sources )
+     {
+         const auto policy =
+            detail::tuned_policy_on_scratch<Destination>( inner, signature<Destination,Sources...>( "transform:"+std::string(kernel_name), exts ), begin_index, exts,
+               [&]( const auto p, auto& scratch ){ yam::transform( p, begin_index, exts, scratch, transform_func, sources... ); } );
+
+         yam::transform( policy,
+                         begin_index, exts,
+                         destination,
+                         transform_func,
+                         sources... );
+     }
+  }
+}
@@ -5,6 +5,11 @@
 # include <utility>
 # include <concepts>
 # include <algorithm>
+# include <numeric>
+# include <vector>
+
+# include <cstddef>
+# include <cassert>
 
 namespace yam::utl
 {
@@ -100,9 +105,12 @@ namespace yam::utl
      }
   }
 
+/*
+ * value on its own cache line(s): aligning to the line length also pads the size to a multiple of it
+ */
    template<typename T,
             size_t   N=64>
-   struct alignas(std::max(N,sizeof(T))) aligned_t
+   struct alignas(N) alignas(T) aligned_t
   {
       constexpr static size_t line_length = N;
 
@@ -116,4 +124,36 @@ namespace yam::utl
       operator cref() const { return data; }
   };
 
+/*
+ * Split items with the given weights into nparts lists with (nearly) equal total weights
+ *    greedy longest-processing-time split: each item, heaviest first, goes to the currently lightest part,
+ *    so the heaviest part is at most 4/3 of the best possible split
+ *    items of equal weight are taken in order, and each part lists its items in increasing order
+ */
+   [[nodiscard]]
+   inline std::vector<std::vector<size_t>> balanced_partition( const std::vector<size_t>& weights,
+                                                               const size_t                nparts )
+  {
+      assert( nparts>0 );
+
+      std::vector<size_t> order( weights.size() );
+      std::iota( order.begin(), order.end(), size_t(0) );
+      std::stable_sort( order.begin(), order.end(),
+         [&weights]( const size_t a, const size_t b ){ return weights[a]>weights[b]; } );
+
+      std::vector<std::vector<size_t>> parts( nparts );
+      std::vector<size_t> load( nparts, 0 );
+
+      for( const size_t item : order )
+     {
+         const size_t p = size_t( std::min_element( load.begin(), load.end() ) - load.begin() );
+         parts[p].push_back( item );
+         load[p] += weights[item];
+     }
+
+      for( auto& part : parts ){ std::sort( part.begin(), part.end() ); }
+
+      return parts;
+  }
+
 }
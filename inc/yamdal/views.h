@@ -5,6 +5,14 @@
 # include "type_traits.h"
 # include "index.h"
 
+# include <array>
+# include <memory>
+# include <tuple>
+# include <utility>
+# include <concepts>
+# include <type_traits>
+# include <cstddef>
+
 namespace yam
 {
 /*
@@ -70,4 +78,367 @@ namespace yam
            { return source(i); };
   }
 
+/*
+ * ===============================================================
+ *
+ * Staggered grid operators
+ *    dual index i is the cell between primal indices i and i+1 along each axis, so
+ *       to_dual_interp<Axes...>( p )(i)   averages p(i+c) over the corners c with c[a] in {0,1} for each of Axes
+ *       to_primal_interp<Axes...>( d )(i) averages d(i-c) over the same corners
+ *    an empty list of axes interpolates along every axis
+ *
+ *       gradient<axis>( p, inv_dx )       primal->dual difference along axis, averaged along the other axes
+ *       divergence( inv_dx, d0, d1, .. )  dual->primal sum of the differences of component a along axis a, averaged along the other axes
+ *       laplacian( s, inv_dx )            divergence of gradient as a single 3^ndim point stencil, on the grid of s
+ *    divergence is minus the transpose of gradient, so laplacian is conservative and symmetric
+ *
+ *    All return by value and hold a reference to their sources, like cwindow.
+ *    Stencil offsets are compile time constants. For sources with strides (basic_span, basic_array) they are converted
+ *    to pointer offsets when the view is made, so each evaluation computes one element address instead of one per point.
+ *
+ * ===============================================================
+ */
+
+   namespace detail
+  {
+   // sources whose elements are laid out with constant strides, so neighbours can be reached by pointer offsets
+      template<typename I>
+      concept strided_indexable =
+         indexable<I>
+      && std::is_lvalue_reference_v<element_type_of_t<const I&>>
+      && requires( const I& source ){ { source.stride(0) } -> std::convertible_to<ptrdiff_t>; };
+
+      template<typename I>
+      using stencil_value_t = std::remove_cvref_t<element_type_of_t<const I&>>;
+
+   // axes selected by Axes, or all axes if Axes is empty
+      template<ndim_t       ndim,
+               ndim_t...    Axes>
+      [[nodiscard]]
+      constexpr std::array<bool,ndim> axis_mask()
+     {
+         static_assert( ((Axes<ndim)&&...), "axis out of range" );
+
+         std::array<bool,ndim> mask{};
+         for( ndim_t r=0; r<ndim; ++r ){ mask[r] = sizeof...(Axes)==0 || ((r==Axes)||...); }
+         return mask;
+     }
+
+      template<size_t ndim>
+      [[nodiscard]]
+      constexpr size_t num_corners( const std::array<bool,ndim> mask )
+     {
+         size_t n=1;
+         for( const bool m : mask ){ if( m ){ n*=2; } }
+         return n;
+     }
+
+   // offsets of the corners of the cell spanned by the axes in mask, each step (+1 or -1) away from the origin along those axes
+   // the first corner is the origin
+      template<size_t ncorners,
+               size_t     ndim>
+      [[nodiscard]]
+      constexpr auto corner_offsets( const std::array<bool,ndim> mask,
+                                     const idx_t                 step )
+         -> std::array<std::array<idx_t,ndim>,ncorners>
+     {
+         std::array<std::array<idx_t,ndim>,ncorners> offsets{};
+         for( size_t c=0; c<ncorners; ++c )
+        {
+            size_t bit=0;
+            for( size_t r=0; r<ndim; ++r )
+           {
+               if( mask[r] ){ offsets[c][r] = ((c>>bit++)&1) ? step : 0; }
+           }
+        }
+         return offsets;
+     }
+
+   // the corners followed by the corners shifted by step along axis
+      template<size_t ncorners,
+               size_t     ndim>
+      [[nodiscard]]
+      constexpr auto with_shifted( const std::array<std::array<idx_t,ndim>,ncorners> corners,
+                                   const size_t                                         axis,
+                                   const idx_t                                          step )
+         -> std::array<std::array<idx_t,ndim>,2*ncorners>
+     {
+         std::array<std::array<idx_t,ndim>,2*ncorners> offsets{};
+         for( size_t c=0; c<ncorners; ++c )
+        {
+            offsets[c] = corners[c];
+            offsets[ncorners+c] = corners[c];
+            offsets[ncorners+c][axis] += step;
+        }
+         return offsets;
+     }
+
+   // all offsets in {-1,0,1}^ndim, the first is the origin
+      template<size_t ndim>
+      [[nodiscard]]
+      constexpr auto neighbourhood_offsets()
+     {
+         constexpr size_t npoints = [](){ size_t n=1; for( size_t r=0; r<ndim; ++r ){ n*=3; } return n; }();
+
+         std::array<std::array<idx_t,ndim>,npoints> offsets{};
+         for( size_t k=0; k<npoints; ++k )
+        {
+            size_t digits=k;
+            for( size_t r=0; r<ndim; ++r )
+           {
+               constexpr idx_t step[3] = {0,1,-1};
+               offsets[k][r] = step[digits%3];
+               digits/=3;
+           }
+        }
+         return offsets;
+     }
+
+   // number of points of the offsets returned by the constexpr generator Offsets
+      template<typename Offsets>
+      inline constexpr size_t stencil_size_v = std::tuple_size_v<decltype(Offsets{}())>;
+
+   /*
+    * lazy view over out_grid of sum_k weights[k]*source(scale*i+offsets[k])
+    *    the offsets come from a captureless constexpr generator so that they are constants in the generated code,
+    *    also when stencils are composed
+    *    scale is 1 except for stencils between grids of different resolution (eg multigrid restriction)
+    */
+      template<grid_t out_grid,
+               typename Offsets,
+               idx_t      scale= 1,
+               indexable      I>
+      [[nodiscard]]
+      constexpr view auto stencil( const I&                                                         source,
+                                   const std::array<stencil_value_t<I>,stencil_size_v<Offsets>>    weights )
+     {
+         constexpr ndim_t ndim = ndim_of_v<I>;
+         constexpr size_t npoints = stencil_size_v<Offsets>;
+
+         using value_type   = stencil_value_t<I>;
+         using source_index = index_type_of_t<I>;
+         using index_type   = index<ndim,out_grid>;
+
+         static_assert( std::floating_point<value_type>, "staggered operators need floating point elements" );
+         static_assert( npoints>0 );
+
+         const auto offset_index =
+            []( const index_type idx, const std::array<idx_t,ndim>& offset ) -> source_index
+           {
+               source_index shifted{};
+               for( ndim_t r=0; r<ndim; ++r ){ shifted[r] = scale*idx[r]+offset[r]; }
+               return shifted;
+           };
+
+         if constexpr( strided_indexable<I> )
+        {
+         // memory offsets relative to the first point, which is where the element address is computed
+            std::array<ptrdiff_t,npoints> flat{};
+            for( size_t k=0; k<npoints; ++k )
+           {
+               const auto offset = Offsets{}()[k];
+               for( ndim_t r=0; r<ndim; ++r ){ flat[k] += (offset[r]-Offsets{}()[0][r])*ptrdiff_t(source.stride(r)); }
+           }
+
+            return [ &source, offset_index, flat, weights ]
+                  ( const index_type idx ) -> value_type
+                 {
+                     constexpr auto offsets = Offsets{}();
+
+                     const auto* p = std::addressof( source( offset_index( idx, offsets[0] ) ) );
+
+                     value_type sum = weights[0]*p[0];
+                     for( size_t k=1; k<npoints; ++k ){ sum += weights[k]*p[flat[k]]; }
+                     return sum;
+                 };
+        }
+         else
+        {
+            return [ &source, offset_index, weights ]
+                  ( const index_type idx ) -> value_type
+                 {
+                     constexpr auto offsets = Offsets{}();
+
+                     value_type sum = weights[0]*source( offset_index( idx, offsets[0] ) );
+                     for( size_t k=1; k<npoints; ++k ){ sum += weights[k]*source( offset_index( idx, offsets[k] ) ); }
+                     return sum;
+                 };
+        }
+     }
+
+   // interpolation from the other grid onto out_grid along Axes
+      template<grid_t out_grid,
+               ndim_t...   Axes,
+               indexable      I>
+      [[nodiscard]]
+      constexpr view auto interp( const I& source )
+     {
+         using value_type = stencil_value_t<I>;
+
+         constexpr auto mask = axis_mask<ndim_of_v<I>,Axes...>();
+         constexpr size_t ncorners = num_corners( mask );
+
+      // dual cells lie above primal nodes, primal nodes below dual cells
+         constexpr idx_t step = out_grid==dual ? 1 : -1;
+         constexpr auto offsets = [](){ return corner_offsets<ncorners>( mask, step ); };
+
+         std::array<value_type,ncorners> weights;
+         weights.fill( value_type(1)/value_type(ncorners) );
+
+         return stencil<out_grid,decltype(offsets)>( source, weights );
+     }
+
+   // difference along axis onto out_grid, averaged along the other axes
+      template<grid_t out_grid,
+               ndim_t     axis,
+               indexable     I>
+      [[nodiscard]]
+      constexpr view auto difference( const I&                      source,
+                                      const stencil_value_t<I>      inv_dx )
+     {
+         using value_type = stencil_value_t<I>;
+
+         constexpr ndim_t ndim = ndim_of_v<I>;
+         static_assert( axis<ndim, "axis out of range" );
+
+         constexpr auto mask =
+            []()
+           {
+               std::array<bool,ndim> m{};
+               for( ndim_t r=0; r<ndim; ++r ){ m[r] = r!=axis; }
+               return m;
+           }();
+         constexpr size_t ncorners = num_corners( mask );
+
+      // primal->dual: p(i+c+e_axis) - p(i+c),  dual->primal: d(i-c) - d(i-c-e_axis)
+         constexpr idx_t step = out_grid==dual ? 1 : -1;
+         constexpr auto offsets = [](){ return with_shifted( corner_offsets<ncorners>( mask, step ), axis, step ); };
+
+         const value_type w = value_type(step)*inv_dx/value_type(ncorners);
+
+         std::array<value_type,2*ncorners> weights;
+         for( size_t c=0; c<ncorners; ++c )
+        {
+            weights[c]          = -w;
+            weights[ncorners+c] =  w;
+        }
+
+         return stencil<out_grid,decltype(offsets)>( source, weights );
+     }
+
+   // divergence of gradient along each axis, onto the grid of the source
+      template<indexable I>
+      [[nodiscard]]
+      constexpr view auto laplacian( const I&                                                source,
+                                     const std::array<stencil_value_t<I>,ndim_of_v<I>>      inv_dx )
+     {
+         using value_type = stencil_value_t<I>;
+
+         constexpr ndim_t ndim = ndim_of_v<I>;
+         constexpr auto offsets = [](){ return neighbourhood_offsets<ndim>(); };
+
+      // second difference (1,-2,1) along each axis, smoothed by (1/4,1/2,1/4) along the other axes
+         constexpr auto points = offsets();
+
+         std::array<value_type,points.size()> weights{};
+         for( size_t k=0; k<points.size(); ++k )
+        {
+            for( ndim_t a=0; a<ndim; ++a )
+           {
+               value_type w = inv_dx[a]*inv_dx[a]*( points[k][a]==0 ? value_type(-2) : value_type(1) );
+               for( ndim_t b=0; b<ndim; ++b )
+              {
+                  if( b!=a ){ w *= points[k][b]==0 ? value_type(0.5) : value_type(0.25); }
+              }
+               weights[k] += w;
+           }
+        }
+
+         return stencil<grid_of_v<I>,decltype(offsets)>( source, weights );
+     }
+  }
+
+/*
+ * interpolate a primal indexable onto the dual grid, along Axes (or all axes)
+ */
+   template<ndim_t...   Axes,
+            indexable      I>
+      requires (grid_of_v<I> == primal)
+   [[nodiscard]]
+   constexpr view auto to_dual_interp( const I& source )
+  {
+      return detail::interp<dual,Axes...>( source );
+  }
+
+/*
+ * interpolate a dual indexable onto the primal grid, along Axes (or all axes)
+ */
+   template<ndim_t...   Axes,
+            indexable      I>
+      requires (grid_of_v<I> == dual)
+   [[nodiscard]]
+   constexpr view auto to_primal_interp( const I& source )
+  {
+      return detail::interp<primal,Axes...>( source );
+  }
+
+/*
+ * derivative along axis of a primal indexable, on the dual grid
+ */
+   template<ndim_t   axis,
+            indexable   I>
+      requires (grid_of_v<I> == primal)
+   [[nodiscard]]
+   constexpr view auto gradient( const I&                              source,
+                                 const detail::stencil_value_t<I>      inv_dx )
+  {
+      return detail::difference<dual,axis>( source, inv_dx );
+  }
+
+/*
+ * divergence of a vector field with one dual indexable per axis, on the primal grid
+ */
+   template<typename   T,
+            size_t  ndim,
+            indexable... Is>
+      requires (sizeof...(Is) == ndim)
+            && ((grid_of_v<Is> == dual)&&...)
+            && ((ndim_of_v<Is> == ndim)&&...)
+   [[nodiscard]]
+   constexpr view auto divergence( const std::array<T,ndim>&      inv_dx,
+                                   const Is&...               components )
+  {
+      using index_type = index<ndim_t(ndim),primal>;
+
+      const auto terms =
+         [&]<size_t... Axes>( std::index_sequence<Axes...> )
+        {
+            return std::tuple{ detail::difference<primal,ndim_t(Axes)>( components, inv_dx[Axes] )... };
+        }( std::make_index_sequence<ndim>() );
+
+      return [ terms ]
+            ( const index_type idx )
+           {
+               return std::apply( [&]( const auto&... term ){ return (term(idx)+...); }, terms );
+           };
+  }
+
+/*
+ * laplacian of a primal or dual indexable, on the same grid
+ *    equal to divergence of gradient (for primal sources) but evaluated as one stencil
+ */
+   template<typename   T,
+            size_t  ndim,
+            indexable   I>
+      requires (ndim_of_v<I> == ndim)
+   [[nodiscard]]
+   constexpr view auto laplacian( const I&                     source,
+                                  const std::array<T,ndim>&    inv_dx )
+  {
+      std::array<detail::stencil_value_t<I>,ndim> inv_dx_v;
+      for( size_t r=0; r<ndim; ++r ){ inv_dx_v[r] = detail::stencil_value_t<I>(inv_dx[r]); }
+
+      return detail::laplacian( source, inv_dx_v );
+  }
+
 }
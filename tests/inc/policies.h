@@ -0,0 +1,23 @@
+# pragma once
+
+# include <yamdal/execution.h>
+# include <yamdal/index.h>
+
+# include <array>
+
+/*
+ * run a test function with each execution policy
+ *    serial_tile and parallel_tile are the tile extents of the tiled policies with serial and OpenMP inner policies
+ */
+   template<typename Test>
+   void for_each_policy( const std::array<yam::idx_t,3>   serial_tile,
+                         const std::array<yam::idx_t,3> parallel_tile,
+                               Test&&                           test )
+  {
+      test( yam::execution::seq );
+      test( yam::execution::tiled( yam::execution::seq, serial_tile ) );
+# ifdef _OPENMP
+      test( yam::execution::openmp );
+      test( yam::execution::tiled( yam::execution::openmp, parallel_tile ) );
+# endif
+  }
@@ -0,0 +1,706 @@
+
+# include <yamdal/algorithm.h>
+# include <yamdal/span.h>
+
+# include <catch.hpp>
+
+# include <policies.h>
+
+# include <memory>
+# include <functional>
+# include <numeric>
+# include <vector>
+# include <array>
+# include <algorithm>
+
+namespace
+{
+   using integer = yam::idx_t;
+
+// accumulator which counts its copies, to check that accumulate does not copy per element
+   struct counting_sum
+  {
+      static inline size_t copies=0;
+
+      std::vector<integer> sums;
+
+      explicit counting_sum( const size_t n ) : sums(n,0) {}
+
+      counting_sum( const counting_sum& other ) : sums(other.sums) { ++copies; }
+      counting_sum( counting_sum&& ) = default;
+
+      counting_sum& operator=( const counting_sum& other ){ sums=other.sums; ++copies; return *this; }
+      counting_sum& operator=( counting_sum&& ) = default;
+  };
+}
+
+   TEST_CASE( "whole-range scans in row-major order", "[algorithm][scan]" )
+  {
+      constexpr size_t n0=5;
+      constexpr size_t n1=7;
+      constexpr size_t n=n0*n1;
+
+      auto sdata = std::make_unique<integer[]>(n);
+      auto ddata = std::make_unique<integer[]>(n);
+
+      yam::span<integer,n0,n1> src(sdata.get());
+      yam::span<integer,n0,n1> dst(ddata.get());
+
+      const stx::extents<n0,n1> exts;
+
+      std::iota( sdata.get(), sdata.get()+n, 1 );
+
+      std::vector<integer> expected(n);
+
+      for_each_policy( {2,2,2}, {2,2,2},
+         [&]( const auto policy )
+        {
+            std::inclusive_scan( sdata.get(), sdata.get()+n, expected.begin() );
+
+            yam::inclusive_scan( policy, {0,0}, exts, dst, std::plus<integer>{}, src );
+            for( size_t i=0; i<n; ++i ){ REQUIRE( ddata[i] == expected[i] ); }
+
+            std::inclusive_scan( sdata.get(), sdata.get()+n, expected.begin(), std::plus<integer>{}, integer(100) );
+
+            yam::inclusive_scan( policy, {0,0}, exts, dst, std::plus<integer>{}, integer(100), src );
+            for( size_t i=0; i<n; ++i ){ REQUIRE( ddata[i] == expected[i] ); }
+
+            std::exclusive_scan( sdata.get(), sdata.get()+n, expected.begin(), integer(10) );
+
+            yam::exclusive_scan( policy, {0,0}, exts, dst, std::plus<integer>{}, integer(10), src );
+            for( size_t i=0; i<n; ++i ){ REQUIRE( ddata[i] == expected[i] ); }
+
+         // in-place
+            std::copy( sdata.get(), sdata.get()+n, ddata.get() );
+            yam::exclusive_scan( policy, {0,0}, exts, dst, std::plus<integer>{}, integer(10), dst );
+            for( size_t i=0; i<n; ++i ){ REQUIRE( ddata[i] == expected[i] ); }
+
+         // subrange {1,2}->{4,5}: row-major order over the subrange only
+            std::fill( ddata.get(), ddata.get()+n, 0 );
+            yam::inclusive_scan( policy, {1,2}, stx::extents<3,3>{}, dst, std::plus<integer>{}, src );
+
+            integer sum=0;
+            for( integer i=1; i<4; ++i )
+           {
+               for( integer j=2; j<5; ++j )
+              {
+                  sum += src(yam::index2<>{i,j});
+                  REQUIRE( dst(yam::index2<>{i,j}) == sum );
+              }
+           }
+            REQUIRE( dst(yam::index2<>{0,0}) == 0 );
+            REQUIRE( dst(yam::index2<>{4,4}) == 0 );
+        } );
+  }
+
+   TEST_CASE( "scans along an axis", "[algorithm][scan]" )
+  {
+      constexpr size_t n0=4;
+      constexpr size_t n1=5;
+      constexpr size_t n2=6;
+      constexpr size_t n=n0*n1*n2;
+
+      auto sdata = std::make_unique<integer[]>(n);
+      auto ddata = std::make_unique<integer[]>(n);
+
+      yam::span<integer,n0,n1,n2> src(sdata.get());
+      yam::span<integer,n0,n1,n2> dst(ddata.get());
+
+      const stx::extents<n0,n1,n2> exts;
+
+      std::iota( sdata.get(), sdata.get()+n, 1 );
+
+   // check destination against a scan along each line in direction axis
+      const auto check =
+         [&]( const yam::ndim_t axis, const bool inclusive, const integer init )
+        {
+            const std::array<integer,3> ext{n0,n1,n2};
+
+            for( integer i=0; i<integer(n0); ++i )
+           {
+               for( integer j=0; j<integer(n1); ++j )
+              {
+                  for( integer k=0; k<integer(n2); ++k )
+                 {
+                     yam::index3<> idx{i,j,k};
+                     const integer m = idx[axis];
+
+                     integer expected = init;
+                     for( integer l=0; l<m+(inclusive ? 1 : 0); ++l )
+                    {
+                        idx[axis] = l;
+                        expected += src(idx);
+                    }
+                     idx[axis] = m;
+
+                     REQUIRE( dst(idx) == expected );
+                     REQUIRE( m < ext[axis] );
+                 }
+              }
+           }
+        };
+
+      for_each_policy( {2,2,2}, {2,2,2},
+         [&]( const auto policy )
+        {
+            yam::inclusive_scan<0>( policy, {}, exts, dst, std::plus<integer>{}, src );
+            check( 0, true, 0 );
+
+            yam::inclusive_scan<1>( policy, {}, exts, dst, std::plus<integer>{}, src );
+            check( 1, true, 0 );
+
+            yam::inclusive_scan<2>( policy, {}, exts, dst, std::plus<integer>{}, integer(3), src );
+            check( 2, true, 3 );
+
+            yam::exclusive_scan<2>( policy, {}, exts, dst, std::plus<integer>{}, integer(0), src );
+            check( 2, false, 0 );
+
+            yam::exclusive_scan<0>( policy, {}, exts, dst, std::plus<integer>{}, integer(-1), src );
+            check( 0, false, -1 );
+        } );
+
+   // convenience overload, 1D
+      yam::span<integer,n> src1(sdata.get());
+      yam::span<integer,n> dst1(ddata.get());
+
+      yam::inclusive_scan<0>( {0}, stx::extents<n>{}, dst1, std::plus<integer>{}, src1 );
+      REQUIRE( ddata[n-1] == integer(n*(n+1)/2) );
+  }
+
+   TEST_CASE( "reduce along axes into lower rank destination", "[algorithm][reduce_axis]" )
+  {
+      constexpr size_t n0=4;
+      constexpr size_t n1=5;
+      constexpr size_t n2=6;
+      constexpr size_t n=n0*n1*n2;
+
+      using exts_t = stx::extents<n0,n1,n2>;
+
+      auto sdata = std::make_unique<integer[]>(n);
+
+   // source value depends only on index, so layouts can be compared
+      const auto value =
+         []( const yam::index3<> idx ){ return 100*idx[0] + 10*idx[1] + idx[2]; };
+
+      yam::basic_span<integer,exts_t,stx::layout_right> src_right(sdata.get());
+      yam::basic_span<integer,exts_t,stx::layout_left>  src_left(sdata.get());
+
+      std::array<integer,n1*n2> ddata2{};
+      std::array<integer,n0>    ddata1{};
+
+   // sum over axis a of value(idx) for given remaining indices
+      const auto expected =
+         [&]( yam::index3<> idx, const std::vector<yam::ndim_t>& axes, const yam::index3<> begin, const std::array<integer,3>& ext )
+        {
+            integer sum=1;
+            std::array<integer,3> lo{}, hi{};
+            for( yam::ndim_t d=0; d<3; ++d )
+           {
+               const bool reduced = std::find( axes.begin(), axes.end(), d )!=axes.end();
+               lo[d] = reduced ? begin[d] : idx[d];
+               hi[d] = reduced ? begin[d]+ext[d] : idx[d]+1;
+           }
+            for( idx[0]=lo[0]; idx[0]<hi[0]; ++idx[0] )
+           {
+               for( idx[1]=lo[1]; idx[1]<hi[1]; ++idx[1] )
+              {
+                  for( idx[2]=lo[2]; idx[2]<hi[2]; ++idx[2] ){ sum += value(idx); }
+              }
+           }
+            return sum;
+        };
+
+      const auto run =
+         [&]( const auto policy, const auto& src )
+        {
+            yam::assign( yam::execution::seq, {}, exts_t{}, src, value );
+
+         // reduce over innermost/outermost/middle axis into 2D destination of the remaining axes
+            {
+               yam::span<integer,n1,n2> dst(ddata2.data());
+               yam::reduce_axis<0>( policy, {}, exts_t{}, dst, std::plus<integer>{}, integer(1), src );
+
+               for( integer j=0; j<integer(n1); ++j )
+              {
+                  for( integer k=0; k<integer(n2); ++k )
+                 {
+                     REQUIRE( dst(yam::index2<>{j,k}) == expected( {0,j,k}, {0}, {0,0,0}, {n0,n1,n2} ) );
+                 }
+              }
+            }
+            {
+               yam::span<integer,n0,n2> dst(ddata2.data());
+               yam::reduce_axis<1>( policy, {}, exts_t{}, dst, std::plus<integer>{}, integer(1), src );
+
+               for( integer i=0; i<integer(n0); ++i )
+              {
+                  for( integer k=0; k<integer(n2); ++k )
+                 {
+                     REQUIRE( dst(yam::index2<>{i,k}) == expected( {i,0,k}, {1}, {0,0,0}, {n0,n1,n2} ) );
+                 }
+              }
+            }
+            {
+               yam::span<integer,n0,n1> dst(ddata2.data());
+               yam::reduce_axis<2>( policy, {}, exts_t{}, dst, std::plus<integer>{}, integer(1), src );
+
+               for( integer i=0; i<integer(n0); ++i )
+              {
+                  for( integer j=0; j<integer(n1); ++j )
+                 {
+                     REQUIRE( dst(yam::index2<>{i,j}) == expected( {i,j,0}, {2}, {0,0,0}, {n0,n1,n2} ) );
+                 }
+              }
+            }
+
+         // two axes, over a subrange: destination indexed by the remaining source index
+            {
+               ddata1.fill(0);
+               yam::span<integer,n0> dst(ddata1.data());
+               yam::reduce_axis<1,2>( policy, {1,1,2}, stx::extents<3,2,3>{}, dst, std::plus<integer>{}, integer(1), src );
+
+               REQUIRE( ddata1[0] == 0 );
+               for( integer i=1; i<4; ++i )
+              {
+                  REQUIRE( dst(yam::index1<>{i}) == expected( {i,0,0}, {1,2}, {1,1,2}, {3,2,3} ) );
+              }
+            }
+        };
+
+      for_each_policy( {2,2,2}, {2,2,2},
+         [&]( const auto policy )
+        {
+            run( policy, src_right );
+            run( policy, src_left );
+
+         // generic indexable without strides
+            std::array<integer,n1*n2> out{};
+            yam::span<integer,n1,n2> dst(out.data());
+            yam::reduce_axis<0>( policy, {}, exts_t{}, dst, std::plus<integer>{}, integer(1), value );
+            REQUIRE( dst(yam::index2<>{2,3}) == expected( {0,2,3}, {0}, {0,0,0}, {n0,n1,n2} ) );
+        } );
+  }
+
+   TEST_CASE( "argmin, argmax and top_k return indices with values", "[algorithm][argmin]" )
+  {
+      constexpr size_t n0=6;
+      constexpr size_t n1=7;
+      constexpr size_t n2=5;
+      constexpr size_t n=n0*n1*n2;
+
+      using exts_t = stx::extents<n0,n1,n2>;
+
+      auto data = std::make_unique<double[]>(n);
+      yam::span<double,n0,n1,n2> src(data.get());
+
+   // pseudo-random values with repeats, so ties are ranked by index
+      const auto value =
+         []( const yam::index3<> idx ){ return double( (idx[0]*31 + idx[1]*17 + idx[2]*7) % 23 ); };
+
+      yam::assign( yam::execution::seq, {}, exts_t{}, src, value );
+
+   // reference: every element with its index in row-major order
+      std::vector<yam::indexed_value<yam::index3<>,double>> all;
+      for( integer i=0; i<integer(n0); ++i )
+     {
+         for( integer j=0; j<integer(n1); ++j )
+        {
+            for( integer k=0; k<integer(n2); ++k ){ all.push_back( {{i,j,k}, value({i,j,k})} ); }
+        }
+     }
+
+      const auto by_value =
+         []( auto compare )
+        {
+            return [=]( const auto& a, const auto& b ){ return compare(a.value,b.value); };
+        };
+
+      std::stable_sort( all.begin(), all.end(), by_value(std::less<>{}) );
+      const auto smallest = all;
+
+      std::stable_sort( all.begin(), all.end(), by_value(std::greater<>{}) );
+      const auto largest = all;
+
+      for_each_policy( {2,2,2}, {2,2,2},
+         [&]( const auto policy )
+        {
+            const auto min = yam::argmin( policy, {}, exts_t{}, src );
+            REQUIRE( min.index == smallest[0].index );
+            REQUIRE( min.value == smallest[0].value );
+
+            const auto max = yam::argmax( policy, {}, exts_t{}, src );
+            REQUIRE( max.index == largest[0].index );
+            REQUIRE( max.value == largest[0].value );
+
+            for( const size_t k : { size_t(0), size_t(1), size_t(9), n, n+3 } )
+           {
+               const auto top = yam::top_k( policy, {}, exts_t{}, k, std::greater<>{}, src );
+               REQUIRE( top.size() == std::min(k,n) );
+
+               for( size_t r=0; r<top.size(); ++r )
+              {
+                  REQUIRE( top[r].index == largest[r].index );
+                  REQUIRE( top[r].value == largest[r].value );
+              }
+           }
+
+            const auto bottom = yam::top_k( policy, {}, exts_t{}, 5, std::less<>{}, src );
+            for( size_t r=0; r<bottom.size(); ++r ){ REQUIRE( bottom[r].index == smallest[r].index ); }
+
+         // subrange, over a lazy view
+            const auto shifted = yam::transform( []( const double v ){ return -v; }, yam::window(src) );
+            const auto sub = yam::argmax( policy, {1,2,1}, stx::extents<3,2,4>{}, shifted );
+
+            double expected = 1e9;
+            for( integer i=1; i<4; ++i )
+           {
+               for( integer j=2; j<4; ++j )
+              {
+                  for( integer k=1; k<5; ++k ){ expected = std::min( expected, value({i,j,k}) ); }
+              }
+           }
+            REQUIRE( sub.value == -expected );
+            REQUIRE( value(sub.index) == expected );
+            REQUIRE( sub.index[0] >= 1 );
+            REQUIRE( sub.index[0] <  4 );
+        } );
+
+   // convenience overloads
+      REQUIRE( yam::argmin( {}, exts_t{}, src ).index == smallest[0].index );
+      REQUIRE( yam::top_k( {}, exts_t{}, 2, std::less<>{}, src ).size() == 2 );
+  }
+
+   TEST_CASE( "histogram and binned statistics over a range", "[algorithm][histogram]" )
+  {
+      constexpr size_t n0=9;
+      constexpr size_t n1=8;
+      constexpr size_t n2=7;
+
+      using exts_t = stx::extents<n0,n1,n2>;
+
+   // keys in [-2,22), values depend on the index
+      const auto key =
+         []( const yam::index3<> idx ){ return double( (idx[0]*13 + idx[1]*5 + idx[2]*3) % 24 ) - 2.0; };
+
+      const auto value =
+         []( const yam::index3<> idx ){ return idx[0] + 2*idx[1] - idx[2]; };
+
+      const yam::uniform_bins<>  ubins( 0.0, 20.0, 5 );
+      const yam::variable_bins<> vbins( {-1.0, 0.0, 3.0, 15.0, 19.0} );
+
+   // reference statistics for a subrange
+      const auto reference =
+         [&]( const auto& bins, const yam::index3<> begin, const std::array<integer,3>& ext )
+        {
+            std::vector<yam::bin_statistics<>> stats( bins.size() );
+            for( integer i=begin[0]; i<begin[0]+ext[0]; ++i )
+           {
+               for( integer j=begin[1]; j<begin[1]+ext[1]; ++j )
+              {
+                  for( integer k=begin[2]; k<begin[2]+ext[2]; ++k )
+                 {
+                     const size_t b = bins.bin( key({i,j,k}) );
+                     if( b<bins.size() ){ stats[b].add( double( value({i,j,k}) ) ); }
+                 }
+              }
+           }
+            return stats;
+        };
+
+      const auto check =
+         [&]( const auto policy, const auto& bins, const yam::histogram_mode mode )
+        {
+            const auto expected = reference( bins, {0,0,0}, {n0,n1,n2} );
+
+            const auto counts = yam::histogram( policy, {}, exts_t{}, bins, mode, key );
+            REQUIRE( counts.size() == bins.size() );
+
+            const auto stats = yam::binned_statistic( policy, {}, exts_t{}, bins, mode, key, value );
+            REQUIRE( stats.size() == bins.size() );
+
+            for( size_t b=0; b<bins.size(); ++b )
+           {
+               REQUIRE( counts[b] == expected[b].count );
+               REQUIRE( stats[b].count == expected[b].count );
+               REQUIRE( stats[b].mean == Approx(expected[b].mean) );
+               REQUIRE( stats[b].variance() == Approx(expected[b].variance()).margin(1e-9) );
+           }
+
+            const auto sub_expected = reference( bins, {2,1,3}, {5,6,2} );
+            const auto sub_counts = yam::histogram( policy, {2,1,3}, stx::extents<5,6,2>{}, bins, mode, key );
+
+            for( size_t b=0; b<bins.size(); ++b ){ REQUIRE( sub_counts[b] == sub_expected[b].count ); }
+        };
+
+      for_each_policy( {2,2,2}, {2,2,2},
+         [&]( const auto policy )
+        {
+            for( const auto mode : { yam::histogram_mode::automatic, yam::histogram_mode::privatised, yam::histogram_mode::atomic } )
+           {
+               check( policy, ubins, mode );
+               check( policy, vbins, mode );
+           }
+        } );
+
+   // convenience overloads and default mode
+      const auto counts = yam::histogram( {}, exts_t{}, ubins, key );
+      const auto stats  = yam::binned_statistic( yam::execution::seq, {}, exts_t{}, ubins, key, value );
+
+      for( size_t b=0; b<ubins.size(); ++b ){ REQUIRE( counts[b] == stats[b].count ); }
+  }
+
+   TEST_CASE( "binned statistics of values with a large mean", "[algorithm][histogram]" )
+  {
+      using exts_t = stx::extents<16,12,10>;
+
+      const auto key =
+         []( const yam::index3<> idx ){ return double( (idx[0]*7 + idx[1]*3 + idx[2]) % 8 ); };
+
+   // a spread of a few units about 1e9, where the sum of squares has no digits of the variance left
+      const auto value =
+         []( const yam::index3<> idx ){ return 1.0e9 + double( (idx[0]*5 + idx[1]*11 + idx[2]*2) % 7 ) - 3.0; };
+
+      const yam::uniform_bins<> bins( 0.0, 8.0, 8 );
+
+      std::vector<yam::bin_statistics<>> expected( bins.size() );
+      yam::for_each_index( yam::execution::seq, yam::index3<>{}, exts_t{},
+         [&]( const yam::index3<> idx ){ expected[bins.bin( key(idx) )].add( value(idx) ); } );
+
+      for_each_policy( {2,2,2}, {2,2,2},
+         [&]( const auto policy )
+        {
+            const auto privatised = yam::binned_statistic( policy, {}, exts_t{}, bins, yam::histogram_mode::privatised, key, value );
+            const auto atomic     = yam::binned_statistic( policy, {}, exts_t{}, bins, yam::histogram_mode::atomic,     key, value );
+
+            for( size_t b=0; b<bins.size(); ++b )
+           {
+               REQUIRE( expected[b].variance() > 1.0 );
+
+               REQUIRE( privatised[b].count == expected[b].count );
+               REQUIRE( atomic[b].count     == expected[b].count );
+
+               REQUIRE( privatised[b].mean == Approx(expected[b].mean).epsilon(1e-12) );
+               REQUIRE( atomic[b].mean     == Approx(expected[b].mean).epsilon(1e-12) );
+
+               REQUIRE( privatised[b].variance() == Approx(expected[b].variance()).epsilon(1e-6) );
+               REQUIRE( atomic[b].variance()     == Approx(expected[b].variance()).epsilon(1e-6) );
+           }
+        } );
+  }
+
+   TEST_CASE( "accumulate updates the accumulator in place", "[algorithm][accumulate]" )
+  {
+      constexpr size_t n0=6;
+      constexpr size_t n1=5;
+      constexpr size_t n2=4;
+
+      using exts_t = stx::extents<n0,n1,n2>;
+
+      const auto value =
+         []( const yam::index3<> idx ){ return idx[0]*100 + idx[1]*10 + idx[2]; };
+
+   // per-residue sums of the values, mod 3
+      const auto accumulate_func =
+         []( counting_sum& acc, const integer v ){ acc.sums[size_t(v%3)] += v; };
+
+      const auto combine_func =
+         []( counting_sum& acc, const counting_sum& partial )
+        {
+            for( size_t r=0; r<acc.sums.size(); ++r ){ acc.sums[r] += partial.sums[r]; }
+        };
+
+      const auto expected =
+         [&]( const yam::index3<> begin, const std::array<integer,3>& ext )
+        {
+            std::vector<integer> sums(3,0);
+            sums[0]=7;
+            for( integer i=begin[0]; i<begin[0]+ext[0]; ++i )
+           {
+               for( integer j=begin[1]; j<begin[1]+ext[1]; ++j )
+              {
+                  for( integer k=begin[2]; k<begin[2]+ext[2]; ++k ){ sums[size_t(value({i,j,k})%3)] += value({i,j,k}); }
+              }
+           }
+            return sums;
+        };
+
+      const counting_sum identity(3);
+
+      for_each_policy( {2,2,2}, {2,2,2},
+         [&]( const auto policy )
+        {
+            counting_sum init(3);
+            init.sums[0]=7;
+
+            counting_sum::copies=0;
+
+            const auto result =
+               yam::accumulate( policy, {}, exts_t{}, accumulate_func, combine_func, identity, std::move(init), value );
+
+            REQUIRE( result.sums == expected( {0,0,0}, {n0,n1,n2} ) );
+
+         // at most one copy of identity per thread, independent of the number of elements
+            REQUIRE( counting_sum::copies <= size_t(64) );
+            REQUIRE( counting_sum::copies <  n0*n1*n2 );
+
+            counting_sum sub_init(3);
+            sub_init.sums[0]=7;
+
+            const auto sub =
+               yam::accumulate( policy, {1,2,1}, stx::extents<4,2,3>{}, accumulate_func, combine_func, identity, std::move(sub_init), value );
+
+            REQUIRE( sub.sums == expected( {1,2,1}, {4,2,3} ) );
+        } );
+
+   // serial overloads without identity/combine
+      counting_sum::copies=0;
+
+      counting_sum init(3);
+      init.sums[0]=7;
+
+      const auto result = yam::accumulate( {}, exts_t{}, accumulate_func, std::move(init), value );
+
+      REQUIRE( result.sums == expected( {0,0,0}, {n0,n1,n2} ) );
+      REQUIRE( counting_sum::copies == 0 );
+  }
+
+   TEST_CASE( "masked assignment and compacted index lists", "[algorithm][mask]" )
+  {
+      constexpr size_t n0=9;
+      constexpr size_t n1=6;
+      constexpr size_t n2=5;
+      constexpr size_t n=n0*n1*n2;
+
+      using exts_t = stx::extents<n0,n1,n2>;
+
+   // land/sea style mask over about half the domain
+      const auto mask =
+         []( const yam::index3<> idx ){ return (idx[0]*7 + idx[1]*3 + idx[2]) % 5 < 2; };
+
+      const auto value =
+         []( const yam::index3<> idx ){ return double( 100*idx[0] + 10*idx[1] + idx[2] ); };
+
+      for_each_policy( {2,2,2}, {2,2,2},
+         [&]( const auto policy )
+        {
+            auto data = std::make_unique<double[]>(n);
+            yam::span<double,n0,n1,n2> dst(data.get());
+
+            yam::fill( policy, {}, exts_t{}, dst, -1.0 );
+
+         // only the interior of the range, so the mask is not evaluated outside it
+            const yam::index3<> begin{1,1,1};
+            const stx::extents<7,4,3> exts;
+
+            yam::assign_if( policy, begin, exts, dst, mask, value );
+
+            const auto inside =
+               []( const yam::index3<> idx )
+              {
+                  return idx[0]>=1 && idx[0]<8 && idx[1]>=1 && idx[1]<5 && idx[2]>=1 && idx[2]<4;
+              };
+
+            for( integer i=0; i<integer(n0); ++i )
+           {
+               for( integer j=0; j<integer(n1); ++j )
+              {
+                  for( integer k=0; k<integer(n2); ++k )
+                 {
+                     const yam::index3<> idx{i,j,k};
+                     REQUIRE( dst(idx) == ( inside(idx) && mask(idx) ? value(idx) : -1.0 ) );
+                 }
+              }
+           }
+
+         // transform_where with several sources
+            yam::transform_where( policy, begin, exts, dst, mask,
+                                  []( const double d, const double v ){ return d + 2*v; },
+                                  dst, value );
+
+            REQUIRE( dst(yam::index3<>{1,1,1}) == ( mask(yam::index3<>{1,1,1}) ? 3*value(yam::index3<>{1,1,1}) : -1.0 ) );
+
+         // compacted list, in row-major order
+            const auto active = yam::compact( policy, begin, exts, mask );
+
+            std::vector<yam::index3<>> expected;
+            yam::for_each_index( yam::execution::seq, begin, exts,
+               [&]( const yam::index3<> idx ){ if( mask(idx) ){ expected.push_back(idx); } } );
+
+            REQUIRE( active == expected );
+
+         // reused for later kernels, which only evaluate the source at the listed indices
+            size_t calls=0;
+            const auto counted =
+               [&calls]( const yam::index3<> ){ ++calls; return 0.0; };
+
+            yam::assign( yam::execution::seq, active, dst, counted );
+            REQUIRE( calls == active.size() );
+
+            yam::transform( policy, active, dst,
+                            []( const double v ){ return v+1; },
+                            value );
+
+            for( const auto& idx : active ){ REQUIRE( dst(idx) == value(idx)+1 ); }
+        } );
+  }
+
+   TEST_CASE( "gather and scatter_add through index arrays", "[algorithm][scatter]" )
+  {
+   // particles in the cells of a 2D grid, several per cell and some cells empty
+      constexpr size_t np=500;
+      constexpr size_t n0=12;
+      constexpr size_t n1=9;
+
+      std::vector<yam::index2<>> cells(np);
+      std::vector<double>        charge(np);
+      for( size_t p=0; p<np; ++p )
+     {
+         cells[p]  = { integer( (p*7)%n0 ), integer( (p*p)%n1 ) };
+         charge[p] = double( p%13 );
+     }
+
+      const auto cell_of   = [&]( const yam::index1<> p ){ return cells[size_t(p[0])]; };
+      const auto charge_of = [&]( const yam::index1<> p ){ return charge[size_t(p[0])]; };
+
+      std::vector<double> reference( n0*n1, 0.0 );
+      for( size_t p=0; p<np; ++p ){ reference[size_t(cells[p][0])*n1+size_t(cells[p][1])] += charge[p]; }
+
+      const std::array modes{ yam::scatter_mode::automatic,   yam::scatter_mode::privatised,
+                              yam::scatter_mode::partitioned, yam::scatter_mode::atomic };
+
+      for_each_policy( {2,2,2}, {2,2,2},
+         [&]( const auto policy )
+        {
+            for( const auto mode : modes )
+           {
+               auto data = std::make_unique<double[]>(n0*n1);
+               yam::span<double,n0,n1> grid(data.get());
+               yam::fill( {}, stx::extents<n0,n1>{}, grid, 1.0 );
+
+               yam::scatter_add( policy, {}, stx::extents<np>{}, grid, cell_of, charge_of, mode );
+
+               for( size_t c=0; c<n0*n1; ++c ){ REQUIRE( data[c] == 1.0+reference[c] ); }
+
+            // interpolate back to the particles
+               std::vector<double> sampled(np);
+               yam::span<double,np> sampled_span( sampled.data() );
+
+               yam::gather( policy, {}, stx::extents<np>{}, sampled_span, grid, cell_of );
+
+               for( size_t p=0; p<np; ++p )
+              {
+                  REQUIRE( sampled[p] == 1.0+reference[size_t(cells[p][0])*n1+size_t(cells[p][1])] );
+              }
+           }
+        } );
+
+   // only part of the particles
+      auto data = std::make_unique<double[]>(n0*n1);
+      yam::span<double,n0,n1> grid(data.get());
+      yam::fill( {}, stx::extents<n0,n1>{}, grid, 0.0 );
+
+      yam::scatter_add( yam::index1<>{np-1}, stx::extents<1>{}, grid, cell_of, charge_of );
+
+      REQUIRE( grid(cells[np-1]) == charge[np-1] );
+      REQUIRE( yam::reduce( {}, stx::extents<n0,n1>{}, std::plus{}, 0.0, grid ) == charge[np-1] );
+  }
@@ -0,0 +1,134 @@
+
+# include <yamdal/aosoa.h>
+# include <yamdal/algorithm.h>
+
+# include <catch.hpp>
+
+# include <policies.h>
+
+# include <cstddef>
+# include <utility>
+
+namespace
+{
+   using integer = yam::idx_t;
+
+   struct cell
+  {
+      double rho;
+      float  phase;
+      int    flag;
+      double e;
+  };
+
+   constexpr size_t B = 4;
+
+   using accessor_t = yam::aosoa_accessor<B,&cell::rho,&cell::phase,&cell::flag,&cell::e>;
+
+   constexpr integer n0 = 6;
+   constexpr integer n1 = 9;
+}
+
+   TEST_CASE( "aosoa_accessor storage of fields in blocks", "[aosoa]" )
+  {
+      using array_t = yam::aosoa_array1<accessor_t>;
+      using index_t = array_t::index_type;
+
+      constexpr integer n = 10;
+
+      array_t q( n );
+
+      static_assert( yam::indexable1<array_t> );
+      static_assert( std::same_as<yam::element_type_of_t<array_t&>,accessor_t::reference> );
+      static_assert( std::same_as<yam::element_type_of_t<const array_t&>,accessor_t::const_reference> );
+      static_assert( accessor_t::storage_size( n )==12 );
+
+   // within a block of 4 elements: 4 rho, then 4 phase, 4 flag and 4 e
+      const auto* base = reinterpret_cast<const std::byte*>( q.data().base );
+      constexpr size_t block_bytes = B*sizeof(cell);
+      for( integer i=0; i<n; ++i )
+     {
+         const auto block = base + size_t(i)/B*block_bytes;
+         const auto lane  = size_t(i)%B;
+         const auto elem  = q(index_t{i});
+         REQUIRE( reinterpret_cast<const std::byte*>( &yam::field<&cell::rho>( elem ) )   == block + lane*sizeof(double) );
+         REQUIRE( reinterpret_cast<const std::byte*>( &yam::field<&cell::phase>( elem ) ) == block + 32 + lane*sizeof(float) );
+         REQUIRE( reinterpret_cast<const std::byte*>( &yam::field<&cell::flag>( elem ) )  == block + 48 + lane*sizeof(int) );
+         REQUIRE( reinterpret_cast<const std::byte*>( &yam::field<&cell::e>( elem ) )     == block + 64 + lane*sizeof(double) );
+     }
+
+   // elements assign from and convert to the struct
+      q(index_t{5}) = cell{ 1.5, 2.5f, 3, 4.5 };
+      const cell c = std::as_const(q)(index_t{5});
+      REQUIRE( c.rho == 1.5 );
+      REQUIRE( c.phase == 2.5f );
+      REQUIRE( c.flag == 3 );
+      REQUIRE( c.e == 4.5 );
+
+      yam::field<&cell::flag>( q(index_t{9}) ) = 7;
+      REQUIRE( cell( q(index_t{9}) ).flag == 7 );
+      REQUIRE( cell( q(index_t{8}) ).flag == 0 );
+
+   // assignment between elements assigns the fields
+      q(index_t{0}) = q(index_t{5});
+      REQUIRE( cell( q(index_t{0}) ).e == 4.5 );
+
+   // copies are deep
+      const array_t r = q;
+      q(index_t{5}) = cell{};
+      REQUIRE( cell( r(index_t{5}) ).phase == 2.5f );
+      REQUIRE( cell( r(index_t{9}) ).flag == 7 );
+
+   // spans of the same storage, from an offset pointer
+      using span_t = yam::basic_span<cell,yam::dextents<1>,yam::default_layout,accessor_t>;
+      const span_t s( q.accessor().offset( q.data(), 3 ), n-3 );
+      REQUIRE( cell( s(index_t{6}) ).flag == 7 );
+      REQUIRE( &yam::field<&cell::e>( s(index_t{6}) ) == &yam::field<&cell::e>( q(index_t{9}) ) );
+  }
+
+   TEST_CASE( "aosoa_accessor with algorithms and field views", "[aosoa]" )
+  {
+      using array_t = yam::aosoa_array2<accessor_t>;
+      using index_t = array_t::index_type;
+
+      const index_t begin{1,1};
+      const auto range = yam::dextents<2>( n0-2, n1-2 );
+
+      for_each_policy( {2,3,0}, {3,2,0}, [&]( const auto policy )
+     {
+         array_t q( n0, n1 );
+
+      // whole elements
+         yam::assign( policy, begin, range, q,
+                      []( const index_t idx ){ return cell{ double(idx[0]), float(idx[1]), int(idx[0]+idx[1]), 1.0 }; } );
+
+      // single fields, read and written through views
+         yam::transform( policy, begin, range, yam::field_view<&cell::e>( q ),
+                         []( const double rho, const float phase ){ return rho*double(phase); },
+                         yam::field_view<&cell::rho>( std::as_const(q) ), yam::field_view<&cell::phase>( std::as_const(q) ) );
+
+      // elements as sources
+         array_t p( n0, n1 );
+         yam::transform( policy, begin, range, p,
+                         []( const cell u ){ return cell{ u.e, u.phase, -u.flag, u.rho }; },
+                         std::as_const(q) );
+
+         for( integer i=0; i<n0; ++i )
+        {
+            for( integer j=0; j<n1; ++j )
+           {
+               const index_t idx{i,j};
+               const bool inside = i>0 && i<n0-1 && j>0 && j<n1-1;
+               const cell u = std::as_const(q)(idx);
+               const cell v = std::as_const(p)(idx);
+               REQUIRE( u.rho   == ( inside ? double(i) : 0.0 ) );
+               REQUIRE( u.phase == ( inside ? float(j) : 0.0f ) );
+               REQUIRE( u.flag  == ( inside ? int(i+j) : 0 ) );
+               REQUIRE( u.e     == ( inside ? double(i*j) : 0.0 ) );
+               REQUIRE( v.rho   == u.e );
+               REQUIRE( v.flag  == -u.flag );
+               REQUIRE( v.e     == u.rho );
+           }
+        }
+     } );
+  }
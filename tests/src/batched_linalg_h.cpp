@@ -0,0 +1,174 @@
+
+# include <yamdal/batched_linalg.h>
+# include <yamdal/array.h>
+
+# include <catch.hpp>
+
+# include <policies.h>
+
+# include <array>
+# include <cmath>
+# include <utility>
+
+namespace
+{
+   using integer = yam::idx_t;
+
+   using array_t = yam::primal_array2<double>;
+   using index_t = array_t::index_type;
+
+// a grid of 5 x 40 nodes, solved over an interior range with a partial last segment
+   constexpr integer n0 = 5;
+   constexpr integer n1 = 2*yam::batched_segment_length+8;
+
+   const index_t begin{1,2};
+   const auto range = yam::dextents<2>( n0-2, n1-5 );
+
+   template<size_t size>
+   std::array<array_t,size> make_components()
+  {
+      return [&]<size_t... m>( std::index_sequence<m...> )
+     {
+         return std::array<array_t,size>{ (void(m),array_t( n0, n1 ))... };
+     }( std::make_index_sequence<size>{} );
+  }
+
+   bool in_range( const index_t idx )
+  {
+      return idx[0]>=begin[0] && idx[0]<begin[0]+integer(range.extent(0))
+          && idx[1]>=begin[1] && idx[1]<begin[1]+integer(range.extent(1));
+  }
+
+// max over the range of |A*x-b|, and over the rest of the grid of |x-b|
+   template<size_t N>
+   double residual( const auto&                      a,
+                    const std::array<array_t,N>&     x,
+                    const std::array<array_t,N>&     b )
+  {
+      double r = 0;
+      for( integer i0=0; i0<n0; ++i0 )
+     {
+         for( integer i1=0; i1<n1; ++i1 )
+        {
+            const index_t idx{i0,i1};
+            for( size_t i=0; i<N; ++i )
+           {
+               double ax = 0;
+               if( in_range( idx ) ){ for( size_t j=0; j<N; ++j ){ ax += a(idx,i,j)*x[j](idx); } }
+               else { ax = x[i](idx); }
+               r = std::max( r, std::abs( ax-b[i](idx) ) );
+           }
+        }
+     }
+      return r;
+  }
+}
+
+   TEST_CASE( "batched LU solves of diagonally dominant systems", "[batched_linalg]" )
+  {
+      constexpr size_t N = 4;
+
+   // diagonally dominant and not symmetric, different at each node
+      const auto a =
+         []( const index_t idx, const size_t i, const size_t j )
+        {
+            const double off = 0.1*double(idx[0]+1) + 0.01*double(idx[1]) + 0.3*double(i) - 0.2*double(j);
+            return i==j ? 4.0+double(i)+0.05*double(idx[1]) : off;
+        };
+      const auto b =
+         []( const index_t idx, const size_t i ){ return 1.0 + double(i) - 0.02*double(idx[1]*idx[0]); };
+
+      const auto fill =
+         [&]( auto& A, auto& B )
+        {
+            for( integer i0=0; i0<n0; ++i0 )
+           {
+               for( integer i1=0; i1<n1; ++i1 )
+              {
+                  const index_t idx{i0,i1};
+                  for( size_t i=0; i<N; ++i )
+                 {
+                     B[i](idx) = b( idx, i );
+                     for( size_t j=0; j<N; ++j ){ A[i*N+j](idx) = a( idx, i, j ); }
+                 }
+              }
+           }
+        };
+
+      for_each_policy( {2,3,0}, {3,2,0}, [&]( const auto policy )
+     {
+         auto A = make_components<N*N>();
+         auto x = make_components<N>();
+         auto rhs = make_components<N>();
+         fill( A, rhs );
+         fill( A, x );
+
+      // factorisation, then solve
+         yam::lu_factor<N>( policy, begin, range, A );
+         yam::lu_solve<N>( policy, begin, range, A, x );
+         REQUIRE( residual<N>( a, x, rhs ) < 1e-12 );
+
+      // outside the range the factors are not set
+         REQUIRE( A[1](index_t{0,0}) == a( index_t{0,0}, 0, 1 ) );
+         REQUIRE( A[N](index_t{n0-1,n1-1}) == a( index_t{n0-1,n1-1}, 1, 0 ) );
+
+      // single pass, with a lazy matrix
+         const auto element =
+            [&]( const size_t i, const size_t j ){ return [&a,i,j]( const index_t idx ){ return a( idx, i, j ); }; };
+
+         std::array<decltype(element(0,0)),N*N> lazy{ element(0,0), element(0,1), element(0,2), element(0,3),
+                                                      element(1,0), element(1,1), element(1,2), element(1,3),
+                                                      element(2,0), element(2,1), element(2,2), element(2,3),
+                                                      element(3,0), element(3,1), element(3,2), element(3,3) };
+         fill( A, x );
+         yam::lu_factor_solve<N>( policy, begin, range, lazy, x );
+         REQUIRE( residual<N>( a, x, rhs ) < 1e-12 );
+     } );
+  }
+
+   TEST_CASE( "batched Cholesky solves of symmetric positive definite systems", "[batched_linalg]" )
+  {
+      constexpr size_t N = 5;
+
+   // M^T M + I, with M different at each node
+      const auto m =
+         []( const index_t idx, const size_t i, const size_t j ){ return std::sin( double(idx[0]*7+idx[1]*3) + double(i*N+j) ); };
+      const auto a =
+         [&]( const index_t idx, const size_t i, const size_t j )
+        {
+            double s = i==j ? 1.0 : 0.0;
+            for( size_t k=0; k<N; ++k ){ s += m( idx, k, i )*m( idx, k, j ); }
+            return s;
+        };
+
+      for_each_policy( {2,3,0}, {3,2,0}, [&]( const auto policy )
+     {
+         auto A = make_components<N*N>();
+         auto x = make_components<N>();
+         auto y = make_components<N>();
+         auto rhs = make_components<N>();
+         for( integer i0=0; i0<n0; ++i0 )
+        {
+            for( integer i1=0; i1<n1; ++i1 )
+           {
+               const index_t idx{i0,i1};
+               for( size_t i=0; i<N; ++i )
+              {
+                  rhs[i](idx) = x[i](idx) = y[i](idx) = double(i+1) - 0.1*double(i1);
+                  for( size_t j=0; j<N; ++j ){ A[i*N+j](idx) = a( idx, i, j ); }
+              }
+           }
+        }
+
+      // single pass
+         yam::cholesky_factor_solve<N>( policy, begin, range, std::as_const(A), y );
+         REQUIRE( residual<N>( a, y, rhs ) < 1e-12 );
+
+      // factorisation, then solve: only the lower triangle is written
+         yam::cholesky_factor<N>( policy, begin, range, A );
+         yam::cholesky_solve<N>( policy, begin, range, A, x );
+         REQUIRE( residual<N>( a, x, rhs ) < 1e-12 );
+         REQUIRE( A[1](begin) == a( begin, 0, 1 ) );
+         REQUIRE( A[N](begin) != a( begin, 1, 0 ) );
+     } );
+  }
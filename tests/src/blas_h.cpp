@@ -0,0 +1,116 @@
+
+# include <yamdal/blas.h>
+# include <yamdal/array.h>
+
+# include <catch.hpp>
+
+# include <policies.h>
+
+# include <tuple>
+# include <cmath>
+
+namespace
+{
+   using integer = yam::idx_t;
+}
+
+   TEST_CASE( "blas-1 kernels over 1D arrays", "[blas]" )
+  {
+      using array_t = yam::primal_array1<double>;
+      using index_t = array_t::index_type;
+
+   // more than two segments, and a partial last segment
+      constexpr integer n = 2*yam::detail::blas_segment_length+37;
+      const auto range = yam::dextents<1>( n-2 );
+
+      for_each_policy( {2,3,2}, {3,2,5}, [&]( const auto policy )
+     {
+         array_t x(n);
+         array_t y(n);
+         array_t z(n);
+         for( integer i=0; i<n; ++i )
+        {
+            x(index_t{i}) = double(i%11);
+            y(index_t{i}) = double(1+i%3);
+            z(index_t{i}) = 0.5;
+        }
+
+      // exact in floating point, whatever the order of summation
+         double x_dot_y=0;
+         double x_dot_x=0;
+         for( integer i=1; i<n-1; ++i )
+        {
+            x_dot_y += x(index_t{i})*y(index_t{i});
+            x_dot_x += x(index_t{i})*x(index_t{i});
+        }
+
+         REQUIRE( yam::dot( policy, index_t{1}, range, x, y ) == x_dot_y );
+         REQUIRE( yam::nrm2( policy, index_t{1}, range, x ) == Approx( std::sqrt( x_dot_x ) ) );
+
+      // lazy source
+         const auto twice_x = [&x]( const index_t i ){ return 2*x(i); };
+         REQUIRE( yam::dot( policy, index_t{1}, range, twice_x, y ) == 2*x_dot_y );
+
+         yam::axpy( policy, index_t{1}, range, 2.0, x, y );
+         yam::axpby( policy, index_t{1}, range, 3.0, x, -1.0, z );
+         for( integer i=1; i<n-1; ++i )
+        {
+            REQUIRE( y(index_t{i}) == 2*double(i%11) + double(1+i%3) );
+            REQUIRE( z(index_t{i}) == 3*double(i%11) - 0.5 );
+        }
+
+      // outside the range
+         REQUIRE( y(index_t{0})   == 1.0 );
+         REQUIRE( z(index_t{n-1}) == 0.5 );
+
+         yam::scal( policy, index_t{1}, range, 0.5, z );
+         yam::axpy( policy, index_t{1}, range, std::array{1.0,-2.0,0.5}, std::tie( x, twice_x, z ), y );
+         for( integer i=1; i<n-1; ++i )
+        {
+            const double xi = double(i%11);
+            REQUIRE( y(index_t{i}) == Approx( 2*xi + double(1+i%3) + xi - 4*xi + 0.5*(1.5*xi - 0.25) ) );
+        }
+     } );
+  }
+
+   TEST_CASE( "blas-1 kernels over 2D arrays with strides", "[blas]" )
+  {
+      using right_t = yam::basic_array<float,yam::dextents<2>>;
+      using left_t  = yam::basic_array<float,yam::dextents<2>,stx::layout_left>;
+      using index_t = right_t::index_type;
+
+      const auto range = yam::dextents<2>( 5, 1500 );
+
+      for_each_policy( {2,3,2}, {3,2,5}, [&]( const auto policy )
+     {
+         right_t x( 7, 1502 );
+         left_t  y( 7, 1502 );
+         for( integer i=0; i<7; ++i )
+        {
+            for( integer j=0; j<1502; ++j )
+           {
+               x(index_t{i,j}) = float(i+j%4);
+               y(index_t{i,j}) = float(j%2);
+           }
+        }
+
+         double x_dot_y=0;
+         for( integer i=1; i<6; ++i )
+        {
+            for( integer j=2; j<1502; ++j ){ x_dot_y += double(x(index_t{i,j}))*double(y(index_t{i,j})); }
+        }
+
+         REQUIRE( double( yam::dot( policy, index_t{1,2}, range, x, y ) ) == x_dot_y );
+         REQUIRE( double( yam::dot( policy, index_t{1,2}, range, y, y ) ) == 5*750 );
+
+         yam::axpy( policy, index_t{1,2}, range, -1.0f, x, y );
+         for( integer i=0; i<7; ++i )
+        {
+            for( integer j=0; j<1502; ++j )
+           {
+               const bool inside = i>=1 && i<6 && j>=2;
+               REQUIRE( y(index_t{i,j}) == float(j%2) - (inside ? float(i+j%4) : 0.0f) );
+           }
+        }
+     } );
+  }
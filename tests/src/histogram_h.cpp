@@ -0,0 +1,88 @@
+
+# include <yamdal/histogram.h>
+
+# include <catch.hpp>
+
+# include <vector>
+# include <limits>
+# include <cmath>
+
+   TEST_CASE( "bin lookup for uniform and variable bins", "[histogram]" )
+  {
+      const yam::uniform_bins<> ubins( -1.0, 3.0, 4 );
+
+      REQUIRE( ubins.size() == 4 );
+      REQUIRE( ubins.edge(0) == -1.0 );
+      REQUIRE( ubins.edge(4) ==  3.0 );
+
+      REQUIRE( ubins.bin(-1.0) == 0 );
+      REQUIRE( ubins.bin(-0.5) == 0 );
+      REQUIRE( ubins.bin( 0.0) == 1 );
+      REQUIRE( ubins.bin( 2.9) == 3 );
+
+   // last bin is closed
+      REQUIRE( ubins.bin( 3.0) == 3 );
+
+   // out of range and NaN
+      REQUIRE( ubins.bin(-1.5) == 4 );
+      REQUIRE( ubins.bin( 3.5) == 4 );
+      REQUIRE( ubins.bin( std::numeric_limits<double>::quiet_NaN() ) == 4 );
+
+      const yam::variable_bins<> vbins( {0.0, 1.0, 10.0, 100.0} );
+
+      REQUIRE( vbins.size() == 3 );
+      REQUIRE( vbins.bin(  0.0) == 0 );
+      REQUIRE( vbins.bin(  0.5) == 0 );
+      REQUIRE( vbins.bin(  1.0) == 1 );
+      REQUIRE( vbins.bin( 99.0) == 2 );
+      REQUIRE( vbins.bin(100.0) == 2 );
+      REQUIRE( vbins.bin(-1e-9) == 3 );
+      REQUIRE( vbins.bin(1e3  ) == 3 );
+      REQUIRE( vbins.bin( std::numeric_limits<double>::quiet_NaN() ) == 3 );
+
+      STATIC_REQUIRE( yam::binning<yam::uniform_bins<float>> );
+      STATIC_REQUIRE( yam::binning<yam::variable_bins<double>> );
+  }
+
+   TEST_CASE( "bin statistics accumulate and merge", "[histogram]" )
+  {
+      const std::vector<double> xs{ 1.0, 4.0, -2.0, 7.5, 3.25, 0.0, 11.0 };
+
+      double mean=0;
+      for( const double x : xs ){ mean += x; }
+      mean /= double(xs.size());
+
+      double var=0;
+      for( const double x : xs ){ var += (x-mean)*(x-mean); }
+      var /= double(xs.size());
+
+      yam::bin_statistics<> all;
+      for( const double x : xs ){ all.add(x); }
+
+      REQUIRE( all.count == xs.size() );
+      REQUIRE( all.mean == Approx(mean) );
+      REQUIRE( all.variance() == Approx(var) );
+
+   // any split of the values merges to the same statistics
+      for( size_t split=0; split<=xs.size(); ++split )
+     {
+         yam::bin_statistics<> lhs, rhs;
+         for( size_t i=0;     i<split;     ++i ){ lhs.add(xs[i]); }
+         for( size_t i=split; i<xs.size(); ++i ){ rhs.add(xs[i]); }
+
+         lhs.merge(rhs);
+
+         REQUIRE( lhs.count == xs.size() );
+         REQUIRE( lhs.mean == Approx(mean) );
+         REQUIRE( lhs.variance() == Approx(var) );
+     }
+
+      double sum=0, sum_sq=0;
+      for( const double x : xs ){ sum += x; sum_sq += x*x; }
+
+      const auto from_sums = yam::bin_statistics<>::from_sums( xs.size(), sum, sum_sq );
+      REQUIRE( from_sums.mean == Approx(mean) );
+      REQUIRE( from_sums.variance() == Approx(var) );
+
+      REQUIRE( yam::bin_statistics<>{}.variance() == 0 );
+  }
@@ -0,0 +1,122 @@
+
+# include <yamdal/index_set.h>
+# include <yamdal/algorithm.h>
+# include <yamdal/span.h>
+
+# include <catch.hpp>
+
+# include <policies.h>
+
+# include <memory>
+# include <vector>
+# include <functional>
+
+namespace
+{
+   using integer = yam::idx_t;
+}
+
+   TEST_CASE( "index_set merges consecutive indices into row spans", "[index_set]" )
+  {
+      yam::index_set<2> set;
+
+      set.insert( yam::index2<>{0,3} );
+      set.insert( yam::index2<>{0,4} );
+      set.insert( yam::index2<>{0,5}, 3 );   // extends the span
+      set.insert( yam::index2<>{1,9} );      // new row
+      set.insert( yam::index2<>{1,7} );      // not after the end of the last span
+      set.insert( yam::index2<>{2,0}, 0 );   // empty
+
+      REQUIRE( set.size() == 7 );
+      REQUIRE( set.row_spans().size() == 3 );
+      REQUIRE( set.row_spans()[0].length == 5 );
+
+      std::vector<yam::index2<>> all;
+      set.for_each_index( [&]( const yam::index2<> idx ){ all.push_back(idx); } );
+
+      REQUIRE( all == std::vector<yam::index2<>>{ {0,3}, {0,4}, {0,5}, {0,6}, {0,7}, {1,9}, {1,7} } );
+
+   // parts cover the set in order, and clip the spans
+      for( size_t nparts=1; nparts<=8; ++nparts )
+     {
+         std::vector<yam::index2<>> joined;
+         for( size_t p=0; p<nparts; ++p )
+        {
+            const auto [first,last] = set.part( p, nparts );
+            REQUIRE( last-first <= set.size()/nparts+1 );
+
+            set.for_each_index( first, last, [&]( const yam::index2<> idx ){ joined.push_back(idx); } );
+        }
+         REQUIRE( joined == all );
+     }
+
+      std::vector<std::pair<yam::index2<>,integer>> clipped;
+      set.for_each_span( 2, 6, [&]( const yam::index2<> begin, const integer length ){ clipped.push_back({begin,length}); } );
+
+      REQUIRE( clipped.size() == 2 );
+      REQUIRE( clipped[0].first == yam::index2<>{0,5} );
+      REQUIRE( clipped[0].second == 3 );
+      REQUIRE( clipped[1].first == yam::index2<>{1,9} );
+      REQUIRE( clipped[1].second == 1 );
+
+      set.clear();
+      REQUIRE( set.empty() );
+  }
+
+   TEST_CASE( "algorithms over an index_set", "[index_set][algorithm]" )
+  {
+      constexpr size_t n0=8;
+      constexpr size_t n1=7;
+      constexpr size_t n2=40;
+      constexpr size_t n=n0*n1*n2;
+
+      using exts_t = stx::extents<n0,n1,n2>;
+
+   // band around a front, a few runs per row
+      const auto in_band =
+         []( const yam::index3<> idx ){ const integer d = idx[2] - 3*idx[0] - idx[1]; return d>=4 && d<9; };
+
+      const auto value =
+         []( const yam::index3<> idx ){ return double( 1000*idx[0] + 100*idx[1] + idx[2] ); };
+
+      const yam::index_set<3> band( yam::compact( yam::index3<>{}, exts_t{}, in_band ) );
+
+      REQUIRE( band.row_spans().size() == n0*n1 );
+
+      for_each_policy( {2,2,2}, {2,2,2},
+         [&]( const auto policy )
+        {
+            auto data = std::make_unique<double[]>(n);
+            yam::span<double,n0,n1,n2> dst(data.get());
+
+            yam::fill( policy, {}, exts_t{}, dst, 0.0 );
+
+            yam::assign( policy, band, dst, value );
+            yam::transform( policy, band, dst, []( const double x ){ return 2*x; }, dst );
+
+            double expected_sum=0;
+            for( integer i=0; i<integer(n0); ++i )
+           {
+               for( integer j=0; j<integer(n1); ++j )
+              {
+                  for( integer k=0; k<integer(n2); ++k )
+                 {
+                     const yam::index3<> idx{i,j,k};
+                     REQUIRE( dst(idx) == ( in_band(idx) ? 2*value(idx) : 0.0 ) );
+                     if( in_band(idx) ){ expected_sum += 2*value(idx); }
+                 }
+              }
+           }
+
+            REQUIRE( yam::reduce( policy, band, std::plus{}, 0.0, 0.0, dst ) == expected_sum );
+
+         // bool partial results are written by each thread
+            const auto all_positive =
+               yam::reduce( policy, band, std::logical_and{}, true, true,
+                            [&]( const yam::index3<> idx ){ return dst(idx) > 0.0; } );
+
+            REQUIRE( all_positive );
+        } );
+
+      REQUIRE( yam::reduce( band, std::plus{}, 1.0, value ) > 1.0 );
+  }
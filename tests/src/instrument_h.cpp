@@ -0,0 +1,309 @@
+
+# define YAMDAL_INSTRUMENT
+
+# include <yamdal/instrument.h>
+# include <yamdal/algorithm.h>
+# include <yamdal/span.h>
+# include <yamdal/patch_collection.h>
+
+# include <catch.hpp>
+
+# include <memory>
+# include <functional>
+# include <sstream>
+# include <source_location>
+# include <cmath>
+# include <string>
+# include <vector>
+
+   TEST_CASE( "located_index records call site", "[instrument]" )
+  {
+      using index = yam::index2<>;
+      using located = yam::located_index<index>;
+
+      const auto get_location =
+         []( const located idx ){ return idx.location; };
+
+      const auto get_index =
+         []( const located idx ) -> index { return idx; };
+
+      const index i0{3,4};
+
+      const auto line = std::source_location::current().line(); const auto loc = get_location( i0 );
+
+      REQUIRE( loc.line() == line );
+
+   // implicit construction from index or braced list keeps index values
+      REQUIRE( get_index( i0 ) == i0 );
+      REQUIRE( get_index( {3,4} ) == i0 );
+      REQUIRE( get_index( {} ) == index{0,0} );
+  }
+
+   TEST_CASE( "instrumentation aggregates outermost calls by call site", "[instrument]" )
+  {
+      namespace instrument = yam::instrument;
+
+      using integer = yam::idx_t;
+
+      constexpr size_t n0=4;
+      constexpr size_t n1=5;
+      constexpr size_t n=n0*n1;
+
+      auto data0 = std::make_unique<integer[]>(n);
+      auto data1 = std::make_unique<integer[]>(n);
+
+      yam::span<integer,n0,n1> dst(data0.get());
+      yam::span<integer,n0,n1> src(data1.get());
+
+      const yam::index2<> begin{0,0};
+      const stx::extents<n0,n1> exts;
+
+      instrument::reset();
+
+      yam::fill( yam::execution::seq, begin, exts, src, integer(1) );
+
+      for( int i=0; i<3; ++i )
+     {
+         yam::assign( yam::execution::seq, begin, exts, dst, src );
+     }
+
+      yam::transform( yam::execution::seq, begin, exts, dst, std::negate<integer>{}, src );
+
+      const auto sum =
+         yam::reduce( yam::execution::seq, begin, exts, std::plus<integer>{}, integer(0), integer(0), dst );
+
+      REQUIRE( sum == -integer(n) );
+
+      const auto sites = instrument::report();
+
+   // the assign inside fill/transform and the transform inside reduce are not recorded
+      REQUIRE( sites.size() == 4 );
+
+      const auto find_site =
+         [&]( const std::string& kernel )
+        {
+            return *std::find_if( sites.begin(), sites.end(),
+                                  [&]( const auto& s ){ return s.kernel==kernel; } );
+        };
+
+      const auto assign_site = find_site( "assign" );
+
+      REQUIRE( assign_site.calls  == 3 );
+      REQUIRE( assign_site.policy == "seq" );
+      REQUIRE( assign_site.elems  == 3*n );
+      REQUIRE( assign_site.bytes  == 3*n*2*sizeof(integer) );
+      REQUIRE( assign_site.extents == std::vector<ptrdiff_t>{n0,n1} );
+      REQUIRE( assign_site.file.ends_with( "instrument_h.cpp" ) );
+
+      REQUIRE( find_site( "fill"      ).calls == 1 );
+      REQUIRE( find_site( "transform" ).calls == 1 );
+      REQUIRE( find_site( "reduce"    ).bytes == n*sizeof(integer) );
+
+      instrument::reset();
+      REQUIRE( instrument::report().empty() );
+  }
+
+   TEST_CASE( "algorithms without a begin index record the caller's site", "[instrument]" )
+  {
+      namespace instrument = yam::instrument;
+
+      using integer = yam::idx_t;
+
+      constexpr size_t n0=4;
+      constexpr size_t n1=5;
+      constexpr size_t n=n0*n1;
+
+      auto data0 = std::make_unique<integer[]>(n);
+      auto data1 = std::make_unique<integer[]>(n);
+
+      yam::span<integer,n0,n1> dst(data0.get());
+      yam::span<integer,n0,n1> src(data1.get());
+
+      yam::fill( yam::execution::seq, {}, stx::extents<n0,n1>{}, src, integer(1) );
+
+      const std::vector<yam::index2<>> indices{ {0,1}, {2,3}, {3,4} };
+
+      const auto only_site =
+         []( const std::string& kernel )
+        {
+            const auto sites = instrument::report();
+            REQUIRE( sites.size() == 1 );
+            REQUIRE( sites[0].kernel == kernel );
+            REQUIRE( sites[0].file.ends_with( "instrument_h.cpp" ) );
+            return sites[0];
+        };
+
+   // index list
+      instrument::reset();
+      const auto list_line = std::source_location::current().line(); yam::assign( yam::execution::seq, indices, dst, src );
+      REQUIRE( only_site( "assign" ).line == list_line );
+      REQUIRE( only_site( "assign" ).elems == indices.size() );
+
+      instrument::reset();
+      const auto tiled_line = std::source_location::current().line(); yam::assign( yam::execution::tiled( yam::execution::seq, {2,2} ), indices, dst, src );
+      REQUIRE( only_site( "assign" ).line == tiled_line );
+
+      instrument::reset();
+      const auto transform_line = std::source_location::current().line(); yam::transform( yam::execution::seq, indices, dst, std::negate<integer>{}, src );
+      REQUIRE( only_site( "assign" ).line == transform_line );
+      REQUIRE( dst(yam::index2<>{2,3}) == -1 );
+
+      instrument::reset();
+      const auto default_transform_line = std::source_location::current().line(); yam::transform( indices, dst, std::negate<integer>{}, src );
+      REQUIRE( only_site( "assign" ).line == default_transform_line );
+
+   // index_set
+      const yam::index_set<2> set( indices );
+
+      instrument::reset();
+      const auto set_line = std::source_location::current().line(); yam::assign( yam::execution::seq, set, dst, src );
+      REQUIRE( only_site( "assign" ).line == set_line );
+
+      instrument::reset();
+      const auto set_transform_line = std::source_location::current().line(); yam::transform( yam::execution::tiled( yam::execution::seq, {2,2} ), set, dst, std::negate<integer>{}, src );
+      REQUIRE( only_site( "assign" ).line == set_transform_line );
+
+      instrument::reset();
+      const auto default_set_transform_line = std::source_location::current().line(); yam::transform( set, dst, std::negate<integer>{}, src );
+      REQUIRE( only_site( "assign" ).line == default_set_transform_line );
+
+      instrument::reset();
+      const auto reduce_line = std::source_location::current().line(); const auto sum = yam::reduce( set, std::plus<integer>{}, integer(0), src );
+      REQUIRE( only_site( "reduce" ).line == reduce_line );
+      REQUIRE( sum == yam::reduce( yam::execution::seq, set, std::plus<integer>{}, integer(0), integer(0), src ) );
+
+# ifdef _OPENMP
+      instrument::reset();
+      const auto openmp_line = std::source_location::current().line(); yam::assign( yam::execution::openmp, set, dst, src );
+      REQUIRE( only_site( "assign" ).line == openmp_line );
+      REQUIRE( only_site( "assign" ).policy == "openmp" );
+# endif
+
+   // patch_collection
+      yam::patch_collection<integer,2> patches;
+      (void)patches.add_patch( 0, {0,0}, {2,3} );
+      (void)patches.add_patch( 0, {4,0}, {3,3} );
+
+      instrument::reset();
+      const auto patches_line = std::source_location::current().line(); yam::transform_patches( patches, []( const integer x ){ return x+1; } );
+      REQUIRE( only_site( "transform_patches" ).line == patches_line );
+      REQUIRE( only_site( "transform_patches" ).elems == 15 );
+
+      instrument::reset();
+      const auto reduce_patches_line = std::source_location::current().line(); (void)yam::reduce_patches( yam::execution::seq, patches, std::plus<>{}, integer(0), integer(0) );
+      REQUIRE( only_site( "reduce_patches" ).line == reduce_patches_line );
+
+      instrument::reset();
+  }
+
+   TEST_CASE( "instrumentation chrome trace output", "[instrument]" )
+  {
+      namespace instrument = yam::instrument;
+
+      using integer = yam::idx_t;
+
+      constexpr size_t n=8;
+
+      auto data = std::make_unique<integer[]>(n);
+      yam::span<integer,n> dst(data.get());
+
+      instrument::reset();
+      instrument::enable_trace();
+
+      yam::fill( yam::execution::seq, {0}, stx::extents<n>{}, dst, integer(2) );
+      yam::fill( yam::execution::seq, {0}, stx::extents<n>{}, dst, integer(3) );
+
+      instrument::enable_trace(false);
+
+      std::ostringstream trace;
+      instrument::write_chrome_trace( trace );
+
+      REQUIRE( trace.str().starts_with( "{\"traceEvents\":[" ) );
+      REQUIRE( trace.str().find( "\"name\":\"fill\"" ) != std::string::npos );
+
+   // two fill call sites on different lines
+      std::ostringstream json;
+      instrument::write_json( json );
+
+      REQUIRE( instrument::report().size() == 2 );
+      REQUIRE( json.str().find( "\"kernel\":\"fill\"" ) != std::string::npos );
+
+      instrument::reset();
+  }
+
+   TEST_CASE( "json strings escape quotes, backslashes and control characters", "[instrument]" )
+  {
+      using yam::instrument::detail::json_string;
+
+      REQUIRE( json_string( "fill" ) == "\"fill\"" );
+      REQUIRE( json_string( "a\"b\\c" ) == "\"a\\\"b\\\\c\"" );
+      REQUIRE( json_string( "a\nb\tc\x1f" ) == "\"a\\u000ab\\u0009c\\u001f\"" );
+  }
+
+   TEST_CASE( "hardware counters are monotonic or unavailable", "[instrument]" )
+  {
+      namespace instrument = yam::instrument;
+
+      const auto& counters = instrument::perf_counters::instance();
+
+      const auto before = counters.read();
+      const auto after  = counters.read();
+
+      for( size_t n=0; n<instrument::num_counters; ++n )
+     {
+         const auto c = instrument::counter(n);
+
+         if( counters.available(c) )
+        {
+            REQUIRE( after[c] >= before[c] );
+        }
+         else
+        {
+            REQUIRE( std::isnan( after[c] ) );
+        }
+     }
+  }
+
+   TEST_CASE( "roofline classification of call sites", "[instrument]" )
+  {
+      namespace instrument = yam::instrument;
+      using instrument::counter;
+
+      const instrument::machine_peaks peaks{ .bandwidth=10e9, .fp_vector_rate=1e10 };
+
+      instrument::call_site_stats site;
+      site.calls=1;
+      site.elems=1000;
+      site.bytes=64000;
+      site.total_time=1e-5; // 6.4 GB/s
+
+      site.counters[counter::cycles]=20000;
+      site.counters[counter::instructions]=10000;
+      site.counters[counter::llc_misses]=900;
+      site.counters[counter::fp_packed]=2000;
+      site.counters[counter::fp_scalar]=100;
+
+      REQUIRE( instrument::classify( site, peaks ) == std::string("bandwidth") );
+
+   // slow, data from memory, low IPC
+      site.total_time=1e-4;
+      REQUIRE( instrument::classify( site, peaks ) == std::string("latency") );
+
+   // slow, data in cache, vectorised
+      site.counters[counter::llc_misses]=10;
+      REQUIRE( instrument::classify( site, peaks ) == std::string("compute") );
+
+   // slow, data in cache, floating-point work not vectorised
+      site.counters[counter::fp_packed]=10;
+      REQUIRE( instrument::classify( site, peaks ) == std::string("fp-scalar") );
+
+   // slow, data in cache, no floating-point arithmetic (eg a copy or an integer kernel): cannot tell
+      site.counters[counter::fp_packed]=0;
+      site.counters[counter::fp_scalar]=0;
+      REQUIRE( instrument::classify( site, peaks ) == std::string("unknown") );
+
+      site.counters[counter::fp_packed]=2000;
+
+      site.counters[counter::llc_misses]=std::nan("");
+      REQUIRE( instrument::classify( site, peaks ) == std::string("unknown") );
+  }
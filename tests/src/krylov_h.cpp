@@ -0,0 +1,177 @@
+
+# include <yamdal/krylov.h>
+# include <yamdal/views.h>
+# include <yamdal/array.h>
+
+# include <catch.hpp>
+
+# include <policies.h>
+
+# include <array>
+# include <cmath>
+
+namespace
+{
+   using integer = yam::idx_t;
+
+   using array_t = yam::primal_array2<double>;
+   using index_t = array_t::index_type;
+
+// n x n nodes, with the outer layer as a zero boundary, so the unknowns are the (n-2)^2 interior nodes
+   constexpr integer n = 24;
+
+   const auto interior = yam::dextents<2>( n-2, n-2 );
+
+   index_t shift( const index_t i,
+                  const integer di,
+                  const integer dj )
+  {
+      return index_t{ i[0]+di, i[1]+dj };
+  }
+
+// -laplacian with the 5 point stencil
+   const auto minus_laplacian =
+      []( const auto& x )
+     {
+         return [&x]( const index_t i ) -> double
+        {
+            return 4*x(i) - x(shift(i,1,0)) - x(shift(i,-1,0)) - x(shift(i,0,1)) - x(shift(i,0,-1));
+        };
+     };
+
+// -laplacian plus a first difference along axis 0, so not symmetric
+   const auto convection_diffusion =
+      []( const auto& x )
+     {
+         return [&x]( const index_t i ) -> double
+        {
+            return 4.5*x(i) - 1.5*x(shift(i,-1,0)) - x(shift(i,1,0)) - x(shift(i,0,1)) - x(shift(i,0,-1));
+        };
+     };
+
+   array_t right_hand_side()
+  {
+      array_t b(n,n);
+      for( integer i=1; i<n-1; ++i )
+     {
+         for( integer j=1; j<n-1; ++j ){ b(index_t{i,j}) = std::sin( 0.3*double(i) ) + 0.01*double(j*j); }
+     }
+      return b;
+  }
+
+// ||b-A*x||/||b|| over the interior
+   template<typename ViewFunc>
+   double true_residual( const yam::linear_operator<ViewFunc>& A,
+                         const array_t&                        x,
+                         const array_t&                        b )
+  {
+      const auto Ax = A( x );
+      double rr=0;
+      double bb=0;
+      for( integer i=1; i<n-1; ++i )
+     {
+         for( integer j=1; j<n-1; ++j )
+        {
+            const index_t idx{i,j};
+            rr += (b(idx)-Ax(idx))*(b(idx)-Ax(idx));
+            bb += b(idx)*b(idx);
+        }
+     }
+      return std::sqrt( rr/bb );
+  }
+}
+
+   TEST_CASE( "linear_operator applies its view", "[krylov]" )
+  {
+      const yam::linear_operator A( minus_laplacian );
+
+      array_t x(n,n);
+      array_t y(n,n);
+      for( integer i=0; i<n; ++i )
+     {
+         for( integer j=0; j<n; ++j ){ x(index_t{i,j}) = double(i*i); }
+     }
+
+      A.apply( yam::execution::seq, index_t{1,1}, interior, y, x );
+
+      for( integer i=1; i<n-1; ++i )
+     {
+         for( integer j=1; j<n-1; ++j ){ REQUIRE( y(index_t{i,j}) == Approx( -2.0 ) ); }
+     }
+      REQUIRE( y(index_t{0,0}) == 0.0 );
+  }
+
+   TEST_CASE( "krylov solvers", "[krylov]" )
+  {
+      const array_t b = right_hand_side();
+
+      yam::solver_options options;
+      options.tolerance = 1e-10;
+
+      for_each_policy( {5,7}, {8,3}, [&]( const auto policy )
+     {
+      // conjugate_gradient
+        {
+            const yam::linear_operator A( minus_laplacian );
+
+            array_t x(n,n);
+            const auto result = yam::conjugate_gradient( policy, index_t{1,1}, interior, A, x, b, options );
+
+            REQUIRE( result.converged );
+            REQUIRE( result.iterations < (n-2)*(n-2) );
+            REQUIRE( result.residual <= options.tolerance );
+            REQUIRE( true_residual( A, x, b ) < 1e-8 );
+
+         // a solution needs no iterations
+            const auto again = yam::conjugate_gradient( policy, index_t{1,1}, interior, A, x, b, options );
+            REQUIRE( again.iterations == 0 );
+        }
+
+      // bicgstab
+        {
+            const yam::linear_operator A( convection_diffusion );
+
+            array_t x(n,n);
+            const auto result = yam::bicgstab( policy, index_t{1,1}, interior, A, x, b, options );
+
+            REQUIRE( result.converged );
+            REQUIRE( true_residual( A, x, b ) < 1e-8 );
+        }
+
+      // gmres
+        {
+            const yam::linear_operator A( convection_diffusion );
+
+            yam::solver_options gmres_options = options;
+            gmres_options.restart = 20;
+
+            array_t x(n,n);
+            const auto result = yam::gmres( policy, index_t{1,1}, interior, A, x, b, gmres_options );
+
+            REQUIRE( result.converged );
+            REQUIRE( result.iterations > gmres_options.restart );
+            REQUIRE( true_residual( A, x, b ) < 1e-8 );
+        }
+
+      // gmres with a nonzero boundary
+        {
+         // x = 1 on the boundary and b = 0 inside has solution x = 1 for -laplacian
+            const yam::linear_operator A( minus_laplacian );
+
+            array_t x(n,n);
+            array_t zero(n,n);
+            for( integer i=0; i<n; ++i )
+           {
+               x(index_t{i,0}) = x(index_t{i,n-1}) = x(index_t{0,i}) = x(index_t{n-1,i}) = 1.0;
+           }
+
+            const auto result = yam::gmres( policy, index_t{1,1}, interior, A, x, zero, options );
+
+            REQUIRE( result.converged );
+            for( integer i=1; i<n-1; ++i )
+           {
+               for( integer j=1; j<n-1; ++j ){ REQUIRE( x(index_t{i,j}) == Approx( 1.0 ) ); }
+           }
+        }
+     } );
+  }
@@ -0,0 +1,138 @@
+
+# include <yamdal/multi_array.h>
+# include <yamdal/algorithm.h>
+
+# include <catch.hpp>
+
+# include <policies.h>
+
+# include <tuple>
+# include <cstdint>
+
+namespace
+{
+   using integer = yam::idx_t;
+
+   constexpr integer n0 = 6;
+   constexpr integer n1 = 9;
+}
+
+   TEST_CASE( "multi_array storage of components as planes", "[multi_array]" )
+  {
+      using array_t = yam::multi_array2<double,float,int>;
+      using index_t = array_t::index_type;
+
+      array_t q( n0, n1 );
+
+      static_assert( yam::indexable2<array_t> );
+      static_assert( std::same_as<yam::element_type_of_t<array_t&>,yam::multi_reference<double,float,int>> );
+      static_assert( std::same_as<yam::element_type_of_t<const array_t&>,std::tuple<const double&,const float&,const int&>> );
+
+      REQUIRE( q.extent(0) == n0 );
+      REQUIRE( q.extent(1) == n1 );
+      REQUIRE( q.size() == size_t(n0*n1) );
+
+   // one allocation, with each plane aligned: 54 doubles padded to 448 bytes, then 54 floats and 54 ints padded to 256 bytes
+      const auto* first = q.data();
+      REQUIRE( reinterpret_cast<std::uintptr_t>( first ) % array_t::plane_alignment == 0 );
+      REQUIRE( reinterpret_cast<const std::byte*>( q.component<0>().data() ) == first );
+      REQUIRE( reinterpret_cast<const std::byte*>( q.component<1>().data() ) == first+448 );
+      REQUIRE( reinterpret_cast<const std::byte*>( q.component<2>().data() ) == first+704 );
+      REQUIRE( q.size_bytes() == 960 );
+
+   // zero initialised, and elements refer to the components
+      REQUIRE( std::as_const(q)(index_t{2,3}) == std::tuple{ 0.0, 0.0f, 0 } );
+
+      q(index_t{2,3}) = std::tuple{ 1.5, 2.5f, 3 };
+      REQUIRE( q.component<0>()(index_t{2,3}) == 1.5 );
+      REQUIRE( q.component<1>()(index_t{2,3}) == 2.5f );
+      REQUIRE( q.component<2>()(index_t{2,3}) == 3 );
+
+      auto [a,b,c] = q(index_t{1,1});
+      a = 4.0;
+      c = 7;
+      REQUIRE( std::as_const(q)(index_t{1,1}) == std::tuple{ 4.0, 0.0f, 7 } );
+
+   // assignment between elements assigns the components
+      q(index_t{0,0}) = q(index_t{2,3});
+      REQUIRE( std::tuple<double,float,int>( q(index_t{0,0}) ) == std::tuple{ 1.5, 2.5f, 3 } );
+
+   // copies are deep
+      const array_t r = q;
+      q(index_t{2,3}) = std::tuple{ 0.0, 0.0f, 0 };
+      REQUIRE( r(index_t{2,3}) == std::tuple{ 1.5, 2.5f, 3 } );
+      REQUIRE( r(index_t{1,1}) == std::tuple{ 4.0, 0.0f, 7 } );
+  }
+
+   TEST_CASE( "multi_array components updated in one sweep", "[multi_array]" )
+  {
+      using array_t = yam::multi_array2<double,double,double>;
+      using index_t = array_t::index_type;
+
+      const index_t begin{1,1};
+      const auto range = yam::dextents<2>( n0-2, n1-2 );
+
+      for_each_policy( {2,3,0}, {3,2,0}, [&]( const auto policy )
+     {
+         array_t q( n0, n1 );
+         array_t dq( n0, n1 );
+
+      // components set through their spans
+         auto q0 = q.component<0>();
+         auto q1 = q.component<1>();
+         for( integer i=1; i<n0-1; ++i )
+        {
+            for( integer j=1; j<n1-1; ++j ){ q0(index_t{i,j}) = double(i); q1(index_t{i,j}) = double(j); }
+        }
+
+      // all components read and written by each transform
+         yam::transform( policy, begin, range, dq,
+            []( const auto& u ){ const auto& [u0,u1,u2] = u; return std::tuple{ u0+u1, u0-u1, 2*u2+1 }; },
+            q );
+         yam::transform( policy, begin, range, q,
+            []( const auto& u, const auto& du ){ return std::tuple{ std::get<0>(u)+std::get<0>(du), std::get<1>(u)*std::get<1>(du), std::get<2>(du) }; },
+            q, dq );
+
+         for( integer i=0; i<n0; ++i )
+        {
+            for( integer j=0; j<n1; ++j )
+           {
+               const index_t idx{i,j};
+               const bool inside = i>0 && i<n0-1 && j>0 && j<n1-1;
+               const double x = double(i);
+               const double y = double(j);
+               REQUIRE( std::as_const(q)(idx) == ( inside ? std::tuple{ 2*x+y, y*(x-y), 1.0 } : std::tuple{ 0.0, 0.0, 0.0 } ) );
+           }
+        }
+
+      // assign between multi_arrays
+         array_t p( n0, n1 );
+         yam::assign( policy, begin, range, p, std::as_const(q) );
+         for( integer i=0; i<n0; ++i )
+        {
+            for( integer j=0; j<n1; ++j ){ REQUIRE( p(index_t{i,j}) == std::as_const(q)(index_t{i,j}) ); }
+        }
+     } );
+  }
+
+   TEST_CASE( "multi_array assigned over several segments", "[multi_array]" )
+  {
+      using array_t = yam::multi_array1<double,int>;
+      using index_t = array_t::index_type;
+
+   // more than two segments, and a partial last segment
+      constexpr integer n = 3*yam::detail::multi_array_segment_length+7;
+
+      for_each_policy( {2,3,0}, {3,2,0}, [&]( const auto policy )
+     {
+         array_t q( n );
+         yam::assign( policy, index_t{2}, yam::dextents<1>( n-3 ), q,
+                      []( const index_t idx ){ return std::tuple{ 0.5*double(idx[0]), int(idx[0]) }; } );
+
+         for( integer i=0; i<n; ++i )
+        {
+            const bool inside = i>=2 && i<n-1;
+            REQUIRE( std::as_const(q)(index_t{i}) == ( inside ? std::tuple{ 0.5*double(i), int(i) } : std::tuple{ 0.0, 0 } ) );
+        }
+     } );
+  }
@@ -0,0 +1,172 @@
+
+# include <yamdal/multigrid.h>
+# include <yamdal/array.h>
+
+# include <catch.hpp>
+
+# include <policies.h>
+
+# include <array>
+# include <cmath>
+
+namespace
+{
+   using integer = yam::idx_t;
+
+// position of index i along an axis, in units of the coarse spacing, for a grid of the given level (0 coarse, 1 fine)
+   template<yam::grid_t grid>
+   double position( const integer i,
+                    const int level )
+  {
+      const double x = grid==yam::primal ? double(i) : double(i)+0.5;
+      return level==0 ? x : x/2;
+  }
+
+   template<yam::grid_t grid,
+            typename Index>
+   double linear( const Index idx,
+                  const int level )
+  {
+      double f=0.25;
+      for( yam::ndim_t r=0; r<Index::ndim; ++r ){ f += double(r+1)*position<grid>( idx[r], level ); }
+      return f;
+  }
+
+   template<typename Array,
+            typename  Func>
+   void set_all( Array& a,
+                 Func&& func )
+  {
+      yam::for_each_index( yam::execution::seq, typename Array::index_type{}, yam::make_dextents( a.extents() ),
+         [&]( const typename Array::index_type idx ){ a(idx) = func( idx ); } );
+  }
+}
+
+   TEST_CASE( "multigrid transfers reproduce linear fields", "[multigrid]" )
+  {
+      for_each_policy( {2,3,2}, {3,2,5}, []( const auto policy )
+     {
+      // primal 2D: fine nodes 0..2*(n-1)
+        {
+            using array_t = yam::primal_array2<double>;
+            using index_t = array_t::index_type;
+
+            array_t coarse(5,7);
+            array_t fine(9,13);
+
+            set_all( coarse, []( const index_t I ){ return linear<yam::primal>( I, 0 ); } );
+            set_all( fine,   []( const index_t ){ return -1.0; } );
+
+            yam::prolong_linear( policy, index_t{0,0}, yam::dextents<2>(9,13), fine, coarse );
+
+            for( integer i=0; i<9; ++i )
+           {
+               for( integer j=0; j<13; ++j )
+              {
+                  REQUIRE( fine(index_t{i,j}) == Approx( linear<yam::primal>( index_t{i,j}, 1 ) ) );
+                  REQUIRE( yam::prolong_linear( coarse )(index_t{i,j}) == Approx( fine(index_t{i,j}) ) );
+              }
+           }
+
+            set_all( coarse, []( const index_t ){ return -1.0; } );
+            yam::restrict_full_weighting( policy, index_t{1,1}, yam::dextents<2>(3,5), coarse, fine );
+
+            for( integer i=0; i<5; ++i )
+           {
+               for( integer j=0; j<7; ++j )
+              {
+                  const bool interior = i>=1 && i<4 && j>=1 && j<6;
+                  REQUIRE( coarse(index_t{i,j}) == Approx( interior ? linear<yam::primal>( index_t{i,j}, 0 ) : -1.0 ) );
+              }
+           }
+        }
+
+      // dual 3D: fine cells 0..2*n-1, prolongation needs one coarse cell on each side
+        {
+            using array_t = yam::dual_array3<double>;
+            using index_t = array_t::index_type;
+
+            array_t coarse(4,3,5);
+            array_t fine(8,6,10);
+
+            set_all( coarse, []( const index_t I ){ return linear<yam::dual>( I, 0 ); } );
+            set_all( fine,   []( const index_t ){ return -1.0; } );
+
+            yam::prolong_linear( policy, index_t{1,2,1}, yam::dextents<3>(6,2,8), fine, coarse );
+
+            for( integer i=0; i<8; ++i )
+           {
+               for( integer j=0; j<6; ++j )
+              {
+                  for( integer k=0; k<10; ++k )
+                 {
+                     const bool inside = i>=1 && i<7 && j>=2 && j<4 && k>=1 && k<9;
+                     REQUIRE( fine(index_t{i,j,k}) == Approx( inside ? linear<yam::dual>( index_t{i,j,k}, 1 ) : -1.0 ) );
+                 }
+              }
+           }
+
+         // a range starting away from the origin along the last axis, so the buffered coarse row does not start at 0
+            set_all( fine, []( const index_t ){ return -1.0; } );
+            yam::prolong_linear( policy, index_t{2,2,4}, yam::dextents<3>(3,2,5), fine, coarse );
+
+            for( integer i=0; i<8; ++i )
+           {
+               for( integer j=0; j<6; ++j )
+              {
+                  for( integer k=0; k<10; ++k )
+                 {
+                     const bool inside = i>=2 && i<5 && j>=2 && j<4 && k>=4 && k<9;
+                     REQUIRE( fine(index_t{i,j,k}) == Approx( inside ? linear<yam::dual>( index_t{i,j,k}, 1 ) : -1.0 ) );
+                 }
+              }
+           }
+
+            set_all( fine,   []( const index_t i ){ return linear<yam::dual>( i, 1 ); } );
+            set_all( coarse, []( const index_t ){ return -1.0; } );
+            yam::restrict_full_weighting( policy, index_t{0,0,0}, yam::dextents<3>(4,3,5), coarse, fine );
+
+            for( integer i=0; i<4; ++i )
+           {
+               for( integer j=0; j<3; ++j )
+              {
+                  for( integer k=0; k<5; ++k )
+                 {
+                     REQUIRE( coarse(index_t{i,j,k}) == Approx( linear<yam::dual>( index_t{i,j,k}, 0 ) ) );
+                 }
+              }
+           }
+        }
+     } );
+  }
+
+   TEST_CASE( "multigrid transfer weights", "[multigrid]" )
+  {
+   // restriction of a fine delta gives the full weighting stencil, and prolongation spreads a coarse delta with the same weights
+      using array_t = yam::primal_array2<double>;
+      using index_t = array_t::index_type;
+
+      array_t fine(9,9);
+      set_all( fine, []( const index_t i ){ return i[0]==4 && i[1]==3 ? 1.0 : 0.0; } );
+
+      const auto restricted = yam::restrict_full_weighting( fine );
+      REQUIRE( restricted(index_t{2,2}) == Approx( 0.125 ) );   // 1/2 * 1/4
+      REQUIRE( restricted(index_t{2,1}) == Approx( 0.125 ) );
+      REQUIRE( restricted(index_t{3,2}) == Approx( 0.0 ) );
+      REQUIRE( restricted(index_t{1,1}) == Approx( 0.0 ) );
+
+      array_t coarse(5,5);
+      set_all( coarse, []( const index_t I ){ return I[0]==2 && I[1]==2 ? 1.0 : 0.0; } );
+
+      yam::prolong_linear( index_t{0,0}, yam::dextents<2>(9,9), fine, coarse );
+      REQUIRE( fine(index_t{4,4}) == 1.0 );
+      REQUIRE( fine(index_t{4,3}) == 0.5 );
+      REQUIRE( fine(index_t{3,5}) == 0.25 );
+      REQUIRE( fine(index_t{2,4}) == 0.0 );
+
+   // dual: restriction is the average of the children
+      using dual_t = yam::dual_array1<double>;
+      dual_t dfine(8);
+      set_all( dfine, []( const yam::dual_index1 i ){ return double(i[0]*i[0]); } );
+      REQUIRE( yam::restrict_full_weighting( dfine )(yam::dual_index1{2}) == Approx( (16.0+25.0)/2 ) );
+  }
@@ -0,0 +1,179 @@
+
+# include <yamdal/patch_collection.h>
+# include <yamdal/utility.h>
+
+# include <catch.hpp>
+
+# include <policies.h>
+
+# include <vector>
+# include <numeric>
+# include <algorithm>
+# include <functional>
+
+namespace
+{
+   using integer = yam::idx_t;
+}
+
+   TEST_CASE( "balanced_partition shares out weights evenly", "[patch_collection]" )
+  {
+      const std::vector<size_t> weights{ 7, 3, 3, 2, 2, 2, 1, 9, 5 };
+
+      const auto parts = yam::utl::balanced_partition( weights, 3 );
+
+      REQUIRE( parts.size() == 3 );
+
+      std::vector<size_t> all;
+      std::vector<size_t> load;
+      for( const auto& part : parts )
+     {
+         REQUIRE( std::is_sorted( part.begin(), part.end() ) );
+         all.insert( all.end(), part.begin(), part.end() );
+
+         size_t sum=0;
+         for( const size_t n : part ){ sum += weights[n]; }
+         load.push_back( sum );
+     }
+
+   // every item in exactly one part, total 34 split as evenly as possible
+      std::sort( all.begin(), all.end() );
+      std::vector<size_t> expected( weights.size() );
+      std::iota( expected.begin(), expected.end(), size_t(0) );
+      REQUIRE( all == expected );
+      REQUIRE( *std::max_element( load.begin(), load.end() ) <= 12 );
+
+   // more parts than items leaves some empty
+      REQUIRE( yam::utl::balanced_partition( {4,1}, 4 )[2].empty() );
+  }
+
+   TEST_CASE( "batched algorithms over patches", "[patch_collection]" )
+  {
+      for_each_policy( {2,2,2}, {2,2,2}, []( const auto policy )
+     {
+         yam::patch_collection<integer,2> patches;
+
+      // many patches of different sizes, on two levels
+         for( integer n=0; n<40; ++n )
+        {
+            const int level = int(n%2);
+            (void)patches.add_patch( level, {10*n,-n}, {1+n%7,2+n%5} );
+        }
+
+         REQUIRE( patches.size() == 40 );
+         REQUIRE( patches.num_levels() == 2 );
+         REQUIRE( patches.level_patches(1).size() == 20 );
+
+         yam::generate_patches( policy, patches,
+            []( const int level, const yam::index2<> idx ){ return 1000*level + 10*idx[0] + idx[1]; } );
+
+         yam::transform_patches( policy, patches, []( const integer x ){ return 2*x; } );
+
+         integer expected_sum=0;
+         for( const auto& p : patches )
+        {
+            for( integer i=p.origin[0]; i<p.end()[0]; ++i )
+           {
+               for( integer j=p.origin[1]; j<p.end()[1]; ++j )
+              {
+                  REQUIRE( p(yam::index2<>{i,j}) == 2*(1000*p.level + 10*i + j) );
+                  expected_sum += p(yam::index2<>{i,j});
+              }
+           }
+        }
+
+         REQUIRE( yam::reduce_patches( policy, patches, std::plus<>{}, integer(0), integer(5) ) == expected_sum+5 );
+         REQUIRE( yam::reduce_patches( patches, std::plus<>{}, integer(5) ) == expected_sum+5 );
+
+      // bool partials: the element at the origin of level 0 is 0, all others are not
+         REQUIRE_FALSE( yam::reduce_patches( policy, patches, std::logical_and<>{}, true, true ) );
+         REQUIRE( yam::reduce_patches( policy, patches, std::logical_or<>{}, false, false ) );
+
+      // each patch visited once, only patches on the requested level
+         std::vector<int> visits( patches.size(), 0 );
+         yam::for_each_patch( policy, patches, 1,
+            [&]( auto& p ){ ++visits[size_t(&p-&patches[0])]; REQUIRE( p.level==1 ); } );
+
+         for( size_t n=0; n<visits.size(); ++n ){ REQUIRE( visits[n] == int(n%2) ); }
+     } );
+  }
+
+   TEST_CASE( "restriction and prolongation between patch levels", "[patch_collection]" )
+  {
+      for_each_policy( {2,2,2}, {2,2,2}, []( const auto policy )
+     {
+      // dual grid: average and piecewise constant
+        {
+            yam::patch_collection<double,2,yam::dual> patches(2);
+
+            const size_t coarse = patches.add_patch( 0, {0,0}, {8,8} );
+            const size_t fine0  = patches.add_patch( 1, {2,4}, {4,6} );
+            const size_t fine1  = patches.add_patch( 1, {9,9}, {3,3} );   // only covers coarse cell {5,5}
+
+            yam::generate_patches( policy, patches,
+               []( const int level, const yam::dual_index2 idx ){ return level==1 ? double(idx[0]+10*idx[1]) : -1.0; } );
+
+            yam::restrict_to_coarse( policy, patches, 1 );
+
+            const auto& c = patches[coarse];
+            REQUIRE( c(yam::dual_index2{1,2}) == 2.5+10*4.5 );
+            REQUIRE( c(yam::dual_index2{2,4}) == 4.5+10*8.5 );
+            REQUIRE( c(yam::dual_index2{0,0}) == -1.0 );
+            REQUIRE( c(yam::dual_index2{3,2}) == -1.0 );
+            REQUIRE( c(yam::dual_index2{5,5}) == 10.5+10*10.5 );   // cells 10,11 in each dimension
+            REQUIRE( c(yam::dual_index2{4,4}) == -1.0 );           // only partly covered
+
+            yam::prolong_to_fine( policy, patches, 1 );
+
+            for( integer i=2; i<6; ++i )
+           {
+               for( integer j=4; j<10; ++j )
+              {
+                  REQUIRE( patches[fine0](yam::dual_index2{i,j}) == c(yam::dual_index2{i/2,j/2}) );
+              }
+           }
+            REQUIRE( patches[fine1](yam::dual_index2{9,11}) == c(yam::dual_index2{4,5}) );
+        }
+
+      // primal grid: injection and bilinear interpolation, which is exact for a linear function
+        {
+            yam::patch_collection<double,2> patches(3);
+
+            const size_t coarse = patches.add_patch( 0, {-2,0}, {4,3} );   // nodes -2..1, 0..2
+            const size_t fine   = patches.add_patch( 1, {-7,1}, {11,8} );  // nodes -7..3, 1..8
+
+            const auto linear = []( const double x, const double y ){ return 1.0 + 2.0*x - 0.5*y; };
+
+            yam::generate_patches( policy, patches,
+               [&]( const int level, const yam::index2<> idx )
+              {
+                  return level==0 ? linear( double(idx[0]), double(idx[1]) ) : 0.0;
+              } );
+
+            yam::prolong_to_fine( policy, patches, 1 );
+
+            const auto& f = patches[fine];
+            for( integer i=-6; i<=3; ++i )
+           {
+               for( integer j=1; j<=6; ++j )
+              {
+                  REQUIRE( f(yam::index2<>{i,j}) == Approx( linear( double(i)/3.0, double(j)/3.0 ) ).margin( 1e-12 ) );
+              }
+           }
+         // outside the coarse patch
+            REQUIRE( f(yam::index2<>{-7,1}) == 0.0 );
+            REQUIRE( f(yam::index2<>{0,7}) == 0.0 );
+
+         // only the fine patch changes
+            yam::for_each_patch( policy, patches, 1,
+               []( auto& p ){ std::for_each( p.data.data(), p.data.data()+p.size(), []( double& x ){ x += 1.0; } ); } );
+            yam::restrict_to_coarse( policy, patches, 1 );
+
+            const auto& c = patches[coarse];
+            REQUIRE( c(yam::index2<>{-2,1}) == Approx( linear( -2, 1 )+1.0 ) );
+            REQUIRE( c(yam::index2<>{-1,1}) == Approx( linear( -1, 1 )+1.0 ) );
+            REQUIRE( c(yam::index2<>{1,2}) == Approx( linear( 1, 2 )+1.0 ) );
+            REQUIRE( c(yam::index2<>{0,0}) == Approx( linear( 0, 0 ) ) );      // not coincident with a fine node
+        }
+     } );
+  }
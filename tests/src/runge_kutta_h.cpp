@@ -0,0 +1,125 @@
+
+# include <yamdal/runge_kutta.h>
+# include <yamdal/array.h>
+
+# include <catch.hpp>
+
+# include <policies.h>
+
+# include <array>
+# include <cmath>
+
+namespace
+{
+   using integer = yam::idx_t;
+
+   using array_t = yam::primal_array1<double>;
+   using index_t = array_t::index_type;
+
+   constexpr integer n = 20;
+
+   const auto range = yam::dextents<1>( n );
+}
+
+   TEST_CASE( "rk_integrator stability polynomials", "[runge_kutta]" )
+  {
+   // du/dt = lambda*u, so one step multiplies u by the stability polynomial of the method at z = lambda*dt
+      const double lambda = -0.7;
+      const double dt     =  0.3;
+      const double z      = lambda*dt;
+
+      const auto decay =
+         [lambda]( const double, auto& U, auto& k )
+        {
+            for( integer i=0; i<n; ++i ){ k[0](index_t{i}) = lambda*U[0](index_t{i}); }
+        };
+
+      for_each_policy( {3,0,0}, {5,0,0}, [&]( const auto policy )
+     {
+         yam::array_pool<array_t> pool;
+
+         const auto check =
+            [&]<auto tableau>( const double factor )
+           {
+               yam::rk_integrator<tableau,array_t> rk( pool, array_t::extents_type( n ) );
+
+               std::array<array_t,1> u{ array_t( n ) };
+               for( integer i=0; i<n; ++i ){ u[0](index_t{i}) = 1.0+double(i); }
+
+               rk.step( policy, index_t{0}, range, u, 0.0, dt, decay );
+
+               for( integer i=0; i<n; ++i ){ REQUIRE( u[0](index_t{i}) == Approx( factor*(1.0+double(i)) ) ); }
+           };
+
+         check.template operator()<yam::tableau::forward_euler>( 1+z );
+         check.template operator()<yam::tableau::heun>( 1+z+z*z/2 );
+         check.template operator()<yam::tableau::ssprk3>( 1+z+z*z/2+z*z*z/6 );
+         check.template operator()<yam::tableau::rk4>( 1+z+z*z/2+z*z*z/6+z*z*z*z/24 );
+     } );
+  }
+
+   TEST_CASE( "rk_integrator with several fields and a time dependent rhs", "[runge_kutta]" )
+  {
+   // du/dt = v, dv/dt = -u + cos(t), from u=v=0: u = t*sin(t)/2
+      const auto forced_oscillator =
+         []( const double t, auto& U, auto& k )
+        {
+            for( integer i=0; i<n; ++i )
+           {
+               const index_t idx{i};
+               k[0](idx) =  U[1](idx);
+               k[1](idx) = -U[0](idx) + std::cos( t );
+           }
+        };
+
+      for_each_policy( {3,0,0}, {5,0,0}, [&]( const auto policy )
+     {
+         yam::array_pool<array_t> pool;
+         yam::rk_integrator<yam::tableau::rk4,array_t,2> rk( pool, array_t::extents_type( n ) );
+
+         std::array<array_t,2> u{ array_t( n ), array_t( n ) };
+
+         const int    steps = 200;
+         const double dt    = 0.01;
+         for( int s=0; s<steps; ++s ){ rk.step( policy, index_t{0}, range, u, s*dt, dt, forced_oscillator ); }
+
+         const double t = steps*dt;
+         for( integer i=0; i<n; ++i )
+        {
+            REQUIRE( u[0](index_t{i}) == Approx( t*std::sin( t )/2 ).margin( 1e-9 ) );
+            REQUIRE( u[1](index_t{i}) == Approx( (std::sin( t )+t*std::cos( t ))/2 ).margin( 1e-9 ) );
+        }
+     } );
+  }
+
+   TEST_CASE( "rk_integrator draws its stage arrays from a pool", "[runge_kutta]" )
+  {
+      yam::array_pool<array_t> pool;
+
+      const double* first_data = nullptr;
+     {
+         yam::rk_integrator<yam::tableau::rk4,array_t,5> rk( pool, array_t::extents_type( n ) );
+         REQUIRE( pool.size() == 0 );
+         first_data = rk.stage_tendency(0)[0].data();
+     }
+
+   // 4 stage tendencies and one stage state for each field
+      REQUIRE( pool.size() == 25 );
+
+   // arrays of other extents are allocated, and those of the same extents are reused
+      const array_t other = pool.acquire( array_t::extents_type( n+1 ) );
+      REQUIRE( pool.size() == 25 );
+
+      bool reused = false;
+     {
+         yam::rk_integrator<yam::tableau::ssprk3,array_t,5> rk( pool, array_t::extents_type( n ) );
+         REQUIRE( pool.size() == 5 );
+         for( size_t j=0; j<3; ++j )
+        {
+            for( const auto& a : rk.stage_tendency(j) ){ reused = reused || a.data()==first_data; }
+        }
+     }
+      REQUIRE( reused );
+      REQUIRE( pool.size() == 25 );
+      REQUIRE( other.extent(0) == n+1 );
+  }
@@ -0,0 +1,376 @@
+
+# include <yamdal/slice.h>
+# include <yamdal/span.h>
+# include <yamdal/array.h>
+# include <yamdal/algorithm.h>
+
+# include <catch.hpp>
+
+# include <vector>
+# include <concepts>
+# include <memory>
+# include <utility>
+
+namespace
+{
+   using integer = yam::idx_t;
+
+// row-major 2D field with value 100*i+j at (i,j)
+   struct field2D
+  {
+      static constexpr integer n0=6;
+      static constexpr integer n1=8;
+
+      std::vector<integer> data = std::vector<integer>( size_t(n0*n1) );
+      yam::span2<integer> span{ data.data(), n0, n1 };
+
+      field2D()
+     {
+         for( integer i=0; i<n0; ++i )
+        {
+            for( integer j=0; j<n1; ++j )
+           {
+               span(yam::index2<>{i,j}) = 100*i+j;
+           }
+        }
+     }
+  };
+}
+
+   TEST_CASE( "subview of a span is a span with its own origin", "[slice][span]" )
+  {
+      field2D f;
+
+      const yam::index2<> begin{2,3};
+      const stx::extents<3,4> exts;
+
+      auto sub = yam::subview( f.span, begin, exts );
+
+   // still a span over the same memory, with the static extents of the box
+      static_assert( requires { sub.data(); sub.stride(0); } );
+      static_assert( std::same_as<decltype(sub.extents()),stx::extents<3,4>> );
+      REQUIRE( sub.extent(0) == 3 );
+      REQUIRE( sub.extent(1) == 4 );
+
+      for( integer i=0; i<3; ++i )
+     {
+         for( integer j=0; j<4; ++j )
+        {
+            const yam::index2<> idx{i,j};
+            REQUIRE( sub(idx) == 100*(i+2)+(j+3) );
+            REQUIRE( &sub(idx) == &f.span(yam::index2<>{i+2,j+3}) );
+        }
+     }
+
+   // writes go to the source
+      yam::fill( yam::index2<>{}, exts, sub, integer(-1) );
+
+      for( integer i=0; i<field2D::n0; ++i )
+     {
+         for( integer j=0; j<field2D::n1; ++j )
+        {
+            const bool inside = i>=2 && i<5 && j>=3 && j<7;
+            REQUIRE( (f.span(yam::index2<>{i,j}) == -1) == inside );
+        }
+     }
+  }
+
+   TEST_CASE( "strided slice of a span selects every n-th point", "[slice][span]" )
+  {
+      field2D f;
+
+   // every second row and every third column, starting from (1,1)
+      const yam::index2<> begin{1,1};
+      const stx::extents<3,3> exts;
+
+      const auto coarse = yam::slice( f.span, begin, exts, {2,3} );
+
+   // extents type is kept, strides are the source strides times the slice strides
+      static_assert( std::same_as<decltype(coarse.extents()),stx::extents<3,3>> );
+      REQUIRE( coarse.stride(0) == 2*f.span.stride(0) );
+      REQUIRE( coarse.stride(1) == 3*f.span.stride(1) );
+
+      for( integer i=0; i<3; ++i )
+     {
+         for( integer j=0; j<3; ++j )
+        {
+            REQUIRE( coarse(yam::index2<>{i,j}) == 100*(1+2*i)+(1+3*j) );
+        }
+     }
+
+   // slices compose
+      const auto coarser = yam::slice( coarse, yam::index2<>{1,0}, stx::extents<1,2>{}, {1,2} );
+
+      REQUIRE( coarser(yam::index2<>{0,0}) == 100*3+1 );
+      REQUIRE( coarser(yam::index2<>{0,1}) == 100*3+7 );
+
+      REQUIRE( yam::reduce( yam::index2<>{}, exts, std::plus{}, integer(0), coarse )
+               == (100+300+500)*3 + (1+4+7)*3 );
+  }
+
+   TEST_CASE( "slices of const arrays are cspans", "[slice][array]" )
+  {
+      yam::basic_array<double,stx::extents<stx::dynamic_extent,stx::dynamic_extent>> arr( 4, 5 );
+
+      for( integer i=0; i<4; ++i )
+     {
+         for( integer j=0; j<5; ++j )
+        {
+            arr(yam::index2<>{i,j}) = double(10*i+j);
+        }
+     }
+
+      auto msub = yam::subview( arr, yam::index2<>{1,1}, stx::extents<2,2>{} );
+      const auto csub = yam::subview( std::as_const(arr), yam::index2<>{1,1}, stx::extents<2,2>{} );
+
+      static_assert(  std::is_assignable_v<decltype(msub(yam::index2<>{})),double> );
+      static_assert( !std::is_assignable_v<decltype(csub(yam::index2<>{})),double> );
+
+      msub(yam::index2<>{1,1}) = -1.0;
+
+      REQUIRE( arr(yam::index2<>{2,2}) == -1.0 );
+      REQUIRE( csub(yam::index2<>{1,1}) == -1.0 );
+      REQUIRE( csub(yam::index2<>{0,1}) == 12.0 );
+  }
+
+namespace
+{
+   template<typename A>
+   concept subviewable =
+      requires( A&& a ){ yam::subview( std::forward<A>(a), yam::index2<>{}, stx::extents<2,2>{} ); };
+
+   template<typename A>
+   concept reshapeable =
+      requires( A&& a ){ yam::flatten( std::forward<A>(a) ); yam::permute_axes<1,0>( std::forward<A>(a) ); };
+}
+
+   TEST_CASE( "spans cannot be taken of rvalue arrays", "[slice][array]" )
+  {
+      using array_type = yam::basic_array<double,stx::extents<stx::dynamic_extent,stx::dynamic_extent>>;
+      using span_type  = yam::span2<double>;
+
+   // the span would outlive the storage of a temporary array
+      static_assert(  subviewable<array_type&> );
+      static_assert(  subviewable<const array_type&> );
+      static_assert( !subviewable<array_type> );
+      static_assert( !subviewable<const array_type> );
+
+      static_assert(  reshapeable<array_type&> );
+      static_assert( !reshapeable<array_type> );
+
+   // spans do not own their storage
+      static_assert( subviewable<span_type> );
+      static_assert( reshapeable<span_type> );
+
+   // linear_view holds an rvalue array by value
+      array_type arr( 2, 3 );
+      for( integer n=0; n<6; ++n ){ arr(yam::index2<>{n/3,n%3}) = double(n); }
+
+      const auto linear = yam::linear_view( std::move(arr) );
+
+      for( integer n=0; n<6; ++n ){ REQUIRE( linear(yam::index1<>{n}) == double(n) ); }
+  }
+
+   TEST_CASE( "slice of a generic indexable remaps the index", "[slice][views]" )
+  {
+      const auto generator =
+         []( const yam::index2<yam::dual> idx ){ return 100*idx[0]+idx[1]; };
+
+      const auto coarse = yam::slice( generator, yam::index2<yam::dual>{1,2}, stx::extents<2,2>{}, {2,2} );
+
+      static_assert( std::invocable<decltype(coarse),yam::index2<yam::dual>> );
+      static_assert( !yam::detail::mdspan_backed<decltype(coarse)> );
+
+      REQUIRE( coarse(yam::index2<yam::dual>{0,0}) == 102 );
+      REQUIRE( coarse(yam::index2<yam::dual>{1,1}) == 304 );
+
+   // rvalue sources are held by copy
+      const auto sub =
+         yam::subview( yam::slice( generator, yam::index2<yam::dual>{0,0}, stx::extents<3,3>{}, {1,1} ),
+                       yam::index2<yam::dual>{1,1}, stx::extents<2,2>{} );
+
+      REQUIRE( sub(yam::index2<yam::dual>{0,0}) == 101 );
+      REQUIRE( sub(yam::index2<yam::dual>{1,0}) == 201 );
+  }
+
+   TEST_CASE( "permute_axes of a span permutes extents and strides", "[slice][permute]" )
+  {
+      yam::basic_array<double,stx::extents<2,stx::dynamic_extent,4>> arr( 3 );
+
+      for( integer i=0; i<2; ++i )
+     {
+         for( integer j=0; j<3; ++j )
+        {
+            for( integer k=0; k<4; ++k )
+           {
+               arr(yam::index3<>{i,j,k}) = double(100*i+10*j+k);
+           }
+        }
+     }
+
+      auto t = yam::permute_axes<2,0,1>( arr );
+
+   // static extents follow their axis
+      static_assert( decltype(t)::extents_type::static_extent(0) == 4 );
+      static_assert( decltype(t)::extents_type::static_extent(1) == 2 );
+      static_assert( decltype(t)::extents_type::static_extent(2) == stx::dynamic_extent );
+
+      REQUIRE( t.extent(2) == 3 );
+      REQUIRE( t.stride(0) == arr.stride(2) );
+      REQUIRE( t.stride(1) == arr.stride(0) );
+      REQUIRE( t.stride(2) == arr.stride(1) );
+
+      for( integer k=0; k<4; ++k )
+     {
+         for( integer i=0; i<2; ++i )
+        {
+            for( integer j=0; j<3; ++j )
+           {
+               REQUIRE( &t(yam::index3<>{k,i,j}) == &arr(yam::index3<>{i,j,k}) );
+           }
+        }
+     }
+
+   // the inverse permutation gives back the source layout
+      const auto back = yam::permute_axes<1,2,0>( t );
+
+      REQUIRE( back.stride(2) == 1 );
+      REQUIRE( &back(yam::index3<>{1,2,3}) == &arr(yam::index3<>{1,2,3}) );
+
+   // const arrays give cspans
+      const auto ct = yam::permute_axes<2,0,1>( std::as_const(arr) );
+
+      static_assert( !std::is_assignable_v<decltype(ct(yam::index3<>{})),double> );
+      REQUIRE( ct(yam::index3<>{3,1,2}) == 123.0 );
+
+   // generic indexables get an index-permuting view
+      const auto generator =
+         []( const yam::index2<> idx ){ return 100*idx[0]+idx[1]; };
+
+      const auto gt = yam::permute_axes<1,0>( generator );
+
+      static_assert( !yam::detail::mdspan_backed<decltype(gt)> );
+      REQUIRE( gt(yam::index2<>{3,5}) == 503 );
+  }
+
+   TEST_CASE( "assigning a permuted span transposes in tiles", "[slice][permute][algorithm]" )
+  {
+   // extents that are not multiples of the tile
+      constexpr integer n0=37;
+      constexpr integer n1=5;
+      constexpr integer n2=70;
+
+      const auto value =
+         []( const yam::index3<> idx ){ return 10000*idx[0]+100*idx[1]+idx[2]; };
+
+      yam::basic_array<integer,yam::dextents<3>> kinner( n0, n1, n2 );
+      yam::assign( yam::index3<>{}, kinner.extents(), kinner, value );
+
+      const auto test =
+         [&]( const auto policy )
+        {
+         // i-innermost copy, accessed through an (i,j,k)-indexed permuted view
+            yam::basic_array<integer,yam::dextents<3>> iinner( n2, n1, n0 );
+            yam::fill( yam::index3<>{}, iinner.extents(), iinner, integer(-1) );
+
+            auto dst = yam::permute_axes<2,1,0>( iinner );
+
+            REQUIRE( yam::detail::is_transposing<3>( dst, kinner ) );
+
+         // a sub-range, the rest must stay untouched
+            const yam::index3<> begin{1,0,3};
+            const stx::extents<35,5,66> exts;
+
+            yam::assign( policy, begin, exts, dst, std::as_const(kinner) );
+
+            for( integer i=0; i<n0; ++i )
+           {
+               for( integer j=0; j<n1; ++j )
+              {
+                  for( integer k=0; k<n2; ++k )
+                 {
+                     const yam::index3<> idx{i,j,k};
+                     const bool inside = i>=1 && i<36 && k>=3 && k<69;
+                     REQUIRE( dst(idx) == (inside ? value(idx) : -1) );
+                 }
+              }
+           }
+        };
+
+      test( yam::execution::seq );
+      test( yam::execution::tiled( yam::execution::seq, {8,8,8} ) );
+# ifdef _OPENMP
+      test( yam::execution::openmp );
+# endif
+  }
+
+   TEST_CASE( "reshape and flatten of contiguous spans", "[slice][reshape]" )
+  {
+      yam::basic_array<double,stx::extents<2,3,4>> arr;
+
+      for( integer i=0; i<2; ++i )
+     {
+         for( integer j=0; j<3; ++j )
+        {
+            for( integer k=0; k<4; ++k )
+           {
+               arr(yam::index3<>{i,j,k}) = double(100*i+10*j+k);
+           }
+        }
+     }
+
+   // whole array as one static 1D span, in memory order
+      auto flat = yam::flatten( arr );
+
+      static_assert( decltype(flat)::extents_type::static_extent(0) == 24 );
+      REQUIRE( flat.data() == arr.data() );
+      REQUIRE( flat(yam::index1<>{13}) == 101.0 );
+
+      flat(yam::index1<>{23}) = -1.0;
+      REQUIRE( arr(yam::index3<>{1,2,3}) == -1.0 );
+      flat(yam::index1<>{23}) = 123.0;
+
+   // 1D algorithms over the whole array match the 3D ones
+      const auto whole = yam::reshape( arr, arr.extents() );
+      const double sum3 = yam::reduce( yam::index3<>{}, arr.extents(), std::plus{}, 0.0, whole );
+      const double sum1 = yam::reduce( yam::index1<>{}, flat.extents(), std::plus{}, 0.0, flat );
+      REQUIRE( sum1 == sum3 );
+# ifdef _OPENMP
+      REQUIRE( yam::reduce( yam::execution::openmp, yam::index1<>{}, flat.extents(), std::plus{}, 0.0, flat ) == sum3 );
+# endif
+
+   // reshape keeps the layout
+      const auto r = yam::reshape( std::as_const(arr), stx::extents<stx::dynamic_extent,6>( 4 ) );
+
+      static_assert( std::same_as<decltype(r)::layout_type,stx::layout_right> );
+      static_assert( !std::is_assignable_v<decltype(r(yam::index2<>{})),double> );
+      REQUIRE( r(yam::index2<>{2,3}) == 103.0 );
+
+   // dynamic extents flatten to a dynamic extent
+      yam::basic_array<float,yam::dextents<2>,stx::layout_left> col( 3, 5 );
+      const auto cflat = yam::flatten( col );
+
+      REQUIRE( cflat.extent(0) == 15 );
+      REQUIRE( &cflat(yam::index1<>{4}) == &col(yam::index2<>{1,1}) );
+  }
+
+   TEST_CASE( "linear_view indexes any span in row-major order", "[slice][reshape]" )
+  {
+      field2D f;
+
+   // a strided slice is not contiguous, but can still be traversed linearly
+      const auto coarse = yam::slice( f.span, yam::index2<>{1,1}, stx::extents<3,3>{}, {2,3} );
+      const auto lin = yam::linear_view( coarse );
+
+      REQUIRE( lin(yam::index1<>{0}) == 101 );
+      REQUIRE( lin(yam::index1<>{2}) == 107 );
+      REQUIRE( lin(yam::index1<>{4}) == 304 );
+      REQUIRE( &lin(yam::index1<>{8}) == &f.span(yam::index2<>{5,7}) );
+
+      REQUIRE( yam::reduce( yam::index1<>{}, stx::extents<9>{}, std::plus{}, integer(0), lin )
+               == yam::reduce( yam::index2<>{}, stx::extents<3,3>{}, std::plus{}, integer(0), coarse ) );
+
+   // rvalue sources are held by copy
+      const auto tlin = yam::linear_view( yam::permute_axes<1,0>( f.span ) );
+      REQUIRE( tlin(yam::index1<>{7}) == 101 );
+  }
@@ -0,0 +1,324 @@
+
+# include <yamdal/tune.h>
+# include <yamdal/algorithm.h>
+# include <yamdal/span.h>
+
+# include <catch.hpp>
+
+# include <memory>
+# include <functional>
+# include <vector>
+# include <string>
+# include <cstdio>
+# include <cstdlib>
+# include <algorithm>
+# include <array>
+
+   TEST_CASE( "tiled assign visits every index once", "[tune]" )
+  {
+      using integer = yam::idx_t;
+
+      constexpr size_t n0=5;
+      constexpr size_t n1=7;
+      constexpr size_t n2=3;
+      constexpr size_t n=n0*n1*n2;
+
+      auto data = std::make_unique<integer[]>(n);
+      yam::span<integer,n0,n1,n2> dst(data.get());
+
+      const stx::extents<n0,n1,n2> exts;
+
+   // value is linear index
+      const auto linear =
+         []( const yam::index3<> idx ){ return (idx[0]*integer(n1) + idx[1])*integer(n2) + idx[2]; };
+
+   // count visits of each index
+      std::vector<integer> visits(n,0);
+      const auto count =
+         [&]( const yam::index3<> idx ){ return ++visits[size_t(linear(idx))]; };
+
+      using tiles_t = std::array<yam::idx_t,3>;
+      using order_t = std::array<yam::ndim_t,3>;
+
+      for( const auto& tile : { tiles_t{0,0,0}, tiles_t{2,3,2}, tiles_t{1,0,1}, tiles_t{4,4,4} } )
+     {
+         for( const auto& order : { order_t{0,1,2}, order_t{2,1,0}, order_t{1,2,0} } )
+        {
+            const auto policy = yam::execution::tiled( yam::execution::seq, tile, order );
+
+            yam::fill( yam::execution::seq, {}, exts, dst, integer(0) );
+            std::fill( visits.begin(), visits.end(), 0 );
+
+            yam::assign( policy, {}, exts, dst, linear );
+            yam::assign( policy, {}, exts, dst, count );
+
+            for( size_t i=0; i<n; ++i ){ REQUIRE( visits[i] == 1 ); }
+
+            const auto sum =
+               yam::reduce( policy, {}, exts, std::plus<integer>{}, integer(0), integer(0), dst );
+
+            REQUIRE( sum == integer(n) );
+        }
+     }
+
+   // subrange
+      yam::fill( yam::execution::seq, {}, exts, dst, integer(0) );
+      yam::assign( yam::execution::tiled( yam::execution::seq, {2,2,2} ), {1,2,0}, stx::extents<3,4,2>{}, dst, linear );
+
+      REQUIRE( dst(yam::index3<>{0,0,0}) == 0 );
+      REQUIRE( dst(yam::index3<>{1,2,0}) == linear({1,2,0}) );
+      REQUIRE( dst(yam::index3<>{3,5,1}) == linear({3,5,1}) );
+      REQUIRE( dst(yam::index3<>{3,5,2}) == 0 );
+      REQUIRE( dst(yam::index3<>{4,5,1}) == 0 );
+
+# ifdef _OPENMP
+   // parallel tiled reduce folds tile results in order
+      const auto policy = yam::execution::tiled( yam::execution::openmp, {2,3,0}, {1,0,2}, 3 );
+
+      yam::assign( policy, {}, exts, dst, linear );
+
+      const auto sum =
+         yam::reduce( policy, {}, exts, std::plus<integer>{}, integer(0), integer(0), dst );
+
+      REQUIRE( sum == integer(n*(n-1)/2) );
+# endif
+  }
+
+   TEST_CASE( "tuning database round trip", "[tune]" )
+  {
+      namespace tune = yam::tune;
+
+      const std::string path = "progrm/tune_h_test.db";
+      std::remove( path.c_str() );
+
+      using integer = yam::idx_t;
+
+      constexpr size_t n0=16;
+      constexpr size_t n1=24;
+
+      auto data0 = std::make_unique<integer[]>(n0*n1);
+      auto data1 = std::make_unique<integer[]>(n0*n1);
+
+      yam::span<integer,n0,n1> dst(data0.get());
+      yam::span<integer,n0,n1> src(data1.get());
+
+      const stx::extents<n0,n1> exts;
+
+      yam::fill( yam::execution::seq, {}, exts, src, integer(3) );
+
+      tune::settings().repeats = 1;
+
+      const auto key = tune::signature<decltype(dst),decltype(src)>( "assign", exts );
+
+      REQUIRE( key.starts_with( "assign|" ) );
+      REQUIRE( key.ends_with( "|16x24" ) );
+
+      size_t runs=0;
+      const auto kernel =
+         [&]( const auto policy )
+        {
+            ++runs;
+            yam::assign( policy, {}, exts, dst, src );
+        };
+
+      tune::config tuned;
+      {
+         tune::database db( path, "test cpu" );
+         REQUIRE( db.size() == 0 );
+
+         const auto policy = tune::tuned_policy( db, yam::execution::seq, key, exts, kernel );
+
+         REQUIRE( runs > 2 );
+         REQUIRE( db.size() == 1 );
+
+         tuned.tile = policy.tile;
+         tuned.order = policy.order;
+      }
+
+   // reloaded database returns the same configuration without running the kernel
+      {
+         runs=0;
+         tune::database db( path, "test cpu" );
+         REQUIRE( db.size() == 1 );
+
+         const auto policy = tune::tuned_policy( db, yam::execution::seq, key, exts, kernel );
+
+         REQUIRE( runs == 0 );
+         REQUIRE( policy.tile  == tuned.tile );
+         REQUIRE( policy.order == tuned.order );
+      }
+
+   // a different cpu model does not use the record
+      {
+         tune::database db( path, "other cpu" );
+         REQUIRE( !db.find( key+"|seq" ) );
+         REQUIRE( db.find( key+"|seq" ) == std::nullopt );
+      }
+
+   // records inserted through two databases open on the same file are merged, not overwritten
+      {
+         tune::database a( path, "test cpu" );
+         tune::database b( path, "test cpu" );
+
+         a.insert( "first", tuned );
+         b.insert( "second", tuned );
+
+         REQUIRE( tune::database( path, "test cpu" ).size() == 3 );
+         REQUIRE( tune::database( path, "test cpu" ).find( "first" ) );
+      }
+
+      for( size_t i=0; i<n0; ++i )
+     {
+         for( size_t j=0; j<n1; ++j )
+        {
+            REQUIRE( dst(yam::index2<>{yam::idx_t(i),yam::idx_t(j)}) == 3 );
+        }
+     }
+
+      std::remove( path.c_str() );
+      std::remove( (path+".lock").c_str() );
+  }
+
+   TEST_CASE( "tiled reduce folds tile results in tile order", "[tune]" )
+  {
+      using integer = yam::idx_t;
+
+      constexpr integer n0=4;
+      constexpr integer n1=5;
+      constexpr integer n2=3;
+
+      const stx::extents<n0,n1,n2> exts;
+
+   // one letter per index, so string concatenation records the order of the reduction
+      const auto letter =
+         []( const yam::index3<> idx ){ return std::string( 1, char('A' + (idx[0]*n1 + idx[1])*n2 + idx[2]) ); };
+
+      const auto concat =
+         [&]( const auto policy ){ return yam::reduce( policy, {}, exts, std::plus<std::string>{}, std::string{}, std::string{}, letter ); };
+
+   // a single tile is the plain row-major reduction
+      const std::string rowmajor = concat( yam::execution::seq );
+
+      REQUIRE( rowmajor.size() == size_t(n0*n1*n2) );
+      REQUIRE( concat( yam::execution::tiled( yam::execution::seq, {0,0,0} ) ) == rowmajor );
+
+      using tiles_t = std::array<yam::idx_t,3>;
+      using order_t = std::array<yam::ndim_t,3>;
+
+      for( const auto& tile : { tiles_t{2,3,2}, tiles_t{1,0,1}, tiles_t{4,4,4} } )
+     {
+         for( const auto& order : { order_t{0,1,2}, order_t{2,1,0}, order_t{1,2,0} } )
+        {
+            const std::string serial = concat( yam::execution::tiled( yam::execution::seq, tile, order ) );
+
+         // every index is reduced exactly once
+            std::string sorted = serial;
+            std::sort( sorted.begin(), sorted.end() );
+            REQUIRE( sorted == rowmajor );
+
+# ifdef _OPENMP
+         // parallel tiles are folded in the same order as the serial tiles are visited
+            REQUIRE( concat( yam::execution::tiled( yam::execution::openmp, tile, order, 3 ) ) == serial );
+# endif
+        }
+     }
+  }
+
+   TEST_CASE( "tuned assign and transform", "[tune]" )
+  {
+      namespace tune = yam::tune;
+
+   // the default database is opened on first use
+      const std::string path = "progrm/tune_h_instance.db";
+      std::remove( path.c_str() );
+      setenv( "YAMDAL_TUNE_DB", path.c_str(), 1 );
+
+      tune::database& db = tune::database::instance();
+      REQUIRE( db.path() == path );
+
+      using integer = yam::idx_t;
+
+      constexpr size_t n0=12;
+      constexpr size_t n1=20;
+
+      auto data0 = std::make_unique<integer[]>(n0*n1);
+      auto data1 = std::make_unique<integer[]>(n0*n1);
+      auto data2 = std::make_unique<integer[]>(n0*n1);
+
+      yam::span<integer,n0,n1> dst(data0.get());
+      yam::span<integer,n0,n1> src0(data1.get());
+      yam::span<integer,n0,n1> src1(data2.get());
+
+      const stx::extents<n0,n1> exts;
+
+      const auto linear =
+         []( const yam::index2<> idx ){ return idx[0]*integer(n1) + idx[1]; };
+
+      yam::assign( yam::execution::seq, {}, exts, src0, linear );
+      yam::fill( yam::execution::seq, {}, exts, src1, integer(2) );
+
+      tune::settings().repeats = 1;
+
+      const size_t before = db.size();
+
+      const auto check =
+         [&]( const auto expected )
+        {
+            for( integer i=0; i<integer(n0); ++i )
+           {
+               for( integer j=0; j<integer(n1); ++j )
+              {
+                  REQUIRE( dst(yam::index2<>{i,j}) == expected(yam::index2<>{i,j}) );
+              }
+           }
+        };
+
+   // first call of each signature is tuned and recorded, later calls look up the record
+      for( size_t call=0; call<2; ++call )
+     {
+         yam::fill( yam::execution::seq, {}, exts, dst, integer(0) );
+         tune::assign( yam::execution::seq, "copy", {}, exts, dst, src0 );
+         check( linear );
+
+         REQUIRE( db.size() == before + (call==0 ? 1 : 2) );
+
+         yam::fill( yam::execution::seq, {}, exts, dst, integer(0) );
+         tune::transform( yam::execution::seq, "product", {}, exts, dst, std::multiplies<integer>{}, src0, src1 );
+         check( [&]( const yam::index2<> idx ){ return 2*linear(idx); } );
+
+         REQUIRE( db.size() == before+2 );
+     }
+
+   // subrange
+      yam::fill( yam::execution::seq, {}, exts, dst, integer(0) );
+      tune::assign( yam::execution::seq, "copy", {2,3}, stx::extents<4,5>{}, dst, src0 );
+
+      REQUIRE( dst(yam::index2<>{2,3}) == linear({2,3}) );
+      REQUIRE( dst(yam::index2<>{5,7}) == linear({5,7}) );
+      REQUIRE( dst(yam::index2<>{1,3}) == 0 );
+      REQUIRE( dst(yam::index2<>{6,7}) == 0 );
+      REQUIRE( dst(yam::index2<>{5,8}) == 0 );
+
+   // lambdas of the same type signature are told apart by the kernel name, not by their type
+      const size_t named = db.size();
+
+      tune::transform( yam::execution::seq, "plus_one", {}, exts, dst, []( const integer x ){ return x+1; }, src0 );
+      check( [&]( const yam::index2<> idx ){ return linear(idx)+1; } );
+
+      tune::transform( yam::execution::seq, "minus_one", {}, exts, dst, []( const integer x ){ return x-1; }, src0 );
+      check( [&]( const yam::index2<> idx ){ return linear(idx)-1; } );
+
+      REQUIRE( db.size() == named+2 );
+
+   // tuning runs on a scratch array, so a destination that is also a source is only updated once
+      yam::assign( yam::execution::seq, {}, exts, dst, src0 );
+      tune::transform( yam::execution::seq, "increment", {}, exts, dst, []( const integer x ){ return x+1; }, dst );
+      check( [&]( const yam::index2<> idx ){ return linear(idx)+1; } );
+
+      REQUIRE( db.size() == named+3 );
+
+      REQUIRE( tune::database( path ).size() == db.size() );
+
+      std::remove( path.c_str() );
+      std::remove( (path+".lock").c_str() );
+  }
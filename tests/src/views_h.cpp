@@ -1,9 +1,12 @@
 
 # include <yamdal/views.h>
+# include <yamdal/span.h>
 
 # include <catch.hpp>
 
 # include <array>
+# include <vector>
+# include <concepts>
 
 // indexable 1D array of type T and size N
    template<typename T,
@@ -64,7 +67,7 @@
      }
   };
 
-   TEST_CASE( "non-const view for non-const lvalue 1D source" "[views][1D]" )
+   TEST_CASE( "non-const view for non-const lvalue 1D source", "[views][1D]" )
   {
       using integer = yam::idx_t;
       using index = yam::index1<>;
@@ -93,7 +96,7 @@
      }
   }
 
-   TEST_CASE( "const view for non-const lvalue 1D source" "[views][1D]" )
+   TEST_CASE( "const view for non-const lvalue 1D source", "[views][1D]" )
   {
       using integer = yam::idx_t;
       using index = yam::index1<>;
@@ -117,3 +120,204 @@
      }
   }
 
+   TEST_CASE( "staggered interpolation is exact for linear fields", "[views][staggered]" )
+  {
+      using integer = yam::idx_t;
+
+      constexpr integer n0=5;
+      constexpr integer n1=4;
+
+      const auto linear =
+         []( const double x, const double y ){ return 2*x + 3*y + 1; };
+
+   // primal field as a plain indexable and as a span
+      array2D<double,n0,n1> parr{};
+      std::vector<double> pdata( size_t(n0*n1) );
+      const yam::primal_span2<double> pspan( pdata.data(), n0, n1 );
+
+      for( integer i=0; i<n0; ++i )
+     {
+         for( integer j=0; j<n1; ++j )
+        {
+            parr(yam::primal_index2{i,j}) = linear( double(i), double(j) );
+            pspan(yam::primal_index2{i,j}) = linear( double(i), double(j) );
+        }
+     }
+
+      SECTION( "primal to dual" )
+     {
+         const auto check =
+            [&]( const auto& p )
+           {
+               const auto d  = yam::to_dual_interp( p );
+               const auto d0 = yam::to_dual_interp<0>( p );
+               const auto d1 = yam::to_dual_interp<1>( p );
+
+               static_assert(  std::invocable<decltype(d),yam::dual_index2> );
+               static_assert( !std::invocable<decltype(d),yam::primal_index2> );
+
+               for( integer i=0; i<n0-1; ++i )
+              {
+                  for( integer j=0; j<n1-1; ++j )
+                 {
+                     const yam::dual_index2 idx{i,j};
+                     REQUIRE( d(idx)  == Approx( linear( double(i)+0.5, double(j)+0.5 ) ) );
+                     REQUIRE( d0(idx) == Approx( linear( double(i)+0.5, double(j) ) ) );
+                     REQUIRE( d1(idx) == Approx( linear( double(i),     double(j)+0.5 ) ) );
+                 }
+              }
+           };
+
+         check( parr );
+         check( pspan );
+     }
+
+      SECTION( "dual to primal" )
+     {
+         std::vector<double> ddata( size_t((n0-1)*(n1-1)) );
+         const yam::dual_span2<double> dspan( ddata.data(), n0-1, n1-1 );
+
+         for( integer i=0; i<n0-1; ++i )
+        {
+            for( integer j=0; j<n1-1; ++j )
+           {
+               dspan(yam::dual_index2{i,j}) = linear( double(i)+0.5, double(j)+0.5 );
+           }
+        }
+
+         const auto p = yam::to_primal_interp( dspan );
+
+         static_assert( std::invocable<decltype(p),yam::primal_index2> );
+
+      // interior nodes only
+         for( integer i=1; i<n0-1; ++i )
+        {
+            for( integer j=1; j<n1-1; ++j )
+           {
+               REQUIRE( p(yam::primal_index2{i,j}) == Approx( linear( double(i), double(j) ) ) );
+           }
+        }
+     }
+
+      SECTION( "3D" )
+     {
+         constexpr integer m=4;
+
+         std::vector<double> data( size_t(m*m*m) );
+         const yam::primal_span3<double> p( data.data(), m, m, m );
+
+         for( integer i=0; i<m; ++i )
+        {
+            for( integer j=0; j<m; ++j )
+           {
+               for( integer k=0; k<m; ++k )
+              {
+                  p(yam::primal_index3{i,j,k}) = double(i + 2*j + 3*k);
+              }
+           }
+        }
+
+         const auto d = yam::to_dual_interp( p );
+         const auto d2 = yam::to_dual_interp<0,2>( p );
+
+      // dual cell centres are offset by 1/2 along each interpolated axis
+         for( integer i=0; i<m-1; ++i )
+        {
+            for( integer j=0; j<m-1; ++j )
+           {
+               for( integer k=0; k<m-1; ++k )
+              {
+                  REQUIRE( d(yam::dual_index3{i,j,k})  == Approx( double(i + 2*j + 3*k) + 3.0 ) );
+                  REQUIRE( d2(yam::dual_index3{i,j,k}) == Approx( double(i + 2*j + 3*k) + 2.0 ) );
+              }
+           }
+        }
+     }
+  }
+
+   TEST_CASE( "staggered gradient and divergence", "[views][staggered]" )
+  {
+      using integer = yam::idx_t;
+
+      constexpr integer n0=6;
+      constexpr integer n1=5;
+
+      const double dx=0.5;
+      const double dy=0.25;
+
+   // p = x^2 + 3y^2, so grad p = (2x,6y) and laplacian p = 8
+      const auto quadratic =
+         [&]( const integer i, const integer j ){ const double x=double(i)*dx, y=double(j)*dy; return x*x + 3*y*y; };
+
+      array2D<double,n0,n1> parr{};
+      std::vector<double> pdata( size_t(n0*n1) );
+      const yam::primal_span2<double> pspan( pdata.data(), n0, n1 );
+
+      for( integer i=0; i<n0; ++i )
+     {
+         for( integer j=0; j<n1; ++j )
+        {
+            parr(yam::primal_index2{i,j}) = quadratic( i, j );
+            pspan(yam::primal_index2{i,j}) = quadratic( i, j );
+        }
+     }
+
+      const auto check =
+         [&]( const auto& p )
+        {
+            const auto gx = yam::gradient<0>( p, 1/dx );
+            const auto gy = yam::gradient<1>( p, 1/dy );
+
+            static_assert( std::invocable<decltype(gx),yam::dual_index2> );
+
+         // gradient is exact at cell centres
+            for( integer i=0; i<n0-1; ++i )
+           {
+               for( integer j=0; j<n1-1; ++j )
+              {
+                  const yam::dual_index2 idx{i,j};
+                  REQUIRE( gx(idx) == Approx( 2*(double(i)+0.5)*dx ) );
+                  REQUIRE( gy(idx) == Approx( 6*(double(j)+0.5)*dy ) );
+              }
+           }
+
+         // divergence of the lazy gradient views
+            const auto lap = yam::divergence( std::array{1/dx,1/dy}, gx, gy );
+
+            static_assert( std::invocable<decltype(lap),yam::primal_index2> );
+
+         // and of gradients stored in dual spans
+            std::vector<double> gxdata( size_t((n0-1)*(n1-1)) );
+            std::vector<double> gydata( size_t((n0-1)*(n1-1)) );
+            const yam::dual_span2<double> gxspan( gxdata.data(), n0-1, n1-1 );
+            const yam::dual_span2<double> gyspan( gydata.data(), n0-1, n1-1 );
+
+            for( integer i=0; i<n0-1; ++i )
+           {
+               for( integer j=0; j<n1-1; ++j )
+              {
+                  gxspan(yam::dual_index2{i,j}) = gx(yam::dual_index2{i,j});
+                  gyspan(yam::dual_index2{i,j}) = gy(yam::dual_index2{i,j});
+              }
+           }
+
+            const auto lapspan = yam::divergence( std::array{1/dx,1/dy}, gxspan, gyspan );
+
+         // and as a single stencil
+            const auto lapfused = yam::laplacian( p, std::array{1/dx,1/dy} );
+
+            for( integer i=1; i<n0-1; ++i )
+           {
+               for( integer j=1; j<n1-1; ++j )
+              {
+                  const yam::primal_index2 idx{i,j};
+                  REQUIRE( lap(idx)     == Approx( 8.0 ) );
+                  REQUIRE( lapspan(idx) == Approx( 8.0 ) );
+                  REQUIRE( lapfused(idx) == Approx( lap(idx) ) );
+              }
+           }
+        };
+
+      check( parr );
+      check( pspan );
+  }